@@ -0,0 +1,199 @@
+#include "AdbClient.h"
+#include <QTcpSocket>
+#include <QDeadlineTimer>
+
+AdbClient::AdbClient(const QString &host, quint16 port)
+    : m_host(host), m_port(port)
+{
+}
+
+AdbClient::~AdbClient()
+{
+}
+
+bool AdbClient::devices(QList<AdbDevice> &out, QString *error)
+{
+    QByteArray payload;
+    if (!hostQuery("host:devices", payload, error))
+        return false;
+    out = parseDevices(payload);
+    return true;
+}
+
+bool AdbClient::hostQuery(const QByteArray &service, QByteArray &out, QString *error)
+{
+    for (;;) {
+        bool reused = false;
+        QTcpSocket *socket = acquire(&reused, error);
+        if (!socket)
+            return false;
+        if (request(*socket, service, error) && readLengthPrefixed(*socket, out, error))
+            return true;
+        // 复用的连接可能已被 server 关闭（应答后关闭的消息还没读到），换新连接重试一次
+        disconnectFromServer();
+        if (!reused)
+            return false;
+    }
+}
+
+bool AdbClient::shell(const QString &serial, const QByteArray &command, QByteArray &out, QString *error)
+{
+    // 同一连接上先切换到目标设备，再打开 shell 服务
+    const QByteArray transport = serial.isEmpty() ? QByteArray("host:transport-any")
+                                                  : "host:transport:" + serial.toUtf8();
+    QTcpSocket *socket = nullptr;
+    for (;;) {
+        bool reused = false;
+        socket = acquire(&reused, error);
+        if (!socket)
+            return false;
+        if (request(*socket, transport, error))
+            break;
+        disconnectFromServer();
+        if (!reused)
+            return false;
+    }
+    // 连接从这里起属于设备端，用完即关闭
+    std::unique_ptr<QTcpSocket> stream = std::move(m_socket);
+    if (!request(*stream, "shell:" + command, error))
+        return false;
+
+    out.clear();
+    for (;;) {
+        out += stream->readAll();
+        if (stream->state() != QAbstractSocket::ConnectedState)
+            break;
+        // 超时按两次输出之间的间隔计算，大量输出（如 getprop、dumpsys）不受总时长限制
+        if (!stream->waitForReadyRead(m_timeoutMs) && stream->state() == QAbstractSocket::ConnectedState) {
+            if (error)
+                *error = "等待设备输出超时";
+            return false;
+        }
+    }
+    out += stream->readAll();
+    // 旧设备的 shell 经过 PTY，换行是 \r\n
+    out.replace("\r\n", "\n");
+    return true;
+}
+
+void AdbClient::disconnectFromServer()
+{
+    if (m_socket) {
+        m_socket->abort();
+        m_socket.reset();
+    }
+}
+
+bool AdbClient::isConnected() const
+{
+    return m_socket && m_socket->state() == QAbstractSocket::ConnectedState;
+}
+
+// 取得可用的连接：保持的连接还开着就复用，否则新建
+QTcpSocket *AdbClient::acquire(bool *reused, QString *error)
+{
+    if (m_socket) {
+        // 处理已到达的关闭通知（不等待），server 已关闭的连接不再复用
+        if (m_socket->state() == QAbstractSocket::ConnectedState && m_socket->bytesAvailable() == 0)
+            m_socket->waitForReadyRead(0);
+        if (m_socket->state() == QAbstractSocket::ConnectedState && m_socket->bytesAvailable() == 0) {
+            *reused = true;
+            return m_socket.get();
+        }
+        disconnectFromServer();
+    }
+
+    *reused = false;
+    m_socket.reset(new QTcpSocket);
+    if (!connectTo(*m_socket, error)) {
+        m_socket.reset();
+        return nullptr;
+    }
+    return m_socket.get();
+}
+
+QList<AdbDevice> AdbClient::parseDevices(const QByteArray &payload)
+{
+    QList<AdbDevice> devices;
+    for (const QByteArray &line : payload.split('\n')) {
+        const int tab = line.indexOf('\t');
+        if (tab <= 0)
+            continue;
+        AdbDevice device;
+        device.serial = QString::fromUtf8(line.left(tab));
+        device.state = QString::fromUtf8(line.mid(tab + 1).trimmed());
+        devices.append(device);
+    }
+    return devices;
+}
+
+QByteArray AdbClient::encodeRequest(const QByteArray &service)
+{
+    return QByteArray::number(service.size(), 16).rightJustified(4, '0') + service;
+}
+
+bool AdbClient::connectTo(QTcpSocket &socket, QString *error) const
+{
+    socket.connectToHost(m_host, m_port);
+    if (!socket.waitForConnected(m_timeoutMs)) {
+        if (error)
+            *error = "无法连接 adb server: " + socket.errorString();
+        return false;
+    }
+    return true;
+}
+
+bool AdbClient::request(QTcpSocket &socket, const QByteArray &service, QString *error) const
+{
+    socket.write(encodeRequest(service));
+    if (!socket.waitForBytesWritten(m_timeoutMs)) {
+        if (error)
+            *error = "发送请求失败: " + socket.errorString();
+        return false;
+    }
+
+    QByteArray status;
+    if (!readExact(socket, 4, status, error))
+        return false;
+    if (status == "OKAY")
+        return true;
+
+    if (error) {
+        QByteArray message;
+        if (status == "FAIL" && readLengthPrefixed(socket, message, nullptr))
+            *error = QString::fromUtf8(message);
+        else
+            *error = "adb server 应答异常: " + QString::fromLatin1(status);
+    }
+    return false;
+}
+
+bool AdbClient::readExact(QTcpSocket &socket, qint64 length, QByteArray &out, QString *error) const
+{
+    out.clear();
+    QDeadlineTimer deadline(m_timeoutMs);
+    while (out.size() < length) {
+        if (socket.bytesAvailable() == 0 && !socket.waitForReadyRead(int(deadline.remainingTime()))) {
+            if (error)
+                *error = "读取 adb 应答失败: " + socket.errorString();
+            return false;
+        }
+        out += socket.read(length - out.size());
+    }
+    return true;
+}
+
+bool AdbClient::readLengthPrefixed(QTcpSocket &socket, QByteArray &out, QString *error) const
+{
+    QByteArray hex;
+    if (!readExact(socket, 4, hex, error))
+        return false;
+    bool ok = false;
+    const int length = hex.toInt(&ok, 16);
+    if (!ok) {
+        if (error)
+            *error = "adb 应答长度无效";
+        return false;
+    }
+    return readExact(socket, length, out, error);
+}
@@ -0,0 +1,70 @@
+#ifndef ADBCLIENT_H
+#define ADBCLIENT_H
+
+#include <QString>
+#include <QByteArray>
+#include <QList>
+#include <memory>
+
+class QTcpSocket;
+
+struct AdbDevice {
+    QString serial;
+    QString state;          // device / offline / unauthorized / recovery ...
+};
+
+// adb 主机协议客户端：直接与本机 adb server（默认 127.0.0.1:5037）通信，
+// 不再为每次查询启动 shell 和 adb 进程，也没有命令行转义问题
+//
+// 请求格式为 4 位十六进制长度 + 服务名，服务端回复 "OKAY" 或 "FAIL" + 长度 + 错误信息。
+// 所有调用都是阻塞的（带超时），不依赖事件循环。
+//
+// 连接在调用之间保持打开并复用：host: 查询应答后连接仍打开时，下一个请求直接在其上发出；
+// adb server 应答后关闭了连接（多数版本对 host: 服务如此）时自动重连，复用的连接上请求失败也重连重试一次。
+// shell 会把连接切换成设备数据流，结束后该连接不再可用，下次调用重新连接。
+// 连接属于创建它的线程：同一个 AdbClient 只在一个线程中使用（或每个线程各用一个）。
+class AdbClient
+{
+public:
+    static constexpr quint16 DefaultPort = 5037;
+    static constexpr int DefaultTimeoutMs = 3000;
+
+    explicit AdbClient(const QString &host = "127.0.0.1", quint16 port = DefaultPort);
+    ~AdbClient();
+
+    // 连接、单次应答的超时；shell 输出按无数据的间隔计算，持续有输出时不会超时
+    void setTimeout(int ms) { m_timeoutMs = ms; }
+    QString host() const { return m_host; }
+    quint16 port() const { return m_port; }
+
+    // host:devices
+    bool devices(QList<AdbDevice> &out, QString *error = nullptr);
+    // 其他 host: 服务（如 host:version），返回带长度前缀的应答内容
+    bool hostQuery(const QByteArray &service, QByteArray &out, QString *error = nullptr);
+    // host:transport:<serial> + shell:<command>，读取全部输出直到设备端关闭连接
+    bool shell(const QString &serial, const QByteArray &command, QByteArray &out, QString *error = nullptr);
+
+    // 关闭保持的连接（在使用它的线程中调用）
+    void disconnectFromServer();
+    bool isConnected() const;
+
+    // "serial\tstate\n" 列表（host:devices 与 host:track-devices 共用）
+    static QList<AdbDevice> parseDevices(const QByteArray &payload);
+
+    // 协议辅助，供长连接（track-devices）复用
+    static QByteArray encodeRequest(const QByteArray &service);
+
+private:
+    QTcpSocket *acquire(bool *reused, QString *error);
+    bool connectTo(QTcpSocket &socket, QString *error) const;
+    bool request(QTcpSocket &socket, const QByteArray &service, QString *error) const;
+    bool readExact(QTcpSocket &socket, qint64 length, QByteArray &out, QString *error) const;
+    bool readLengthPrefixed(QTcpSocket &socket, QByteArray &out, QString *error) const;
+
+    QString m_host;
+    quint16 m_port;
+    int m_timeoutMs = DefaultTimeoutMs;
+    std::unique_ptr<QTcpSocket> m_socket;     // 保持的连接
+};
+
+#endif // ADBCLIENT_H
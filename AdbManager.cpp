@@ -1,4 +1,8 @@
 #include "AdbManager.h"
+#include "AdbClient.h"
+#include "DeviceWatcher.h"
+#include "ScreenCapture.h"
+#include <QThread>
 #include <QDir>
 #include <QDateTime>
 #include <QPixmap>
@@ -6,23 +10,50 @@
 #include <QRegularExpression>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QFile>
+#include <QDebug>
 
 // 构造函数
 AdbManager::AdbManager(QObject *parent)
-    : QObject(parent), m_logcatProcess(nullptr), m_stopLogFlag(false), m_deviceConnected(false)
+    : QObject(parent), m_deviceConnected(false)
 {
     // 初始化成员变量
     // setAdbPath(QCoreApplication::applicationDirPath() + "/adb.exe");  // 初始化ADB路径
-    checkDeviceStatus();  // 检查设备状态
+
+    // adb 查询固定在一个线程中执行，连接可以跨查询保持
+    m_adbPool.setMaxThreadCount(1);
+    m_adbPool.setExpiryTimeout(-1);
+
+    // 设备插拔由 adb server 主动推送，不再定时轮询
+    m_watcher = new DeviceWatcher(getAdbPath(), this);
+    connect(m_watcher, &DeviceWatcher::devicesChanged, this, &AdbManager::onDevicesChanged);
+    // 设备断开或状态变化（重连、重启进入 recovery 等）后属性需要重新获取
+    connect(m_watcher, &DeviceWatcher::deviceRemoved, this, [this](const QString &serial) {
+        m_properties.invalidate(serial);
+    });
+    connect(m_watcher, &DeviceWatcher::deviceStateChanged, this, [this](const AdbDevice &device) {
+        m_properties.invalidate(device.serial);
+    });
+    connect(m_watcher, &DeviceWatcher::serverAvailableChanged, this, [this](bool, const QString &error) {
+        m_serverError = error;
+        onDevicesChanged();
+    });
+    m_watcher->start();
+
+    m_screenCapture = new ScreenCapture(getAdbPath(), this);
+    connect(m_screenCapture, &ScreenCapture::captured, this, &AdbManager::screenshotCaptured);
+    connect(m_screenCapture, &ScreenCapture::failed, this, &AdbManager::errorOccurred);
+    connect(m_screenCapture, &ScreenCapture::burstFinished, this, [this](int frames, const QString &dir) {
+        emit logMessage(QString("连拍结束，共保存 %1 张: %2").arg(frames).arg(dir));
+    });
 }
 
 // 析构函数
 AdbManager::~AdbManager()
 {
-    if (m_logcatProcess) {
-        m_logcatProcess->kill();
-        m_logcatProcess->deleteLater();
-    }
+    // 连接在查询线程中创建，也在那里关闭
+    m_adbPool.start([this]() { m_adb.disconnectFromServer(); });
+    m_adbPool.waitForDone();
 }
 
 // -----------------------------------------------------------------------------
@@ -35,44 +66,59 @@ QString AdbManager::getAdbPath() const {
     return "adb";
 }
 
-// 检查设备状态（adb devices + 获取设备属性）
-void AdbManager::checkDeviceStatus() {
-    QThreadPool::globalInstance()->start([this]() {
-        QString adbCmd = getAdbPath() + " devices";
-        QString adbOutput = runCommand(adbCmd);
-
-        qDebug() << "adb devices output:" << adbOutput;  // <<<< 这里加上调试输出
+// 设备列表或 adb server 状态变化（由 DeviceWatcher 推送）
+void AdbManager::onDevicesChanged()
+{
+    QStringList online;
+    for (const AdbDevice &device : m_watcher->devices()) {
+        if (device.state == "device")
+            online << device.serial;
+    }
+    const QString serial = online.isEmpty() ? QString() : online.first();
+    if (online != m_onlineDevices) {
+        m_onlineDevices = online;
+        emit onlineDevicesChanged(m_onlineDevices);
+    }
 
-        QString status, color = "red";
-        QString serial = "-", brand = "-", model = "-", androidVer = "-";
+    // 更新状态，并触发信号（只有状态变化才发信号）
+    const bool connected = !serial.isEmpty();
+    m_serialNumber = serial;
+    if (connected != m_deviceConnected) {
+        m_deviceConnected = connected;
+        emit deviceConnectionChanged(m_deviceConnected);
+    }
 
-        QStringList lines = adbOutput.split('\n');
-        QStringList devices;
-        for (int i=1; i<lines.size(); ++i) {
-            auto line = lines[i].trimmed();
-            if (!line.isEmpty() && line.contains("device"))
-                devices << line.split(QRegularExpression("\\s+")).first();
-        }
+    checkDeviceStatus();
+}
 
-        // ---- 这里开始判断设备连接 ----
-        bool connected = !devices.isEmpty();
+// 刷新设备状态显示：设备属性在线程池中通过 adb server 读取，
+// 期间设备列表又发生变化时，旧的结果直接丢弃
+void AdbManager::checkDeviceStatus() {
+    const quint64 generation = ++m_statusGeneration;
+    const QList<AdbDevice> devices = m_watcher->devices();
+    const bool serverOk = m_watcher->isServerAvailable();
+    const QString serverError = m_serverError;
+    const QString onlineSerial = m_serialNumber;
 
-        // 更新状态，并触发信号（只有状态变化才发信号）
-        if (connected != m_deviceConnected) {
-            m_deviceConnected = connected;
-            emit deviceConnectionChanged(m_deviceConnected);
-        }
-        // ---- 判断结束 ----
+    m_adbPool.start([this, generation, devices, serverOk, serverError, onlineSerial]() {
+        QString status, color = "red";
+        QString serial = "-", brand = "-", model = "-", androidVer = "-";
 
-        if (connected) {
-            serial = devices[0];
+        if (!onlineSerial.isEmpty()) {
+            serial = onlineSerial;
             status = "已连接设备: " + serial;
             color = "green";
-            brand = runCommand(getAdbPath() + " -s " + serial + " shell getprop ro.product.brand");
-            model = runCommand(getAdbPath() + " -s " + serial + " shell getprop ro.product.model");
-            androidVer = runCommand(getAdbPath() + " -s " + serial + " shell getprop ro.build.version.release");
-        } else if (!adbOutput.contains("List of devices")) {
-            status = "设备处于 fastboot 模式";
+            // 同一设备连接期间只取一次全部属性
+            if (!m_properties.contains(serial))
+                m_properties.fetch(m_adb, serial);
+            brand = m_properties.value(serial, "ro.product.brand", "-");
+            model = m_properties.value(serial, "ro.product.model", "-");
+            androidVer = m_properties.value(serial, "ro.build.version.release", "-");
+        } else if (!serverOk) {
+            status = "ADB 服务不可用: " + serverError;
+            color = "orange";
+        } else if (!devices.isEmpty()) {
+            status = "设备未就绪: " + devices[0].serial + " (" + devices[0].state + ")";
             color = "orange";
         } else {
             status = "未检测到设备";
@@ -82,7 +128,15 @@ void AdbManager::checkDeviceStatus() {
         QString imagePath = ":/images/" + brand + "_" + model + ".png";
         if (!QFile::exists(imagePath)) imagePath = "device.png";
 
-        emit deviceStatusUpdated(status, color, serial, brand, model, androidVer, imagePath);
+        QMetaObject::invokeMethod(this, [=]() {
+            if (generation != m_statusGeneration)
+                return;
+            const bool online = !onlineSerial.isEmpty();
+            m_deviceBrand = online ? brand : QString();
+            m_deviceModel = online ? model : QString();
+            m_androidVersion = online ? androidVer : QString();
+            emit deviceStatusUpdated(status, color, serial, brand, model, androidVer, imagePath);
+        }, Qt::QueuedConnection);
     });
 }
 
@@ -92,110 +146,88 @@ bool AdbManager::isDeviceConnected() const
     return m_deviceConnected;         // 这里返回状态查询
 }
 
-// 开始抓取 adb logcat 日志
-void AdbManager::startLogcat()
+void AdbManager::clearLogcat()
 {
-    if (!isDeviceConnected()) {
-        emit errorOccurred("未检测到ADB设备");
-        return;
+    if (isDeviceConnected()) {
+        const QString serial = m_serialNumber;
+        m_adbPool.start([this, serial]() {
+            QByteArray output;
+            m_adb.shell(serial, "logcat -c", output);
+        });
     }
+}
 
-    if (m_logcatProcess && m_logcatProcess->state() == QProcess::Running) {
-        emit errorOccurred("日志抓取已在进行中");
+// ********************************* 截图功能 *********************************
+// 输出边读边写入文件，超时按无数据间隔计算（大尺寸屏幕不再因 3 秒超时失败）
+void AdbManager::captureScreenshot()
+{
+    if (!isDeviceConnected()) {
+        emit errorOccurred("未检测到ADB设备");
         return;
     }
 
-    // 准备保存路径
-    QString saveDir = QDir::currentPath() + "/device_logs";
+    QString saveDir = QDir::currentPath() + "/screenshots";
     QDir().mkpath(saveDir);
-    QString filename = saveDir + "/log_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".txt";
-
-    emit logMessage("开始实时抓取日志，保存至 " + filename);
-
-    // 重置停止标志
-    m_stopLogFlag.store(false);
-
-    // 打开日志文件
-    m_logFile.setFileName(filename);
-    if (!m_logFile.open(QIODevice::WriteOnly | QIODevice::Text)) {
-        emit logMessage("日志文件打开失败");
-        return;
-    }
-
-    // 若已有旧进程，先删除
-    if (m_logcatProcess) {
-        m_logcatProcess->deleteLater();
-        m_logcatProcess = nullptr;
-    }
-
-    // 创建并启动新的 logcat 进程
-    m_logcatProcess = new QProcess(this);
-    connect(m_logcatProcess, &QProcess::readyReadStandardOutput, this, &AdbManager::onLogcatReadyRead);
-    connect(m_logcatProcess, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &AdbManager::onLogcatFinished);
-
-    runCommand(getAdbPath() + " logcat -c"); // 清除旧日志缓冲区
-    m_logcatProcess->start(getAdbPath(), {"logcat"}); // 启动logcat
+    QString filename = saveDir + "/screenshot_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".png";
+    m_screenCapture->capture(m_serialNumber, filename);
 }
 
-// 停止抓取
-void AdbManager::stopLogcat()
+bool AdbManager::captureScreenshot(const QString &serial, const QString &fileName)
 {
-    if (m_logcatProcess && m_logcatProcess->state() == QProcess::Running) {
-        m_stopLogFlag.store(true);
-        m_logcatProcess->terminate();
-        m_logcatProcess->waitForFinished(3000);
-    }
-
-    if (m_logFile.isOpen()) {
-        m_logFile.close();
-    }
+    const QString target = serial.isEmpty() ? m_serialNumber : serial;
+    if (target.isEmpty() || m_screenCapture->isBusy())
+        return false;
+    return m_screenCapture->capture(target, fileName);
 }
 
-void AdbManager::clearLogcat()
+// ********************************* bugreport *********************************
+// 生成过程需要几分钟，进程在后台运行，不阻塞界面
+bool AdbManager::captureBugreport(const QString &serial, const QString &fileName)
 {
-    if (isDeviceConnected()) {
-        runCommand(getAdbPath() + " logcat -c");      // 修改m_adbPath为getAdbPath()
-    }
+    const QString target = serial.isEmpty() ? m_serialNumber : serial;
+    if (target.isEmpty() || m_bugreport)
+        return false;
+
+    m_bugreport = new QProcess(this);
+    m_bugreport->setProcessChannelMode(QProcess::MergedChannels);
+    connect(m_bugreport, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, [this, target, fileName](int exitCode, QProcess::ExitStatus status) {
+        if (status == QProcess::NormalExit && exitCode == 0)
+            emit logMessage("bugreport 已保存: " + fileName);
+        else
+            emit logMessage("bugreport 失败 [" + target + "]: "
+                            + QString::fromLocal8Bit(m_bugreport->readAll()).trimmed().right(200));
+        m_bugreport->deleteLater();
+        m_bugreport = nullptr;
+    });
+    connect(m_bugreport, &QProcess::errorOccurred, this, [this, target](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart)
+            return;
+        emit logMessage("bugreport 启动失败 [" + target + "]: " + m_bugreport->errorString());
+        m_bugreport->deleteLater();
+        m_bugreport = nullptr;
+    });
+    m_bugreport->start(getAdbPath(), {"-s", target, "bugreport", fileName});
+    emit logMessage("正在生成 bugreport [" + target + "]，需要几分钟");
+    return true;
 }
 
-// ********************************* 截图功能（无法捕获-尚未修复） *********************************
-void AdbManager::captureScreenshot()
+// 连拍：按帧率截取带时间戳的图片序列，frameCount 为 0 时拍到 stopScreenshotBurst()
+void AdbManager::startScreenshotBurst(double fps, int frameCount)
 {
     if (!isDeviceConnected()) {
         emit errorOccurred("未检测到ADB设备");
         return;
     }
 
-    QThreadPool::globalInstance()->start([this]() {
-        QString saveDir = QDir::currentPath() + "/screenshots";
-        QDir().mkpath(saveDir);
-        QString filename = saveDir + "/screenshot_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".png";
-
-        // 尝试直接截图
-        QProcess proc;
-        proc.setProcessChannelMode(QProcess::SeparateChannels);
-        proc.start(getAdbPath(), {"exec-out", "screencap -p"});       // 修改m_adbPath为getAdbPath()
-        
-        bool success = false;
-        if (proc.waitForFinished(3000)) {
-            QByteArray imageData = proc.readAllStandardOutput();
-            if (!imageData.isEmpty() && imageData.startsWith("\x89PNG")) {
-                QFile f(filename);
-                if (f.open(QIODevice::WriteOnly)) {
-                    f.write(imageData);
-                    f.close();
-                    success = true;
-                }
-            }
-        }
+    QString dir = QDir::currentPath() + "/screenshots/burst_" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss");
+    m_screenCapture->startBurst(m_serialNumber, fps, frameCount, dir);
+}
 
-        if (success) {
-            emit screenshotCaptured(filename);
-        } else {
-            emit errorOccurred("截图失败");
-        }
-    });
+void AdbManager::stopScreenshotBurst()
+{
+    m_screenCapture->stopBurst();
 }
+
 // ********************************************* END *********************************************
 
 QString AdbManager::runCommand(const QString &cmd)
@@ -210,34 +242,17 @@ QString AdbManager::runCommand(const QString &cmd)
     return QString::fromLocal8Bit(proc.readAllStandardOutput()).trimmed();
 }
 
-void AdbManager::onLogcatReadyRead()
+// 丢弃当前设备的属性缓存并重新获取（如刷机后）
+void AdbManager::refreshDeviceProperties()
 {
-    if (m_stopLogFlag.load()) return;
-
-    QByteArray data = m_logcatProcess->readAllStandardOutput();
-    if (!data.isEmpty()) {
-        m_logFile.write(data);
-        m_logFile.flush();
-        processLogData(data);
-    }
-}
-
-void AdbManager::onLogcatFinished(int, QProcess::ExitStatus)
-{
-    if (m_logFile.isOpen()) {
-        m_logFile.close();
-    }
+    if (!m_serialNumber.isEmpty())
+        m_properties.invalidate(m_serialNumber);
+    checkDeviceStatus();
 }
 
-void AdbManager::processLogData(const QByteArray &data)
+QString AdbManager::deviceProperty(const QString &key) const
 {
-    QMutexLocker locker(&m_logMutex);
-    for (const auto &line : data.split('\n')) {
-        QString msg = QString::fromUtf8(line).trimmed();
-        if (!msg.isEmpty()) {
-            emit logReceived(msg);
-        }
-    }
+    return m_properties.value(m_serialNumber, key);
 }
 
 QString AdbManager::serialNumber() const
@@ -3,11 +3,13 @@
 
 #include <QObject>
 #include <QProcess>
-#include <QFile>
-#include <QAtomicInt>
-#include <QQueue>
-#include <QMutex>
-#include <atomic>
+#include <QStringList>
+#include <QThreadPool>
+#include "AdbClient.h"
+#include "DevicePropertyCache.h"
+
+class DeviceWatcher;
+class ScreenCapture;
 
 class AdbManager : public QObject
 {
@@ -21,22 +23,30 @@ public:
     QString getAdbPath() const;
     // void setAdbPath(const QString &path);
 
-    // 设备管理
+    // 设备管理（设备变化时自动刷新，也可手动调用）
     void checkDeviceStatus();
     bool isDeviceConnected() const;   // 连接状态
+    QStringList onlineDevices() const { return m_onlineDevices; }
 
-    // 日志管理
-    void startLogcat();
-    void stopLogcat();
+    // 日志管理（抓取由 CaptureSessionManager 按设备进行）
     void clearLogcat();
 
     // 截图管理
     void captureScreenshot();
+    // 截取指定设备（为空时为当前设备）的屏幕到 fileName，上一张未完成时返回 false
+    bool captureScreenshot(const QString &serial, const QString &fileName);
+    // 后台执行 adb bugreport，结果（zip）保存为 fileName，完成后发出 logMessage；同一时间只进行一个
+    bool captureBugreport(const QString &serial, const QString &fileName);
+    void startScreenshotBurst(double fps, int frameCount = 0);
+    void stopScreenshotBurst();
+    ScreenCapture *screenCapture() const { return m_screenCapture; }   // 模式、超时设置
 
     // 命令执行
     QString runCommand(const QString &cmd);
 
-    // 设备信息
+    // 设备信息（来自属性缓存，设备连接期间不再重复访问设备）
+    void refreshDeviceProperties();
+    QString deviceProperty(const QString &key) const;
     QString serialNumber() const;
     QString deviceBrand() const;
     QString deviceModel() const;
@@ -47,33 +57,33 @@ signals:
                              const QString &serial, const QString &brand,
                              const QString &model, const QString &androidVer, const QString &imagePath);
     
-    void logReceived(const QString &log);
+    void onlineDevicesChanged(const QStringList &serials);
     void screenshotCaptured(const QString &filePath);
     void errorOccurred(const QString &error);
     // AdbManager 发日志 → MainWindow::appendLog 收到 → 推入 m_logQueue → 后台 UI 定时刷新显示。
     void logMessage(const QString &msg);  // 新增定义日志窗口提示信号
     void deviceConnectionChanged(bool connected);
 
-private slots:
-    void onLogcatReadyRead();
-    void onLogcatFinished(int exitCode, QProcess::ExitStatus exitStatus);
-
 private:
-    QProcess *m_logcatProcess = nullptr;
-    QFile m_logFile;
-    std::atomic<bool> m_stopLogFlag;
-    QQueue<QString> m_logQueue;
-    QMutex m_logMutex;
-
     QString m_adbPath;
     QString m_serialNumber;
     QString m_deviceBrand;
     QString m_deviceModel;
     QString m_androidVersion;
     bool m_deviceConnected = false;       // 设备连接状态缓存
+    QStringList m_onlineDevices;          // 处于 device 状态的全部设备
+
+    DeviceWatcher *m_watcher;             // track-devices 长连接
+    QString m_serverError;
+    quint64 m_statusGeneration = 0;       // 设备状态刷新序号，丢弃过期结果
+    DevicePropertyCache m_properties;     // 按序列号缓存的 getprop 结果
+    AdbClient m_adb;                      // 与 adb server 的连接，只在 m_adbPool 的线程中使用
+    QThreadPool m_adbPool;                // 单个常驻线程，依次执行 adb 查询
+    ScreenCapture *m_screenCapture;       // 流式截图 / 连拍
+    QProcess *m_bugreport = nullptr;      // 正在进行的 bugreport
 
-    void processLogData(const QByteArray &data);
     QString getScreenshotTempPath() const;
+    void onDevicesChanged();
 };
 
 #endif // ADBMANAGER_H
\ No newline at end of file
@@ -0,0 +1,470 @@
+#include "BenchRunner.h"
+#include "CaptureSessionManager.h"
+#include "LogModel.h"
+#include "LogViewPipeline.h"
+#include "PipelineStats.h"
+#include "TriggerEngine.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QTableView>
+#include <QThread>
+#include <QTimer>
+#include <cstdio>
+#include <cstring>
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+#include <psapi.h>
+#include <io.h>
+#include <fcntl.h>
+#elif defined(Q_OS_UNIX)
+#include <sys/resource.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdlib>
+#endif
+
+bool BenchRunner::parseArguments(const QStringList &arguments, Options &options, QString *error, QString *help)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FaeDiag 端到端吞吐基准：合成日志经模拟 adb / 虚拟串口进入真实的抓取和显示流水线\n"
+                                     "生成参数：rate=<行/秒>,len=<最短>-<最长>,levels=<V>/<D>/<I>/<W>/<E>,"
+                                     "burst=<倍数>x<持续ms>/<周期ms>,seed=<n>");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"bench", "基准模式"},
+        {{"t", "duration"}, "运行时长（秒），默认 10", "seconds"},
+        {"adb-streams", "模拟 logcat 的路数，默认 1", "count"},
+        {"adb", "logcat 生成参数，默认 rate=5000", "spec"},
+        {"uart", "启用虚拟串口（仅类 Unix 系统）并指定生成参数，如 rate=2000", "spec"},
+        {"baud", "虚拟串口的波特率，默认 921600", "baud"},
+        {{"o", "output"}, "同时落盘到该目录（默认不落盘）", "dir"},
+        {"json", "结果另存为 JSON", "file"},
+        {"triggers", "抓取线程同时匹配触发规则（JSON 文件，default 为内置规则），只计命中数，不执行动作", "file"},
+        {"no-merge", "关闭多路日志按时间合并（按到达顺序显示）"},
+        {"min-rate", "持续行速率低于该值（行/秒）时判为失败", "lines"},
+        {"max-p99", "延迟 p99 高于该值（毫秒）时判为失败", "ms"},
+        {"max-dropped", "丢失行数超过该值时判为失败", "lines"},
+    });
+
+    if (!parser.parse(arguments)) {
+        *error = parser.errorText();
+        return false;
+    }
+    if (parser.isSet("help")) {
+        *help = parser.helpText();
+        return true;
+    }
+    if (!parser.positionalArguments().isEmpty()) {
+        *error = "未知参数: " + parser.positionalArguments().join(' ');
+        return false;
+    }
+
+    bool ok = true;
+    if (parser.isSet("duration")) {
+        options.durationSec = parser.value("duration").toInt(&ok);
+        if (!ok || options.durationSec <= 0) {
+            *error = "无效的 --duration: " + parser.value("duration");
+            return false;
+        }
+    }
+    if (parser.isSet("adb-streams")) {
+        options.adbStreams = parser.value("adb-streams").toInt(&ok);
+        if (!ok || options.adbStreams < 0 || options.adbStreams > 64) {
+            *error = "无效的 --adb-streams: " + parser.value("adb-streams");
+            return false;
+        }
+    }
+    if (parser.isSet("adb") && !LoadGenerator::parseSpec(parser.value("adb"), options.adb, error))
+        return false;
+    options.adb.logcat = true;
+
+    options.uart = parser.isSet("uart");
+    options.uartGen.logcat = false;
+    if (options.uart && !LoadGenerator::parseSpec(parser.value("uart"), options.uartGen, error))
+        return false;
+#ifndef Q_OS_UNIX
+    if (options.uart) {
+        *error = "当前平台不支持虚拟串口（--uart）";
+        return false;
+    }
+#endif
+    if (parser.isSet("baud")) {
+        options.baudRate = parser.value("baud").toInt(&ok);
+        if (!ok || options.baudRate <= 0) {
+            *error = "无效的 --baud: " + parser.value("baud");
+            return false;
+        }
+    }
+    if (options.adbStreams == 0 && !options.uart) {
+        *error = "没有数据源：--adb-streams 为 0 时需要 --uart";
+        return false;
+    }
+
+    if (parser.isSet("output"))
+        options.outputDir = QDir(parser.value("output")).absolutePath();
+    options.jsonPath = parser.value("json");
+    options.triggers = parser.value("triggers");
+    options.timelineMerge = !parser.isSet("no-merge");
+
+    if (parser.isSet("min-rate")) {
+        options.minLinesPerSec = parser.value("min-rate").toDouble(&ok);
+        if (!ok || options.minLinesPerSec < 0) {
+            *error = "无效的 --min-rate: " + parser.value("min-rate");
+            return false;
+        }
+    }
+    if (parser.isSet("max-p99")) {
+        options.maxP99Ms = parser.value("max-p99").toDouble(&ok);
+        if (!ok || options.maxP99Ms <= 0) {
+            *error = "无效的 --max-p99: " + parser.value("max-p99");
+            return false;
+        }
+    }
+    if (parser.isSet("max-dropped")) {
+        options.maxDropped = parser.value("max-dropped").toLongLong(&ok);
+        if (!ok || options.maxDropped < 0) {
+            *error = "无效的 --max-dropped: " + parser.value("max-dropped");
+            return false;
+        }
+    }
+    return true;
+}
+
+// 只模拟 logcat：“logcat -c” 直接成功，“logcat ...” 按生成参数持续输出，直到被结束或管道关闭
+int BenchRunner::runFakeAdb(const QStringList &arguments, const QByteArray &spec)
+{
+    QStringList args = arguments.mid(1);
+    QString serial;
+    if (args.size() >= 2 && args[0] == "-s") {
+        serial = args[1];
+        args = args.mid(2);
+    }
+    if (args.value(0) != "logcat") {
+        fprintf(stderr, "fake adb: unsupported command: %s\n", qPrintable(args.join(' ')));
+        return 1;
+    }
+    if (args.contains("-c"))
+        return 0;
+
+    LoadGenerator::Options options;
+    QString error;
+    if (!LoadGenerator::parseSpec(QString::fromUtf8(spec), options, &error)) {
+        fprintf(stderr, "fake adb: %s\n", qPrintable(error));
+        return 2;
+    }
+    options.seed += qHash(serial);      // 各路内容不同，但每次运行可重现
+
+#ifdef Q_OS_WIN
+    _setmode(_fileno(stdout), _O_BINARY);
+#endif
+    LoadGenerator generator(options);
+    QElapsedTimer clock;
+    clock.start();
+    QByteArray out;
+    for (;;) {
+        out.clear();
+        generator.generate(clock.nsecsElapsed() / 1000, out, 100000);
+        if (!out.isEmpty()) {
+            if (fwrite(out.constData(), 1, size_t(out.size()), stdout) != size_t(out.size()) || fflush(stdout) != 0)
+                return 0;
+        }
+        QThread::msleep(2);
+    }
+}
+
+BenchRunner::BenchRunner(const Options &options, QObject *parent)
+    : QObject(parent), m_options(options)
+{
+    m_captures = new CaptureSessionManager(QCoreApplication::applicationFilePath(), this);
+    m_captures->setOutputDirectory(m_options.outputDir);
+    // 与主窗口相同的日志视图和显示流水线，视图需要显示出来才会绘制
+    m_model = new LogModel(LogStore::DefaultCapacity, this);
+    m_view = new QTableView;
+    m_view->setModel(m_model);
+    LogViewPipeline::configureView(m_view);
+    m_view->resize(1280, 800);
+    m_pipeline = new LogViewPipeline(m_model, m_view, this);
+    m_pipeline->setTimelineMerge(m_options.timelineMerge);
+    connect(m_pipeline, &LogViewPipeline::blocksAppended, this, &BenchRunner::account);
+    connect(m_pipeline, &LogViewPipeline::appended, this, [this](bool wasAtBottom) {
+        if (wasAtBottom)
+            m_view->scrollToBottom();
+    });
+
+    connect(m_captures, &CaptureSessionManager::blockReceived, this, &BenchRunner::onBlock);
+    connect(m_captures, &CaptureSessionManager::logMessage, this, [](const QString &msg) {
+        fprintf(stderr, "%s\n", qPrintable(msg));
+    });
+    connect(m_captures, &CaptureSessionManager::errorOccurred, this, [](const QString &source, const QString &error) {
+        fprintf(stderr, "%s: %s\n", qPrintable(source), qPrintable(error));
+    });
+    connect(m_captures, &CaptureSessionManager::allSessionsStopped, this, [this]() {
+        if (m_finishing)
+            report();
+    });
+
+    m_serialTimer = new QTimer(this);
+    m_serialTimer->setTimerType(Qt::PreciseTimer);
+    connect(m_serialTimer, &QTimer::timeout, this, &BenchRunner::writeSerial);
+    m_progressTimer = new QTimer(this);
+    connect(m_progressTimer, &QTimer::timeout, this, &BenchRunner::printProgress);
+}
+
+BenchRunner::~BenchRunner()
+{
+    m_finishing = true;
+    m_captures->stopAll();
+    closeVirtualSerial();
+    delete m_uartGenerator;
+    delete m_view;
+}
+
+bool BenchRunner::start()
+{
+    if (!m_options.triggers.isEmpty()) {
+        QVector<TriggerRule> rules = TriggerEngine::defaultRules();
+        QString error;
+        if (m_options.triggers != "default") {
+            QFile file(m_options.triggers);
+            if (!file.open(QIODevice::ReadOnly) || !TriggerEngine::parseRules(file.readAll(), rules, &error)) {
+                fprintf(stderr, "触发规则读取失败: %s %s\n", qPrintable(m_options.triggers), qPrintable(error));
+                return false;
+            }
+        }
+        const TriggerMatcherPtr matcher = TriggerMatcher::compile(rules, &error);
+        if (!matcher) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return false;
+        }
+        m_captures->setTriggers(matcher);
+    }
+
+    m_view->show();
+    PipelineStats::instance().reset();
+    m_clock.start();
+
+    // 子进程继承环境变量，启动后以模拟 adb 身份运行
+    qputenv(FakeAdbEnv, LoadGenerator::toSpec(m_options.adb).toUtf8());
+    for (int i = 0; i < m_options.adbStreams; ++i) {
+        QString error;
+        if (!m_captures->startLogcat(QString("bench-%1").arg(i), &error)) {
+            fprintf(stderr, "%s\n", qPrintable(error));
+            return false;
+        }
+    }
+
+    if (m_options.uart) {
+        QString portName, error;
+        if (!openVirtualSerial(&portName, &error)
+                || !m_captures->startSerial(portName, m_options.baudRate, &error)) {
+            fprintf(stderr, "虚拟串口打开失败: %s\n", qPrintable(error));
+            m_captures->stopAll();
+            closeVirtualSerial();
+            return false;
+        }
+        m_uartGenerator = new LoadGenerator(m_options.uartGen);
+        m_serialTimer->start(SerialWriteIntervalMs);
+    }
+
+    fprintf(stderr, "基准运行 %d 秒：logcat %d 路（%s）%s\n", m_options.durationSec, m_options.adbStreams,
+            qPrintable(LoadGenerator::toSpec(m_options.adb)),
+            m_options.uart ? qPrintable("，串口（" + LoadGenerator::toSpec(m_options.uartGen) + "）") : "");
+    QTimer::singleShot(m_options.durationSec * 1000, this, &BenchRunner::finish);
+    m_progressTimer->start(1000);
+    return true;
+}
+
+void BenchRunner::onBlock(const LogBlockPtr &block)
+{
+    m_pipeline->push(block);
+}
+
+// 进入模型的行按来源计数，序号用来发现丢失的行（延迟和帧耗时由显示流水线在绘制时统计）
+void BenchRunner::account(const QVector<LogBlockPtr> &blocks)
+{
+    for (const LogBlockPtr &block : blocks) {
+        SourceStats &source = m_sources[block->source];
+        for (const LogBlock::Line &line : block->lines) {
+            const qint64 seq = LoadGenerator::sequenceOf(block->data.constData() + line.offset, line.length);
+            if (seq < 0)
+                continue;
+            ++source.lines;
+            source.maxSeq = qMax(source.maxSeq, seq);
+        }
+        m_lines += quint64(block->lines.size());
+        m_triggerHits += quint64(block->triggered);
+    }
+}
+
+void BenchRunner::writeSerial()
+{
+#ifdef Q_OS_UNIX
+    // 读取端跟不上时伪终端写满，生成的数据留在 m_serialPending，积压过多时暂停生成
+    if (m_serialPending.size() < MaxSerialPendingBytes)
+        m_uartGenerator->generate(m_clock.nsecsElapsed() / 1000, m_serialPending, 100000);
+    m_serialPendingPeak = qMax<qint64>(m_serialPendingPeak, m_serialPending.size());
+    qsizetype written = 0;
+    while (written < m_serialPending.size()) {
+        const ssize_t n = ::write(m_ptyMaster, m_serialPending.constData() + written,
+                                  size_t(m_serialPending.size() - written));
+        if (n <= 0)
+            break;
+        written += n;
+    }
+    m_serialPending.remove(0, written);
+#endif
+}
+
+void BenchRunner::printProgress()
+{
+    const PipelineStats::Snapshot snap = PipelineStats::instance().snapshot();
+    fprintf(stderr, "%5.1fs  %8llu 行/秒  队列 %d  延迟 p99 %.1f ms\n",
+            m_clock.elapsed() / 1000.0, (unsigned long long)(m_lines - m_progressLines), m_pipeline->queueSize(),
+            snap.histograms[PipelineStats::Latency].percentile(0.99) / 1000.0);
+    m_progressLines = m_lines;
+}
+
+void BenchRunner::finish()
+{
+    if (m_finishing)
+        return;
+    m_finishing = true;
+    m_progressTimer->stop();
+    m_serialTimer->stop();
+    m_seconds = qMax<qint64>(1, m_clock.elapsed()) / 1000.0;
+
+    // 停止各路会话；各会话收尾后最后的块都已送达，再统计（allSessionsStopped -> report）
+    m_captures->stopAll();
+    if (m_captures->isIdle())
+        report();
+}
+
+void BenchRunner::report()
+{
+    const double seconds = m_seconds;
+    closeVirtualSerial();
+    m_pipeline->flush();
+
+    const PipelineStats::Snapshot snap = PipelineStats::instance().snapshot();
+    const PipelineStats::HistogramData &latency = snap.histograms[PipelineStats::Latency];
+    const PipelineStats::HistogramData &frameTime = snap.histograms[PipelineStats::FrameTime];
+    qint64 droppedLines = 0;
+    QJsonObject sources;
+    for (auto it = m_sources.constBegin(); it != m_sources.constEnd(); ++it) {
+        const qint64 dropped = it->maxSeq + 1 - qint64(it->lines);
+        droppedLines += dropped;
+        sources.insert(it.key(), QJsonObject{{"lines", qint64(it->lines)}, {"dropped_lines", dropped}});
+    }
+    const double linesPerSec = m_lines / seconds;
+    const double p99Ms = latency.percentile(0.99) / 1000.0;
+    const qint64 peakRss = peakRssBytes();
+
+    QStringList failures;
+    if (m_options.minLinesPerSec > 0 && linesPerSec < m_options.minLinesPerSec)
+        failures << QString("行速率 %1 < %2").arg(qRound64(linesPerSec)).arg(m_options.minLinesPerSec);
+    if (m_options.maxP99Ms > 0 && p99Ms > m_options.maxP99Ms)
+        failures << QString("延迟 p99 %1 ms > %2 ms").arg(p99Ms, 0, 'f', 1).arg(m_options.maxP99Ms);
+    if (m_options.maxDropped >= 0 && droppedLines > m_options.maxDropped)
+        failures << QString("丢失 %1 行 > %2").arg(droppedLines).arg(m_options.maxDropped);
+
+    printf("duration_s        %.1f\n", seconds);
+    printf("lines             %llu\n", (unsigned long long)m_lines);
+    printf("lines_per_sec     %.0f\n", linesPerSec);
+    printf("latency_ms        p50 %.1f  p99 %.1f  max %.1f\n", latency.percentile(0.5) / 1000.0, p99Ms,
+           latency.max / 1000.0);
+    printf("frame_time_ms     p99 %.1f\n", frameTime.percentile(0.99) / 1000.0);
+    printf("peak_rss_mb       %.1f\n", peakRss / 1048576.0);
+    printf("dropped_lines     %lld\n", (long long)droppedLines);
+    printf("queue_dropped     %llu\n", (unsigned long long)snap.counters[PipelineStats::QueueDropped]);
+    if (!m_options.triggers.isEmpty())
+        printf("trigger_hits      %llu\n", (unsigned long long)m_triggerHits);
+    if (m_options.uart)
+        printf("serial_backlog_kb %lld\n", (long long)(m_serialPendingPeak / 1024));
+    printf("result            %s\n", failures.isEmpty() ? "PASS" : qPrintable("FAIL: " + failures.join("; ")));
+    fflush(stdout);
+
+    if (!m_options.jsonPath.isEmpty()) {
+        QJsonObject report{
+            {"time", QDateTime::currentDateTime().toString(Qt::ISODate)},
+            {"duration_s", seconds},
+            {"adb_streams", m_options.adbStreams},
+            {"adb_spec", LoadGenerator::toSpec(m_options.adb)},
+            {"uart_spec", m_options.uart ? LoadGenerator::toSpec(m_options.uartGen) : QString()},
+            {"lines", qint64(m_lines)},
+            {"lines_per_sec", linesPerSec},
+            {"latency_us", QJsonObject{{"p50", qint64(latency.percentile(0.5))},
+                                       {"p99", qint64(latency.percentile(0.99))},
+                                       {"max", qint64(latency.max)}}},
+            {"frame_time_us_p99", qint64(frameTime.percentile(0.99))},
+            {"peak_rss_bytes", peakRss},
+            {"dropped_lines", droppedLines},
+            {"queue_dropped_blocks", qint64(snap.counters[PipelineStats::QueueDropped])},
+            {"timeline_merge", m_options.timelineMerge},
+            {"triggers", m_options.triggers},
+            {"trigger_hits", qint64(m_triggerHits)},
+            {"sources", sources},
+            {"passed", failures.isEmpty()},
+        };
+        QFile file(m_options.jsonPath);
+        if (!file.open(QIODevice::WriteOnly) || file.write(QJsonDocument(report).toJson()) < 0)
+            fprintf(stderr, "结果写入失败: %s\n", qPrintable(m_options.jsonPath));
+    }
+    QCoreApplication::exit(failures.isEmpty() ? 0 : 1);
+}
+
+// 伪终端主端由本对象按速率写入，从端路径（如 /dev/pts/3）作为串口名交给 SerialReader
+bool BenchRunner::openVirtualSerial(QString *portName, QString *error)
+{
+#ifdef Q_OS_UNIX
+    m_ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    if (m_ptyMaster < 0 || grantpt(m_ptyMaster) != 0 || unlockpt(m_ptyMaster) != 0) {
+        *error = QString::fromLocal8Bit(strerror(errno));
+        closeVirtualSerial();
+        return false;
+    }
+    fcntl(m_ptyMaster, F_SETFL, fcntl(m_ptyMaster, F_GETFL) | O_NONBLOCK);
+    *portName = QString::fromLocal8Bit(ptsname(m_ptyMaster));
+    return true;
+#else
+    Q_UNUSED(portName);
+    *error = "当前平台不支持虚拟串口";
+    return false;
+#endif
+}
+
+void BenchRunner::closeVirtualSerial()
+{
+#ifdef Q_OS_UNIX
+    if (m_ptyMaster >= 0)
+        ::close(m_ptyMaster);
+#endif
+    m_ptyMaster = -1;
+}
+
+qint64 BenchRunner::peakRssBytes()
+{
+#if defined(Q_OS_WIN)
+    PROCESS_MEMORY_COUNTERS counters;
+    if (GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters)))
+        return qint64(counters.PeakWorkingSetSize);
+    return -1;
+#elif defined(Q_OS_UNIX)
+    rusage usage;
+    if (getrusage(RUSAGE_SELF, &usage) != 0)
+        return -1;
+#ifdef Q_OS_MACOS
+    return qint64(usage.ru_maxrss);             // macOS 以字节计
+#else
+    return qint64(usage.ru_maxrss) * 1024;      // Linux 以 KB 计
+#endif
+#else
+    return -1;
+#endif
+}
@@ -0,0 +1,99 @@
+#ifndef BENCHRUNNER_H
+#define BENCHRUNNER_H
+
+#include <QObject>
+#include <QHash>
+#include <QElapsedTimer>
+#include "LogRecord.h"
+#include "LoadGenerator.h"
+
+class QTimer;
+class QTableView;
+class CaptureSessionManager;
+class LogModel;
+class LogViewPipeline;
+
+// 端到端吞吐基准（FaeDiag --bench ...），不需要真实设备
+// - logcat：以本程序作为模拟 adb（环境变量 FakeAdbEnv 中带生成参数），LogcatWorker 照常启动
+//   “adb -s <serial> logcat” 子进程，经管道读入、切行、解析
+// - 串口（仅类 Unix 系统）：打开一对伪终端，从端作为串口交给 SerialReader，主端按速率写入合成日志
+// - 显示路径：与主窗口同一个 LogViewPipeline（队列、按帧调度、多路合并、LogModel），
+//   模型显示在真实的日志视图中（默认 offscreen 平台），延迟和帧耗时在视图绘制时统计
+// 结束时报告持续行速率、延迟分位数、峰值内存和丢失的行，可设阈值，不达标时以非 0 退出
+class BenchRunner : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr const char *FakeAdbEnv = "FAEDIAG_FAKE_ADB";
+    static constexpr int SerialWriteIntervalMs = 5;
+    static constexpr int MaxSerialPendingBytes = 4 * 1024 * 1024;
+
+    struct Options {
+        int durationSec = 10;
+        int adbStreams = 1;
+        LoadGenerator::Options adb;
+        bool uart = false;
+        LoadGenerator::Options uartGen;
+        int baudRate = 921600;
+        QString outputDir;                // 为空表示不落盘
+        QString jsonPath;                 // 结果另存为 JSON
+        QString triggers;                 // 触发规则文件，"default" 为内置规则，为空时不匹配
+        bool timelineMerge = true;        // 多路日志按时间合并（主窗口的默认设置）
+        double minLinesPerSec = 0;        // 以下为阈值，0 表示不检查
+        double maxP99Ms = 0;
+        qint64 maxDropped = -1;
+    };
+
+    // 解析命令行（argv 中包含 --bench 时调用）；help 非空时只需打印帮助后退出
+    static bool parseArguments(const QStringList &arguments, Options &options, QString *error, QString *help);
+    // 作为模拟 adb 运行（环境变量 FakeAdbEnv 存在时由 main 调用），返回进程退出码
+    static int runFakeAdb(const QStringList &arguments, const QByteArray &spec);
+
+    explicit BenchRunner(const Options &options, QObject *parent = nullptr);
+    ~BenchRunner();
+
+    // 启动各路数据源，失败返回 false；结束时调用 QCoreApplication::exit()
+    bool start();
+
+private slots:
+    void onBlock(const LogBlockPtr &block);
+    void writeSerial();
+    void printProgress();
+    void finish();
+    void report();
+
+private:
+    bool openVirtualSerial(QString *portName, QString *error);
+    void closeVirtualSerial();
+    void account(const QVector<LogBlockPtr> &blocks);
+    static qint64 peakRssBytes();
+
+    struct SourceStats {
+        quint64 lines = 0;
+        qint64 maxSeq = -1;
+    };
+
+    Options m_options;
+    CaptureSessionManager *m_captures;
+    QTimer *m_serialTimer;
+    QTimer *m_progressTimer;
+    QTableView *m_view;                   // 顶层窗口，析构时删除
+    LogModel *m_model;
+    LogViewPipeline *m_pipeline;
+
+    int m_ptyMaster = -1;
+    LoadGenerator *m_uartGenerator = nullptr;
+    QByteArray m_serialPending;           // 已生成、尚未写入伪终端的数据
+    qint64 m_serialPendingPeak = 0;
+
+    QHash<QString, SourceStats> m_sources;
+    quint64 m_lines = 0;
+    quint64 m_triggerHits = 0;
+    quint64 m_progressLines = 0;
+    QElapsedTimer m_clock;
+    double m_seconds = 0;                 // 结束时的运行时长
+    bool m_finishing = false;
+};
+
+#endif // BENCHRUNNER_H
@@ -0,0 +1,336 @@
+#include "CaptureSessionManager.h"
+#include "LogcatWorker.h"
+#include "SerialReader.h"
+#include "SerialReplayer.h"
+#include <QThread>
+#include <QDir>
+#include <QDateTime>
+#include <QFileInfo>
+#include <QRegularExpression>
+
+CaptureSessionManager::CaptureSessionManager(const QString &adbPath, QObject *parent)
+    : QObject(parent), m_adbPath(adbPath), m_outputDir(QDir::currentPath() + "/device_logs")
+{
+    qRegisterMetaType<LogBlockPtr>();
+
+    // 每路流的工作量很小（读管道/串口、切行、写文件），几个线程足以承载十几路
+    m_maxThreads = qBound(2, QThread::idealThreadCount(), 8);
+}
+
+// 退出时不再等待异步收尾：工作对象在所属线程结束时删除（析构中结束进程、写完文件），这里等线程结束
+CaptureSessionManager::~CaptureSessionManager()
+{
+    const QList<Session> all = m_sessions.values() + m_stopping.values();
+    m_sessions.clear();
+    m_stopping.clear();
+    for (const Session &session : all) {
+        session.worker->disconnect(this);
+        session.worker->deleteLater();
+    }
+    for (QThread *thread : m_threads + m_retiring) {
+        thread->quit();
+        thread->wait();
+    }
+    // 压缩日志关闭后剩余的块和索引在后台写完
+    CompressedLogWriter::waitForBackground();
+}
+
+void CaptureSessionManager::setCompression(bool enabled, const CompressedLogWriter::Options &options)
+{
+    m_compress = enabled;
+    m_compressOptions = options;
+}
+
+// 规则编译后只读，各线程共享同一份；正在进行的会话在各自线程中切换
+void CaptureSessionManager::setTriggers(const TriggerMatcherPtr &triggers)
+{
+    m_triggers = triggers;
+    for (auto it = m_sessions.constBegin(); it != m_sessions.constEnd(); ++it) {
+        QObject *worker = it->worker;
+        if (it.key().startsWith("adb:")) {
+            LogcatWorker *logcat = static_cast<LogcatWorker *>(worker);
+            QMetaObject::invokeMethod(logcat, [logcat, triggers]() { logcat->setTriggers(triggers); });
+        } else if (it.key().startsWith("replay:")) {
+            SerialReplayer *replayer = static_cast<SerialReplayer *>(worker);
+            QMetaObject::invokeMethod(replayer, [replayer, triggers]() { replayer->setTriggers(triggers); });
+        } else {
+            SerialReader *reader = static_cast<SerialReader *>(worker);
+            QMetaObject::invokeMethod(reader, [reader, triggers]() { reader->setTriggers(triggers); });
+        }
+    }
+}
+
+bool CaptureSessionManager::startLogcat(const QString &serial, QString *error)
+{
+    const QString source = logcatSource(serial);
+    if (!checkAvailable(source, "设备 " + serial + " 的日志抓取已在进行中", error))
+        return false;
+
+    Session session;
+    session.fileName = makeFileName("log", serial);
+    session.thread = acquireThread();
+
+    LogcatWorker *worker = new LogcatWorker(m_adbPath, serial, session.fileName);
+    if (m_compress)
+        worker->setCompression(m_compressOptions);
+    worker->setLogcatArgs(m_logcatArgs);
+    worker->setTriggers(m_triggers);
+    worker->moveToThread(session.thread);
+    session.worker = worker;
+    m_sessions.insert(source, session);
+
+    connect(worker, &LogcatWorker::blockReady, this, &CaptureSessionManager::blockReceived);
+    connect(worker, &LogcatWorker::logMessage, this, [this, serial](const QString &msg) {
+        emit logMessage("[" + serial + "] " + msg);
+    });
+    // 主动停止或 logcat 进程自行退出（如设备断开）后回收会话
+    connect(worker, &LogcatWorker::finished, this, [this, source]() { onWorkerFinished(source); });
+    QMetaObject::invokeMethod(worker, &LogcatWorker::start, Qt::QueuedConnection);
+
+    emit sessionStarted(source, session.fileName);
+    return true;
+}
+
+bool CaptureSessionManager::startSerial(const QString &portName, int baudRate, QString *error)
+{
+    const QString source = serialSource(portName);
+    if (!checkAvailable(source, "串口 " + portName + " 已打开", error))
+        return false;
+
+    Session session;
+    session.fileName = makeFileName("uart", portName);
+    session.thread = acquireThread();
+
+    SerialReader *reader = new SerialReader;
+    if (m_compress)
+        reader->setCompression(m_compressOptions);
+    reader->setRawCapture(m_rawSerial);
+    reader->setTriggers(m_triggers);
+    reader->moveToThread(session.thread);
+
+    bool ok = false;
+    QString openError;
+    QMetaObject::invokeMethod(reader, [&]() {
+        ok = reader->open(portName, baudRate, session.fileName, &openError);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        reader->deleteLater();
+        releaseThread(session.thread);
+        if (error)
+            *error = openError;
+        return false;
+    }
+
+    session.worker = reader;
+    m_sessions.insert(source, session);
+
+    connect(reader, &SerialReader::blockReady, this, &CaptureSessionManager::blockReceived);
+    connect(reader, &SerialReader::errorOccurred, this, [this, source](const QString &msg) {
+        emit errorOccurred(source, msg);
+    });
+    connect(reader, &SerialReader::portLost, this, [this, source]() { stop(source); });
+
+    emit sessionStarted(source, session.fileName);
+    return true;
+}
+
+QString CaptureSessionManager::replaySource(const QString &fileName)
+{
+    return "replay:" + QFileInfo(fileName).fileName();
+}
+
+bool CaptureSessionManager::startReplay(const QString &fileName, double speed, QString *error)
+{
+    const QString source = replaySource(fileName);
+    if (!checkAvailable(source, "文件 " + QFileInfo(fileName).fileName() + " 正在回放", error))
+        return false;
+
+    Session session;
+    session.fileName = fileName;
+    session.thread = acquireThread();
+
+    SerialReplayer *replayer = new SerialReplayer(fileName, speed);
+    replayer->setTriggers(m_triggers);
+    replayer->moveToThread(session.thread);
+
+    bool ok = false;
+    QString openError;
+    QMetaObject::invokeMethod(replayer, [&]() {
+        ok = replayer->open(&openError);
+    }, Qt::BlockingQueuedConnection);
+
+    if (!ok) {
+        replayer->deleteLater();
+        releaseThread(session.thread);
+        if (error)
+            *error = openError;
+        return false;
+    }
+
+    session.worker = replayer;
+    m_sessions.insert(source, session);
+
+    connect(replayer, &SerialReplayer::blockReady, this, &CaptureSessionManager::blockReceived);
+    connect(replayer, &SerialReplayer::finished, this, [this, source]() { stop(source); });
+    QMetaObject::invokeMethod(replayer, [replayer]() { replayer->start(); });
+
+    emit sessionStarted(source, session.fileName);
+    return true;
+}
+
+void CaptureSessionManager::writeSerial(const QString &portName, const QByteArray &data)
+{
+    auto it = m_sessions.constFind(serialSource(portName));
+    if (it == m_sessions.constEnd())
+        return;
+    SerialReader *reader = static_cast<SerialReader *>(it->worker);
+    QMetaObject::invokeMethod(reader, [reader, data]() {
+        reader->write(data);
+    });
+}
+
+// 同一来源的上一个会话还在收尾时不能重新开始（输出文件名按秒区分，可能重名）
+bool CaptureSessionManager::checkAvailable(const QString &source, const QString &busyMessage, QString *error) const
+{
+    if (m_sessions.contains(source)) {
+        if (error)
+            *error = busyMessage;
+        return false;
+    }
+    if (m_stopping.contains(source)) {
+        if (error)
+            *error = source + " 正在停止，请稍后再试";
+        return false;
+    }
+    return true;
+}
+
+void CaptureSessionManager::stop(const QString &source)
+{
+    auto it = m_sessions.find(source);
+    if (it == m_sessions.end())
+        return;
+    const Session session = it.value();
+    m_sessions.erase(it);
+    m_stopping.insert(source, session);
+
+    // 在工作线程中结束进程/关闭串口并把缓冲写入文件，界面线程不等待；
+    // logcat 在进程退出后发出 finished，串口和回放关闭后直接通知回来（排在最后一块之后）
+    QObject *worker = session.worker;
+    if (source.startsWith("adb:")) {
+        LogcatWorker *logcat = static_cast<LogcatWorker *>(worker);
+        QMetaObject::invokeMethod(logcat, &LogcatWorker::stop, Qt::QueuedConnection);
+    } else if (source.startsWith("replay:")) {
+        SerialReplayer *replayer = static_cast<SerialReplayer *>(worker);
+        QMetaObject::invokeMethod(replayer, [this, replayer, source]() {
+            replayer->stop();
+            QMetaObject::invokeMethod(this, [this, source]() { finishStop(source); }, Qt::QueuedConnection);
+        }, Qt::QueuedConnection);
+    } else {
+        SerialReader *reader = static_cast<SerialReader *>(worker);
+        QMetaObject::invokeMethod(reader, [this, reader, source]() {
+            reader->close();
+            QMetaObject::invokeMethod(this, [this, source]() { finishStop(source); }, Qt::QueuedConnection);
+        }, Qt::QueuedConnection);
+    }
+}
+
+// logcat 工作对象收尾完毕：主动停止的会话已在 m_stopping 中，进程自行退出的还在 m_sessions 中
+void CaptureSessionManager::onWorkerFinished(const QString &source)
+{
+    auto it = m_sessions.find(source);
+    if (it != m_sessions.end()) {
+        m_stopping.insert(source, it.value());
+        m_sessions.erase(it);
+    }
+    finishStop(source);
+}
+
+void CaptureSessionManager::finishStop(const QString &source)
+{
+    auto it = m_stopping.find(source);
+    if (it == m_stopping.end())
+        return;
+    const Session session = it.value();
+    m_stopping.erase(it);
+
+    session.worker->disconnect(this);
+    session.worker->deleteLater();
+    releaseThread(session.thread);
+
+    emit sessionStopped(source);
+    if (isIdle())
+        emit allSessionsStopped();
+}
+
+void CaptureSessionManager::stopAll()
+{
+    const QStringList all = m_sessions.keys();
+    for (const QString &source : all)
+        stop(source);
+}
+
+void CaptureSessionManager::stopAllLogcat()
+{
+    const QStringList all = m_sessions.keys();
+    for (const QString &source : all) {
+        if (source.startsWith("adb:"))
+            stop(source);
+    }
+}
+
+QString CaptureSessionManager::fileName(const QString &source) const
+{
+    return m_sessions.value(source).fileName;
+}
+
+// <输出目录>/<prefix>_<id>_<时间>.txt，序列号中的 ':' 等字符替换掉（如网络设备 192.168.1.2:5555）
+// 不落盘时返回空
+QString CaptureSessionManager::makeFileName(const QString &prefix, const QString &id) const
+{
+    if (m_outputDir.isEmpty())
+        return QString();
+    QDir().mkpath(m_outputDir);
+    QString safeId = id;
+    safeId.replace(QRegularExpression("[^A-Za-z0-9._-]"), "_");
+    return m_outputDir + "/" + prefix + "_" + safeId + "_"
+            + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".txt";
+}
+
+QThread *CaptureSessionManager::acquireThread()
+{
+    QThread *best = nullptr;
+    for (QThread *thread : m_threads) {
+        if (!best || m_load[thread] < m_load[best])
+            best = thread;
+    }
+
+    // 已有线程都有任务且未达上限时新开一个
+    if (!best || (m_load[best] > 0 && m_threads.size() < m_maxThreads)) {
+        best = new QThread(this);
+        best->setObjectName(QString("capture-%1").arg(m_threadSerial++));
+        best->start();
+        m_threads.append(best);
+        m_load.insert(best, 0);
+    }
+
+    ++m_load[best];
+    return best;
+}
+
+// 线程上没有会话时退出回收；已 deleteLater 的工作对象在线程结束时删除
+void CaptureSessionManager::releaseThread(QThread *thread)
+{
+    auto it = m_load.find(thread);
+    if (it == m_load.end() || --it.value() > 0)
+        return;
+    m_load.erase(it);
+    m_threads.removeOne(thread);
+    m_retiring.append(thread);
+    connect(thread, &QThread::finished, this, [this, thread]() {
+        m_retiring.removeOne(thread);
+        thread->deleteLater();
+    });
+    thread->quit();
+}
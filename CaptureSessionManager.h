@@ -0,0 +1,108 @@
+#ifndef CAPTURESESSIONMANAGER_H
+#define CAPTURESESSIONMANAGER_H
+
+#include <QObject>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include "LogRecord.h"
+#include "CompressedLogWriter.h"
+#include "TriggerMatcher.h"
+
+class QThread;
+
+// 多路抓取会话管理：每台设备的 logcat、每个串口各自一条流水线和输出文件，
+// 工作对象全部是事件驱动的，分摊到固定数量的共享工作线程上（按负载最少分配），
+// 16 路以上同时抓取时线程数也不会随之增长，界面线程只接收攒好的日志块
+//
+// 会话以来源字符串标识：adb:<serial>、uart:<port>、replay:<文件名>，与 LogBlock::source 一致
+//
+// 停止是异步的：stop() 只通知工作线程，不等待；工作对象收尾（最后一块已发出、文件已关闭）后
+// 回到界面线程回收并发出 sessionStopped，全部结束时发出 allSessionsStopped
+// 没有会话的线程随即退出回收，之后的会话按需重新创建线程
+class CaptureSessionManager : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit CaptureSessionManager(const QString &adbPath, QObject *parent = nullptr);
+    ~CaptureSessionManager();
+
+    static QString logcatSource(const QString &serial) { return "adb:" + serial; }
+    static QString serialSource(const QString &portName) { return "uart:" + portName; }
+    static QString replaySource(const QString &fileName);
+
+    // 之后启动的会话输出为压缩分段（.fdz，按大小/时间轮转）
+    void setCompression(bool enabled, const CompressedLogWriter::Options &options = CompressedLogWriter::Options());
+    bool isCompressionEnabled() const { return m_compress; }
+
+    // 输出目录，默认为当前目录下的 device_logs；设为空时之后启动的会话不落盘，只发出日志块
+    void setOutputDirectory(const QString &dir) { m_outputDir = dir; }
+    QString outputDirectory() const { return m_outputDir; }
+
+    // 之后打开的串口另外保存原始字节和到达时间（.fdr），可以回放
+    void setRawSerialCapture(bool enabled) { m_rawSerial = enabled; }
+    bool isRawSerialCaptureEnabled() const { return m_rawSerial; }
+
+    // 之后启动的 logcat 附加的参数（如设备端过滤规则 "ActivityManager:I *:S"）
+    void setLogcatArgs(const QStringList &args) { m_logcatArgs = args; }
+
+    // 触发规则在各抓取线程切行时逐行匹配，对正在进行的和之后启动的会话都生效；为空时不匹配
+    void setTriggers(const TriggerMatcherPtr &triggers);
+
+    bool startLogcat(const QString &serial, QString *error = nullptr);
+    bool startSerial(const QString &portName, int baudRate, QString *error = nullptr);
+    void writeSerial(const QString &portName, const QByteArray &data);
+    // 回放串口原始数据文件，speed 为倍速（<= 0 表示尽快），回放到末尾后会话自动结束
+    bool startReplay(const QString &fileName, double speed, QString *error = nullptr);
+
+    void stop(const QString &source);
+    void stopAll();
+    void stopAllLogcat();
+
+    bool isRunning(const QString &source) const { return m_sessions.contains(source); }
+    QStringList sources() const { return m_sessions.keys(); }
+    // 没有正在运行或正在停止的会话
+    bool isIdle() const { return m_sessions.isEmpty() && m_stopping.isEmpty(); }
+    QString fileName(const QString &source) const;
+    int threadCount() const { return int(m_threads.size()); }
+
+signals:
+    void blockReceived(const LogBlockPtr &block);
+    void sessionStarted(const QString &source, const QString &fileName);
+    void sessionStopped(const QString &source);
+    void allSessionsStopped();
+    void logMessage(const QString &msg);
+    void errorOccurred(const QString &source, const QString &error);
+
+private:
+    struct Session {
+        QObject *worker = nullptr;
+        QThread *thread = nullptr;
+        QString fileName;
+    };
+
+    bool checkAvailable(const QString &source, const QString &busyMessage, QString *error) const;
+    void onWorkerFinished(const QString &source);
+    void finishStop(const QString &source);
+    QString makeFileName(const QString &prefix, const QString &id) const;
+    QThread *acquireThread();
+    void releaseThread(QThread *thread);
+
+    QString m_adbPath;
+    QString m_outputDir;
+    QStringList m_logcatArgs;
+    QHash<QString, Session> m_sessions;
+    QHash<QString, Session> m_stopping;   // 已通知停止、等待工作对象收尾的会话
+    QVector<QThread *> m_threads;         // 共享工作线程（按需创建，数量有上限）
+    QVector<QThread *> m_retiring;        // 已空闲、正在退出的线程
+    QHash<QThread *, int> m_load;         // 每个线程上的会话数
+    int m_maxThreads;
+    int m_threadSerial = 0;
+    bool m_compress = false;
+    CompressedLogWriter::Options m_compressOptions;
+    bool m_rawSerial = false;
+    TriggerMatcherPtr m_triggers;
+};
+
+#endif // CAPTURESESSIONMANAGER_H
@@ -0,0 +1,59 @@
+#ifndef COMPRESSEDLOGFORMAT_H
+#define COMPRESSEDLOGFORMAT_H
+
+#include <QtGlobal>
+
+// 压缩日志分段文件（.fdz）格式，按小端字节序存放
+//
+//   CompressedFileHeader
+//   数据块：CompressedBlockHeader + 块数据（qCompress 即 zlib 压缩，或原样存放）……
+//   块索引：CompressedBlockIndex × blockCount
+//   CompressedFileFooter
+//
+// 每个数据块独立压缩，且都在换行处切分，读取端可以各块并行解压、解析。
+// 写入中断时没有索引和尾部，读取端顺序扫描块头重建索引。
+// 长时间抓取按大小或时间轮转为 <name>_001.fdz、<name>_002.fdz ……
+
+static const char COMPRESSED_FILE_MAGIC[4] = {'F', 'D', 'L', 'Z'};
+static const char COMPRESSED_INDEX_MAGIC[4] = {'F', 'D', 'Z', 'I'};
+static const quint32 COMPRESSED_FILE_VERSION = 1;
+
+enum CompressedBlockFlag : quint32 {
+    CompressedBlockZlib = 1         // 未置位表示原样存放（压缩积压或压缩后反而更大）
+};
+
+struct CompressedFileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 segment;                // 分段序号，从 1 开始
+    quint32 reserved;
+};
+
+struct CompressedBlockHeader {
+    quint32 storedSize;             // 块数据在文件中的字节数
+    quint32 rawSize;                // 解压后的字节数
+    quint32 flags;
+    quint32 reserved;
+};
+
+struct CompressedBlockIndex {
+    quint64 fileOffset;             // 块头的文件偏移
+    quint64 rawOffset;              // 块在本段原始文本中的偏移
+    quint32 storedSize;
+    quint32 rawSize;
+    quint32 flags;
+    quint32 reserved;
+};
+
+struct CompressedFileFooter {
+    quint64 indexOffset;
+    quint32 blockCount;
+    char magic[4];
+};
+
+static_assert(sizeof(CompressedFileHeader) == 16, "unexpected compressed header size");
+static_assert(sizeof(CompressedBlockHeader) == 16, "unexpected compressed block size");
+static_assert(sizeof(CompressedBlockIndex) == 32, "unexpected compressed index size");
+static_assert(sizeof(CompressedFileFooter) == 16, "unexpected compressed footer size");
+
+#endif // COMPRESSEDLOGFORMAT_H
@@ -0,0 +1,151 @@
+#include "CompressedLogReader.h"
+#include <cstring>
+
+CompressedLogReader::~CompressedLogReader()
+{
+    close();
+}
+
+bool CompressedLogReader::open(const QString &fileName, QString *error)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = m_file.errorString();
+        return false;
+    }
+
+    m_size = quint64(m_file.size());
+    if (m_size < sizeof(CompressedFileHeader)) {
+        if (error)
+            *error = "文件太小，不是压缩日志";
+        close();
+        return false;
+    }
+    m_map = m_file.map(0, qint64(m_size));
+    if (!m_map) {
+        if (error)
+            *error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    CompressedFileHeader header;
+    memcpy(&header, m_map, sizeof(header));
+    if (memcmp(header.magic, COMPRESSED_FILE_MAGIC, 4) != 0 || header.version != COMPRESSED_FILE_VERSION) {
+        if (error)
+            *error = "不支持的压缩日志格式";
+        close();
+        return false;
+    }
+
+    // 正常关闭的分段直接使用尾部的块索引；抓取中断或索引损坏时顺序扫描块头重建
+    if (!loadIndex())
+        rebuildIndex();
+    return true;
+}
+
+void CompressedLogReader::close()
+{
+    if (m_map)
+        m_file.unmap(const_cast<uchar *>(m_map));
+    m_file.close();
+    m_map = nullptr;
+    m_size = 0;
+    m_blocks.clear();
+}
+
+QByteArray CompressedLogReader::block(int i) const
+{
+    if (i < 0 || size_t(i) >= m_blocks.size())
+        return QByteArray();
+
+    const CompressedBlockIndex &entry = m_blocks[size_t(i)];
+    if (entry.fileOffset > m_size || sizeof(CompressedBlockHeader) + quint64(entry.storedSize) > m_size - entry.fileOffset)
+        return QByteArray();
+    const uchar *data = m_map + entry.fileOffset + sizeof(CompressedBlockHeader);
+    if (entry.flags & CompressedBlockZlib)
+        return qUncompress(data, qsizetype(entry.storedSize));
+    return QByteArray(reinterpret_cast<const char *>(data), qsizetype(entry.storedSize));
+}
+
+bool CompressedLogReader::isCompressedFile(const QString &fileName)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly))
+        return false;
+    return file.read(4) == QByteArray(COMPRESSED_FILE_MAGIC, 4);
+}
+
+// 尾部索引的每一项都要落在数据区内、与块头一致且首尾相接，否则不用
+bool CompressedLogReader::loadIndex()
+{
+    if (m_size < sizeof(CompressedFileHeader) + sizeof(CompressedFileFooter))
+        return false;
+    CompressedFileFooter footer;
+    memcpy(&footer, m_map + m_size - sizeof(footer), sizeof(footer));
+    if (memcmp(footer.magic, COMPRESSED_INDEX_MAGIC, 4) != 0)
+        return false;
+    const quint64 dataEnd = m_size - sizeof(CompressedFileFooter);
+    const quint64 indexBytes = quint64(footer.blockCount) * sizeof(CompressedBlockIndex);
+    if (footer.indexOffset < sizeof(CompressedFileHeader) || footer.indexOffset > dataEnd
+            || indexBytes != dataEnd - footer.indexOffset)
+        return false;
+
+    m_blocks.resize(footer.blockCount);
+    if (indexBytes > 0)
+        memcpy(m_blocks.data(), m_map + footer.indexOffset, indexBytes);
+
+    quint64 offset = sizeof(CompressedFileHeader);
+    quint64 rawOffset = 0;
+    for (const CompressedBlockIndex &entry : m_blocks) {
+        CompressedBlockHeader header;
+        if (entry.fileOffset != offset || entry.rawOffset != rawOffset || entry.rawSize == 0
+                || offset + sizeof(header) > footer.indexOffset
+                || quint64(entry.storedSize) > footer.indexOffset - offset - sizeof(header)) {
+            m_blocks.clear();
+            return false;
+        }
+        memcpy(&header, m_map + offset, sizeof(header));
+        if (header.storedSize != entry.storedSize || header.rawSize != entry.rawSize || header.flags != entry.flags) {
+            m_blocks.clear();
+            return false;
+        }
+        offset += sizeof(header) + entry.storedSize;
+        rawOffset += entry.rawSize;
+    }
+    if (offset != footer.indexOffset) {
+        m_blocks.clear();
+        return false;
+    }
+    return true;
+}
+
+void CompressedLogReader::rebuildIndex()
+{
+    m_blocks.clear();
+    quint64 offset = sizeof(CompressedFileHeader);
+    quint64 rawOffset = 0;
+
+    while (offset + sizeof(CompressedBlockHeader) <= m_size) {
+        CompressedBlockHeader h;
+        memcpy(&h, m_map + offset, sizeof(h));
+        const quint64 size = sizeof(CompressedBlockHeader) + quint64(h.storedSize);
+        if (h.rawSize == 0 || size > m_size - offset)
+            break;      // 最后一块只写了一半
+
+        CompressedBlockIndex entry;
+        entry.fileOffset = offset;
+        entry.rawOffset = rawOffset;
+        entry.storedSize = h.storedSize;
+        entry.rawSize = h.rawSize;
+        entry.flags = h.flags;
+        entry.reserved = 0;
+        m_blocks.push_back(entry);
+
+        offset += size;
+        rawOffset += h.rawSize;
+    }
+}
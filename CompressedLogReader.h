@@ -0,0 +1,39 @@
+#ifndef COMPRESSEDLOGREADER_H
+#define COMPRESSEDLOGREADER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <vector>
+#include "CompressedLogFormat.h"
+
+// 压缩日志分段读取：整体内存映射，读入块索引（尾部索引逐项校验，缺失或损坏时扫描块头重建），逐块解压
+// 块彼此独立，可以在多个线程中同时调用 block()
+class CompressedLogReader
+{
+public:
+    CompressedLogReader() = default;
+    ~CompressedLogReader();
+
+    bool open(const QString &fileName, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+
+    int blockCount() const { return int(m_blocks.size()); }
+    const CompressedBlockIndex &blockIndex(int i) const { return m_blocks[size_t(i)]; }
+
+    // 解压第 i 块，失败时返回空
+    QByteArray block(int i) const;
+
+    static bool isCompressedFile(const QString &fileName);
+
+private:
+    bool loadIndex();
+    void rebuildIndex();
+
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    quint64 m_size = 0;
+    std::vector<CompressedBlockIndex> m_blocks;   // 从文件复制（索引在文件中不一定对齐）或重建
+};
+
+#endif // COMPRESSEDLOGREADER_H
@@ -0,0 +1,243 @@
+#include "CompressedLogWriter.h"
+#include <QThreadPool>
+#include <cstring>
+
+namespace {
+
+// 所有写入器共用，每个写入器同一时刻最多占用其中一个线程
+QThreadPool &backgroundPool()
+{
+    static QThreadPool pool;
+    return pool;
+}
+
+} // namespace
+
+CompressedLogWriter::CompressedLogWriter()
+    : m_storedBlocks(std::make_shared<std::atomic<qint64>>(0))
+{
+}
+
+CompressedLogWriter::~CompressedLogWriter()
+{
+    close();
+}
+
+bool CompressedLogWriter::open(const QString &baseName)
+{
+    close();
+
+    m_baseName = baseName;
+    m_segment = 1;
+    std::unique_ptr<SegmentFile> file(new SegmentFile);
+    if (!openSegment(*file, segmentFileName(m_segment), m_segment))
+        return false;
+    m_backend = std::make_shared<Backend>();
+    m_backend->file = std::move(file);
+    m_storedBlocks = std::make_shared<std::atomic<qint64>>(0);
+    m_droppedBytes = 0;
+
+    m_buffer.clear();
+    m_buffer.reserve(m_options.blockBytes * 2);
+    m_segmentRawBytes = 0;
+    m_segmentClock.start();
+    m_sinceBlock.start();
+    m_open = true;
+    return true;
+}
+
+void CompressedLogWriter::close()
+{
+    if (!m_open)
+        return;
+
+    // 不等待后台写完，抓取线程可以立即处理别的会话
+    cutBlock(true);
+    post(m_backend, [](Backend &backend) {
+        finishSegment(*backend.file);
+        backend.file.reset();
+    });
+    m_backend.reset();
+    m_open = false;
+}
+
+void CompressedLogWriter::waitForBackground()
+{
+    backgroundPool().waitForDone();
+}
+
+void CompressedLogWriter::post(const std::shared_ptr<Backend> &backend, std::function<void(Backend &)> task)
+{
+    QMutexLocker locker(&backend->mutex);
+    backend->tasks.push_back(std::move(task));
+    if (backend->running)
+        return;
+    backend->running = true;
+    locker.unlock();
+    backgroundPool().start([backend]() { drain(backend); });
+}
+
+// 依次执行队列中的任务，队列为空时退出，下一次 post 再重新投递
+void CompressedLogWriter::drain(const std::shared_ptr<Backend> &backend)
+{
+    for (;;) {
+        std::function<void(Backend &)> task;
+        {
+            QMutexLocker locker(&backend->mutex);
+            if (backend->tasks.empty()) {
+                backend->running = false;
+                return;
+            }
+            task = std::move(backend->tasks.front());
+            backend->tasks.pop_front();
+        }
+        task(*backend);
+    }
+}
+
+void CompressedLogWriter::write(const char *data, qsizetype length)
+{
+    if (!m_open || length <= 0)
+        return;
+    m_buffer.append(data, length);
+    if (m_buffer.size() >= m_options.blockBytes)
+        cutBlock(false);
+}
+
+void CompressedLogWriter::flushIfDue()
+{
+    if (!m_open)
+        return;
+    if (!m_buffer.isEmpty() && m_sinceBlock.elapsed() >= m_options.blockIntervalMs)
+        cutBlock(false);
+    if (m_options.rotateSeconds > 0 && m_segmentRawBytes > 0
+            && m_segmentClock.elapsed() >= qint64(m_options.rotateSeconds) * 1000)
+        rotate();
+}
+
+QString CompressedLogWriter::segmentFileName(int segment) const
+{
+    return QString("%1_%2.fdz").arg(m_baseName).arg(segment, 3, 10, QChar('0'));
+}
+
+// 在最后一个换行处切块，保证每块都是完整的行；没有换行时只在强制或数据过长时整段切出
+void CompressedLogWriter::cutBlock(bool force)
+{
+    if (m_buffer.isEmpty())
+        return;
+
+    qsizetype cut = m_buffer.lastIndexOf('\n') + 1;
+    if (cut == 0) {
+        if (!force && m_buffer.size() < qsizetype(m_options.blockBytes) * 2)
+            return;
+        cut = m_buffer.size();
+    }
+
+    submit(m_buffer.left(cut));
+    m_buffer.remove(0, cut);
+    m_sinceBlock.restart();
+
+    m_segmentRawBytes += cut;
+    if (m_options.rotateBytes > 0 && m_segmentRawBytes >= m_options.rotateBytes && !force)
+        rotate();
+}
+
+void CompressedLogWriter::submit(const QByteArray &block)
+{
+    // 积压过多时不再压缩，保证写入速度跟得上抓取速度；原样写入也跟不上时丢弃新块
+    const qint64 pending = m_backend->pendingBytes.load();
+    if (pending > 0 && pending + block.size() > m_options.maxQueuedBytes) {
+        m_droppedBytes += block.size();
+        return;
+    }
+    const bool compress = pending < m_options.maxPendingBytes;
+    m_backend->pendingBytes += block.size();
+    const int level = m_options.level;
+    const std::shared_ptr<std::atomic<qint64>> storedBlocks = m_storedBlocks;
+
+    post(m_backend, [block, compress, level, storedBlocks](Backend &backend) {
+        SegmentFile &segment = *backend.file;
+        QByteArray stored;
+        quint32 flags = 0;
+        if (compress) {
+            stored = qCompress(block, level);
+            if (stored.size() < block.size())
+                flags = CompressedBlockZlib;
+        }
+        if (!flags) {
+            stored = block;
+            ++*storedBlocks;
+        }
+
+        CompressedBlockHeader header;
+        header.storedSize = quint32(stored.size());
+        header.rawSize = quint32(block.size());
+        header.flags = flags;
+        header.reserved = 0;
+
+        CompressedBlockIndex entry;
+        entry.fileOffset = segment.offset;
+        entry.rawOffset = segment.rawOffset;
+        entry.storedSize = header.storedSize;
+        entry.rawSize = header.rawSize;
+        entry.flags = flags;
+        entry.reserved = 0;
+
+        if (segment.file.isOpen()) {
+            segment.file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+            segment.file.write(stored);
+            segment.index.append(entry);
+            segment.offset += sizeof(header) + quint64(stored.size());
+            segment.rawOffset += quint64(block.size());
+        }
+        backend.pendingBytes -= block.size();
+    });
+}
+
+// 结束当前段并开始下一段（在后台线程中按顺序执行）
+void CompressedLogWriter::rotate()
+{
+    const int next = ++m_segment;
+    const QString fileName = segmentFileName(next);
+    post(m_backend, [fileName, next](Backend &backend) {
+        finishSegment(*backend.file);
+        backend.file.reset(new SegmentFile);
+        openSegment(*backend.file, fileName, next);
+    });
+    m_segmentRawBytes = 0;
+    m_segmentClock.restart();
+}
+
+bool CompressedLogWriter::openSegment(SegmentFile &segment, const QString &fileName, int number)
+{
+    segment.file.setFileName(fileName);
+    if (!segment.file.open(QIODevice::WriteOnly))
+        return false;
+
+    CompressedFileHeader header;
+    memcpy(header.magic, COMPRESSED_FILE_MAGIC, 4);
+    header.version = COMPRESSED_FILE_VERSION;
+    header.segment = quint32(number);
+    header.reserved = 0;
+    segment.file.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    segment.offset = sizeof(header);
+    segment.rawOffset = 0;
+    segment.index.clear();
+    return true;
+}
+
+void CompressedLogWriter::finishSegment(SegmentFile &segment)
+{
+    if (!segment.file.isOpen())
+        return;
+
+    CompressedFileFooter footer;
+    footer.indexOffset = segment.offset;
+    footer.blockCount = quint32(segment.index.size());
+    memcpy(footer.magic, COMPRESSED_INDEX_MAGIC, 4);
+
+    segment.file.write(reinterpret_cast<const char *>(segment.index.constData()),
+                       qsizetype(segment.index.size()) * qsizetype(sizeof(CompressedBlockIndex)));
+    segment.file.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+    segment.file.close();
+}
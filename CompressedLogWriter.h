@@ -0,0 +1,101 @@
+#ifndef COMPRESSEDLOGWRITER_H
+#define COMPRESSEDLOGWRITER_H
+
+#include <QByteArray>
+#include <QString>
+#include <QFile>
+#include <QVector>
+#include <QMutex>
+#include <QElapsedTimer>
+#include <atomic>
+#include <deque>
+#include <functional>
+#include <memory>
+#include "CompressedLogFormat.h"
+
+// 压缩日志写入：调用线程只负责攒数据并在换行处切块，压缩和写文件都在后台线程中依次进行
+// 后台积压超过 maxPendingBytes 时新块改为原样存放；超过 maxQueuedBytes（磁盘也跟不上）时丢弃新块并计入
+// droppedBytes()，内存占用有界，也不会反过来阻塞抓取线程
+// close() 只投递收尾任务就返回，剩余的块和块索引由后台写完；各写入器共用一个后台线程池，
+// 同一写入器的任务按提交顺序执行
+// 按原始字节数或时间轮转分段，每段关闭时写入块索引
+class CompressedLogWriter
+{
+public:
+    struct Options {
+        qint64 rotateBytes = 256LL * 1024 * 1024;   // 每段原始字节数上限，0 表示不按大小轮转
+        int rotateSeconds = 0;                      // 每段时长上限，0 表示不按时间轮转
+        int blockBytes = 1024 * 1024;               // 目标块大小
+        int blockIntervalMs = 2000;                 // 数据不足一块时最长等待时间
+        int level = 6;                              // zlib 压缩级别
+        qint64 maxPendingBytes = 64LL * 1024 * 1024;  // 积压超过后不再压缩
+        qint64 maxQueuedBytes = 256LL * 1024 * 1024;  // 积压超过后丢弃新块
+    };
+
+    CompressedLogWriter();
+    ~CompressedLogWriter();
+
+    void setOptions(const Options &options) { m_options = options; }
+    const Options &options() const { return m_options; }
+
+    // baseName 不含扩展名，分段依次为 baseName_001.fdz ……
+    bool open(const QString &baseName);
+    void close();
+    bool isOpen() const { return m_open; }
+
+    void write(const char *data, qsizetype length);
+    void write(const QByteArray &data) { write(data.constData(), data.size()); }
+    // 定时调用：把攒了一段时间的数据切成块，并检查按时间轮转
+    void flushIfDue();
+
+    QString currentFileName() const { return segmentFileName(m_segment); }
+    int segmentCount() const { return m_segment; }
+    qint64 storedBlocks() const { return m_storedBlocks->load(); }  // 因积压未压缩的块数
+    qint64 droppedBytes() const { return m_droppedBytes; }          // 因积压丢弃的原始字节数
+
+    // 等待所有写入器（包括已 close 的）的后台任务完成，程序退出前或需要读取刚关闭的文件时调用
+    static void waitForBackground();
+
+private:
+    struct SegmentFile {
+        QFile file;
+        quint64 offset = 0;
+        quint64 rawOffset = 0;
+        QVector<CompressedBlockIndex> index;
+    };
+
+    QString segmentFileName(int segment) const;
+    void cutBlock(bool force);
+    void submit(const QByteArray &block);
+    void rotate();
+    static bool openSegment(SegmentFile &segment, const QString &fileName, int number);
+    static void finishSegment(SegmentFile &segment);
+
+    Options m_options;
+    QString m_baseName;
+    bool m_open = false;
+
+    // 调用线程的状态
+    QByteArray m_buffer;
+    qint64 m_segmentRawBytes = 0;
+    int m_segment = 0;
+    QElapsedTimer m_segmentClock;
+    QElapsedTimer m_sinceBlock;
+    qint64 m_droppedBytes = 0;
+
+    // 后台状态，由调用线程与后台任务共享，close() 后随最后一个任务释放；文件只在后台任务中访问
+    struct Backend {
+        QMutex mutex;
+        std::deque<std::function<void(Backend &)>> tasks;
+        bool running = false;               // 已有任务在线程池中依次执行队列
+        std::unique_ptr<SegmentFile> file;
+        std::atomic<qint64> pendingBytes{0};
+    };
+    static void post(const std::shared_ptr<Backend> &backend, std::function<void(Backend &)> task);
+    static void drain(const std::shared_ptr<Backend> &backend);
+
+    std::shared_ptr<Backend> m_backend;
+    std::shared_ptr<std::atomic<qint64>> m_storedBlocks;      // 后台任务计数，写入器销毁后任务仍可能访问
+};
+
+#endif // COMPRESSEDLOGWRITER_H
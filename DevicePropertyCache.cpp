@@ -0,0 +1,93 @@
+#include "DevicePropertyCache.h"
+#include "AdbClient.h"
+#include <QMutexLocker>
+
+bool DevicePropertyCache::contains(const QString &serial) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.contains(serial);
+}
+
+DevicePropertyCache::Properties DevicePropertyCache::properties(const QString &serial) const
+{
+    QMutexLocker locker(&m_mutex);
+    return m_cache.value(serial);
+}
+
+QString DevicePropertyCache::value(const QString &serial, const QString &key, const QString &defaultValue) const
+{
+    QMutexLocker locker(&m_mutex);
+    auto it = m_cache.constFind(serial);
+    if (it == m_cache.constEnd())
+        return defaultValue;
+    return it->value(key, defaultValue);
+}
+
+bool DevicePropertyCache::fetch(AdbClient &client, const QString &serial, QString *error)
+{
+    QByteArray output;
+    if (!client.shell(serial, "getprop", output, error))
+        return false;
+
+    Properties props = parseGetprop(output);
+    if (props.isEmpty()) {
+        if (error)
+            *error = "getprop 没有返回属性";
+        return false;
+    }
+
+    QMutexLocker locker(&m_mutex);
+    m_cache.insert(serial, props);
+    return true;
+}
+
+void DevicePropertyCache::invalidate(const QString &serial)
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.remove(serial);
+}
+
+void DevicePropertyCache::clear()
+{
+    QMutexLocker locker(&m_mutex);
+    m_cache.clear();
+}
+
+DevicePropertyCache::Properties DevicePropertyCache::parseGetprop(const QByteArray &output)
+{
+    Properties props;
+    QString key;
+    QByteArray value;
+    bool inValue = false;       // 值跨行，尚未遇到结尾的 ']'
+
+    for (const QByteArray &rawLine : output.split('\n')) {
+        if (inValue) {
+            value += '\n';
+            if (rawLine.endsWith(']')) {
+                value += rawLine.left(rawLine.size() - 1);
+                props.insert(key, QString::fromUtf8(value));
+                inValue = false;
+            } else {
+                value += rawLine;
+            }
+            continue;
+        }
+
+        const QByteArray line = rawLine.trimmed();
+        if (!line.startsWith('['))
+            continue;
+        const int sep = line.indexOf("]: [");
+        if (sep < 0)
+            continue;
+
+        key = QString::fromUtf8(line.mid(1, sep - 1));
+        value = line.mid(sep + 4);
+        if (value.endsWith(']')) {
+            value.chop(1);
+            props.insert(key, QString::fromUtf8(value));
+        } else {
+            inValue = true;
+        }
+    }
+    return props;
+}
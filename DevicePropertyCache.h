@@ -0,0 +1,36 @@
+#ifndef DEVICEPROPERTYCACHE_H
+#define DEVICEPROPERTYCACHE_H
+
+#include <QHash>
+#include <QString>
+#include <QMutex>
+
+class AdbClient;
+
+// 按序列号缓存设备属性：一次 getprop 取回全部属性并解析，
+// 设备保持连接期间重复查询不再访问设备；设备重连或主动要求时才失效
+// 可在线程池和界面线程中同时使用
+class DevicePropertyCache
+{
+public:
+    using Properties = QHash<QString, QString>;
+
+    bool contains(const QString &serial) const;
+    Properties properties(const QString &serial) const;
+    QString value(const QString &serial, const QString &key, const QString &defaultValue = QString()) const;
+
+    // 从设备拉取全部属性并写入缓存（阻塞，在工作线程中调用）
+    bool fetch(AdbClient &client, const QString &serial, QString *error = nullptr);
+
+    void invalidate(const QString &serial);
+    void clear();
+
+    // 解析 getprop 输出，每行格式为 [key]: [value]，值中可能含有换行
+    static Properties parseGetprop(const QByteArray &output);
+
+private:
+    mutable QMutex m_mutex;
+    QHash<QString, Properties> m_cache;
+};
+
+#endif // DEVICEPROPERTYCACHE_H
@@ -0,0 +1,183 @@
+#include "DeviceWatcher.h"
+#include <QTcpSocket>
+#include <QTimer>
+#include <QProcess>
+#include <algorithm>
+
+DeviceWatcher::DeviceWatcher(const QString &adbPath, QObject *parent, quint16 port)
+    : QObject(parent), m_adbPath(adbPath), m_port(port),
+      m_socket(new QTcpSocket(this)),
+      m_retryTimer(new QTimer(this))
+{
+    m_retryTimer->setSingleShot(true);
+    connect(m_retryTimer, &QTimer::timeout, this, &DeviceWatcher::connectToServer);
+
+    connect(m_socket, &QTcpSocket::connected, this, &DeviceWatcher::onConnected);
+    connect(m_socket, &QTcpSocket::readyRead, this, &DeviceWatcher::onReadyRead);
+    connect(m_socket, &QTcpSocket::disconnected, this, &DeviceWatcher::onDisconnected);
+    connect(m_socket, &QTcpSocket::errorOccurred, this, &DeviceWatcher::onSocketError);
+}
+
+DeviceWatcher::~DeviceWatcher()
+{
+    stop();
+}
+
+void DeviceWatcher::start()
+{
+    if (m_running)
+        return;
+    m_running = true;
+    m_retryMs = MinRetryMs;
+    m_serverStateReported = false;
+    connectToServer();
+}
+
+void DeviceWatcher::stop()
+{
+    m_running = false;
+    m_retryTimer->stop();
+    m_socket->abort();
+}
+
+void DeviceWatcher::connectToServer()
+{
+    if (!m_running)
+        return;
+    m_buffer.clear();
+    m_handshakeDone = false;
+    m_socket->abort();
+    m_socket->connectToHost("127.0.0.1", m_port);
+}
+
+void DeviceWatcher::onConnected()
+{
+    m_socket->write(AdbClient::encodeRequest("host:track-devices"));
+}
+
+void DeviceWatcher::onReadyRead()
+{
+    m_buffer += m_socket->readAll();
+
+    if (!m_handshakeDone) {
+        if (m_buffer.size() < 4)
+            return;
+        if (!m_buffer.startsWith("OKAY")) {
+            setServerAvailable(false, "adb server 拒绝 track-devices 请求");
+            m_socket->abort();
+            scheduleReconnect();
+            return;
+        }
+        m_buffer.remove(0, 4);
+        m_handshakeDone = true;
+        m_retryMs = MinRetryMs;
+        m_triedStartServer = false;
+        setServerAvailable(true);
+    }
+
+    // 每次变化推送一份完整列表：4 位十六进制长度 + 内容
+    while (m_buffer.size() >= 4) {
+        bool ok = false;
+        const int length = m_buffer.left(4).toInt(&ok, 16);
+        if (!ok) {
+            m_socket->abort();
+            scheduleReconnect();
+            return;
+        }
+        if (m_buffer.size() < 4 + length)
+            return;
+        const QByteArray payload = m_buffer.mid(4, length);
+        m_buffer.remove(0, 4 + length);
+        applyDevices(AdbClient::parseDevices(payload));
+    }
+}
+
+void DeviceWatcher::onDisconnected()
+{
+    if (!m_running)
+        return;
+    // server 退出（如 adb kill-server）时所有设备都视为断开
+    setServerAvailable(false, "与 adb server 的连接已断开");
+    applyDevices({});
+    scheduleReconnect();
+}
+
+void DeviceWatcher::onSocketError()
+{
+    if (!m_running || m_socket->state() == QAbstractSocket::ConnectedState)
+        return;
+
+    // 连接被拒绝通常是 server 尚未启动，先尝试启动一次
+    if (m_socket->error() == QAbstractSocket::ConnectionRefusedError && !m_triedStartServer && !m_serverProcess) {
+        m_triedStartServer = true;
+        // 先报告不可用，界面不必等 start-server 结束才有状态
+        setServerAvailable(false, "adb server 未运行，正在启动");
+        m_serverProcess = new QProcess(this);
+        connect(m_serverProcess, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, [this]() {
+            m_serverProcess->deleteLater();
+            m_serverProcess = nullptr;
+            connectToServer();
+        });
+        connect(m_serverProcess, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+            if (error != QProcess::FailedToStart)
+                return;
+            m_serverProcess->deleteLater();
+            m_serverProcess = nullptr;
+            setServerAvailable(false, "无法启动 adb: " + m_adbPath);
+            scheduleReconnect();
+        });
+        m_serverProcess->start(m_adbPath, {"start-server"});
+        return;
+    }
+
+    setServerAvailable(false, m_socket->errorString());
+    applyDevices({});
+    scheduleReconnect();
+}
+
+void DeviceWatcher::scheduleReconnect()
+{
+    if (!m_running || m_retryTimer->isActive())
+        return;
+    m_retryTimer->start(m_retryMs);
+    m_retryMs = qMin(m_retryMs * 2, MaxRetryMs);
+}
+
+// m_serverAvailable 初始为 false，第一次连接失败时状态“没有变化”，也要发出一次
+void DeviceWatcher::setServerAvailable(bool available, const QString &error)
+{
+    if (available == m_serverAvailable && m_serverStateReported)
+        return;
+    m_serverAvailable = available;
+    m_serverStateReported = true;
+    emit serverAvailableChanged(available, error);
+}
+
+void DeviceWatcher::applyDevices(const QList<AdbDevice> &devices)
+{
+    bool changed = false;
+
+    for (const AdbDevice &old : m_devices) {
+        auto it = std::find_if(devices.begin(), devices.end(),
+                               [&old](const AdbDevice &d) { return d.serial == old.serial; });
+        if (it == devices.end()) {
+            emit deviceRemoved(old.serial);
+            changed = true;
+        }
+    }
+    for (const AdbDevice &device : devices) {
+        auto it = std::find_if(m_devices.begin(), m_devices.end(),
+                               [&device](const AdbDevice &d) { return d.serial == device.serial; });
+        if (it == m_devices.end()) {
+            emit deviceAdded(device);
+            changed = true;
+        } else if (it->state != device.state) {
+            emit deviceStateChanged(device);
+            changed = true;
+        }
+    }
+
+    m_devices = devices;
+    if (changed)
+        emit devicesChanged(m_devices);
+}
@@ -0,0 +1,67 @@
+#ifndef DEVICEWATCHER_H
+#define DEVICEWATCHER_H
+
+#include <QObject>
+#include <QList>
+#include "AdbClient.h"
+
+class QTcpSocket;
+class QTimer;
+class QProcess;
+
+// 设备插拔监视：与 adb server 保持一条 host:track-devices 长连接，
+// 设备列表变化时 server 主动推送，空闲时没有任何轮询
+// server 未运行时自动执行一次 adb start-server，连接断开后按退避间隔重连
+// 每次 start() 后的第一次连接结果（成功或失败）总会发出 serverAvailableChanged，之后只在变化时发出
+class DeviceWatcher : public QObject
+{
+    Q_OBJECT
+
+public:
+    explicit DeviceWatcher(const QString &adbPath, QObject *parent = nullptr,
+                           quint16 port = AdbClient::DefaultPort);
+    ~DeviceWatcher();
+
+    void start();
+    void stop();
+
+    QList<AdbDevice> devices() const { return m_devices; }
+    bool isServerAvailable() const { return m_serverAvailable; }
+
+signals:
+    void devicesChanged(const QList<AdbDevice> &devices);
+    void deviceAdded(const AdbDevice &device);
+    void deviceRemoved(const QString &serial);
+    void deviceStateChanged(const AdbDevice &device);
+    void serverAvailableChanged(bool available, const QString &error);
+
+private:
+    void connectToServer();
+    void onConnected();
+    void onReadyRead();
+    void onDisconnected();
+    void onSocketError();
+    void scheduleReconnect();
+    void setServerAvailable(bool available, const QString &error = QString());
+    void applyDevices(const QList<AdbDevice> &devices);
+
+    QString m_adbPath;
+    quint16 m_port;
+    QTcpSocket *m_socket;
+    QTimer *m_retryTimer;
+    QProcess *m_serverProcess = nullptr;
+
+    QByteArray m_buffer;
+    bool m_running = false;
+    bool m_handshakeDone = false;
+    bool m_triedStartServer = false;
+    bool m_serverAvailable = false;
+    bool m_serverStateReported = false;   // 本次 start() 后是否已发出过 server 状态
+    int m_retryMs = MinRetryMs;
+    QList<AdbDevice> m_devices;
+
+    static constexpr int MinRetryMs = 500;
+    static constexpr int MaxRetryMs = 5000;
+};
+
+#endif // DEVICEWATCHER_H
@@ -1,27 +1,11 @@
-QT += core gui widgets serialport
+# 程序（FaeDiagApp.pro）和测试/基准（tests/）
+# 构建后在构建目录执行 make check 运行全部测试；基准用例的选项见 tests/tests.pro
+TEMPLATE = subdirs
 
-CONFIG += c++17
+SUBDIRS += \
+    app \
+    tests
 
-TARGET = FaeDiag
-TEMPLATE = app
-
-SOURCES += \
-    main.cpp \
-    mainwindow.cpp \
-    SerialPortManager.cpp \
-    AdbManager.cpp
-
-HEADERS += \
-    mainwindow.h \
-    LogQueue.h \
-    SerialPortManager.h \
-    AdbManager.h
-
-FORMS += \
-    mainwindow.ui
-
-# 设置 Windows EXE 图标
-RC_FILE = appicon.rc
-
-# 添加资源文件
-RESOURCES += resources.qrc
+app.file = FaeDiagApp.pro
+app.makefile = Makefile.app
+tests.file = tests/tests.pro
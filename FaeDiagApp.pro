@@ -0,0 +1,106 @@
+QT += core gui widgets serialport network
+
+CONFIG += c++17
+
+TARGET = FaeDiag
+TEMPLATE = app
+
+SOURCES += \
+    main.cpp \
+    mainwindow.cpp \
+    SerialPortManager.cpp \
+    SerialReader.cpp \
+    RawCaptureWriter.cpp \
+    SerialReplayer.cpp \
+    AdbManager.cpp \
+    AdbClient.cpp \
+    DeviceWatcher.cpp \
+    DevicePropertyCache.cpp \
+    ScreenCapture.cpp \
+    LogcatParser.cpp \
+    LogBlockBuilder.cpp \
+    LogFileWriter.cpp \
+    LogFileImporter.cpp \
+    CompressedLogWriter.cpp \
+    CompressedLogReader.cpp \
+    LogcatWorker.cpp \
+    CaptureSessionManager.cpp \
+    HeadlessCapture.cpp \
+    LoadGenerator.cpp \
+    BenchRunner.cpp \
+    TriggerMatcher.cpp \
+    TriggerEngine.cpp \
+    LogWindowRecorder.cpp \
+    LogSessionWriter.cpp \
+    LogSessionReader.cpp \
+    LogStore.cpp \
+    LogStringPool.cpp \
+    TimelineMerger.cpp \
+    LogFilterEngine.cpp \
+    LogSearchIndex.cpp \
+    LogTextKernels.cpp \
+    PipelineStats.cpp \
+    StatsPanel.cpp \
+    FrameScheduler.cpp \
+    LogModel.cpp \
+    LogItemDelegate.cpp \
+    LogViewPipeline.cpp \
+    SessionLogModel.cpp
+
+HEADERS += \
+    mainwindow.h \
+    LogQueue.h \
+    SerialPortManager.h \
+    SerialReader.h \
+    RawCaptureFormat.h \
+    RawCaptureWriter.h \
+    SerialReplayer.h \
+    AdbManager.h \
+    AdbClient.h \
+    DeviceWatcher.h \
+    DevicePropertyCache.h \
+    ScreenCapture.h \
+    LogRecord.h \
+    LogcatParser.h \
+    LogBlockBuilder.h \
+    LogFileWriter.h \
+    LogFileImporter.h \
+    CompressedLogFormat.h \
+    CompressedLogWriter.h \
+    CompressedLogReader.h \
+    LogcatWorker.h \
+    CaptureSessionManager.h \
+    HeadlessCapture.h \
+    LoadGenerator.h \
+    BenchRunner.h \
+    TriggerMatcher.h \
+    TriggerEngine.h \
+    LogWindowRecorder.h \
+    LogSessionFormat.h \
+    LogSessionWriter.h \
+    LogSessionReader.h \
+    LogStore.h \
+    LogStringPool.h \
+    TimelineMerger.h \
+    LogFilterEngine.h \
+    LogSearchIndex.h \
+    LogTextKernels.h \
+    PipelineStats.h \
+    StatsPanel.h \
+    FrameScheduler.h \
+    LogModel.h \
+    LogItemDelegate.h \
+    LogViewPipeline.h \
+    SessionLogModel.h
+
+FORMS += \
+    mainwindow.ui
+
+# 基准模式读取进程峰值内存
+win32: LIBS += -lpsapi
+
+# 设置 Windows EXE 图标
+RC_FILE = appicon.rc
+
+# 添加资源文件
+RESOURCES += resources.qrc
@@ -0,0 +1,59 @@
+#include "FrameScheduler.h"
+#include <QTimer>
+
+FrameScheduler::FrameScheduler(QObject *parent)
+    : QObject(parent)
+{
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, [this]() {
+        m_sinceFrame.start();
+        emit frame();
+    });
+}
+
+bool FrameScheduler::isScheduled() const
+{
+    return m_timer->isActive();
+}
+
+void FrameScheduler::requestFrame()
+{
+    if (m_timer->isActive())
+        return;
+    // 距上一帧已超过一个周期时立即刷新，否则等到周期结束
+    const qint64 elapsed = m_sinceFrame.isValid() ? m_sinceFrame.elapsed() : FrameIntervalMs;
+    m_timer->start(int(qMax<qint64>(0, FrameIntervalMs - elapsed)));
+}
+
+void FrameScheduler::frameFinished(int backlog)
+{
+    if (backlog <= 0) {
+        m_budgetUs = qMax(MinBudgetUs, m_budgetUs - BudgetStepUs / 2);
+        m_trendClock.invalidate();
+        m_growingSeconds = 0;
+        if (m_reported) {
+            m_reported = false;
+            emit backlogCleared();
+        }
+        return;
+    }
+
+    m_budgetUs = qMin(MaxBudgetUs, m_budgetUs + BudgetStepUs);
+    requestFrame();
+
+    if (!m_trendClock.isValid()) {
+        m_trendClock.start();
+        m_trendBacklog = backlog;
+        return;
+    }
+    if (m_trendClock.elapsed() < 1000)
+        return;
+    m_growingSeconds = backlog > m_trendBacklog ? m_growingSeconds + 1 : 0;
+    m_trendBacklog = backlog;
+    m_trendClock.restart();
+    if (m_growingSeconds >= GrowingSecondsToReport && !m_reported) {
+        m_reported = true;
+        emit backlogGrowing(backlog);
+    }
+}
@@ -0,0 +1,51 @@
+#ifndef FRAMESCHEDULER_H
+#define FRAMESCHEDULER_H
+
+#include <QObject>
+#include <QElapsedTimer>
+
+class QTimer;
+
+// 日志视图的刷新调度：有新数据时才安排下一帧（相邻两帧至少间隔一个周期，多次请求合并为一帧），
+// 每帧只处理 budgetUs() 以内的工作，处理不完的留到下一帧；空闲时不产生任何定时唤醒
+//
+// 积压的处理：帧结束时仍有剩余则逐步加大预算（不超过帧周期的一半），处理完后再逐步收回；
+// 剩余积压连续几秒上升时发出 backlogGrowing，清空后发出 backlogCleared
+class FrameScheduler : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FrameIntervalMs = 33;       // 约 30 帧/秒
+    static constexpr qint64 MinBudgetUs = 4000;
+    static constexpr qint64 MaxBudgetUs = FrameIntervalMs * 1000 / 2;
+    static constexpr qint64 BudgetStepUs = 2000;
+    static constexpr int GrowingSecondsToReport = 3;
+
+    explicit FrameScheduler(QObject *parent = nullptr);
+
+    // 有新数据到达：没有排期时安排下一帧
+    void requestFrame();
+    // 帧处理结束，backlog 为剩余的待处理量（0 表示已处理完）；有剩余时自动安排下一帧
+    void frameFinished(int backlog);
+
+    qint64 budgetUs() const { return m_budgetUs; }
+    bool isScheduled() const;
+
+signals:
+    void frame();                         // 开始一帧，处理量以 budgetUs() 为限
+    void backlogGrowing(int backlog);
+    void backlogCleared();
+
+private:
+    QTimer *m_timer;
+    QElapsedTimer m_sinceFrame;           // 距上一帧开始的时间
+    qint64 m_budgetUs = MinBudgetUs * 2;
+
+    QElapsedTimer m_trendClock;           // 积压趋势（每秒比较一次）
+    int m_trendBacklog = 0;
+    int m_growingSeconds = 0;
+    bool m_reported = false;
+};
+
+#endif // FRAMESCHEDULER_H
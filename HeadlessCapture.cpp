@@ -0,0 +1,349 @@
+#include "HeadlessCapture.h"
+#include "AdbManager.h"
+#include "CaptureSessionManager.h"
+#include "LogFilterEngine.h"
+#include <QCoreApplication>
+#include <QCommandLineParser>
+#include <QDateTime>
+#include <QDir>
+#include <QTimer>
+#include <csignal>
+#include <cstring>
+#include <cstdio>
+
+namespace {
+
+// 信号处理函数里只置标志，由定时器在事件循环中收尾
+volatile std::sig_atomic_t g_stopRequested = 0;
+
+void onStopSignal(int)
+{
+    g_stopRequested = 1;
+}
+
+int levelFromName(const QString &name)
+{
+    for (int i = 0; i < LEVELS.size(); ++i) {
+        if (LEVELS[i].level.compare(name, Qt::CaseInsensitive) == 0)
+            return i;
+    }
+    return -1;
+}
+
+} // namespace
+
+bool HeadlessCapture::parseArguments(const QStringList &arguments, Options &options, QString *error, QString *help)
+{
+    QCommandLineParser parser;
+    parser.setApplicationDescription("FaeDiag 无界面抓取模式");
+    parser.addHelpOption();
+    parser.addOptions({
+        {"capture", "无界面抓取模式"},
+        {{"d", "device"}, "抓取指定设备（可重复）", "serial"},
+        {"all-devices", "抓取全部在线设备，之后接入的设备也自动抓取（未指定设备和串口时的默认行为）"},
+        {{"p", "serial"}, "抓取串口（可重复），可带波特率，如 COM3:921600，默认 115200", "port[:baud]"},
+        {{"o", "output"}, "输出目录，默认为当前目录下的 device_logs", "dir"},
+        {"no-file", "不落盘（需配合 --stdout）"},
+        {"format", "文件格式：txt（文本 + .fdl 索引，默认）或 fdz（压缩分段）", "txt|fdz"},
+        {"rotate-size", "按大小轮转（MB，仅 fdz），默认 256", "MB"},
+        {"rotate-time", "按时间轮转（分钟，仅 fdz）", "minutes"},
+        {"logcat-filter", "设备端 logcat 过滤规则（可重复），如 *:W 或 ActivityManager:I", "spec"},
+        {{"t", "duration"}, "抓取时长（秒），默认一直抓取直到 Ctrl+C", "seconds"},
+        {"stdout", "同时把日志行输出到标准输出（多路时行首带 [来源]）"},
+        {"level", "stdout 输出的最低级别", "V|D|I|W|E"},
+        {"tag", "stdout 只输出该 TAG", "tag"},
+        {"pid", "stdout 只输出该 PID", "pid"},
+        {"grep", "stdout 只输出包含关键字的行（不区分大小写）", "keyword"},
+    });
+
+    if (!parser.parse(arguments)) {
+        *error = parser.errorText();
+        return false;
+    }
+    if (parser.isSet("help")) {
+        *help = parser.helpText();
+        return true;
+    }
+    if (!parser.positionalArguments().isEmpty()) {
+        *error = "未知参数: " + parser.positionalArguments().join(' ');
+        return false;
+    }
+
+    options.devices = parser.values("device");
+    options.serialPorts = parser.values("serial");
+    options.allDevices = parser.isSet("all-devices")
+            || (options.devices.isEmpty() && options.serialPorts.isEmpty());
+    options.toStdout = parser.isSet("stdout");
+    options.logcatArgs = parser.values("logcat-filter");
+
+    if (!parser.isSet("no-file"))
+        options.outputDir = QDir(parser.isSet("output") ? parser.value("output") : "device_logs").absolutePath();
+    else if (!options.toStdout) {
+        *error = "--no-file 需要配合 --stdout 使用";
+        return false;
+    }
+
+    // 轮转只有压缩分段支持，未指定格式时自动使用 fdz
+    const bool rotate = parser.isSet("rotate-size") || parser.isSet("rotate-time");
+    const QString format = parser.value("format").toLower();
+    if (format == "fdz" || (format.isEmpty() && rotate)) {
+        options.compress = true;
+    } else if (!format.isEmpty() && format != "txt") {
+        *error = "不支持的格式: " + format;
+        return false;
+    } else if (rotate) {
+        *error = "--rotate-size/--rotate-time 只支持 fdz 格式";
+        return false;
+    }
+
+    bool ok = true;
+    if (parser.isSet("rotate-size")) {
+        const qint64 mb = parser.value("rotate-size").toLongLong(&ok);
+        if (!ok || mb < 0) {
+            *error = "无效的 --rotate-size: " + parser.value("rotate-size");
+            return false;
+        }
+        options.compressOptions.rotateBytes = mb * 1024 * 1024;
+    }
+    if (parser.isSet("rotate-time")) {
+        const int minutes = parser.value("rotate-time").toInt(&ok);
+        if (!ok || minutes < 0) {
+            *error = "无效的 --rotate-time: " + parser.value("rotate-time");
+            return false;
+        }
+        options.compressOptions.rotateSeconds = minutes * 60;
+    }
+    if (parser.isSet("duration")) {
+        options.durationSec = parser.value("duration").toInt(&ok);
+        if (!ok || options.durationSec <= 0) {
+            *error = "无效的 --duration: " + parser.value("duration");
+            return false;
+        }
+    }
+
+    if (parser.isSet("level")) {
+        options.minLevel = levelFromName(parser.value("level"));
+        if (options.minLevel < 0) {
+            *error = "无效的 --level: " + parser.value("level");
+            return false;
+        }
+    }
+    options.tag = parser.value("tag").toUtf8();
+    if (parser.isSet("pid")) {
+        options.pid = parser.value("pid").toInt(&ok);
+        if (!ok || options.pid < 0) {
+            *error = "无效的 --pid: " + parser.value("pid");
+            return false;
+        }
+    }
+    options.keyword = LogFilterEngine::foldNeedle(parser.value("grep"));
+
+    const bool filtered = parser.isSet("level") || parser.isSet("tag") || parser.isSet("pid") || parser.isSet("grep");
+    if (filtered && !options.toStdout) {
+        *error = "--level/--tag/--pid/--grep 只作用于 --stdout 输出，设备端过滤请用 --logcat-filter";
+        return false;
+    }
+    return true;
+}
+
+HeadlessCapture::HeadlessCapture(const Options &options, QObject *parent)
+    : QObject(parent), m_options(options)
+{
+    m_adbManager = new AdbManager(this);
+    m_captures = new CaptureSessionManager(m_adbManager->getAdbPath(), this);
+    m_captures->setOutputDirectory(m_options.outputDir);
+    m_captures->setLogcatArgs(m_options.logcatArgs);
+    if (m_options.compress)
+        m_captures->setCompression(true, m_options.compressOptions);
+
+    connect(m_adbManager, &AdbManager::onlineDevicesChanged, this, &HeadlessCapture::onOnlineDevicesChanged);
+    connect(m_adbManager, &AdbManager::errorOccurred, this, &HeadlessCapture::printStatus);
+    connect(m_captures, &CaptureSessionManager::blockReceived, this, &HeadlessCapture::onBlock);
+    connect(m_captures, &CaptureSessionManager::sessionStopped, this, &HeadlessCapture::onSessionStopped);
+    connect(m_captures, &CaptureSessionManager::allSessionsStopped, this, [this]() {
+        if (m_finishing)
+            report();
+    });
+    connect(m_captures, &CaptureSessionManager::logMessage, this, &HeadlessCapture::printStatus);
+    connect(m_captures, &CaptureSessionManager::errorOccurred, this, [this](const QString &source, const QString &error) {
+        printStatus(source + ": " + error);
+    });
+    connect(m_captures, &CaptureSessionManager::sessionStarted, this, [this](const QString &source, const QString &fileName) {
+        printStatus("开始抓取 " + source + (fileName.isEmpty() ? QString() : " -> " + fileName));
+    });
+
+    m_signalTimer = new QTimer(this);
+    connect(m_signalTimer, &QTimer::timeout, this, [this]() {
+        if (g_stopRequested)
+            finish();
+    });
+}
+
+HeadlessCapture::~HeadlessCapture()
+{
+    m_finishing = true;
+    m_captures->stopAll();
+}
+
+bool HeadlessCapture::start()
+{
+    std::signal(SIGINT, onStopSignal);
+    std::signal(SIGTERM, onStopSignal);
+#ifdef SIGPIPE
+    // stdout 接到管道时对端关闭不终止进程，写失败后正常收尾
+    std::signal(SIGPIPE, SIG_IGN);
+#endif
+    if (m_options.toStdout)
+        setvbuf(stdout, nullptr, _IOFBF, 64 * 1024);
+
+    for (const QString &spec : m_options.serialPorts) {
+        QString port = spec;
+        int baudRate = DefaultBaudRate;
+        const int colon = spec.lastIndexOf(':');
+        bool ok = false;
+        const int parsed = colon > 0 ? spec.mid(colon + 1).toInt(&ok) : 0;
+        if (ok && parsed > 0) {
+            port = spec.left(colon);
+            baudRate = parsed;
+        }
+
+        const QString source = CaptureSessionManager::serialSource(port);
+        m_baudRates.insert(source, baudRate);
+        QString error;
+        if (!startSource(source, &error)) {
+            printStatus("串口 " + port + " 打开失败: " + error);
+            m_captures->stopAll();
+            return false;
+        }
+    }
+
+    // 设备由 AdbManager 的 track-devices 推送，在线后再启动
+    onOnlineDevicesChanged(m_adbManager->onlineDevices());
+
+    if (m_options.durationSec > 0)
+        QTimer::singleShot(m_options.durationSec * 1000, this, &HeadlessCapture::finish);
+    m_signalTimer->start(200);
+    m_clock.start();
+    return true;
+}
+
+void HeadlessCapture::onOnlineDevicesChanged(const QStringList &serials)
+{
+    m_onlineDevices = serials;
+    if (m_finishing)
+        return;
+    for (const QString &serial : serials) {
+        const QString source = CaptureSessionManager::logcatSource(serial);
+        if (!wantsDevice(serial) || m_captures->isRunning(source))
+            continue;
+        QString error;
+        if (!startSource(source, &error))
+            printStatus(error);
+    }
+}
+
+bool HeadlessCapture::wantsDevice(const QString &serial) const
+{
+    return m_options.allDevices || m_options.devices.contains(serial);
+}
+
+bool HeadlessCapture::startSource(const QString &source, QString *error)
+{
+    if (source.startsWith("adb:"))
+        return m_captures->startLogcat(source.mid(4), error);
+    return m_captures->startSerial(source.mid(5), m_baudRates.value(source, DefaultBaudRate), error);
+}
+
+void HeadlessCapture::onSessionStopped(const QString &source)
+{
+    if (m_finishing)
+        return;
+    printStatus("抓取中断 " + source + "，等待重新连接");
+    scheduleRetry(source);
+}
+
+// logcat 进程退出、串口掉线（设备重启、USB 重新枚举）后定时重试；
+// 设备不在线时不重试，等 onlineDevicesChanged 再启动
+void HeadlessCapture::scheduleRetry(const QString &source)
+{
+    QTimer::singleShot(RetryIntervalMs, this, [this, source]() {
+        if (m_finishing || m_captures->isRunning(source))
+            return;
+        if (source.startsWith("adb:") && !m_onlineDevices.contains(source.mid(4)))
+            return;
+        if (!startSource(source, nullptr))
+            scheduleRetry(source);
+    });
+}
+
+void HeadlessCapture::onBlock(const LogBlockPtr &block)
+{
+    if (m_finishing)
+        return;
+    SourceStats &stats = m_stats[block->source];
+    stats.lines += quint64(block->lines.size());
+    stats.bytes += quint64(block->data.size());
+    if (!m_options.toStdout)
+        return;
+
+    // 只有一路来源时不加前缀，便于直接接给其他工具
+    const bool prefix = m_options.allDevices || m_options.devices.size() + m_options.serialPorts.size() > 1;
+    const QByteArray head = prefix ? "[" + block->source.toUtf8() + "] " : QByteArray();
+
+    for (const LogBlock::Line &line : block->lines) {
+        const LogLine &meta = line.meta;
+        const char *data = block->data.constData() + line.offset;
+        if (meta.level < m_options.minLevel)
+            continue;
+        if (m_options.pid >= 0 && meta.pid != m_options.pid)
+            continue;
+        if (!m_options.tag.isEmpty() && (meta.tagLength != m_options.tag.size()
+                || memcmp(data + meta.tagOffset, m_options.tag.constData(), size_t(meta.tagLength)) != 0))
+            continue;
+        if (!m_options.keyword.isEmpty() && !LogFilterEngine::lineMatches(data, line.length, m_options.keyword))
+            continue;
+
+        if (!head.isEmpty())
+            fwrite(head.constData(), 1, size_t(head.size()), stdout);
+        fwrite(data, 1, size_t(line.length), stdout);
+        fputc('\n', stdout);
+    }
+
+    // 每块刷新一次；读取端已关闭时结束抓取
+    if (fflush(stdout) != 0 || ferror(stdout)) {
+        printStatus("标准输出已关闭，停止抓取");
+        finish();
+    }
+}
+
+void HeadlessCapture::finish()
+{
+    if (m_finishing)
+        return;
+    m_finishing = true;
+    m_signalTimer->stop();
+
+    // 逐个停止会话，缓冲写入文件并写好索引/尾部；全部收尾（最后的块已输出）后再报告
+    m_captures->stopAll();
+    if (m_captures->isIdle())
+        report();
+}
+
+void HeadlessCapture::report()
+{
+    const double seconds = qMax<qint64>(1, m_clock.elapsed()) / 1000.0;
+    printStatus(QString("抓取结束，用时 %1 秒").arg(seconds, 0, 'f', 1));
+    for (auto it = m_stats.constBegin(); it != m_stats.constEnd(); ++it) {
+        printStatus(QString("  %1: %2 行, %3 KB, %4 行/秒")
+                    .arg(it.key()).arg(it->lines).arg(it->bytes / 1024)
+                    .arg(qRound64(it->lines / seconds)));
+    }
+    QCoreApplication::exit(0);
+}
+
+void HeadlessCapture::printStatus(const QString &msg) const
+{
+    const QString line = QDateTime::currentDateTime().toString("HH:mm:ss ") + msg;
+    fprintf(stderr, "%s\n", qPrintable(line));
+    fflush(stderr);
+}
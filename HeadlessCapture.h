@@ -0,0 +1,81 @@
+#ifndef HEADLESSCAPTURE_H
+#define HEADLESSCAPTURE_H
+
+#include <QObject>
+#include <QHash>
+#include <QStringList>
+#include <QElapsedTimer>
+#include "LogRecord.h"
+#include "CompressedLogWriter.h"
+
+class QTimer;
+class AdbManager;
+class CaptureSessionManager;
+
+// 无界面抓取模式（FaeDiag --capture ...），供无显示器的拷机架和自动化脚本使用
+// 基于 QCoreApplication，复用 AdbManager 的设备跟踪和 CaptureSessionManager 的抓取流水线；
+// 不创建日志视图，日志块写出后即释放，每路流只占用解析缓冲和文件写缓冲
+// 设备断开、串口掉线后会在重新出现时自动续抓，按 Ctrl+C 或到达时长后正常收尾（写入文件索引）
+class HeadlessCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    struct Options {
+        QStringList devices;              // 指定设备序列号，为空且未指定串口时抓取全部设备
+        bool allDevices = false;
+        QStringList serialPorts;          // 端口名，可带波特率：COM3:921600
+        QString outputDir;                // 为空表示不落盘
+        bool compress = false;            // .fdz 压缩分段
+        CompressedLogWriter::Options compressOptions;
+        QStringList logcatArgs;           // 设备端过滤规则
+        int durationSec = 0;              // 0 表示一直抓取
+        bool toStdout = false;
+        int minLevel = 0;                 // 以下为 stdout 输出的过滤条件
+        QByteArray tag;
+        qint32 pid = -1;
+        QByteArray keyword;               // 已转小写
+    };
+
+    static constexpr int DefaultBaudRate = 115200;
+    static constexpr int RetryIntervalMs = 2000;
+
+    // 解析命令行（argv 中包含 --capture 时调用）；help 非空时只需打印帮助后退出
+    static bool parseArguments(const QStringList &arguments, Options &options, QString *error, QString *help);
+
+    explicit HeadlessCapture(const Options &options, QObject *parent = nullptr);
+    ~HeadlessCapture();
+
+    // 启动抓取，失败（如串口打不开）返回 false；结束时调用 QCoreApplication::exit()
+    bool start();
+
+private slots:
+    void onOnlineDevicesChanged(const QStringList &serials);
+    void onBlock(const LogBlockPtr &block);
+    void onSessionStopped(const QString &source);
+    void finish();
+    void report();
+
+private:
+    bool wantsDevice(const QString &serial) const;
+    bool startSource(const QString &source, QString *error);
+    void scheduleRetry(const QString &source);
+    void printStatus(const QString &msg) const;
+
+    struct SourceStats {
+        quint64 lines = 0;
+        quint64 bytes = 0;
+    };
+
+    Options m_options;
+    AdbManager *m_adbManager;
+    CaptureSessionManager *m_captures;
+    QHash<QString, int> m_baudRates;      // uart:<port> -> 波特率
+    QHash<QString, SourceStats> m_stats;
+    QStringList m_onlineDevices;
+    QTimer *m_signalTimer;
+    QElapsedTimer m_clock;
+    bool m_finishing = false;
+};
+
+#endif // HEADLESSCAPTURE_H
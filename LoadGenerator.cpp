@@ -0,0 +1,201 @@
+#include "LoadGenerator.h"
+#include <QDateTime>
+#include <QStringList>
+#include <cmath>
+#include <cstring>
+
+namespace {
+
+const char LEVEL_CHARS[5] = {'V', 'D', 'I', 'W', 'E'};
+const char *const TAGS[] = {"ActivityManager", "WindowManager", "SurfaceFlinger", "AudioFlinger",
+                            "wpa_supplicant", "CameraService", "BluetoothAdapter", "PowerManagerService"};
+const int TAG_COUNT = int(sizeof(TAGS) / sizeof(TAGS[0]));
+const int FILLER_BYTES = 8192;
+
+} // namespace
+
+bool LoadGenerator::parseSpec(const QString &spec, Options &options, QString *error)
+{
+    const QStringList items = spec.split(',', Qt::SkipEmptyParts);
+    for (const QString &item : items) {
+        const int eq = item.indexOf('=');
+        const QString key = item.left(eq).trimmed();
+        const QString value = eq < 0 ? QString() : item.mid(eq + 1).trimmed();
+        bool ok = eq > 0;
+
+        if (key == "rate") {
+            options.linesPerSec = value.toDouble(&ok);
+            ok = ok && options.linesPerSec >= 0;
+        } else if (key == "len") {
+            const QStringList range = value.split('-');
+            bool ok2 = true;
+            options.minLineBytes = range.value(0).toInt(&ok);
+            options.maxLineBytes = range.size() > 1 ? range[1].toInt(&ok2) : options.minLineBytes;
+            ok = ok && ok2 && range.size() <= 2 && options.minLineBytes > 0
+                    && options.maxLineBytes >= options.minLineBytes && options.maxLineBytes <= 60000;
+        } else if (key == "levels") {
+            const QStringList weights = value.split('/');
+            ok = weights.size() == 5;
+            for (int i = 0; ok && i < 5; ++i) {
+                options.levelWeights[i] = weights[i].toInt(&ok);
+                ok = ok && options.levelWeights[i] >= 0;
+            }
+        } else if (key == "burst") {
+            // <倍数>x<持续毫秒>/<周期毫秒>
+            const int x = value.indexOf('x');
+            const int slash = value.indexOf('/');
+            bool ok2 = false, ok3 = false;
+            options.burstFactor = value.left(x).toDouble(&ok);
+            options.burstLengthMs = value.mid(x + 1, slash - x - 1).toInt(&ok2);
+            options.burstPeriodMs = value.mid(slash + 1).toInt(&ok3);
+            ok = ok && ok2 && ok3 && x > 0 && slash > x && options.burstFactor >= 1
+                    && options.burstLengthMs > 0 && options.burstPeriodMs >= options.burstLengthMs;
+        } else if (key == "format") {
+            options.logcat = value == "logcat";
+            ok = value == "logcat" || value == "uart";
+        } else if (key == "seed") {
+            options.seed = value.toUInt(&ok);
+        } else {
+            ok = false;
+        }
+
+        if (!ok) {
+            if (error)
+                *error = "无效的生成参数: " + item;
+            return false;
+        }
+    }
+
+    int total = 0;
+    for (int weight : options.levelWeights)
+        total += weight;
+    if (total == 0) {
+        if (error)
+            *error = "级别比例不能全为 0";
+        return false;
+    }
+    return true;
+}
+
+QString LoadGenerator::toSpec(const Options &options)
+{
+    QString spec = QString("rate=%1,len=%2-%3,levels=%4/%5/%6/%7/%8,format=%9,seed=%10")
+            .arg(options.linesPerSec).arg(options.minLineBytes).arg(options.maxLineBytes)
+            .arg(options.levelWeights[0]).arg(options.levelWeights[1]).arg(options.levelWeights[2])
+            .arg(options.levelWeights[3]).arg(options.levelWeights[4])
+            .arg(options.logcat ? "logcat" : "uart").arg(options.seed);
+    if (options.burstFactor > 1)
+        spec += QString(",burst=%1x%2/%3").arg(options.burstFactor).arg(options.burstLengthMs).arg(options.burstPeriodMs);
+    return spec;
+}
+
+qint64 LoadGenerator::sequenceOf(const char *data, qsizetype length)
+{
+    for (qsizetype i = 0; i + 4 < length; ++i) {
+        if (memcmp(data + i, "seq=", 4) != 0)
+            continue;
+        qint64 value = 0;
+        qsizetype pos = i + 4;
+        if (pos >= length || data[pos] < '0' || data[pos] > '9')
+            return -1;
+        while (pos < length && data[pos] >= '0' && data[pos] <= '9')
+            value = value * 10 + (data[pos++] - '0');
+        return value;
+    }
+    return -1;
+}
+
+LoadGenerator::LoadGenerator(const Options &options)
+    : m_options(options), m_random(options.seed)
+{
+    m_filler.resize(FILLER_BYTES);
+    for (int i = 0; i < FILLER_BYTES; ++i) {
+        // 以小写字母为主，夹杂空格和数字，接近真实日志的 trigram 分布
+        const quint32 r = m_random.bounded(40);
+        m_filler[i] = r < 26 ? char('a' + r) : r < 36 ? char('0' + r - 26) : ' ';
+    }
+    for (int weight : m_options.levelWeights)
+        m_levelTotal += weight;
+}
+
+// 速率对时间的积分；突发时段在每个周期开头
+double LoadGenerator::linesDue(qint64 elapsedUs) const
+{
+    const double seconds = double(elapsedUs) / 1e6;
+    double burstSeconds = 0;
+    if (m_options.burstFactor > 1 && m_options.burstPeriodMs > 0) {
+        const double period = m_options.burstPeriodMs / 1000.0;
+        const double length = m_options.burstLengthMs / 1000.0;
+        burstSeconds = std::floor(seconds / period) * length + qMin(std::fmod(seconds, period), length);
+    }
+    return m_options.linesPerSec * (seconds + (m_options.burstFactor - 1) * burstSeconds);
+}
+
+int LoadGenerator::generate(qint64 elapsedUs, QByteArray &out, int maxLines)
+{
+    const quint64 due = quint64(linesDue(elapsedUs));
+    if (due <= m_generated)
+        return 0;
+
+    // 同一批行共用一个时间戳：logcat 用当前时间，串口用开机以来的秒数（内核 printk 格式）
+    QByteArray stamp;
+    if (m_options.logcat) {
+        stamp = QDateTime::currentDateTime().toString("MM-dd HH:mm:ss.zzz").toLatin1();
+    } else {
+        stamp = "[" + QByteArray::number(double(elapsedUs) / 1e6, 'f', 6).rightJustified(12, ' ') + "]";
+    }
+
+    int count = 0;
+    while (m_generated < due && count < maxLines) {
+        appendLine(out, stamp);
+        ++m_generated;
+        ++count;
+    }
+    return count;
+}
+
+void LoadGenerator::appendLine(QByteArray &out, const QByteArray &stamp)
+{
+    quint32 pick = m_random.bounded(quint32(m_levelTotal));
+    int level = 0;
+    while (pick >= quint32(m_options.levelWeights[level])) {
+        pick -= quint32(m_options.levelWeights[level]);
+        ++level;
+    }
+
+    const qsizetype lineStart = out.size();
+    out += stamp;
+    if (m_options.logcat) {
+        // MM-DD HH:MM:SS.mmm  PID  TID L TAG: msg
+        const int pid = 1000 + int(m_random.bounded(64)) * 17;
+        const int tid = pid + int(m_random.bounded(8));
+        out += ' ';
+        out += QByteArray::number(pid).rightJustified(5, ' ');
+        out += ' ';
+        out += QByteArray::number(tid).rightJustified(5, ' ');
+        out += ' ';
+        out += LEVEL_CHARS[level];
+        out += ' ';
+        out += TAGS[m_random.bounded(TAG_COUNT)];
+        out += ": ";
+    } else {
+        out += ' ';
+        out += LEVEL_CHARS[level];
+        out += ' ';
+    }
+    out += "seq=";
+    out += QByteArray::number(m_generated);
+    out += ' ';
+
+    const int target = m_options.minLineBytes
+            + int(m_random.bounded(quint32(m_options.maxLineBytes - m_options.minLineBytes + 1)));
+    const qsizetype need = qMax<qsizetype>(1, target - (out.size() - lineStart));
+    qsizetype remaining = need;
+    while (remaining > 0) {
+        const qsizetype offset = qsizetype(m_random.bounded(quint32(FILLER_BYTES)));
+        const qsizetype take = qMin<qsizetype>(remaining, FILLER_BYTES - offset);
+        out.append(m_filler.constData() + offset, take);
+        remaining -= take;
+    }
+    out += '\n';
+}
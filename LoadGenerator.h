@@ -0,0 +1,52 @@
+#ifndef LOADGENERATOR_H
+#define LOADGENERATOR_H
+
+#include <QByteArray>
+#include <QString>
+#include <QRandomGenerator>
+
+// 合成日志生成器：按设定的速率、行长、级别比例和突发模式生成 logcat（threadtime）或串口控制台文本
+// 生成量只取决于经过的时间，调用方可以按任意间隔取数；每行消息以 "seq=<n> " 开头（从 0 递增），
+// 接收端据此统计丢失的行
+//
+// 参数可以写成一个字符串在进程间传递：
+//   rate=5000,len=60-200,levels=10/30/40/15/5,burst=10x200/5000,format=logcat,seed=1
+//   burst=<倍数>x<持续毫秒>/<周期毫秒>：每个周期开头的一段时间内速率乘以倍数
+class LoadGenerator
+{
+public:
+    struct Options {
+        double linesPerSec = 5000;
+        int minLineBytes = 60;
+        int maxLineBytes = 200;
+        int levelWeights[5] = {10, 30, 40, 15, 5};   // V D I W E
+        double burstFactor = 1;
+        int burstLengthMs = 0;
+        int burstPeriodMs = 0;
+        bool logcat = true;                         // false 为串口控制台格式（内核时间戳 + 文本）
+        quint32 seed = 1;
+    };
+
+    static bool parseSpec(const QString &spec, Options &options, QString *error);
+    static QString toSpec(const Options &options);
+    // 行中 "seq=" 后的序号，没有时返回 -1
+    static qint64 sequenceOf(const char *data, qsizetype length);
+
+    explicit LoadGenerator(const Options &options);
+
+    // 生成截至 elapsedUs（从开始生成算起）应产生而尚未产生的行，追加到 out，最多 maxLines 行
+    int generate(qint64 elapsedUs, QByteArray &out, int maxLines);
+    quint64 linesGenerated() const { return m_generated; }
+
+private:
+    double linesDue(qint64 elapsedUs) const;
+    void appendLine(QByteArray &out, const QByteArray &stamp);
+
+    Options m_options;
+    QRandomGenerator m_random;
+    QByteArray m_filler;                  // 随机可见字符，按需截取作为消息正文
+    int m_levelTotal = 0;
+    quint64 m_generated = 0;
+};
+
+#endif // LOADGENERATOR_H
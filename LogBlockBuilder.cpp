@@ -0,0 +1,154 @@
+#include "LogBlockBuilder.h"
+#include "LogcatParser.h"
+#include "LogTextKernels.h"
+#include "PipelineStats.h"
+
+namespace {
+
+// 不超过 limit 的切分位置，不落在 UTF-8 多字节字符中间（数据不是合法 UTF-8 时按 limit 切）
+qsizetype utf8Boundary(const char *data, qsizetype limit)
+{
+    for (qsizetype cut = limit; cut > 0 && cut > limit - 4; --cut) {
+        if ((uchar(data[cut]) & 0xC0) != 0x80)
+            return cut;
+    }
+    return limit;
+}
+
+} // namespace
+
+LogBlockBuilder::LogBlockBuilder(int reserveBytes)
+    : m_reserveBytes(reserveBytes), m_block(new LogBlock)
+{
+    m_block->data.reserve(m_reserveBytes);
+}
+
+void LogBlockBuilder::feed(const char *data, qsizetype length)
+{
+    if (length <= 0)
+        return;
+    // 同一段数据中的各行按这段数据读到的时间计，跨段的行按首段的时间计
+    const qint64 nowUs = PipelineStats::nowUs();
+    if (m_block->receivedUs < 0)
+        m_block->receivedUs = nowUs;
+
+    const char *end = data + length;
+    const char *p = data;
+    while (p < end) {
+        const char *nl = LogTextKernels::findByte(p, end, '\n');
+        if (nl == end) {
+            if (m_partial.isEmpty())
+                m_partialUs = nowUs;
+            m_partial.append(p, end - p);
+            breakPartial();
+            return;
+        }
+        if (!m_partial.isEmpty()) {
+            m_partial.append(p, nl - p);
+            addLine(m_partial.constData(), m_partial.size(), m_partialUs);
+            m_partial.clear();
+        } else {
+            addLine(p, nl - p, nowUs);
+        }
+        p = nl + 1;
+    }
+}
+
+// 超长无换行的数据按 MaxLineBytes 强制断行，断点避开多字节字符，剩余部分继续等待换行
+void LogBlockBuilder::breakPartial()
+{
+    qsizetype done = 0;
+    while (m_partial.size() - done > MaxLineBytes) {
+        const qsizetype cut = utf8Boundary(m_partial.constData() + done, MaxLineBytes);
+        appendLine(m_partial.constData() + done, cut, m_partialUs);
+        done += cut;
+    }
+    if (done > 0)
+        m_partial.remove(0, done);
+}
+
+void LogBlockBuilder::finishPartial()
+{
+    if (m_partial.isEmpty())
+        return;
+    addLine(m_partial.constData(), m_partial.size(), m_partialUs);
+    m_partial.clear();
+}
+
+void LogBlockBuilder::addLine(const char *data, qsizetype length, qint64 receivedUs)
+{
+    const char *end = data + length;
+    LogTextKernels::trim(data, end);
+    length = end - data;
+    if (length == 0)
+        return;
+    if (receivedUs < 0)
+        receivedUs = PipelineStats::nowUs();
+
+    // 超长的行分成多行，每行不超过 MaxLineBytes（行内偏移因此都能放进 LogLine 的字段）
+    while (length > MaxLineBytes) {
+        const qsizetype cut = utf8Boundary(data, MaxLineBytes);
+        appendLine(data, cut, receivedUs);
+        data += cut;
+        length -= cut;
+    }
+    appendLine(data, length, receivedUs);
+}
+
+void LogBlockBuilder::appendLine(const char *data, qsizetype length, qint64 receivedUs)
+{
+    LogBlock::Line line;
+    line.offset = quint32(m_block->data.size());
+    line.length = quint32(length);
+    line.receivedUs = receivedUs;
+    LogcatParser::parse(data, length, line.meta);
+    if (m_triggers)
+        matchTrigger(line, data);
+    m_block->data.append(data, length);
+    m_block->lines.append(line);
+}
+
+void LogBlockBuilder::setTriggers(const TriggerMatcherPtr &triggers)
+{
+    m_triggers = triggers;
+    m_block->triggered = 0;
+    const char *data = m_block->data.constData();
+    for (LogBlock::Line &line : m_block->lines) {
+        line.meta.trigger = 0;
+        if (m_triggers)
+            matchTrigger(line, data + line.offset);
+    }
+}
+
+void LogBlockBuilder::matchTrigger(LogBlock::Line &line, const char *data)
+{
+    const int rule = m_triggers->match(data, line.length, line.meta.level);
+    if (rule >= 0) {
+        line.meta.trigger = quint8(rule + 1);
+        ++m_block->triggered;
+    }
+}
+
+LogBlockPtr LogBlockBuilder::take()
+{
+    if (m_block->lines.isEmpty())
+        return LogBlockPtr();
+
+    m_block->source = m_source;
+    if (m_block->triggered)
+        m_block->triggers = m_triggers;
+    PipelineStats::instance().add(PipelineStats::LinesParsed, quint64(m_block->lines.size()));
+    PipelineStats::instance().add(PipelineStats::BlocksParsed);
+    LogBlockPtr block = m_block;
+    m_block.reset(new LogBlock);
+    m_block->data.reserve(m_reserveBytes);
+    return block;
+}
+
+LogBlockPtr LogBlockBuilder::fromText(const QByteArray &text)
+{
+    LogBlockBuilder builder(int(text.size()));
+    builder.feed(text);
+    builder.finishPartial();
+    return builder.take();
+}
@@ -0,0 +1,57 @@
+#ifndef LOGBLOCKBUILDER_H
+#define LOGBLOCKBUILDER_H
+
+#include <QByteArray>
+#include <QSharedPointer>
+#include "LogRecord.h"
+#include "TriggerMatcher.h"
+
+// 把原始字节流切分成行、解析并攒成 LogBlock
+// 数据可以按任意边界分段喂入，不完整的末行会保留到下一段数据到达
+class LogBlockBuilder
+{
+public:
+    static constexpr int DefaultReserveBytes = 64 * 1024;
+    static constexpr int MaxLineBytes = 64 * 1024;     // 超长的行强制断行（断在 UTF-8 字符之间）
+
+    explicit LogBlockBuilder(int reserveBytes = DefaultReserveBytes);
+
+    // 追加一段原始数据，按 '\n' 切行
+    void feed(const char *data, qsizetype length);
+    void feed(const QByteArray &data) { feed(data.constData(), data.size()); }
+    // 流结束时把残留的不完整行当作一行
+    void finishPartial();
+    // 追加一整行（会去掉首尾空白，空行忽略），receivedUs < 0 时取当前时间
+    void addLine(const char *data, qsizetype length, qint64 receivedUs = -1);
+
+    int lineCount() const { return int(m_block->lines.size()); }
+    qsizetype byteCount() const { return m_block->data.size(); }
+    bool isEmpty() const { return m_block->lines.isEmpty(); }
+    bool hasPartial() const { return !m_partial.isEmpty(); }
+
+    // 之后取出的块都标记为该来源
+    void setSource(const QString &source) { m_source = source; }
+    // 之后加入的行逐行匹配触发规则，命中的行记下规则编号（LogLine::trigger）；为空时不匹配
+    // 当前块中已有的行按新规则重新匹配，块中的编号始终对应同一套规则
+    void setTriggers(const TriggerMatcherPtr &triggers);
+
+    // 取出已攒好的块并开始新块，没有内容时返回空指针
+    LogBlockPtr take();
+
+    // 把一段完整文本（如提示信息）直接转成块
+    static LogBlockPtr fromText(const QByteArray &text);
+
+private:
+    void breakPartial();
+    void appendLine(const char *data, qsizetype length, qint64 receivedUs);
+    void matchTrigger(LogBlock::Line &line, const char *data);
+
+    int m_reserveBytes;
+    QSharedPointer<LogBlock> m_block;
+    QByteArray m_partial;               // 上一段数据末尾不完整的行
+    qint64 m_partialUs = -1;            // 不完整行的首段数据读到的时间
+    QString m_source;
+    TriggerMatcherPtr m_triggers;
+};
+
+#endif // LOGBLOCKBUILDER_H
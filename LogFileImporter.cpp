@@ -0,0 +1,224 @@
+#include "LogFileImporter.h"
+#include "LogBlockBuilder.h"
+#include "CompressedLogReader.h"
+#include <cstring>
+
+LogFileImporter::LogFileImporter(QObject *parent)
+    : QObject(parent)
+{
+}
+
+LogFileImporter::~LogFileImporter()
+{
+    cancel();
+}
+
+bool LogFileImporter::start(const QStringList &fileNames, QString *error)
+{
+    cancel();
+
+    m_chunks.clear();
+    m_totalBytes = 0;
+    for (const QString &fileName : fileNames) {
+        if (!addSource(fileName, error)) {
+            if (error)
+                *error = fileName + ": " + *error;
+            release();
+            return false;
+        }
+    }
+    if (m_chunks.isEmpty()) {
+        if (error)
+            *error = "文件为空";
+        release();
+        return false;
+    }
+
+    m_nextToSchedule = 0;
+    m_nextToEmit = 0;
+    m_inFlight = 0;
+    m_doneBytes = 0;
+    m_pending.clear();
+    m_lineCount = 0;
+    m_cancelled = std::make_shared<std::atomic<bool>>(false);
+    m_elapsed.start();
+
+    scheduleChunks();
+    return true;
+}
+
+bool LogFileImporter::addSource(const QString &fileName, QString *error)
+{
+    std::unique_ptr<Source> source(new Source);
+    const int sourceIndex = int(m_sources.size());
+
+    if (CompressedLogReader::isCompressedFile(fileName)) {
+        source->reader.reset(new CompressedLogReader);
+        if (!source->reader->open(fileName, error))
+            return false;
+        for (int i = 0; i < source->reader->blockCount(); ++i) {
+            Chunk chunk;
+            chunk.source = sourceIndex;
+            chunk.block = i;
+            chunk.length = source->reader->blockIndex(i).storedSize;
+            m_chunks.append(chunk);
+            m_totalBytes += chunk.length;
+        }
+        m_sources.push_back(std::move(source));
+        return true;
+    }
+
+    source->file.setFileName(fileName);
+    if (!source->file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = source->file.errorString();
+        return false;
+    }
+    const qint64 size = source->file.size();
+    if (size == 0) {
+        m_sources.push_back(std::move(source));
+        return true;
+    }
+    source->map = source->file.map(0, size);
+    if (!source->map) {
+        if (error)
+            *error = source->file.errorString();
+        return false;
+    }
+
+    // 按 ChunkBytes 切块，边界挪到下一个换行之后，保证每行完整地落在一个块内
+    // 其后 MaxLineBytes 内没有换行时（超长的行本来也会被强制断开）直接断在 UTF-8 字符之间，块的大小有上限
+    const uchar *map = source->map;
+    qint64 begin = 0;
+    while (begin < size) {
+        qint64 end = begin + ChunkBytes;
+        if (end >= size) {
+            end = size;
+        } else {
+            const qint64 searchEnd = qMin<qint64>(size, end + LogBlockBuilder::MaxLineBytes);
+            const void *nl = memchr(map + end, '\n', size_t(searchEnd - end));
+            if (nl) {
+                end = static_cast<const uchar *>(nl) - map + 1;
+            } else if (searchEnd == size) {
+                end = size;
+            } else {
+                end = searchEnd;
+                while (end > begin + 1 && (map[end] & 0xC0) == 0x80)
+                    --end;
+            }
+        }
+        Chunk chunk;
+        chunk.source = sourceIndex;
+        chunk.offset = begin;
+        chunk.length = end - begin;
+        m_chunks.append(chunk);
+        m_totalBytes += chunk.length;
+        begin = end;
+    }
+    m_sources.push_back(std::move(source));
+    return true;
+}
+
+void LogFileImporter::cancel()
+{
+    if (m_sources.empty())
+        return;
+
+    if (m_cancelled)
+        m_cancelled->store(true);
+    m_pool.waitForDone();
+    m_pending.clear();
+    release();
+}
+
+void LogFileImporter::release()
+{
+    for (const std::unique_ptr<Source> &source : m_sources) {
+        if (source->map)
+            source->file.unmap(const_cast<uchar *>(source->map));
+        source->file.close();
+    }
+    m_sources.clear();
+}
+
+// 限制同时在途的块数，解析速度快于界面消费时不会把整个文件都堆在内存里
+void LogFileImporter::scheduleChunks()
+{
+    const int maxInFlight = qMax(2, m_pool.maxThreadCount() * 2);
+
+    while (m_nextToSchedule < m_chunks.size() && m_inFlight + m_pending.size() < maxInFlight) {
+        const int index = m_nextToSchedule++;
+        const Chunk chunk = m_chunks[index];
+        Source *source = m_sources[size_t(chunk.source)].get();
+        auto cancelled = m_cancelled;
+        ++m_inFlight;
+
+        m_pool.start([this, index, chunk, source, cancelled]() {
+            LogBlockPtr block;
+            if (!cancelled->load()) {
+                QByteArray decompressed;
+                const char *data;
+                qint64 length;
+                if (chunk.block >= 0) {
+                    decompressed = source->reader->block(chunk.block);
+                    data = decompressed.constData();
+                    length = decompressed.size();
+                } else {
+                    data = reinterpret_cast<const char *>(source->map) + chunk.offset;
+                    length = chunk.length;
+                }
+                // 文本块有上限，压缩分段的块按文件中的记录，预留的空间再限制一次
+                LogBlockBuilder builder(int(qMin<qint64>(length, ChunkBytes + LogBlockBuilder::MaxLineBytes)));
+                builder.feed(data, length);
+                builder.finishPartial();
+                block = builder.take();
+            }
+            if (!cancelled->load()) {
+                QMetaObject::invokeMethod(this, [this, index, block, cancelled]() {
+                    if (!cancelled->load())
+                        onChunkParsed(index, block);
+                }, Qt::QueuedConnection);
+            }
+        });
+    }
+}
+
+void LogFileImporter::onChunkParsed(int index, const LogBlockPtr &block)
+{
+    --m_inFlight;
+    m_pending.insert(index, block);
+    emitReady();
+}
+
+void LogFileImporter::resume()
+{
+    if (!m_sources.empty())
+        emitReady();
+}
+
+// 按文件顺序发出已就绪的块，接收端积压过多时暂停，已解析的块留在 m_pending 中（同时计入在途上限）
+void LogFileImporter::emitReady()
+{
+    while (m_pending.contains(m_nextToEmit) && (!m_backlog || m_backlog() < MaxBacklogBlocks)) {
+        const LogBlockPtr ready = m_pending.take(m_nextToEmit);
+        m_doneBytes += m_chunks[m_nextToEmit].length;
+        ++m_nextToEmit;
+        if (ready) {
+            m_lineCount += ready->lines.size();
+            emit blockReady(ready);
+        }
+        emit progress(m_doneBytes, m_totalBytes);
+    }
+
+    if (m_nextToEmit == m_chunks.size()) {
+        finish();
+        return;
+    }
+    scheduleChunks();
+}
+
+void LogFileImporter::finish()
+{
+    release();
+    emit finished(m_lineCount, m_elapsed.elapsed());
+}
@@ -0,0 +1,92 @@
+#ifndef LOGFILEIMPORTER_H
+#define LOGFILEIMPORTER_H
+
+#include <QObject>
+#include <QFile>
+#include <QHash>
+#include <QVector>
+#include <QStringList>
+#include <QThreadPool>
+#include <QElapsedTimer>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <vector>
+#include "LogRecord.h"
+
+class CompressedLogReader;
+
+// 离线日志文件导入（logcat / 串口文本，以及压缩分段 .fdz）
+// 文本文件整体内存映射后按换行对齐切成若干块；压缩分段直接以其数据块为单位（写入时已在换行处切分），
+// 在线程池中并行解压、切行和解析，解析结果按文件顺序逐块发出，第一块解析完即可显示，
+// 其余部分边解析边追加；选择多个文件（如轮转出的各分段）时按给定顺序依次导入
+// 设置了积压查询时，接收端积压达到 MaxBacklogBlocks 块就暂停发出，等 resume() 再继续，
+// 解析也随之停在在途块数的上限，大文件导入时内存占用有界，接收队列不会因写满而丢行
+class LogFileImporter : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr qint64 ChunkBytes = 4 * 1024 * 1024;
+    static constexpr int MaxBacklogBlocks = 4;
+
+    using BacklogFunction = std::function<int()>;
+
+    explicit LogFileImporter(QObject *parent = nullptr);
+    ~LogFileImporter();
+
+    bool start(const QString &fileName, QString *error = nullptr) { return start(QStringList{fileName}, error); }
+    bool start(const QStringList &fileNames, QString *error = nullptr);
+    void cancel();
+    bool isRunning() const { return !m_sources.empty(); }
+
+    // 接收端当前积压的块数（如显示流水线的队列长度），为空表示不限
+    void setBacklog(const BacklogFunction &backlog) { m_backlog = backlog; }
+
+public slots:
+    // 接收端消费了数据，继续发出已解析好的块
+    void resume();
+
+signals:
+    void blockReady(const LogBlockPtr &block);
+    void progress(qint64 bytesDone, qint64 bytesTotal);
+    void finished(qint64 lineCount, qint64 elapsedMs);
+
+private:
+    struct Source {
+        QFile file;                                   // 文本文件
+        const uchar *map = nullptr;
+        std::unique_ptr<CompressedLogReader> reader;  // 压缩分段
+    };
+    struct Chunk {
+        int source = 0;
+        qint64 offset = 0;          // 文本文件中的偏移
+        qint64 length = 0;          // 文件中占用的字节数（用于进度）
+        int block = -1;             // 压缩分段中的块号，文本文件为 -1
+    };
+
+    bool addSource(const QString &fileName, QString *error);
+    void scheduleChunks();
+    void onChunkParsed(int index, const LogBlockPtr &block);
+    void emitReady();
+    void finish();
+    void release();
+
+    QThreadPool m_pool;
+    std::vector<std::unique_ptr<Source>> m_sources;
+    QVector<Chunk> m_chunks;
+    qint64 m_totalBytes = 0;
+    qint64 m_doneBytes = 0;
+
+    int m_nextToSchedule = 0;
+    int m_nextToEmit = 0;
+    int m_inFlight = 0;
+    QHash<int, LogBlockPtr> m_pending;    // 已解析、等待按顺序发出的块
+    BacklogFunction m_backlog;
+
+    qint64 m_lineCount = 0;
+    QElapsedTimer m_elapsed;
+    std::shared_ptr<std::atomic<bool>> m_cancelled;
+};
+
+#endif // LOGFILEIMPORTER_H
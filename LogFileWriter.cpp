@@ -0,0 +1,62 @@
+#include "LogFileWriter.h"
+
+LogFileWriter::LogFileWriter(int flushBytes, int flushIntervalMs)
+    : m_flushBytes(flushBytes), m_flushIntervalMs(flushIntervalMs)
+{
+}
+
+LogFileWriter::~LogFileWriter()
+{
+    close();
+}
+
+bool LogFileWriter::open(const QString &fileName)
+{
+    close();
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::WriteOnly))
+        return false;
+    m_buffer.reserve(m_flushBytes * 2);
+    m_sinceFlush.start();
+    return true;
+}
+
+void LogFileWriter::close()
+{
+    if (!m_file.isOpen())
+        return;
+    flush();
+    m_file.close();
+}
+
+void LogFileWriter::write(const char *data, qsizetype length)
+{
+    if (!m_file.isOpen() || length <= 0)
+        return;
+    // 大块数据（如整个读缓冲）先落盘已缓冲的部分，再直接写文件，不再拷贝进缓冲
+    if (length >= m_flushBytes) {
+        flush();
+        m_file.write(data, length);
+        m_file.flush();
+        return;
+    }
+    m_buffer.append(data, length);
+    if (m_buffer.size() >= m_flushBytes)
+        flush();
+}
+
+void LogFileWriter::flushIfDue()
+{
+    if (!m_buffer.isEmpty() && m_sinceFlush.elapsed() >= m_flushIntervalMs)
+        flush();
+}
+
+void LogFileWriter::flush()
+{
+    if (m_file.isOpen() && !m_buffer.isEmpty()) {
+        m_file.write(m_buffer);
+        m_file.flush();
+        m_buffer.resize(0);      // 保留已分配的容量
+    }
+    m_sinceFlush.restart();
+}
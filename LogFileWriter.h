@@ -0,0 +1,40 @@
+#ifndef LOGFILEWRITER_H
+#define LOGFILEWRITER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <QElapsedTimer>
+
+// 带缓冲的日志文件写入：数据先攒在内存里，达到大小阈值或距上次落盘超过时间阈值才写文件
+// 单次写入不小于大小阈值时直接写文件
+class LogFileWriter
+{
+public:
+    static constexpr int DefaultFlushBytes = 256 * 1024;
+    static constexpr int DefaultFlushIntervalMs = 1000;
+
+    LogFileWriter(int flushBytes = DefaultFlushBytes, int flushIntervalMs = DefaultFlushIntervalMs);
+    ~LogFileWriter();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_file.isOpen(); }
+    QString fileName() const { return m_file.fileName(); }
+    QString errorString() const { return m_file.errorString(); }
+
+    void write(const char *data, qsizetype length);
+    void write(const QByteArray &data) { write(data.constData(), data.size()); }
+
+    // 超过时间阈值才落盘，供定时器周期调用
+    void flushIfDue();
+    void flush();
+
+private:
+    QFile m_file;
+    QByteArray m_buffer;
+    int m_flushBytes;
+    int m_flushIntervalMs;
+    QElapsedTimer m_sinceFlush;
+};
+
+#endif // LOGFILEWRITER_H
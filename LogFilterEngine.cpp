@@ -0,0 +1,129 @@
+#include "LogFilterEngine.h"
+#include "LogTextKernels.h"
+
+namespace {
+
+// ASCII 不区分大小写的子串查找，needle 已转小写
+inline bool containsIgnoreCase(const char *data, qsizetype length, const QByteArray &needle)
+{
+    return LogTextKernels::findIgnoreCase(data, length, needle.constData(), needle.size()) >= 0;
+}
+
+} // namespace
+
+LogFilterEngine::LogFilterEngine(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+    m_levelBits.resize(LEVELS.size());
+    for (Bitmap &bits : m_levelBits)
+        bits.resize(m_capacity);
+}
+
+void LogFilterEngine::setMinLevel(int level)
+{
+    m_minLevel = qBound(0, level, int(LEVELS.size()) - 1);
+}
+
+void LogFilterEngine::setKeyword(const QString &keyword, const LogStore &store)
+{
+    m_keyword = keyword;
+    if (keyword.isEmpty()) {
+        m_active = -1;
+        return;
+    }
+
+    // 缓存的查找、收窄和逐行匹配都比较折叠后的字节，与匹配规则（只折叠 ASCII）一致
+    const QByteArray needle = foldNeedle(keyword);
+    int index = findKeyword(needle);
+    if (index < 0) {
+        // 新关键字包含某个已缓存的关键字时（例如继续输入），只需复查旧位图中命中的记录
+        int base = -1;
+        for (int i = 0; i < int(m_keywords.size()); ++i) {
+            const QByteArray &cached = m_keywords[i].needle;
+            if (needle.contains(cached) && (base < 0 || cached.size() > m_keywords[base].needle.size()))
+                base = i;
+        }
+
+        KeywordIndex entry;
+        entry.keyword = keyword;
+        entry.needle = needle;
+        entry.bits.resize(m_capacity);
+        for (quint64 seq = store.firstSeq(); seq < store.endSeq(); ++seq) {
+            const int slot = slotOf(seq);
+            if (base >= 0 && !m_keywords[base].bits.test(slot))
+                continue;
+            if (recordMatches(store.bySeq(seq), entry.needle))
+                entry.bits.set(slot, true);
+        }
+
+        if (int(m_keywords.size()) < MaxCachedKeywords) {
+            m_keywords.push_back(std::move(entry));
+            index = int(m_keywords.size()) - 1;
+        } else {
+            // 替换最久未使用的关键字位图
+            index = 0;
+            for (int i = 1; i < int(m_keywords.size()); ++i)
+                if (m_keywords[i].lastUsed < m_keywords[index].lastUsed)
+                    index = i;
+            m_keywords[index] = std::move(entry);
+        }
+    }
+
+    m_active = index;
+    m_keywords[index].lastUsed = ++m_useCounter;
+}
+
+void LogFilterEngine::onAppended(const LogStore &store, quint64 fromSeq, quint64 toSeq)
+{
+    // 槽位被新记录覆盖，位图对应位也随之重写，淘汰旧记录不需要额外处理
+    for (quint64 seq = fromSeq; seq < toSeq; ++seq) {
+        const int slot = slotOf(seq);
+        const LogRecord record = store.bySeq(seq);
+        for (int level = 0; level < int(m_levelBits.size()); ++level)
+            m_levelBits[level].set(slot, level == record.level());
+        for (KeywordIndex &entry : m_keywords)
+            entry.bits.set(slot, recordMatches(record, entry.needle));
+    }
+}
+
+bool LogFilterEngine::matches(quint64 seq) const
+{
+    const int slot = slotOf(seq);
+    return (combinedWord(slot >> 6) >> (slot & 63)) & 1;
+}
+
+quint64 LogFilterEngine::combinedWord(int word) const
+{
+    quint64 bits = ~quint64(0);
+    if (m_minLevel > 0) {
+        bits = 0;
+        for (int level = m_minLevel; level < int(m_levelBits.size()); ++level)
+            bits |= m_levelBits[level].words[word];
+    }
+    if (m_active >= 0)
+        bits &= m_keywords[m_active].bits.words[word];
+    return bits;
+}
+
+int LogFilterEngine::findKeyword(const QByteArray &needle) const
+{
+    for (int i = 0; i < int(m_keywords.size()); ++i)
+        if (m_keywords[i].needle == needle)
+            return i;
+    return -1;
+}
+
+QByteArray LogFilterEngine::foldNeedle(const QString &keyword)
+{
+    QByteArray needle = keyword.toUtf8();
+    for (char &c : needle) {
+        if (c >= 'A' && c <= 'Z')
+            c = char(c + ('a' - 'A'));
+    }
+    return needle;
+}
+
+bool LogFilterEngine::lineMatches(const char *data, qsizetype length, const QByteArray &needle)
+{
+    return containsIgnoreCase(data, length, needle);
+}
@@ -0,0 +1,106 @@
+#ifndef LOGFILTERENGINE_H
+#define LOGFILTERENGINE_H
+
+#include <QString>
+#include <QtAlgorithms>
+#include <vector>
+#include "LogStore.h"
+
+// 日志过滤引擎
+// 按 LogStore 的环形槽位维护匹配位图：每个级别一张，每个最近使用过的关键字一张。
+// 新记录到达时增量更新位图，切换过滤条件时只需按位合并，不必重新抓取或全量匹配。
+class LogFilterEngine
+{
+public:
+    explicit LogFilterEngine(int capacity);
+
+    int minLevel() const { return m_minLevel; }
+    QString keyword() const { return m_keyword; }
+    bool isActive() const { return m_minLevel > 0 || !m_keyword.isEmpty(); }
+
+    // 设置最低显示级别（LEVELS 下标，<= 0 表示全部）
+    void setMinLevel(int level);
+    // 设置关键字（不区分大小写），必要时对 store 中的历史记录建立位图
+    void setKeyword(const QString &keyword, const LogStore &store);
+
+    // store 新追加了 [fromSeq, toSeq) 后调用
+    void onAppended(const LogStore &store, quint64 fromSeq, quint64 toSeq);
+
+    bool matches(quint64 seq) const;
+    // 按当前条件把 [fromSeq, toSeq) 中匹配的序号追加到 out
+    template <typename Container>
+    void collect(quint64 fromSeq, quint64 toSeq, Container &out) const;
+
+    // 记录是否包含 needle（小写 UTF-8，ASCII 不区分大小写），搜索索引校验候选行时也使用
+    static bool recordMatches(const LogRecord &record, const QByteArray &needle)
+    {
+        return lineMatches(record.data(), record.size(), needle);
+    }
+    static bool lineMatches(const char *data, qsizetype length, const QByteArray &needle);
+    // 关键字转为匹配用的 needle：UTF-8，只把 ASCII 大写字母转小写（非 ASCII 字符区分大小写）
+    static QByteArray foldNeedle(const QString &keyword);
+
+private:
+    // 以环形槽位为下标的位图
+    struct Bitmap {
+        std::vector<quint64> words;
+        void resize(int bits) { words.assign((bits + 63) / 64, 0); }
+        bool test(int slot) const { return (words[slot >> 6] >> (slot & 63)) & 1; }
+        void set(int slot, bool on) {
+            const quint64 mask = quint64(1) << (slot & 63);
+            if (on) words[slot >> 6] |= mask; else words[slot >> 6] &= ~mask;
+        }
+    };
+
+    struct KeywordIndex {
+        QString keyword;
+        QByteArray needle;              // 小写 UTF-8，直接在原始字节上匹配
+        Bitmap bits;
+        quint64 lastUsed = 0;
+    };
+
+    static const int MaxCachedKeywords = 4;
+
+    int slotOf(quint64 seq) const { return int(seq % m_capacity); }
+    quint64 combinedWord(int word) const;
+    int findKeyword(const QByteArray &needle) const;
+
+    int m_capacity;
+    int m_minLevel = 0;
+    QString m_keyword;
+    int m_active = -1;                  // 当前关键字在 m_keywords 中的下标
+    quint64 m_useCounter = 0;
+
+    std::vector<Bitmap> m_levelBits;    // 每个级别一张位图
+    std::vector<KeywordIndex> m_keywords;
+};
+
+template <typename Container>
+void LogFilterEngine::collect(quint64 fromSeq, quint64 toSeq, Container &out) const
+{
+    if (!isActive()) {
+        for (quint64 seq = fromSeq; seq < toSeq; ++seq)
+            out.push_back(seq);
+        return;
+    }
+
+    // 按 64 位字遍历；区间在环形缓冲中最多分成两段连续槽位
+    quint64 seq = fromSeq;
+    while (seq < toSeq) {
+        const int slot = slotOf(seq);
+        const int word = slot >> 6;
+        const int bitBegin = slot & 63;
+        const quint64 remaining = qMin<quint64>(toSeq - seq, quint64(qMin(64 - bitBegin, m_capacity - slot)));
+        quint64 bits = combinedWord(word) >> bitBegin;
+        if (remaining < 64)
+            bits &= (quint64(1) << remaining) - 1;
+        while (bits) {
+            const int offset = qCountTrailingZeroBits(bits);
+            out.push_back(seq + offset);
+            bits &= bits - 1;
+        }
+        seq += remaining;
+    }
+}
+
+#endif // LOGFILTERENGINE_H
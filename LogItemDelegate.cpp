@@ -0,0 +1,40 @@
+#include "LogItemDelegate.h"
+#include "LogModel.h"
+#include <QPainter>
+
+LogItemDelegate::LogItemDelegate(QObject *parent)
+    : QStyledItemDelegate(parent)
+{
+}
+
+void LogItemDelegate::paint(QPainter *painter, const QStyleOptionViewItem &option,
+                            const QModelIndex &index) const
+{
+    painter->save();
+
+    QColor color;
+    if (option.state & QStyle::State_Selected) {
+        painter->fillRect(option.rect, option.palette.highlight());
+        color = option.palette.highlightedText().color();
+    } else {
+        if (index.data(LogModel::MarkedRole).toBool())
+            painter->fillRect(option.rect, QColor(255, 240, 160));     // 触发标记
+        int level = index.data(LogModel::LevelRole).toInt();
+        color = (level >= 0 && level < LEVELS.size()) ? LEVELS[level].color : QColor(Qt::black);
+    }
+
+    const QRect textRect = option.rect.adjusted(4, 0, -4, 0);
+    const QString text = index.data(Qt::DisplayRole).toString();
+    painter->setFont(option.font);
+    painter->setPen(color);
+    painter->drawText(textRect, Qt::AlignLeft | Qt::AlignVCenter | Qt::TextSingleLine,
+                      option.fontMetrics.elidedText(text, Qt::ElideRight, textRect.width()));
+
+    painter->restore();
+}
+
+QSize LogItemDelegate::sizeHint(const QStyleOptionViewItem &option, const QModelIndex &) const
+{
+    // 所有行等高，视图可以直接按行号计算位置
+    return QSize(option.rect.width(), option.fontMetrics.height() + 2);
+}
@@ -0,0 +1,20 @@
+#ifndef LOGITEMDELEGATE_H
+#define LOGITEMDELEGATE_H
+
+#include <QStyledItemDelegate>
+
+// 日志行绘制：按级别着色的单行文本，不做富文本排版，保证大量行滚动时的绘制速度
+// 触发标记的行加浅黄色底色
+class LogItemDelegate : public QStyledItemDelegate
+{
+    Q_OBJECT
+
+public:
+    explicit LogItemDelegate(QObject *parent = nullptr);
+
+    void paint(QPainter *painter, const QStyleOptionViewItem &option,
+               const QModelIndex &index) const override;
+    QSize sizeHint(const QStyleOptionViewItem &option, const QModelIndex &index) const override;
+};
+
+#endif // LOGITEMDELEGATE_H
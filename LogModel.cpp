@@ -0,0 +1,167 @@
+#include "LogModel.h"
+#include "TriggerMatcher.h"
+#include <algorithm>
+
+LogModel::LogModel(int capacity, QObject *parent)
+    : QAbstractListModel(parent), m_store(capacity), m_filter(capacity)
+{
+}
+
+int LogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    return m_filter.isActive() ? int(m_visible.size()) : m_store.size();
+}
+
+QVariant LogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const LogRecord rec = record(index.row());
+    switch (role) {
+    case Qt::DisplayRole:
+        return rec.text();          // 只有可见行才会解码成 QString
+    case LevelRole:
+        return int(rec.level());
+    case MarkedRole:
+        return !m_marks.empty() && std::binary_search(m_marks.begin(), m_marks.end(), seqForRow(index.row()));
+    case Qt::ForegroundRole:
+        return LEVELS[rec.level()].color;
+    default:
+        return QVariant();
+    }
+}
+
+void LogModel::appendBlocks(const QVector<LogBlockPtr> &blocks)
+{
+    qsizetype total = 0;
+    for (const LogBlockPtr &block : blocks)
+        total += block->lines.size();
+    if (total == 0)
+        return;
+
+    // 一批超过容量时只保留最后 capacity 条
+    const int capacity = m_store.capacity();
+    qsizetype skip = qMax<qsizetype>(0, total - capacity);
+    const int count = int(total - skip);
+
+    const int overflow = m_store.size() + count - capacity;
+    if (overflow > 0) {
+        const quint64 newFirst = m_store.firstSeq() + quint64(overflow);
+        int removed = overflow;
+        if (m_filter.isActive()) {
+            removed = 0;
+            while (removed < int(m_visible.size()) && m_visible[removed] < newFirst)
+                ++removed;
+        }
+        if (removed > 0)
+            beginRemoveRows(QModelIndex(), 0, removed - 1);
+        m_store.dropOldest(overflow);
+        m_search.onDropped(m_store.firstSeq());
+        while (!m_marks.empty() && m_marks.front() < m_store.firstSeq())
+            m_marks.pop_front();
+        if (m_filter.isActive())
+            m_visible.erase(m_visible.begin(), m_visible.begin() + removed);
+        if (removed > 0)
+            endRemoveRows();
+    }
+
+    const quint64 from = m_store.endSeq();
+    auto store = [&]() {
+        for (const LogBlockPtr &block : blocks) {
+            const qsizetype lines = block->lines.size();
+            if (skip >= lines) {
+                skip -= lines;
+                continue;
+            }
+            const quint64 firstSeq = m_store.endSeq();
+            m_store.append(*block, int(skip));
+            if (block->triggered)
+                addMarks(*block, int(skip), firstSeq);
+            skip = 0;
+        }
+        m_filter.onAppended(m_store, from, m_store.endSeq());
+        m_search.onAppended(m_store, from, m_store.endSeq());
+    };
+
+    if (!m_filter.isActive()) {
+        const int first = m_store.size();
+        beginInsertRows(QModelIndex(), first, first + count - 1);
+        store();
+        endInsertRows();
+        return;
+    }
+
+    store();
+    std::vector<quint64> matched;
+    m_filter.collect(from, m_store.endSeq(), matched);
+    if (!matched.empty()) {
+        const int first = int(m_visible.size());
+        beginInsertRows(QModelIndex(), first, first + int(matched.size()) - 1);
+        m_visible.insert(m_visible.end(), matched.begin(), matched.end());
+        endInsertRows();
+    }
+}
+
+void LogModel::clear()
+{
+    beginResetModel();
+    m_store.clear();
+    m_search.clear();
+    m_visible.clear();
+    m_marks.clear();
+    endResetModel();
+}
+
+void LogModel::setFilter(int minLevel, const QString &keyword)
+{
+    beginResetModel();
+    m_filter.setMinLevel(minLevel);
+    m_filter.setKeyword(keyword, m_store);
+    m_visible.clear();
+    if (m_filter.isActive())
+        m_filter.collect(m_store.firstSeq(), m_store.endSeq(), m_visible);
+    endResetModel();
+}
+
+bool LogModel::search(const LogSearchIndex::Query &query, std::vector<quint64> &hits, QString *error) const
+{
+    return m_search.search(m_store, query, hits, error);
+}
+
+int LogModel::rowForSeq(quint64 seq) const
+{
+    if (seq < m_store.firstSeq() || seq >= m_store.endSeq())
+        return -1;
+    if (!m_filter.isActive())
+        return int(seq - m_store.firstSeq());
+    auto it = std::lower_bound(m_visible.begin(), m_visible.end(), seq);
+    if (it == m_visible.end() || *it != seq)
+        return -1;
+    return int(it - m_visible.begin());
+}
+
+// 行是由抓取线程匹配的（LogLine::trigger），这里只按规则的动作决定是否标记
+void LogModel::addMarks(const LogBlock &block, int firstLine, quint64 firstSeq)
+{
+    if (!block.triggers)
+        return;
+    const QVector<TriggerRule> &rules = block.triggers->rules();
+    for (int i = firstLine; i < block.lines.size(); ++i) {
+        const int trigger = block.lines[i].meta.trigger;
+        if (trigger > 0 && (rules[trigger - 1].actions & TriggerRule::Mark))
+            m_marks.push_back(firstSeq + quint64(i - firstLine));
+    }
+}
+
+LogRecord LogModel::record(int row) const
+{
+    return m_store.bySeq(seqForRow(row));
+}
+
+quint64 LogModel::seqForRow(int row) const
+{
+    return m_filter.isActive() ? m_visible[row] : m_store.firstSeq() + quint64(row);
+}
@@ -0,0 +1,56 @@
+#ifndef LOGMODEL_H
+#define LOGMODEL_H
+
+#include <QAbstractListModel>
+#include <deque>
+#include "LogStore.h"
+#include "LogFilterEngine.h"
+#include "LogSearchIndex.h"
+
+// 日志视图模型：数据放在固定容量的 LogStore 中，视图只会请求可见行
+// 所有记录都会保留在 LogStore 中，过滤只影响显示的行（m_visible）
+class LogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    enum Roles {
+        LevelRole = Qt::UserRole + 1,     // 日志级别（LEVELS 下标）
+        MarkedRole                        // 是否是触发标记的行
+    };
+
+    explicit LogModel(int capacity = LogStore::DefaultCapacity, QObject *parent = nullptr);
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // 批量追加各块中的行（拷贝进存储，块随后可以释放），超出容量时先移除最旧的行
+    void appendBlocks(const QVector<LogBlockPtr> &blocks);
+    void clear();
+
+    // 修改过滤条件，基于已保存的全部历史重新生成可见行
+    void setFilter(int minLevel, const QString &keyword);
+
+    LogRecord record(int row) const;             // 可见行对应的记录
+    const LogStore &store() const { return m_store; }
+
+    // 全文搜索（基于增量维护的 trigram 索引），命中按序号升序
+    bool search(const LogSearchIndex::Query &query, std::vector<quint64> &hits, QString *error = nullptr) const;
+    // 序号对应的可见行，已被丢弃或被过滤隐藏时返回 -1
+    int rowForSeq(quint64 seq) const;
+    quint64 seqForRow(int row) const;
+
+    // 命中带标记动作的触发规则的行（序号升序，随最旧记录一起丢弃）
+    const std::deque<quint64> &marks() const { return m_marks; }
+
+private:
+    void addMarks(const LogBlock &block, int firstLine, quint64 firstSeq);
+
+    LogStore m_store;
+    LogFilterEngine m_filter;
+    LogSearchIndex m_search;
+    std::deque<quint64> m_visible;    // 过滤生效时可见记录的序号
+    std::deque<quint64> m_marks;
+};
+
+#endif // LOGMODEL_H
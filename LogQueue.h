@@ -1,28 +1,154 @@
 #ifndef LOGQUEUE_H
 #define LOGQUEUE_H
 
-#include <QString>
-#include <queue>
-#include <QMutex>
+#include <QtGlobal>
+#include <QVector>
+#include <atomic>
+#include <climits>
+#include <vector>
 
-class LogQueue {
+// 无锁有界环形队列（单生产者 / 单消费者），支持批量入队 / 出队
+//
+// 溢出策略：丢弃最旧。队列满时生产者把 head 向前推进一格，挤掉最旧的元素；
+// 如果消费者此刻正在拷贝最旧的那一批（head 已被认领但尚未释放），则改为丢弃当前新元素。
+// 两种情况都计入 droppedCount()。
+//
+// 下标均为单调递增的 64 位计数，取模后定位槽位：
+//   m_released <= m_head <= m_tail
+//   [m_released, m_head)  消费者已认领、正在读取
+//   [m_head, m_tail)      可读元素
+template <typename T>
+class LogQueue
+{
 public:
-    void push(const QString &msg) {
-        QMutexLocker locker(&m_mutex);
-        m_queue.push(msg);
+    static constexpr int DefaultCapacity = 1 << 18;
+
+    explicit LogQueue(int capacity = DefaultCapacity)
+    {
+        quint64 size = 2;
+        while (size < quint64(qMax(2, capacity)))
+            size <<= 1;
+        m_slots.resize(size);
+        m_mask = size - 1;
+    }
+
+    LogQueue(const LogQueue &) = delete;
+    LogQueue &operator=(const LogQueue &) = delete;
+
+    int capacity() const { return int(m_mask + 1); }
+    int size() const
+    {
+        const quint64 head = m_head.load(std::memory_order_acquire);
+        const quint64 tail = m_tail.load(std::memory_order_acquire);
+        return tail > head ? int(tail - head) : 0;
+    }
+
+    quint64 pushedCount() const { return m_pushed.load(std::memory_order_relaxed); }
+    quint64 poppedCount() const { return m_popped.load(std::memory_order_relaxed); }
+    quint64 droppedCount() const { return m_dropped.load(std::memory_order_relaxed); }
+
+    // 生产者：批量入队，返回被丢弃的元素个数
+    int push(const T *items, int count)
+    {
+        const quint64 capacity = m_mask + 1;
+        quint64 tail = m_tail.load(std::memory_order_relaxed);
+        quint64 published = tail;
+        int dropped = 0;
+
+        for (int i = 0; i < count; ++i) {
+            const quint64 released = m_released.load(std::memory_order_acquire);
+            if (tail - released >= capacity) {
+                // 先发布已写入的元素，保证被挤掉的位置一定在 tail 之前
+                if (published != tail) {
+                    m_tail.store(tail, std::memory_order_release);
+                    published = tail;
+                }
+                ++dropped;
+                if (!dropOldest(released))
+                    continue;       // 消费者正在读最旧的一批，丢弃当前元素
+            }
+            m_slots[tail & m_mask] = items[i];
+            ++tail;
+        }
+
+        if (published != tail)
+            m_tail.store(tail, std::memory_order_release);
+        m_pushed.fetch_add(quint64(count), std::memory_order_relaxed);
+        if (dropped)
+            m_dropped.fetch_add(quint64(dropped), std::memory_order_relaxed);
+        return dropped;
+    }
+
+    int push(const QVector<T> &items) { return push(items.constData(), int(items.size())); }
+    bool push(const T &item) { return push(&item, 1) == 0; }
+
+    // 消费者：批量出队，追加到 out，返回取出的个数
+    int pop(QVector<T> &out, int maxCount = INT_MAX)
+    {
+        quint64 head = m_head.load(std::memory_order_acquire);
+        quint64 count = 0;
+        for (;;) {
+            const quint64 tail = m_tail.load(std::memory_order_acquire);
+            if (head >= tail)
+                return 0;
+            count = qMin<quint64>(tail - head, quint64(qMax(0, maxCount)));
+            if (count == 0)
+                return 0;
+            // 认领 [head, head + count)，期间生产者不会覆盖这些槽位
+            if (m_head.compare_exchange_weak(head, head + count,
+                                             std::memory_order_acq_rel, std::memory_order_acquire))
+                break;
+        }
+
+        out.reserve(out.size() + qsizetype(count));
+        for (quint64 i = 0; i < count; ++i)
+            out.append(std::move(m_slots[(head + i) & m_mask]));
+        advanceReleased(head + count);
+        m_popped.fetch_add(count, std::memory_order_relaxed);
+        return int(count);
     }
 
-    bool pop(QString &msg) {
-        QMutexLocker locker(&m_mutex);
-        if (m_queue.empty()) return false;
-        msg = m_queue.front();
-        m_queue.pop();
+    bool pop(T &item)
+    {
+        QVector<T> one;
+        if (pop(one, 1) == 0)
+            return false;
+        item = std::move(one.first());
         return true;
     }
 
 private:
-    std::queue<QString> m_queue;
-    QMutex m_mutex;
+    // 仅当没有未完成的读取（head == released）时才能挤掉最旧元素
+    bool dropOldest(quint64 released)
+    {
+        quint64 expected = released;
+        if (!m_head.compare_exchange_strong(expected, released + 1,
+                                            std::memory_order_acq_rel, std::memory_order_relaxed))
+            return false;
+        advanceReleased(released + 1);
+        return true;
+    }
+
+    // released 只增不减，生产者与消费者都可能推进
+    void advanceReleased(quint64 value)
+    {
+        quint64 current = m_released.load(std::memory_order_relaxed);
+        while (current < value
+               && !m_released.compare_exchange_weak(current, value,
+                                                    std::memory_order_release, std::memory_order_relaxed)) {
+        }
+    }
+
+    std::vector<T> m_slots;
+    quint64 m_mask = 0;
+
+    alignas(64) std::atomic<quint64> m_tail{0};      // 生产者写
+    alignas(64) std::atomic<quint64> m_head{0};      // 消费者认领（生产者丢弃最旧时也会推进）
+    alignas(64) std::atomic<quint64> m_released{0};  // 消费者读取完成的位置
+
+    alignas(64) std::atomic<quint64> m_pushed{0};
+    std::atomic<quint64> m_popped{0};
+    std::atomic<quint64> m_dropped{0};
 };
 
 #endif // LOGQUEUE_H
@@ -0,0 +1,70 @@
+#ifndef LOGRECORD_H
+#define LOGRECORD_H
+
+#include <QString>
+#include <QByteArray>
+#include <QColor>
+#include <QVector>
+#include <QSharedPointer>
+#include <QMetaType>
+
+// 日志级别颜色
+struct LogLevel {
+    QString level;
+    QColor color;
+};
+
+static const QVector<LogLevel> LEVELS = {
+    {"V", QColor(128,128,128)},  // Verbose 灰色
+    {"D", QColor(0,128,0)},      // Debug   绿色
+    {"I", QColor(0,0,255)},      // Info    蓝色
+    {"W", QColor(255,140,0)},    // Warn    橙色
+    {"E", QColor(255,0,0)}       // Error   红色
+};
+
+// 默认级别（I）在 LEVELS 中的下标
+static const int DEFAULT_LEVEL_INDEX = 2;
+
+// 一行日志的解析结果（定长、无堆分配），偏移均相对行首、以字节计
+struct LogLine {
+    enum Format : quint8 {
+        Raw,            // 未识别的格式（串口/内核输出等），只提取级别
+        ThreadTime,     // MM-DD HH:MM:SS.mmm  PID  TID L TAG: msg
+        Brief           // L/TAG(  PID): msg
+    };
+
+    qint64 timeMs = -1;                   // 设备时间戳（年内毫秒），无则 -1
+    qint32 pid = -1;
+    qint32 tid = -1;
+    quint8 level = DEFAULT_LEVEL_INDEX;   // LEVELS 下标
+    quint8 format = Raw;
+    quint8 trigger = 0;                   // 命中的触发规则编号 + 1（TriggerMatcher），0 表示没有命中
+    quint16 tagOffset = 0;
+    quint16 tagLength = 0;
+    quint32 messageOffset = 0;
+    quint32 messageLength = 0;
+};
+
+class TriggerMatcher;
+
+// 一批已解析的日志行：原始字节连续存放，跨线程以只读共享指针传递
+struct LogBlock {
+    struct Line {
+        quint32 offset = 0;               // 行在 data 中的起始位置
+        quint32 length = 0;
+        qint64 receivedUs = -1;           // 行首数据读到时的主机单调时间（PipelineStats::nowUs）
+        LogLine meta;
+    };
+
+    QByteArray data;
+    QVector<Line> lines;
+    QString source;                       // 来源（如 adb:<serial>、uart:<port>），本地提示信息为空
+    qint64 receivedUs = -1;               // 块内最早一段数据读到时的主机单调时间（PipelineStats::nowUs）
+    int triggered = 0;                    // 命中触发规则的行数
+    QSharedPointer<const TriggerMatcher> triggers;  // 匹配这些行所用的规则（triggered > 0 时有效）
+};
+
+using LogBlockPtr = QSharedPointer<const LogBlock>;
+Q_DECLARE_METATYPE(LogBlockPtr)
+
+#endif // LOGRECORD_H
@@ -0,0 +1,293 @@
+#include "LogSearchIndex.h"
+#include "LogFilterEngine.h"
+#include <QRegularExpression>
+#include <QStringList>
+
+namespace {
+
+inline quint32 lowerByte(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? quint32(c + ('a' - 'A')) : quint32(quint8(c));
+}
+
+inline int trigramBit(quint32 trigram)
+{
+    return int((trigram * 2654435761u) >> 20) & (LogSearchIndex::SignatureBits - 1);
+}
+
+inline bool isAsciiAlnum(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z');
+}
+
+} // namespace
+
+LogSearchIndex::Query LogSearchIndex::parseQuery(const QString &input, bool regex)
+{
+    Query query;
+    query.regex = regex;
+    QStringList rest;
+    const QStringList parts = input.split(' ', Qt::SkipEmptyParts);
+    for (const QString &part : parts) {
+        if (part.startsWith("tag:") && part.size() > 4 && query.tag.isEmpty()) {
+            query.tag = part.mid(4).toUtf8();
+        } else if (part.startsWith("pid:") && query.pid < 0) {
+            bool ok = false;
+            const int pid = part.mid(4).toInt(&ok);
+            if (ok)
+                query.pid = pid;
+            else
+                rest << part;
+        } else {
+            rest << part;
+        }
+    }
+    query.text = rest.join(' ');
+    return query;
+}
+
+void LogSearchIndex::onAppended(const LogStore &store, quint64 fromSeq, quint64 toSeq)
+{
+    if (m_blocks.empty())
+        m_firstBlock = fromSeq / BlockLines;
+
+    for (quint64 seq = fromSeq; seq < toSeq; ++seq) {
+        const quint64 block = seq / BlockLines;
+        while (m_firstBlock + m_blocks.size() <= block)
+            m_blocks.emplace_back();
+        const LogRecord record = store.bySeq(seq);
+        addTrigrams(record.data(), record.size(), m_blocks[block - m_firstBlock]);
+    }
+}
+
+void LogSearchIndex::onDropped(quint64 firstSeq)
+{
+    // 只丢弃完全在 firstSeq 之前的块
+    while (!m_blocks.empty() && (m_firstBlock + 1) * BlockLines <= firstSeq) {
+        m_blocks.pop_front();
+        ++m_firstBlock;
+    }
+}
+
+void LogSearchIndex::clear()
+{
+    m_blocks.clear();
+    m_firstBlock = 0;
+}
+
+bool LogSearchIndex::search(const LogStore &store, const Query &query, std::vector<quint64> &hits, QString *error) const
+{
+    // 命中行中必然出现的字面量，用于按块排除
+    QList<QByteArray> literals;
+    QByteArray needle;
+    QRegularExpression re;
+    if (query.regex && !query.text.isEmpty()) {
+        re = QRegularExpression(query.text, QRegularExpression::CaseInsensitiveOption);
+        if (!re.isValid()) {
+            if (error)
+                *error = re.errorString();
+            return false;
+        }
+        literals = regexLiterals(re);
+    } else {
+        needle = LogFilterEngine::foldNeedle(query.text);
+        literals.append(needle);
+    }
+    if (!query.tag.isEmpty())
+        literals.append(query.tag.toLower());
+
+    std::vector<int> bits;
+    for (const QByteArray &literal : literals)
+        queryTrigrams(literal, bits);
+
+    // TAG 在存储中是驻留编号，从未出现过的 TAG 不会有命中
+    const qint64 tagId = query.tag.isEmpty() ? 0 : store.tags().find(query.tag);
+    if (tagId < 0)
+        return true;
+
+    const quint64 from = store.firstSeq();
+    const quint64 to = store.endSeq();
+    for (quint64 block = qMax(m_firstBlock, from / BlockLines);
+         block < m_firstBlock + m_blocks.size() && block * BlockLines < to; ++block) {
+        const Signature &signature = m_blocks[block - m_firstBlock];
+        bool candidate = true;
+        for (int bit : bits) {
+            if (!((signature.words[bit >> 6] >> (bit & 63)) & 1)) {
+                candidate = false;
+                break;
+            }
+        }
+        if (!candidate)
+            continue;
+
+        const quint64 end = qMin(to, (block + 1) * BlockLines);
+        for (quint64 seq = qMax(from, block * BlockLines); seq < end; ++seq) {
+            const LogRecord record = store.bySeq(seq);
+            const PackedLogRecord &meta = *record.packed;
+            if (meta.level < query.minLevel)
+                continue;
+            if (query.pid >= 0 && meta.pid != query.pid)
+                continue;
+            if (!query.tag.isEmpty() && meta.tagId != quint32(tagId))
+                continue;
+            if (query.regex) {
+                if (!query.text.isEmpty() && !re.match(record.text()).hasMatch())
+                    continue;
+            } else if (!LogFilterEngine::recordMatches(record, needle)) {
+                continue;
+            }
+            hits.push_back(seq);
+        }
+    }
+    return true;
+}
+
+void LogSearchIndex::addTrigrams(const char *data, qsizetype length, Signature &signature)
+{
+    if (length < 3)
+        return;
+    quint32 trigram = (lowerByte(data[0]) << 8) | lowerByte(data[1]);
+    for (qsizetype i = 2; i < length; ++i) {
+        trigram = ((trigram << 8) | lowerByte(data[i])) & 0xFFFFFF;
+        const int bit = trigramBit(trigram);
+        signature.words[bit >> 6] |= quint64(1) << (bit & 63);
+    }
+}
+
+void LogSearchIndex::queryTrigrams(const QByteArray &lowerLiteral, std::vector<int> &bits)
+{
+    for (qsizetype i = 0; i + 3 <= lowerLiteral.size(); ++i) {
+        const quint32 trigram = (quint32(quint8(lowerLiteral[i])) << 16)
+                | (quint32(quint8(lowerLiteral[i + 1])) << 8) | quint32(quint8(lowerLiteral[i + 2]));
+        bits.push_back(trigramBit(trigram));
+    }
+}
+
+// 从正则中提取每个匹配都必须包含的 ASCII 字面量（保守：拿不准的部分一律不算）
+QList<QByteArray> LogSearchIndex::regexLiterals(const QRegularExpression &re)
+{
+    QList<QByteArray> literals;
+    // 扩展语法下空白和 # 之后的内容不是字面量
+    if (re.patternOptions() & QRegularExpression::ExtendedPatternSyntaxOption)
+        return literals;
+    const QByteArray p = re.pattern().toUtf8();
+    const qsizetype n = p.size();
+
+    // 顶层或分组中含有分支时必须出现的内容无法简单确定，不做预过滤；
+    // 内联选项 (?x) (?-i) 等和注释 (?#...) 改变其后内容的含义，同样不做
+    for (qsizetype i = 0; i < n; ++i) {
+        if (p[i] == '\\')
+            ++i;
+        else if (p[i] == '|')
+            return literals;
+        else if (p[i] == '(' && i + 2 < n && p[i + 1] == '?' && QByteArray("imnsxJU^-#").contains(p[i + 2]))
+            return literals;
+    }
+
+    QByteArray current;
+    auto flush = [&]() {
+        if (current.size() >= 3)
+            literals.append(current.toLower());
+        current.clear();
+    };
+    auto skipBraced = [&](qsizetype &i, char open, char close) {
+        if (i + 1 < n && p[i + 1] == open) {
+            while (i < n && p[i] != close)
+                ++i;
+        }
+    };
+
+    for (qsizetype i = 0; i < n; ++i) {
+        const char c = p[i];
+        switch (c) {
+        case '\\': {
+            if (i + 1 >= n)
+                break;
+            const char e = p[++i];
+            if (!isAsciiAlnum(e)) {
+                current += e;           // 转义的普通字符，如 \. \[
+                break;
+            }
+            flush();
+            if (e == 'Q') {             // \Q...\E 之间全部按字面处理
+                while (i + 1 < n && !(p[i + 1] == '\\' && i + 2 < n && p[i + 2] == 'E')) {
+                    const char q = p[++i];
+                    if (quint8(q) >= 0x80)
+                        flush();
+                    else
+                        current += q;
+                }
+                i += 2;
+            } else if (e == 'x' || e == 'o' || e == 'p' || e == 'P' || e == 'g') {
+                skipBraced(i, '{', '}');
+                if (e == 'x' && (i + 1 >= n || p[i + 1] != '{'))
+                    i = qMin(n - 1, i + 2);
+            } else if (e == 'k') {
+                skipBraced(i, '<', '>');
+                skipBraced(i, '{', '}');
+            } else if (e == 'c') {
+                ++i;
+            } else if (e >= '0' && e <= '9') {
+                while (i + 1 < n && p[i + 1] >= '0' && p[i + 1] <= '9')
+                    ++i;
+            }
+            break;
+        }
+        case '?':
+        case '*':
+            if (!current.isEmpty())
+                current.chop(1);    // 前一个字符可以不出现
+            flush();
+            break;
+        case '{':
+            if (!current.isEmpty())
+                current.chop(1);
+            flush();
+            while (i < n && p[i] != '}')
+                ++i;
+            break;
+        case '[':
+            flush();
+            ++i;
+            if (i < n && p[i] == '^')
+                ++i;
+            if (i < n && p[i] == ']')
+                ++i;
+            while (i < n && p[i] != ']') {
+                if (p[i] == '\\')
+                    ++i;
+                ++i;
+            }
+            break;
+        case '(': {
+            // 分组可能带量词，整体跳过
+            flush();
+            int depth = 0;
+            for (; i < n; ++i) {
+                if (p[i] == '\\')
+                    ++i;
+                else if (p[i] == '(')
+                    ++depth;
+                else if (p[i] == ')' && --depth == 0)
+                    break;
+            }
+            break;
+        }
+        case '.':
+        case '^':
+        case '$':
+        case ')':
+        case '+':
+            flush();
+            break;
+        default:
+            if (quint8(c) >= 0x80)
+                flush();
+            else
+                current += c;
+            break;
+        }
+    }
+    flush();
+    return literals;
+}
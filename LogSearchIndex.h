@@ -0,0 +1,58 @@
+#ifndef LOGSEARCHINDEX_H
+#define LOGSEARCHINDEX_H
+
+#include <QString>
+#include <QByteArray>
+#include <QVector>
+#include <deque>
+#include <vector>
+#include "LogStore.h"
+
+class QRegularExpression;
+
+// 全文搜索索引（按块的 trigram 签名）
+// 记录按序号每 BlockLines 条分为一块，块内所有行的小写 3 字节片段散列到一张 SignatureBits 位的签名中。
+// 查询时先用查询串（或正则中必须出现的字面量）的 trigram 排除不可能命中的块，只逐行校验剩余块。
+// 索引随记录追加增量更新，随 LogStore 丢弃最旧记录而丢弃整块；1000 万行约占 80MB。
+class LogSearchIndex
+{
+public:
+    static constexpr int BlockLines = 64;
+    static constexpr int SignatureBits = 4096;
+
+    struct Query {
+        QString text;                   // 子串（不区分大小写）或正则
+        bool regex = false;
+        QByteArray tag;                 // 为空表示不限
+        qint32 pid = -1;                // < 0 表示不限
+        int minLevel = 0;
+    };
+
+    // 解析搜索框输入："tag:<TAG> pid:<PID> 其余文本"，前缀可省略、顺序任意
+    static Query parseQuery(const QString &input, bool regex);
+
+    // store 新追加了 [fromSeq, toSeq) 后调用
+    void onAppended(const LogStore &store, quint64 fromSeq, quint64 toSeq);
+    // store 丢弃了 firstSeq 之前的记录后调用
+    void onDropped(quint64 firstSeq);
+    void clear();
+
+    // 按序号升序返回命中记录，正则无效时返回 false
+    bool search(const LogStore &store, const Query &query, std::vector<quint64> &hits, QString *error = nullptr) const;
+
+    qint64 memoryBytes() const { return qint64(m_blocks.size()) * qint64(sizeof(Signature)); }
+
+private:
+    struct Signature {
+        quint64 words[SignatureBits / 64] = {};
+    };
+
+    static void addTrigrams(const char *data, qsizetype length, Signature &signature);
+    static void queryTrigrams(const QByteArray &lowerLiteral, std::vector<int> &bits);
+    static QList<QByteArray> regexLiterals(const QRegularExpression &re);
+
+    std::deque<Signature> m_blocks;
+    quint64 m_firstBlock = 0;           // m_blocks[0] 对应的块号
+};
+
+#endif // LOGSEARCHINDEX_H
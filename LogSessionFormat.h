@@ -0,0 +1,92 @@
+#ifndef LOGSESSIONFORMAT_H
+#define LOGSESSIONFORMAT_H
+
+#include <QtGlobal>
+
+// 会话文件（.fdl）格式，与原始 .txt 日志同时写出，按小端字节序存放
+//
+//   SessionFileHeader
+//   记录流：SessionRecordHeader + 行字节（补齐到 8 字节）……
+//   块索引：SessionChunkIndex × chunkCount（每 chunkRecords 条记录一项）
+//   SessionFileFooter
+//
+// 块索引是稀疏索引：记录每块的文件偏移、时间范围、级别掩码以及 TAG/PID 的布隆位，
+// 查找时间或按 TAG/PID/级别过滤时只需访问可能命中的块。
+// 抓取异常中断时没有索引和尾部，读取端会顺序扫描记录流重建索引。
+
+static const char SESSION_FILE_MAGIC[4] = {'F', 'D', 'L', 'S'};
+static const char SESSION_INDEX_MAGIC[4] = {'F', 'D', 'L', 'I'};
+static const quint32 SESSION_FILE_VERSION = 1;
+static const quint32 SESSION_CHUNK_RECORDS = 256;
+
+struct SessionFileHeader {
+    char magic[4];
+    quint32 version;
+    quint32 chunkRecords;
+    quint32 reserved;
+};
+
+struct SessionRecordHeader {
+    qint64 timeMs;              // 设备时间戳，无则 -1
+    qint32 pid;
+    qint32 tid;
+    quint32 length;             // 行字节数
+    quint32 messageOffset;
+    quint16 tagOffset;
+    quint16 tagLength;
+    quint8 level;
+    quint8 format;
+    quint16 reserved;
+};
+
+struct SessionChunkIndex {
+    quint64 offset;             // 块内第一条记录的文件偏移
+    quint64 firstRecord;
+    qint64 minTimeMs;           // 块内最小设备时间，块内无时间戳时为 -1
+    qint64 maxTimeMs;           // 截至本块的累计最大设备时间（单调不减，用于二分查找）
+    quint64 tagBloom;
+    quint64 pidBloom;
+    quint32 recordCount;
+    quint32 levelMask;          // 第 n 位表示块内存在级别 n
+};
+
+struct SessionFileFooter {
+    quint64 indexOffset;
+    quint64 recordCount;
+    quint32 chunkCount;
+    char magic[4];
+};
+
+static_assert(sizeof(SessionFileHeader) == 16, "unexpected session header size");
+static_assert(sizeof(SessionRecordHeader) == 32, "unexpected session record size");
+static_assert(sizeof(SessionChunkIndex) == 56, "unexpected session index size");
+static_assert(sizeof(SessionFileFooter) == 24, "unexpected session footer size");
+
+// 记录占用的字节数（头 + 行，补齐到 8 字节）
+inline quint64 sessionRecordSize(quint32 length)
+{
+    return sizeof(SessionRecordHeader) + ((quint64(length) + 7) & ~quint64(7));
+}
+
+// 布隆位：每个值置 64 位中的两位
+inline quint64 sessionBloomBits(quint64 hash)
+{
+    return (quint64(1) << (hash & 63)) | (quint64(1) << ((hash >> 6) & 63));
+}
+
+inline quint64 sessionTagHash(const char *tag, qsizetype length)
+{
+    quint64 hash = 14695981039346656037ULL;      // FNV-1a
+    for (qsizetype i = 0; i < length; ++i) {
+        hash ^= quint8(tag[i]);
+        hash *= 1099511628211ULL;
+    }
+    return hash;
+}
+
+inline quint64 sessionPidHash(qint32 pid)
+{
+    return quint64(quint32(pid)) * 0x9E3779B97F4A7C15ULL >> 20;
+}
+
+#endif // LOGSESSIONFORMAT_H
@@ -0,0 +1,285 @@
+#include "LogSessionReader.h"
+#include <cstring>
+
+namespace {
+
+// 记录头中的字段必须落在行内；级别用作 32 位掩码的位号
+bool validRecord(const SessionRecordHeader *h)
+{
+    return h->level < 32
+            && quint32(h->tagOffset) + h->tagLength <= h->length
+            && h->messageOffset <= h->length;
+}
+
+} // namespace
+
+LogSessionReader::~LogSessionReader()
+{
+    close();
+}
+
+bool LogSessionReader::open(const QString &fileName, QString *error)
+{
+    close();
+
+    m_file.setFileName(fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = m_file.errorString();
+        return false;
+    }
+
+    m_size = quint64(m_file.size());
+    if (m_size < sizeof(SessionFileHeader)) {
+        if (error)
+            *error = "文件太小，不是会话文件";
+        close();
+        return false;
+    }
+    m_map = m_file.map(0, qint64(m_size));
+    if (!m_map) {
+        if (error)
+            *error = m_file.errorString();
+        close();
+        return false;
+    }
+
+    const SessionFileHeader *header = reinterpret_cast<const SessionFileHeader *>(m_map);
+    if (memcmp(header->magic, SESSION_FILE_MAGIC, 4) != 0 || header->version != SESSION_FILE_VERSION
+            || header->chunkRecords == 0) {
+        if (error)
+            *error = "不支持的会话文件格式";
+        close();
+        return false;
+    }
+    m_chunkRecords = header->chunkRecords;
+
+    // 正常关闭的文件直接使用尾部的块索引；索引与文件对不上（文件损坏）时同样按扫描重建
+    if (m_size >= sizeof(SessionFileHeader) + sizeof(SessionFileFooter) && loadIndex())
+        return true;
+
+    // 抓取中断的文件：顺序扫描一遍重建索引
+    return rebuildIndex();
+}
+
+void LogSessionReader::close()
+{
+    if (m_map)
+        m_file.unmap(const_cast<uchar *>(m_map));
+    m_file.close();
+    m_map = nullptr;
+    m_size = 0;
+    m_recordsEnd = 0;
+    m_chunks = nullptr;
+    m_chunkCount = 0;
+    m_recordCount = 0;
+    m_rebuilt.clear();
+    for (OffsetCache &cache : m_cache) {
+        cache.chunk = ~quint64(0);
+        cache.offsets.clear();
+    }
+}
+
+LogSessionReader::Record LogSessionReader::record(quint64 index) const
+{
+    Record rec;
+    if (index >= m_recordCount)
+        return rec;
+
+    // 块内遇到损坏的记录时偏移表在此截止，之后的记录不可访问
+    const std::vector<quint64> &offsets = chunkOffsets(index / m_chunkRecords);
+    if (index % m_chunkRecords >= offsets.size())
+        return rec;
+    const quint64 offset = offsets[index % m_chunkRecords];
+    rec.header = reinterpret_cast<const SessionRecordHeader *>(m_map + offset);
+    rec.line = reinterpret_cast<const char *>(m_map + offset + sizeof(SessionRecordHeader));
+    return rec;
+}
+
+quint64 LogSessionReader::findTime(qint64 timeMs) const
+{
+    // maxTimeMs 是累计最大值，设备时间偶有回跳也能二分
+    quint64 lo = 0, hi = m_chunkCount;
+    while (lo < hi) {
+        const quint64 mid = (lo + hi) / 2;
+        if (m_chunks[mid].maxTimeMs < timeMs)
+            lo = mid + 1;
+        else
+            hi = mid;
+    }
+    if (lo >= m_chunkCount)
+        return m_recordCount;
+
+    const quint64 first = m_chunks[lo].firstRecord;
+    const quint64 end = first + m_chunks[lo].recordCount;
+    for (quint64 i = first; i < end; ++i) {
+        const Record rec = record(i);
+        if (!rec.header)
+            break;
+        if (rec.header->timeMs >= timeMs)
+            return i;
+    }
+    return end < m_recordCount ? end : m_recordCount;
+}
+
+void LogSessionReader::select(int minLevel, const QByteArray &tag, qint32 pid, std::vector<quint64> &out) const
+{
+    quint32 levelMask = 0;
+    for (int level = qMax(0, minLevel); level < 32; ++level)
+        levelMask |= 1u << level;
+    const quint64 tagBits = tag.isEmpty() ? 0 : sessionBloomBits(sessionTagHash(tag.constData(), tag.size()));
+    const quint64 pidBits = pid < 0 ? 0 : sessionBloomBits(sessionPidHash(pid));
+
+    for (quint64 c = 0; c < m_chunkCount; ++c) {
+        const SessionChunkIndex &chunk = m_chunks[c];
+        if (!(chunk.levelMask & levelMask))
+            continue;
+        if ((chunk.tagBloom & tagBits) != tagBits || (chunk.pidBloom & pidBits) != pidBits)
+            continue;
+
+        for (quint64 i = chunk.firstRecord; i < chunk.firstRecord + chunk.recordCount; ++i) {
+            const Record rec = record(i);
+            const SessionRecordHeader *h = rec.header;
+            if (!h)
+                break;
+            if (h->level < minLevel)
+                continue;
+            if (pid >= 0 && h->pid != pid)
+                continue;
+            if (!tag.isEmpty() && (h->tagLength != tag.size()
+                                   || memcmp(rec.line + h->tagOffset, tag.constData(), size_t(tag.size())) != 0))
+                continue;
+            out.push_back(i);
+        }
+    }
+}
+
+bool LogSessionReader::rebuildIndex()
+{
+    m_rebuilt.clear();
+    quint64 offset = sizeof(SessionFileHeader);
+    quint64 recordIndex = 0;
+    qint64 maxTimeMs = -1;
+    SessionChunkIndex chunk;
+
+    auto resetChunk = [&chunk]() {
+        memset(&chunk, 0, sizeof(chunk));
+        chunk.minTimeMs = -1;
+        chunk.maxTimeMs = -1;
+    };
+    resetChunk();
+
+    while (offset + sizeof(SessionRecordHeader) <= m_size) {
+        const SessionRecordHeader *h = reinterpret_cast<const SessionRecordHeader *>(m_map + offset);
+        const quint64 size = sessionRecordSize(h->length);
+        if (offset + size > m_size || !validRecord(h))
+            break;      // 最后一条只写了一半，或从这里开始内容已损坏
+
+        if (chunk.recordCount == 0) {
+            chunk.offset = offset;
+            chunk.firstRecord = recordIndex;
+        }
+        if (h->timeMs >= 0) {
+            if (chunk.minTimeMs < 0 || h->timeMs < chunk.minTimeMs)
+                chunk.minTimeMs = h->timeMs;
+            maxTimeMs = qMax(maxTimeMs, h->timeMs);
+        }
+        chunk.levelMask |= 1u << h->level;
+        if (h->tagLength > 0) {
+            const char *line = reinterpret_cast<const char *>(h + 1);
+            chunk.tagBloom |= sessionBloomBits(sessionTagHash(line + h->tagOffset, h->tagLength));
+        }
+        if (h->pid >= 0)
+            chunk.pidBloom |= sessionBloomBits(sessionPidHash(h->pid));
+
+        offset += size;
+        ++recordIndex;
+        if (++chunk.recordCount >= m_chunkRecords) {
+            chunk.maxTimeMs = maxTimeMs;
+            m_rebuilt.push_back(chunk);
+            resetChunk();
+        }
+    }
+    if (chunk.recordCount > 0) {
+        chunk.maxTimeMs = maxTimeMs;
+        m_rebuilt.push_back(chunk);
+    }
+
+    m_chunks = m_rebuilt.data();
+    m_chunkCount = m_rebuilt.size();
+    m_recordCount = recordIndex;
+    m_recordsEnd = offset;
+    return true;
+}
+
+// 校验尾部和块索引：索引必须紧接在记录流之后；各块按顺序覆盖全部记录，除最后一块外
+// 每块恰好 chunkRecords 条（record() 按下标直接算块号），块的起点和最少字节数都落在记录流内
+// 块内各条记录在首次访问时（chunkOffsets）再逐条校验，打开时不必读遍整个文件
+bool LogSessionReader::loadIndex()
+{
+    // 完整的文件各部分都按 8 字节对齐，长度不是 8 的倍数时必然被截断过
+    if (m_size % 8 != 0)
+        return false;
+    const SessionFileFooter *footer = reinterpret_cast<const SessionFileFooter *>(
+                m_map + m_size - sizeof(SessionFileFooter));
+    if (memcmp(footer->magic, SESSION_INDEX_MAGIC, 4) != 0)
+        return false;
+
+    const quint64 indexOffset = footer->indexOffset;
+    const quint64 indexBytes = quint64(footer->chunkCount) * sizeof(SessionChunkIndex);
+    if (indexOffset < sizeof(SessionFileHeader) || indexOffset % 8 != 0
+            || indexOffset > m_size - sizeof(SessionFileFooter)
+            || indexBytes != m_size - sizeof(SessionFileFooter) - indexOffset)
+        return false;
+
+    const quint64 recordBytes = indexOffset - sizeof(SessionFileHeader);
+    if (footer->recordCount > recordBytes / sizeof(SessionRecordHeader))
+        return false;
+
+    const SessionChunkIndex *chunks = reinterpret_cast<const SessionChunkIndex *>(m_map + indexOffset);
+    quint64 records = 0;
+    for (quint32 c = 0; c < footer->chunkCount; ++c) {
+        const SessionChunkIndex &chunk = chunks[c];
+        const bool last = c + 1 == footer->chunkCount;
+        if (chunk.firstRecord != records || chunk.recordCount == 0 || chunk.recordCount > m_chunkRecords
+                || (!last && chunk.recordCount != m_chunkRecords)
+                || chunk.offset < sizeof(SessionFileHeader) || chunk.offset % 8 != 0 || chunk.offset >= indexOffset
+                || quint64(chunk.recordCount) * sizeof(SessionRecordHeader) > indexOffset - chunk.offset)
+            return false;
+        records += chunk.recordCount;
+    }
+    if (records != footer->recordCount)
+        return false;
+
+    m_chunks = chunks;
+    m_chunkCount = footer->chunkCount;
+    m_recordCount = footer->recordCount;
+    m_recordsEnd = indexOffset;
+    return true;
+}
+
+const std::vector<quint64> &LogSessionReader::chunkOffsets(quint64 chunkIndex) const
+{
+    for (const OffsetCache &cache : m_cache)
+        if (cache.chunk == chunkIndex)
+            return cache.offsets;
+
+    OffsetCache &cache = m_cache[m_cacheNext];
+    m_cacheNext = (m_cacheNext + 1) % 4;
+    cache.chunk = chunkIndex;
+    cache.offsets.clear();
+
+    const SessionChunkIndex &chunk = m_chunks[chunkIndex];
+    quint64 offset = chunk.offset;
+    for (quint32 i = 0; i < chunk.recordCount; ++i) {
+        if (offset > m_recordsEnd || m_recordsEnd - offset < sizeof(SessionRecordHeader))
+            break;
+        const SessionRecordHeader *h = reinterpret_cast<const SessionRecordHeader *>(m_map + offset);
+        const quint64 size = sessionRecordSize(h->length);
+        if (size > m_recordsEnd - offset || !validRecord(h))
+            break;
+        cache.offsets.push_back(offset);
+        offset += size;
+    }
+    return cache.offsets;
+}
@@ -0,0 +1,65 @@
+#ifndef LOGSESSIONREADER_H
+#define LOGSESSIONREADER_H
+
+#include <QFile>
+#include <QByteArray>
+#include <vector>
+#include "LogSessionFormat.h"
+
+// 会话文件读取：整体内存映射，打开时只读取尾部和块索引，记录按需从映射中访问，
+// 滚动、按时间定位、按 TAG/PID/级别过滤都只会触及相关的页
+class LogSessionReader
+{
+public:
+    struct Record {
+        const SessionRecordHeader *header = nullptr;
+        const char *line = nullptr;
+    };
+
+    LogSessionReader() = default;
+    ~LogSessionReader();
+
+    bool open(const QString &fileName, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return m_map != nullptr; }
+    QString fileName() const { return m_file.fileName(); }
+
+    quint64 recordCount() const { return m_recordCount; }
+    int chunkCount() const { return int(m_chunkCount); }
+    const SessionChunkIndex &chunk(int index) const { return m_chunks[index]; }
+
+    Record record(quint64 index) const;
+
+    // 第一条设备时间 >= timeMs 的记录，找不到返回 recordCount()
+    quint64 findTime(qint64 timeMs) const;
+
+    // 过滤：级别 >= minLevel，tag 为空表示不限，pid < 0 表示不限
+    // 只遍历索引显示可能命中的块，命中记录的下标追加到 out
+    void select(int minLevel, const QByteArray &tag, qint32 pid, std::vector<quint64> &out) const;
+
+private:
+    bool loadIndex();
+    bool rebuildIndex();
+    const std::vector<quint64> &chunkOffsets(quint64 chunkIndex) const;
+
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    quint64 m_size = 0;
+    quint64 m_recordsEnd = 0;             // 记录流的结束位置（块索引的起点）
+    quint32 m_chunkRecords = SESSION_CHUNK_RECORDS;
+    quint64 m_recordCount = 0;
+
+    const SessionChunkIndex *m_chunks = nullptr;
+    quint64 m_chunkCount = 0;
+    std::vector<SessionChunkIndex> m_rebuilt;     // 文件没有索引时在内存中重建
+
+    // 最近访问的几个块内记录偏移
+    struct OffsetCache {
+        quint64 chunk = ~quint64(0);
+        std::vector<quint64> offsets;
+    };
+    mutable OffsetCache m_cache[4];
+    mutable int m_cacheNext = 0;
+};
+
+#endif // LOGSESSIONREADER_H
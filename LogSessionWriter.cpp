@@ -0,0 +1,119 @@
+#include "LogSessionWriter.h"
+#include <cstring>
+
+LogSessionWriter::LogSessionWriter()
+{
+    beginChunk();
+}
+
+LogSessionWriter::~LogSessionWriter()
+{
+    close();
+}
+
+bool LogSessionWriter::open(const QString &fileName)
+{
+    close();
+    if (!m_writer.open(fileName))
+        return false;
+
+    SessionFileHeader header;
+    memcpy(header.magic, SESSION_FILE_MAGIC, 4);
+    header.version = SESSION_FILE_VERSION;
+    header.chunkRecords = SESSION_CHUNK_RECORDS;
+    header.reserved = 0;
+    m_writer.write(reinterpret_cast<const char *>(&header), sizeof(header));
+
+    m_offset = sizeof(header);
+    m_recordCount = 0;
+    m_maxTimeMs = -1;
+    m_index.clear();
+    beginChunk();
+    return true;
+}
+
+void LogSessionWriter::close()
+{
+    if (!m_writer.isOpen())
+        return;
+
+    finishChunk();
+
+    SessionFileFooter footer;
+    footer.indexOffset = m_offset;
+    footer.recordCount = m_recordCount;
+    footer.chunkCount = quint32(m_index.size());
+    memcpy(footer.magic, SESSION_INDEX_MAGIC, 4);
+
+    m_writer.write(reinterpret_cast<const char *>(m_index.constData()),
+                   qsizetype(m_index.size()) * qsizetype(sizeof(SessionChunkIndex)));
+    m_writer.write(reinterpret_cast<const char *>(&footer), sizeof(footer));
+    m_writer.close();
+    m_index.clear();
+}
+
+void LogSessionWriter::append(const LogBlock &block)
+{
+    if (!m_writer.isOpen())
+        return;
+
+    static const char padding[8] = {0};
+    for (const LogBlock::Line &line : block.lines) {
+        const LogLine &meta = line.meta;
+        const char *bytes = block.data.constData() + line.offset;
+
+        SessionRecordHeader header;
+        header.timeMs = meta.timeMs;
+        header.pid = meta.pid;
+        header.tid = meta.tid;
+        header.length = line.length;
+        header.messageOffset = meta.messageOffset;
+        header.tagOffset = meta.tagOffset;
+        header.tagLength = meta.tagLength;
+        header.level = meta.level;
+        header.format = meta.format;
+        header.reserved = 0;
+
+        const quint64 size = sessionRecordSize(line.length);
+        m_writer.write(reinterpret_cast<const char *>(&header), sizeof(header));
+        m_writer.write(bytes, line.length);
+        m_writer.write(padding, qsizetype(size - sizeof(header) - line.length));
+
+        // 更新当前块的稀疏索引
+        if (m_chunk.recordCount == 0) {
+            m_chunk.offset = m_offset;
+            m_chunk.firstRecord = m_recordCount;
+        }
+        if (meta.timeMs >= 0) {
+            if (m_chunk.minTimeMs < 0 || meta.timeMs < m_chunk.minTimeMs)
+                m_chunk.minTimeMs = meta.timeMs;
+            m_maxTimeMs = qMax(m_maxTimeMs, meta.timeMs);
+        }
+        m_chunk.levelMask |= 1u << meta.level;
+        if (meta.tagLength > 0)
+            m_chunk.tagBloom |= sessionBloomBits(sessionTagHash(bytes + meta.tagOffset, meta.tagLength));
+        if (meta.pid >= 0)
+            m_chunk.pidBloom |= sessionBloomBits(sessionPidHash(meta.pid));
+
+        m_offset += size;
+        ++m_recordCount;
+        if (++m_chunk.recordCount >= SESSION_CHUNK_RECORDS)
+            finishChunk();
+    }
+}
+
+void LogSessionWriter::beginChunk()
+{
+    memset(&m_chunk, 0, sizeof(m_chunk));
+    m_chunk.minTimeMs = -1;
+    m_chunk.maxTimeMs = -1;
+}
+
+void LogSessionWriter::finishChunk()
+{
+    if (m_chunk.recordCount > 0) {
+        m_chunk.maxTimeMs = m_maxTimeMs;
+        m_index.append(m_chunk);
+    }
+    beginChunk();
+}
@@ -0,0 +1,35 @@
+#ifndef LOGSESSIONWRITER_H
+#define LOGSESSIONWRITER_H
+
+#include <QVector>
+#include "LogRecord.h"
+#include "LogFileWriter.h"
+#include "LogSessionFormat.h"
+
+// 会话文件写入：把解析好的 LogBlock 追加为二进制记录，关闭时写入块索引
+class LogSessionWriter
+{
+public:
+    LogSessionWriter();
+    ~LogSessionWriter();
+
+    bool open(const QString &fileName);
+    void close();
+    bool isOpen() const { return m_writer.isOpen(); }
+
+    void append(const LogBlock &block);
+    void flushIfDue() { m_writer.flushIfDue(); }
+
+private:
+    void beginChunk();
+    void finishChunk();
+
+    LogFileWriter m_writer;
+    quint64 m_offset = 0;                 // 当前文件写入位置
+    quint64 m_recordCount = 0;
+    qint64 m_maxTimeMs = -1;              // 累计最大设备时间
+    SessionChunkIndex m_chunk;            // 正在累积的块
+    QVector<SessionChunkIndex> m_index;
+};
+
+#endif // LOGSESSIONWRITER_H
@@ -0,0 +1,161 @@
+#include "LogStore.h"
+#include <QtGlobal>
+#include <climits>
+#include <cstring>
+
+LogStore::LogStore(int capacity)
+    : m_capacity(qMax(1, capacity))
+{
+}
+
+void LogStore::dropOldest(int count)
+{
+    m_firstSeq += quint64(qBound(0, count, size()));
+    releaseChunks();
+}
+
+void LogStore::append(const LogBlock &block, int firstLine)
+{
+    if (m_tags.count() >= m_compactTagsAt || m_sources.count() >= m_compactSourcesAt)
+        compactStrings();
+    const quint16 sourceId = sourceIdFor(block.source);
+    const char *blockData = block.data.constData();
+
+    for (int i = qMax(0, firstLine); i < block.lines.size(); ++i) {
+        const LogBlock::Line &line = block.lines[i];
+        const LogLine &meta = line.meta;
+        const char *bytes = blockData + line.offset;
+
+        PackedLogRecord packed;
+        packed.timeMs = meta.timeMs;
+        packed.receivedUs = line.receivedUs;
+        packed.length = line.length;
+        packed.pid = meta.pid;
+        packed.tid = meta.tid;
+        packed.tagId = meta.tagLength > 0 ? m_tags.intern(bytes + meta.tagOffset, meta.tagLength) : 0;
+        packed.messageOffset = meta.messageOffset;
+        packed.sourceId = sourceId;
+        packed.level = meta.level;
+        packed.format = meta.format;
+        store(bytes, line.length, packed.chunk, packed.offset);
+
+        // 首轮写入时 seq 与下标一致，直接 push_back；之后按 seq 取模覆盖
+        if (m_records.size() < size_t(m_capacity))
+            m_records.push_back(packed);
+        else
+            m_records[m_endSeq % m_capacity] = packed;
+        ++m_endSeq;
+    }
+}
+
+// 行不跨块：当前块放不下时开新块，超长的行单独占一块
+void LogStore::store(const char *data, quint32 length, quint32 &chunk, quint32 &offset)
+{
+    if (m_chunks.empty() || m_chunks.back().size - m_chunks.back().used < length) {
+        Chunk next;
+        if (m_spare.bytes && m_spare.size >= length) {
+            next = std::move(m_spare);
+            next.used = 0;
+            m_spare = Chunk();
+        } else {
+            next.size = qMax<quint32>(ArenaChunkBytes, length);
+            next.bytes.reset(new char[next.size]);
+        }
+        if (m_chunks.empty())
+            m_firstChunk = 0;
+        m_chunks.push_back(std::move(next));
+    }
+
+    Chunk &current = m_chunks.back();
+    if (length > 0)
+        memcpy(current.bytes.get() + current.used, data, length);
+    chunk = m_firstChunk + quint32(m_chunks.size() - 1);
+    offset = current.used;
+    current.used += length;
+}
+
+// 回收最旧记录之前的字节池块；最后一块仍在写入，不回收
+void LogStore::releaseChunks()
+{
+    const quint32 needed = isEmpty() ? m_firstChunk + quint32(m_chunks.size()) - 1
+                                     : m_records[m_firstSeq % m_capacity].chunk;
+    while (m_chunks.size() > 1 && m_firstChunk < needed) {
+        Chunk &front = m_chunks.front();
+        if (front.size == ArenaChunkBytes && !m_spare.bytes)
+            m_spare = std::move(front);
+        m_chunks.pop_front();
+        ++m_firstChunk;
+    }
+}
+
+quint16 LogStore::sourceIdFor(const QString &source)
+{
+    const QByteArray name = source.toUtf8();
+    const qint64 known = m_sources.find(name);
+    if (known >= 0)
+        return quint16(known);
+    if (m_sources.count() >= OverflowSourceId)
+        return OverflowSourceId;
+    return quint16(m_sources.intern(name));
+}
+
+QByteArray LogStore::sourceName(quint16 sourceId) const
+{
+    if (sourceId == OverflowSourceId || sourceId >= m_sources.count())
+        return "?";
+    return m_sources.value(sourceId);
+}
+
+// 按仍在存储中的记录重建驻留池（不再被引用的 TAG 和来源随之释放），并改写记录中的编号
+void LogStore::compactStrings()
+{
+    LogStringPool tags;
+    LogStringPool sources;
+    std::vector<quint32> tagMap(size_t(m_tags.count()), 0);
+    std::vector<quint32> sourceMap(size_t(m_sources.count()), 0);
+    for (quint64 seq = m_firstSeq; seq < m_endSeq; ++seq) {
+        PackedLogRecord &packed = m_records[seq % m_capacity];
+        if (packed.tagId != 0) {
+            quint32 &mapped = tagMap[packed.tagId];
+            if (mapped == 0)
+                mapped = tags.intern(m_tags.data(packed.tagId), m_tags.size(packed.tagId));
+            packed.tagId = mapped;
+        }
+        if (packed.sourceId != 0 && packed.sourceId != OverflowSourceId) {
+            quint32 &mapped = sourceMap[packed.sourceId];
+            if (mapped == 0)
+                mapped = sources.intern(m_sources.data(packed.sourceId), m_sources.size(packed.sourceId));
+            packed.sourceId = quint16(mapped);
+        }
+    }
+    m_tags = std::move(tags);
+    m_sources = std::move(sources);
+    m_compactTagsAt = qMax(MinCompactStrings, m_tags.count() * 2);
+    // 仍在使用的来源超过编号空间的一半时不再整理，之后的新来源记为 OverflowSourceId
+    m_compactSourcesAt = m_sources.count() < OverflowSourceId / 2 ? int(OverflowSourceId) : INT_MAX;
+}
+
+void LogStore::clear()
+{
+    m_records.clear();
+    m_records.shrink_to_fit();
+    m_chunks.clear();
+    m_spare = Chunk();
+    m_firstChunk = 0;
+    m_tags.clear();
+    m_sources.clear();
+    m_compactTagsAt = MinCompactStrings;
+    m_compactSourcesAt = OverflowSourceId;
+    m_firstSeq = m_endSeq = 0;
+}
+
+LogStore::MemoryUsage LogStore::memoryUsage() const
+{
+    MemoryUsage usage;
+    usage.records = qsizetype(m_records.capacity() * sizeof(PackedLogRecord));
+    for (const Chunk &chunk : m_chunks)
+        usage.text += chunk.size;
+    usage.text += m_spare.size;
+    usage.strings = m_tags.memoryUsage() + m_sources.memoryUsage();
+    return usage;
+}
@@ -0,0 +1,116 @@
+#ifndef LOGSTORE_H
+#define LOGSTORE_H
+
+#include <QString>
+#include <deque>
+#include <memory>
+#include <vector>
+#include "LogRecord.h"
+#include "LogStringPool.h"
+
+// 存储中的一条记录：定长 48 字节，按序号紧凑排列，扫描时顺序访问
+// 行文本（UTF-8 原始字节）在字节池中，TAG 和来源是驻留池编号
+struct PackedLogRecord {
+    qint64 timeMs;                // 设备时间戳（年内毫秒），无则 -1
+    qint64 receivedUs;            // 主机接收时间（PipelineStats::nowUs），无则 -1
+    quint32 chunk;                // 文本所在的字节池块号
+    quint32 offset;               // 块内偏移
+    quint32 length;
+    qint32 pid;
+    qint32 tid;
+    quint32 tagId;                // tags() 中的编号，0 表示无 TAG
+    quint32 messageOffset;        // 消息正文相对行首的偏移
+    quint16 sourceId;             // sources() 中的编号，0 表示本地提示信息，OverflowSourceId 表示来源过多未能记录
+    quint8 level;                 // LEVELS 下标
+    quint8 format;                // LogLine::Format
+};
+
+static_assert(sizeof(PackedLogRecord) == 48, "unexpected packed record size");
+
+// 一条记录的只读视图，指向 LogStore 内部，存储追加或丢弃记录后不再使用
+struct LogRecord {
+    const PackedLogRecord *packed = nullptr;
+    const char *line = nullptr;
+
+    const char *data() const { return line; }
+    qsizetype size() const { return packed->length; }
+    quint8 level() const { return packed->level; }
+    QString text() const { return QString::fromUtf8(line, size()); }
+};
+
+// 固定容量的日志环形缓冲
+// 每条记录有一个单调递增的序号(seq)，写满后覆盖最旧的记录，内存占用不会无限增长
+//
+// 追加时把日志块中的行拷贝进按块分配的字节池（每块 4MB，行不跨块），记录本身只保存位置；
+// 日志块随后即可释放。最旧的记录被丢弃后，不再被引用的字节池块整块回收
+// TAG / 来源驻留池只增不减，条目数超过上次整理时的两倍后按仍在存储中的记录重建，编号随之改变
+class LogStore
+{
+public:
+    static constexpr int DefaultCapacity = 2000000;
+    static constexpr int ArenaChunkBytes = 4 * 1024 * 1024;
+    static constexpr quint16 OverflowSourceId = 0xFFFF;    // 来源编号用尽（整理后仍超过 16 位）
+    static constexpr int MinCompactStrings = 65536;        // TAG 池至少这么多条目时才整理
+
+    struct MemoryUsage {
+        qsizetype records = 0;            // 定长记录数组
+        qsizetype text = 0;               // 字节池
+        qsizetype strings = 0;            // TAG / 来源驻留池
+        qsizetype total() const { return records + text + strings; }
+    };
+
+    explicit LogStore(int capacity = DefaultCapacity);
+
+    int capacity() const { return m_capacity; }
+    int size() const { return int(m_endSeq - m_firstSeq); }
+    bool isEmpty() const { return m_endSeq == m_firstSeq; }
+
+    quint64 firstSeq() const { return m_firstSeq; }   // 最旧记录的序号
+    quint64 endSeq() const { return m_endSeq; }       // 下一条记录的序号
+
+    // 丢弃最旧的 count 条记录
+    void dropOldest(int count);
+    // 追加块中从 firstLine 开始的各行，调用方保证 size() + 行数 <= capacity()
+    void append(const LogBlock &block, int firstLine = 0);
+    void clear();
+
+    LogRecord at(int row) const { return bySeq(m_firstSeq + row); }    // row 0 为最旧
+    LogRecord bySeq(quint64 seq) const
+    {
+        const PackedLogRecord &packed = m_records[seq % m_capacity];
+        return LogRecord{&packed, m_chunks[packed.chunk - m_firstChunk].bytes.get() + packed.offset};
+    }
+
+    const LogStringPool &tags() const { return m_tags; }
+    const LogStringPool &sources() const { return m_sources; }
+    // 来源名，本地提示信息为空，编号用尽时为 "?"
+    QByteArray sourceName(quint16 sourceId) const;
+    MemoryUsage memoryUsage() const;
+
+private:
+    struct Chunk {
+        std::unique_ptr<char[]> bytes;
+        quint32 size = 0;
+        quint32 used = 0;
+    };
+
+    void store(const char *data, quint32 length, quint32 &chunk, quint32 &offset);
+    void releaseChunks();
+    quint16 sourceIdFor(const QString &source);
+    void compactStrings();
+
+    std::vector<PackedLogRecord> m_records;   // 按需增长，到达容量后循环覆盖
+    int m_capacity;
+    quint64 m_firstSeq = 0;
+    quint64 m_endSeq = 0;
+
+    std::deque<Chunk> m_chunks;           // 字节池，front 的块号为 m_firstChunk
+    quint32 m_firstChunk = 0;
+    Chunk m_spare;                        // 回收的一块，下次分配时复用
+    LogStringPool m_tags;
+    LogStringPool m_sources;
+    int m_compactTagsAt = MinCompactStrings;  // 驻留池条目数达到此值时整理
+    int m_compactSourcesAt = OverflowSourceId;
+};
+
+#endif // LOGSTORE_H
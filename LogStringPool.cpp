@@ -0,0 +1,85 @@
+#include "LogStringPool.h"
+#include <cstring>
+
+LogStringPool::LogStringPool()
+{
+    clear();
+}
+
+// FNV-1a
+quint32 LogStringPool::hash(const char *data, qsizetype length)
+{
+    quint32 h = 2166136261u;
+    for (qsizetype i = 0; i < length; ++i) {
+        h ^= quint8(data[i]);
+        h *= 16777619u;
+    }
+    return h;
+}
+
+qint64 LogStringPool::find(const char *data, qsizetype length) const
+{
+    if (length == 0)
+        return 0;
+    const size_t mask = m_slots.size() - 1;
+    for (size_t i = hash(data, length) & mask;; i = (i + 1) & mask) {
+        const quint32 slot = m_slots[i];
+        if (slot == 0)
+            return -1;
+        const quint32 id = slot - 1;
+        if (size(id) == length && memcmp(this->data(id), data, size_t(length)) == 0)
+            return id;
+    }
+}
+
+quint32 LogStringPool::intern(const char *data, qsizetype length)
+{
+    if (length == 0)
+        return 0;
+
+    size_t mask = m_slots.size() - 1;
+    size_t i = hash(data, length) & mask;
+    for (;; i = (i + 1) & mask) {
+        const quint32 slot = m_slots[i];
+        if (slot == 0)
+            break;
+        const quint32 id = slot - 1;
+        if (size(id) == length && memcmp(this->data(id), data, size_t(length)) == 0)
+            return id;
+    }
+
+    const quint32 id = quint32(count());
+    m_bytes.append(data, length);
+    m_offsets.push_back(quint32(m_bytes.size()));
+    m_slots[i] = id + 1;
+
+    // 装载率超过一半时扩容
+    if (size_t(count()) * 2 > m_slots.size())
+        rehash(m_slots.size() * 2);
+    return id;
+}
+
+void LogStringPool::rehash(size_t slotCount)
+{
+    m_slots.assign(slotCount, 0);
+    const size_t mask = slotCount - 1;
+    for (quint32 id = 1; id < quint32(count()); ++id) {
+        size_t i = hash(data(id), size(id)) & mask;
+        while (m_slots[i] != 0)
+            i = (i + 1) & mask;
+        m_slots[i] = id + 1;
+    }
+}
+
+qsizetype LogStringPool::memoryUsage() const
+{
+    return m_bytes.capacity() + qsizetype(m_offsets.capacity() * sizeof(quint32))
+            + qsizetype(m_slots.capacity() * sizeof(quint32));
+}
+
+void LogStringPool::clear()
+{
+    m_bytes.clear();
+    m_offsets.assign(2, 0);             // 编号 0：空串
+    m_slots.assign(64, 0);
+}
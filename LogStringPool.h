@@ -0,0 +1,39 @@
+#ifndef LOGSTRINGPOOL_H
+#define LOGSTRINGPOOL_H
+
+#include <QByteArray>
+#include <vector>
+
+// 字符串驻留池：相同的字节串只保存一份，以 32 位编号引用（TAG、来源名等重复度很高的短串）
+// 开放寻址哈希表只存编号，字符串连续存放在一块字节数组中；查找不分配内存
+// 编号 0 固定表示空串；编号只增不减，clear() 后全部失效
+class LogStringPool
+{
+public:
+    LogStringPool();
+
+    quint32 intern(const char *data, qsizetype length);
+    quint32 intern(const QByteArray &value) { return intern(value.constData(), value.size()); }
+    // 已有的编号，不存在时返回 -1（不会新增）
+    qint64 find(const char *data, qsizetype length) const;
+    qint64 find(const QByteArray &value) const { return find(value.constData(), value.size()); }
+
+    // 返回的指针在下一次 intern() 前有效
+    const char *data(quint32 id) const { return m_bytes.constData() + m_offsets[id]; }
+    qsizetype size(quint32 id) const { return qsizetype(m_offsets[id + 1] - m_offsets[id]); }
+    QByteArray value(quint32 id) const { return QByteArray(data(id), size(id)); }
+
+    int count() const { return int(m_offsets.size()) - 1; }
+    qsizetype memoryUsage() const;
+    void clear();
+
+private:
+    static quint32 hash(const char *data, qsizetype length);
+    void rehash(size_t slotCount);
+
+    QByteArray m_bytes;                   // 全部字符串首尾相接
+    std::vector<quint32> m_offsets;       // 第 id 个串的起始位置，末尾多一项作为结束位置
+    std::vector<quint32> m_slots;         // 哈希槽：0 为空，否则为 id + 1
+};
+
+#endif // LOGSTRINGPOOL_H
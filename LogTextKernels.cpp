@@ -0,0 +1,385 @@
+#include "LogTextKernels.h"
+#include <QtAlgorithms>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64) || defined(__SSE2__) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LOGTEXT_X86 1
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#define LOGTEXT_AVX2_TARGET
+#else
+#define LOGTEXT_AVX2_TARGET __attribute__((target("avx2")))
+#endif
+#endif
+
+namespace {
+
+// ---------------------------------------------------------------- 逐字节实现
+
+inline bool isBlank(char c)
+{
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+inline char asciiLower(char c)
+{
+    return (c >= 'A' && c <= 'Z') ? char(c + ('a' - 'A')) : c;
+}
+
+// 与 QRegularExpression 默认的 \b 一致：只有 ASCII 字母、数字和 '_' 算单词字符，UTF-8 的多字节字符不算
+inline bool isWordChar(char c)
+{
+    return (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z') || c == '_';
+}
+
+inline bool isLevelChar(char c)
+{
+    return c == 'V' || c == 'D' || c == 'I' || c == 'W' || c == 'E';
+}
+
+// 候选位置 i 处的级别字符是否独立（调用方保证 i + 1 < length）
+inline bool isLevelAt(const char *data, qsizetype i)
+{
+    if (i > 0 && isWordChar(data[i - 1]))
+        return false;
+    const char next = data[i + 1];
+    return next == '/' || isBlank(next);
+}
+
+inline bool equalsLower(const char *data, const char *needle, qsizetype n)
+{
+    for (qsizetype j = 0; j < n; ++j) {
+        if (asciiLower(data[j]) != needle[j])
+            return false;
+    }
+    return true;
+}
+
+const char *findByteScalar(const char *p, const char *end, char c)
+{
+    if (p == end)
+        return end;
+    const void *hit = memchr(p, c, size_t(end - p));
+    return hit ? static_cast<const char *>(hit) : end;
+}
+
+qsizetype findLevelScalar(const char *data, qsizetype length, qsizetype from)
+{
+    for (qsizetype i = from; i + 1 < length; ++i) {
+        if (isLevelChar(data[i]) && isLevelAt(data, i))
+            return i;
+    }
+    return -1;
+}
+
+qsizetype findIgnoreCaseScalar(const char *data, qsizetype length, const char *needle, qsizetype n, qsizetype from)
+{
+    const char first = needle[0];
+    for (qsizetype i = from; i + n <= length; ++i) {
+        if (asciiLower(data[i]) == first && equalsLower(data + i + 1, needle + 1, n - 1))
+            return i;
+    }
+    return -1;
+}
+
+#ifdef LOGTEXT_X86
+
+// ---------------------------------------------------------------- SSE2
+
+inline __m128i lower16(__m128i v)
+{
+    const __m128i upper = _mm_and_si128(_mm_cmpgt_epi8(v, _mm_set1_epi8('A' - 1)),
+                                        _mm_cmplt_epi8(v, _mm_set1_epi8('Z' + 1)));
+    return _mm_or_si128(v, _mm_and_si128(upper, _mm_set1_epi8(0x20)));
+}
+
+inline __m128i blank16(__m128i v)
+{
+    const __m128i t = _mm_sub_epi8(v, _mm_set1_epi8('\t'));
+    const __m128i control = _mm_cmpeq_epi8(_mm_min_epu8(t, _mm_set1_epi8('\r' - '\t')), t);
+    return _mm_or_si128(control, _mm_cmpeq_epi8(v, _mm_set1_epi8(' ')));
+}
+
+const char *findByteSse2(const char *p, const char *end, char c)
+{
+    const __m128i needle = _mm_set1_epi8(c);
+    for (; end - p >= 16; p += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        const unsigned mask = unsigned(_mm_movemask_epi8(_mm_cmpeq_epi8(v, needle)));
+        if (mask)
+            return p + qCountTrailingZeroBits(mask);
+    }
+    return findByteScalar(p, end, c);
+}
+
+void trimSse2(const char *&begin, const char *&end)
+{
+    while (end - begin >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(begin));
+        const unsigned solid = ~unsigned(_mm_movemask_epi8(blank16(v))) & 0xFFFF;
+        if (solid) {
+            begin += qCountTrailingZeroBits(solid);
+            break;
+        }
+        begin += 16;
+    }
+    while (begin < end && isBlank(*begin))
+        ++begin;
+
+    while (end - begin >= 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(end - 16));
+        const unsigned solid = ~unsigned(_mm_movemask_epi8(blank16(v))) & 0xFFFF;
+        if (solid) {
+            end -= qCountLeadingZeroBits(quint16(solid));
+            return;
+        }
+        end -= 16;
+    }
+    while (end > begin && isBlank(end[-1]))
+        --end;
+}
+
+qsizetype findLevelSse2(const char *data, qsizetype length)
+{
+    qsizetype i = 0;
+    for (; i + 16 < length; i += 16) {
+        const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i));
+        __m128i hit = _mm_cmpeq_epi8(v, _mm_set1_epi8('V'));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('D')));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('I')));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('W')));
+        hit = _mm_or_si128(hit, _mm_cmpeq_epi8(v, _mm_set1_epi8('E')));
+        unsigned mask = unsigned(_mm_movemask_epi8(hit));
+        while (mask) {
+            const qsizetype pos = i + qCountTrailingZeroBits(mask);
+            if (isLevelAt(data, pos))
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findLevelScalar(data, length, i);
+}
+
+qsizetype findIgnoreCaseSse2(const char *data, qsizetype length, const char *needle, qsizetype n)
+{
+    // 同时比较首字符和末字符，两者都相符的位置再逐字节确认
+    const __m128i first = _mm_set1_epi8(needle[0]);
+    const __m128i last = _mm_set1_epi8(needle[n - 1]);
+    qsizetype i = 0;
+    for (; i + n - 1 + 16 <= length; i += 16) {
+        const __m128i a = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i)));
+        const __m128i b = lower16(_mm_loadu_si128(reinterpret_cast<const __m128i *>(data + i + n - 1)));
+        unsigned mask = unsigned(_mm_movemask_epi8(_mm_and_si128(_mm_cmpeq_epi8(a, first), _mm_cmpeq_epi8(b, last))));
+        while (mask) {
+            const qsizetype pos = i + qCountTrailingZeroBits(mask);
+            if (equalsLower(data + pos + 1, needle + 1, n - 2))
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findIgnoreCaseScalar(data, length, needle, n, i);
+}
+
+// ---------------------------------------------------------------- AVX2
+
+LOGTEXT_AVX2_TARGET inline __m256i lower32(__m256i v)
+{
+    const __m256i upper = _mm256_and_si256(_mm256_cmpgt_epi8(v, _mm256_set1_epi8('A' - 1)),
+                                           _mm256_cmpgt_epi8(_mm256_set1_epi8('Z' + 1), v));
+    return _mm256_or_si256(v, _mm256_and_si256(upper, _mm256_set1_epi8(0x20)));
+}
+
+LOGTEXT_AVX2_TARGET const char *findByteAvx2(const char *p, const char *end, char c)
+{
+    const __m256i needle = _mm256_set1_epi8(c);
+    for (; end - p >= 32; p += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(p));
+        const unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_cmpeq_epi8(v, needle)));
+        if (mask)
+            return p + qCountTrailingZeroBits(mask);
+    }
+    return findByteSse2(p, end, c);
+}
+
+LOGTEXT_AVX2_TARGET qsizetype findLevelAvx2(const char *data, qsizetype length)
+{
+    qsizetype i = 0;
+    for (; i + 32 < length; i += 32) {
+        const __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i));
+        __m256i hit = _mm256_cmpeq_epi8(v, _mm256_set1_epi8('V'));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('D')));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('I')));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('W')));
+        hit = _mm256_or_si256(hit, _mm256_cmpeq_epi8(v, _mm256_set1_epi8('E')));
+        unsigned mask = unsigned(_mm256_movemask_epi8(hit));
+        while (mask) {
+            const qsizetype pos = i + qCountTrailingZeroBits(mask);
+            if (isLevelAt(data, pos))
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findLevelScalar(data, length, i);
+}
+
+LOGTEXT_AVX2_TARGET qsizetype findIgnoreCaseAvx2(const char *data, qsizetype length, const char *needle, qsizetype n)
+{
+    const __m256i first = _mm256_set1_epi8(needle[0]);
+    const __m256i last = _mm256_set1_epi8(needle[n - 1]);
+    qsizetype i = 0;
+    for (; i + n - 1 + 32 <= length; i += 32) {
+        const __m256i a = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i)));
+        const __m256i b = lower32(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(data + i + n - 1)));
+        unsigned mask = unsigned(_mm256_movemask_epi8(_mm256_and_si256(_mm256_cmpeq_epi8(a, first),
+                                                                       _mm256_cmpeq_epi8(b, last))));
+        while (mask) {
+            const qsizetype pos = i + qCountTrailingZeroBits(mask);
+            if (equalsLower(data + pos + 1, needle + 1, n - 2))
+                return pos;
+            mask &= mask - 1;
+        }
+    }
+    return findIgnoreCaseScalar(data, length, needle, n, i);
+}
+
+bool cpuHasAvx2()
+{
+#if defined(_MSC_VER) && !defined(__clang__)
+    int info[4];
+    __cpuid(info, 0);
+    if (info[0] < 7)
+        return false;
+    __cpuid(info, 1);
+    const bool osxsave = (info[2] >> 27) & 1;
+    const bool avx = (info[2] >> 28) & 1;
+    if (!osxsave || !avx || (_xgetbv(0) & 6) != 6)
+        return false;
+    __cpuidex(info, 7, 0);
+    return (info[1] >> 5) & 1;
+#else
+    return __builtin_cpu_supports("avx2");
+#endif
+}
+
+#endif // LOGTEXT_X86
+
+// ---------------------------------------------------------------- 分派
+
+void trimScalar(const char *&begin, const char *&end)
+{
+    while (begin < end && isBlank(*begin))
+        ++begin;
+    while (end > begin && isBlank(end[-1]))
+        --end;
+}
+
+qsizetype findLevelFromStart(const char *data, qsizetype length)
+{
+    return findLevelScalar(data, length, 0);
+}
+
+qsizetype findIgnoreCaseFromStart(const char *data, qsizetype length, const char *needle, qsizetype n)
+{
+    return findIgnoreCaseScalar(data, length, needle, n, 0);
+}
+
+struct Dispatch {
+    const char *(*findByte)(const char *, const char *, char) = findByteScalar;
+    void (*trim)(const char *&, const char *&) = trimScalar;
+    qsizetype (*findLevel)(const char *, qsizetype) = findLevelFromStart;
+    qsizetype (*findIgnoreCase)(const char *, qsizetype, const char *, qsizetype) = findIgnoreCaseFromStart;
+    const char *name = "scalar";
+    LogTextKernels::InstructionSet supported = LogTextKernels::Scalar;
+
+    Dispatch()
+    {
+#ifdef LOGTEXT_X86
+        supported = cpuHasAvx2() ? LogTextKernels::Avx2 : LogTextKernels::Sse2;
+#endif
+        select(supported);
+    }
+
+    void select(LogTextKernels::InstructionSet set)
+    {
+        *this = Dispatch(supported);
+#ifdef LOGTEXT_X86
+        if (set >= LogTextKernels::Sse2) {
+            name = "SSE2";
+            findByte = findByteSse2;
+            trim = trimSse2;
+            findLevel = findLevelSse2;
+            findIgnoreCase = findIgnoreCaseSse2;
+        }
+        if (set >= LogTextKernels::Avx2) {
+            name = "AVX2";
+            findByte = findByteAvx2;
+            findLevel = findLevelAvx2;
+            findIgnoreCase = findIgnoreCaseAvx2;
+        }
+#else
+        Q_UNUSED(set);
+#endif
+    }
+
+private:
+    explicit Dispatch(LogTextKernels::InstructionSet supportedSet) : supported(supportedSet) {}
+};
+
+Dispatch &dispatch()
+{
+    static Dispatch instance;
+    return instance;
+}
+
+} // namespace
+
+const char *LogTextKernels::findByte(const char *begin, const char *end, char c)
+{
+    return dispatch().findByte(begin, end, c);
+}
+
+void LogTextKernels::trim(const char *&begin, const char *&end)
+{
+    dispatch().trim(begin, end);
+}
+
+qsizetype LogTextKernels::findLevelByte(const char *data, qsizetype length)
+{
+    return dispatch().findLevel(data, length);
+}
+
+qsizetype LogTextKernels::findIgnoreCase(const char *data, qsizetype length, const char *needle, qsizetype needleLength)
+{
+    if (needleLength == 0)
+        return 0;
+    if (length < needleLength)
+        return -1;
+    if (needleLength == 1) {
+        for (qsizetype i = 0; i < length; ++i) {
+            if (asciiLower(data[i]) == needle[0])
+                return i;
+        }
+        return -1;
+    }
+    return dispatch().findIgnoreCase(data, length, needle, needleLength);
+}
+
+const char *LogTextKernels::instructionSet()
+{
+    return dispatch().name;
+}
+
+LogTextKernels::InstructionSet LogTextKernels::supportedInstructionSet()
+{
+    return dispatch().supported;
+}
+
+bool LogTextKernels::setInstructionSet(InstructionSet set)
+{
+    Dispatch &d = dispatch();
+    if (set > d.supported)
+        return false;
+    d.select(set);
+    return true;
+}
@@ -0,0 +1,35 @@
+#ifndef LOGTEXTKERNELS_H
+#define LOGTEXTKERNELS_H
+
+#include <QtGlobal>
+
+// 日志文本的基础扫描函数，直接在接收缓冲区的原始字节上工作，不做拷贝和分配
+// x86 上使用 SSE2（x86-64 必备）实现，运行时检测到 AVX2 时切换为 32 字节宽度的版本，
+// 其他平台使用逐字节实现；各实现的结果完全一致
+class LogTextKernels
+{
+public:
+    enum InstructionSet { Scalar, Sse2, Avx2 };
+
+    // [begin, end) 中第一个 c 的位置，没有返回 end（切行）
+    static const char *findByte(const char *begin, const char *end, char c);
+
+    // 去掉首尾空白（空格、\t \n \v \f \r）
+    static void trim(const char *&begin, const char *&end);
+
+    // 原始行中第一个独立的级别字符（V/D/I/W/E，前面不是 ASCII 单词字符，后面是 '/' 或空白）的位置，没有返回 -1
+    static qsizetype findLevelByte(const char *data, qsizetype length);
+
+    // ASCII 不区分大小写的子串查找，needle 必须已转小写，返回位置或 -1
+    static qsizetype findIgnoreCase(const char *data, qsizetype length, const char *needle, qsizetype needleLength);
+
+    // 当前使用的指令集："AVX2"、"SSE2" 或 "scalar"
+    static const char *instructionSet();
+    // 本机支持的最高指令集
+    static InstructionSet supportedInstructionSet();
+    // 改用指定的实现（不高于 supportedInstructionSet()），供测试和基准对比各实现；
+    // 只能在没有其他线程调用上面函数时切换
+    static bool setInstructionSet(InstructionSet set);
+};
+
+#endif // LOGTEXTKERNELS_H
@@ -0,0 +1,189 @@
+#include "LogViewPipeline.h"
+#include "FrameScheduler.h"
+#include "LogItemDelegate.h"
+#include "LogModel.h"
+#include "PipelineStats.h"
+#include <QCoreApplication>
+#include <QEvent>
+#include <QHeaderView>
+#include <QScrollBar>
+#include <QTableView>
+#include <QTimer>
+
+LogViewPipeline::LogViewPipeline(LogModel *model, QTableView *view, QObject *parent)
+    : QObject(parent), m_model(model), m_view(view)
+{
+    m_scheduler = new FrameScheduler(this);
+    connect(m_scheduler, &FrameScheduler::frame, this, &LogViewPipeline::processFrame);
+
+    m_mergeTimer = new QTimer(this);
+    m_mergeTimer->setSingleShot(true);
+    connect(m_mergeTimer, &QTimer::timeout, m_scheduler, &FrameScheduler::requestFrame);
+
+    m_view->viewport()->installEventFilter(this);
+}
+
+// 只绘制可见行，行高固定
+void LogViewPipeline::configureView(QTableView *view)
+{
+    view->setItemDelegate(new LogItemDelegate(view));
+    view->setFont(QFont("Consolas", 10));
+    view->verticalHeader()->setSectionResizeMode(QHeaderView::Fixed);
+    view->verticalHeader()->setDefaultSectionSize(view->fontMetrics().height() + 2);
+    view->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+}
+
+void LogViewPipeline::push(const LogBlockPtr &block)
+{
+    m_queue.push(block);
+    m_scheduler->requestFrame();
+}
+
+void LogViewPipeline::setTimelineMerge(bool enabled)
+{
+    m_timelineMerge = enabled;
+    if (!enabled) {
+        QVector<LogBlockPtr> rest;
+        m_merger.flush(rest);
+        m_model->appendBlocks(rest);
+        emit blocksAppended(rest);
+    }
+}
+
+void LogViewPipeline::clear()
+{
+    QVector<LogBlockPtr> stale;
+    m_queue.pop(stale);
+    m_merger.clear();
+    m_mergeTimer->stop();
+}
+
+void LogViewPipeline::flush()
+{
+    const qint64 startUs = PipelineStats::nowUs();
+    drain(true, startUs);
+    m_scheduler->frameFinished(m_queue.size());
+    updateGauges();
+}
+
+void LogViewPipeline::processFrame()
+{
+    PipelineStats &stats = PipelineStats::instance();
+    const qint64 startUs = PipelineStats::nowUs();
+    if (m_frameWorkUs >= 0) {
+        // 上次刷新后视图没有重绘（窗口最小化、新行都被过滤掉等），帧耗时按模型更新计
+        stats.record(PipelineStats::FrameTime, m_frameWorkUs);
+        stats.add(PipelineStats::FramesDrawn);
+        m_frameWorkUs = -1;
+    }
+
+    auto sb = m_view->verticalScrollBar();
+    const bool atBottom = (sb->value() >= sb->maximum() - 3);   // 追加前判断，避免用户翻看历史时被拉回
+    const bool added = drain(false, startUs);
+
+    m_scheduler->frameFinished(m_queue.size());
+    // 合并时暂存的行等到能确定顺序时再刷新一帧
+    const qint64 deadlineUs = m_merger.nextDeadlineUs();
+    if (deadlineUs >= 0)
+        m_mergeTimer->start(int(qMax<qint64>(0, deadlineUs - PipelineStats::nowUs()) / 1000) + 1);
+    if (!added)
+        return;
+    updateGauges();
+
+    // 一帧只滚动一次，视图的重绘也由 Qt 合并为一次
+    emit appended(atBottom);
+
+    // 绘制耗时在视图绘制时补上；长时间不绘制时延迟按模型更新完成计，避免积压
+    m_frameWorkUs = PipelineStats::nowUs() - startUs;
+    if (m_pendingReceivedUs.size() >= size_t(MaxPendingLatency)) {
+        const qint64 nowUs = PipelineStats::nowUs();
+        for (qint64 receivedUs : m_pendingReceivedUs)
+            stats.record(PipelineStats::Latency, nowUs - receivedUs);
+        m_pendingReceivedUs.clear();
+    }
+}
+
+// 所有记录都进入模型，是否显示由模型中的过滤引擎决定
+// 按小批取出，超过本帧预算就停下，剩余的留到下一帧，避免一次突发卡住界面；all 时取完为止并清空合并暂存
+bool LogViewPipeline::drain(bool all, qint64 startUs)
+{
+    PipelineStats &stats = PipelineStats::instance();
+    stats.setGauge(PipelineStats::QueueDepth, m_queue.size());
+    const quint64 dropped = m_queue.droppedCount();
+    if (dropped != m_lastDropped) {
+        stats.add(PipelineStats::QueueDropped, dropped - m_lastDropped);
+        m_lastDropped = dropped;
+    }
+
+    const qint64 budgetUs = m_scheduler->budgetUs();
+    bool added = false;
+    QVector<LogBlockPtr> blocks;
+    int popped = 0;
+    do {
+        blocks.clear();
+        popped = m_queue.pop(blocks, DrainBatchBlocks);
+        if (m_timelineMerge)
+            mergeBlocks(blocks, all && popped == 0);
+        if (blocks.isEmpty())
+            continue;
+
+        // 各行已在产生数据的线程解析好，这里只拷贝进存储，块随即释放
+        for (const LogBlockPtr &block : blocks) {
+            // 只统计抓取来的数据，本地提示和离线导入不计入延迟
+            if (!block->source.isEmpty() && block->receivedUs >= 0)
+                m_pendingReceivedUs.push_back(block->receivedUs);
+            added = added || !block->lines.isEmpty();
+        }
+        m_model->appendBlocks(blocks);
+        emit blocksAppended(blocks);
+    } while (popped > 0 && (all || PipelineStats::nowUs() - startUs < budgetUs));
+    return added;
+}
+
+// 抓取来的块交给合并器，换成按时间排好的、已能输出的块；本地提示和离线导入没有来源，直接输出
+void LogViewPipeline::mergeBlocks(QVector<LogBlockPtr> &blocks, bool all)
+{
+    QVector<LogBlockPtr> ready;
+    for (const LogBlockPtr &block : blocks) {
+        if (block->source.isEmpty())
+            ready.append(block);
+        else
+            m_merger.push(block);
+    }
+    if (all)
+        m_merger.flush(ready);
+    else
+        m_merger.take(PipelineStats::nowUs(), ready);
+    blocks.swap(ready);
+}
+
+void LogViewPipeline::updateGauges()
+{
+    PipelineStats &stats = PipelineStats::instance();
+    stats.setGauge(PipelineStats::StoreLines, m_model->store().size());
+    stats.setGauge(PipelineStats::StoreBytes, m_model->store().memoryUsage().total());
+}
+
+// 日志视图的绘制：记录读取到绘制的延迟，以及（取队列 + 更新模型 + 绘制）的帧耗时
+// 在过滤器里转发一次绘制事件以便量出绘制本身的耗时，转发的事件不再进入这里
+bool LogViewPipeline::eventFilter(QObject *watched, QEvent *event)
+{
+    if (event->type() != QEvent::Paint || watched != m_view->viewport()
+            || m_inViewportPaint || m_frameWorkUs < 0)
+        return QObject::eventFilter(watched, event);
+
+    PipelineStats &stats = PipelineStats::instance();
+    const qint64 paintStartUs = PipelineStats::nowUs();
+    for (qint64 receivedUs : m_pendingReceivedUs)
+        stats.record(PipelineStats::Latency, paintStartUs - receivedUs);
+    m_pendingReceivedUs.clear();
+
+    m_inViewportPaint = true;
+    QCoreApplication::sendEvent(watched, event);
+    m_inViewportPaint = false;
+
+    stats.record(PipelineStats::FrameTime, m_frameWorkUs + PipelineStats::nowUs() - paintStartUs);
+    stats.add(PipelineStats::FramesDrawn);
+    m_frameWorkUs = -1;
+    return true;
+}
@@ -0,0 +1,79 @@
+#ifndef LOGVIEWPIPELINE_H
+#define LOGVIEWPIPELINE_H
+
+#include <QObject>
+#include <QVector>
+#include <vector>
+#include "LogRecord.h"
+#include "LogQueue.h"
+#include "TimelineMerger.h"
+
+class QTimer;
+class QTableView;
+class FrameScheduler;
+class LogModel;
+
+// 日志视图的显示流水线（界面线程）：
+//   抓取线程发来的块 → 无锁队列 → 按帧预算分批取出 → 多路按时间合并 → LogModel → 视图绘制
+// 视图绘制时统计端到端延迟（读到数据 → 绘制）和帧耗时（取队列 + 更新模型 + 绘制）
+// 主窗口和吞吐基准（FaeDiag --bench）共用这一份实现，基准测到的就是用户实际运行的代码
+class LogViewPipeline : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int DrainBatchBlocks = 32;          // 每次从队列取出的块数，取完一批检查一次帧预算
+    static constexpr int MaxPendingLatency = 4096;       // 长时间不绘制时，攒够这么多块就按模型更新完成计延迟
+
+    // view 显示 model（也可以暂时切换到其他模型，绘制统计只在有待绘制的刷新时进行）
+    LogViewPipeline(LogModel *model, QTableView *view, QObject *parent = nullptr);
+
+    // 日志视图的统一设置：按级别着色的委托、等高行、单列拉伸
+    static void configureView(QTableView *view);
+
+    // 收到一块（抓取数据、导入的文件、本地提示信息），安排一帧
+    void push(const LogBlockPtr &block);
+
+    // 多路日志按时间合并，关闭时暂存的行立即进入模型
+    void setTimelineMerge(bool enabled);
+    bool timelineMerge() const { return m_timelineMerge; }
+
+    // 丢弃队列和合并暂存的数据（如导入文件前）
+    void clear();
+    // 不受帧预算限制，把队列和合并暂存的数据全部放进模型（如基准结束时）
+    void flush();
+
+    int queueSize() const { return m_queue.size(); }
+    FrameScheduler *scheduler() const { return m_scheduler; }
+
+signals:
+    // 一帧追加了数据，wasAtBottom 为追加前视图是否停在底部（自动滚动用）
+    void appended(bool wasAtBottom);
+    // 按进入模型的顺序发出各批块
+    void blocksAppended(const QVector<LogBlockPtr> &blocks);
+
+protected:
+    bool eventFilter(QObject *watched, QEvent *event) override;
+
+private:
+    void processFrame();
+    bool drain(bool all, qint64 startUs);
+    void mergeBlocks(QVector<LogBlockPtr> &blocks, bool all);
+    void updateGauges();
+
+    LogModel *m_model;
+    QTableView *m_view;
+    FrameScheduler *m_scheduler;
+    QTimer *m_mergeTimer;                 // 合并暂存的行到期时再安排一帧
+
+    LogQueue<LogBlockPtr> m_queue;        // 无锁，满时丢弃最旧
+    TimelineMerger m_merger;
+    bool m_timelineMerge = true;
+    quint64 m_lastDropped = 0;            // 上次统计时队列的累计丢弃数
+
+    std::vector<qint64> m_pendingReceivedUs;  // 已进入模型、尚未绘制的块的读取时间
+    qint64 m_frameWorkUs = -1;            // 本次刷新在绘制前的耗时，-1 表示没有待绘制的刷新
+    bool m_inViewportPaint = false;
+};
+
+#endif // LOGVIEWPIPELINE_H
@@ -0,0 +1,53 @@
+#include "LogWindowRecorder.h"
+
+void LogWindowRecorder::append(const LogBlock &block)
+{
+    if (block.lines.isEmpty())
+        return;
+    const char *blockData = block.data.constData();
+    for (const LogBlock::Line &line : block.lines) {
+        if (m_chunks.empty() || (!m_chunks.back().lines.empty()
+                                 && m_chunks.back().data.size() + qsizetype(line.length) > ChunkBytes)) {
+            m_chunks.emplace_back();
+            m_chunks.back().data.reserve(qMax<qsizetype>(ChunkBytes, line.length));
+        }
+        Chunk &chunk = m_chunks.back();
+        chunk.lines.push_back({line.receivedUs, quint32(chunk.data.size()), line.length});
+        chunk.data.append(blockData + line.offset, line.length);
+    }
+    dropExpired(block.lines.last().receivedUs);
+}
+
+// 整块都早于保留时长的才丢弃，最后一块总是保留
+void LogWindowRecorder::dropExpired(qint64 newestUs)
+{
+    while (m_chunks.size() > 1 && m_chunks.front().lines.back().receivedUs < newestUs - m_retainUs)
+        m_chunks.pop_front();
+}
+
+QByteArray LogWindowRecorder::window(qint64 fromUs, qint64 toUs, int *lines) const
+{
+    QByteArray out;
+    int count = 0;
+    for (const Chunk &chunk : m_chunks) {
+        if (chunk.lines.back().receivedUs < fromUs)
+            continue;
+        for (const Line &line : chunk.lines) {
+            if (line.receivedUs < fromUs || line.receivedUs > toUs)
+                continue;
+            out.append(chunk.data.constData() + line.offset, line.length).append('\n');
+            ++count;
+        }
+    }
+    if (lines)
+        *lines = count;
+    return out;
+}
+
+qsizetype LogWindowRecorder::memoryUsage() const
+{
+    qsizetype bytes = 0;
+    for (const Chunk &chunk : m_chunks)
+        bytes += chunk.data.capacity() + qsizetype(chunk.lines.capacity() * sizeof(Line));
+    return bytes;
+}
@@ -0,0 +1,49 @@
+#ifndef LOGWINDOWRECORDER_H
+#define LOGWINDOWRECORDER_H
+
+#include <QByteArray>
+#include <deque>
+#include <vector>
+#include "LogRecord.h"
+
+// 一个抓取来源最近一段时间的日志行（按主机接收时间），供触发器保存命中前后的窗口
+// 与日志视图的存储无关：视图清空、容量溢出或抓取会话结束都不影响已记下的行
+// 行文本拷贝进按块分配的缓冲（不持有日志块），最新的行超出保留时长后整块丢弃
+class LogWindowRecorder
+{
+public:
+    static constexpr int ChunkBytes = 1024 * 1024;
+
+    explicit LogWindowRecorder(qint64 retainUs = 0) : m_retainUs(retainUs) {}
+
+    void setRetainUs(qint64 retainUs) { m_retainUs = retainUs; }
+    qint64 retainUs() const { return m_retainUs; }
+
+    void append(const LogBlock &block);
+    // 接收时间在 [fromUs, toUs] 内的行，按到达顺序，每行以 '\n' 结尾；lines 返回行数
+    QByteArray window(qint64 fromUs, qint64 toUs, int *lines = nullptr) const;
+
+    bool isEmpty() const { return m_chunks.empty(); }
+    // 最后记下的行的接收时间，没有记录时为 -1
+    qint64 newestUs() const { return m_chunks.empty() ? -1 : m_chunks.back().lines.back().receivedUs; }
+    qsizetype memoryUsage() const;
+    void clear() { m_chunks.clear(); }
+
+private:
+    struct Line {
+        qint64 receivedUs;
+        quint32 offset;
+        quint32 length;
+    };
+    struct Chunk {
+        QByteArray data;
+        std::vector<Line> lines;
+    };
+
+    void dropExpired(qint64 newestUs);
+
+    std::deque<Chunk> m_chunks;
+    qint64 m_retainUs;
+};
+
+#endif // LOGWINDOWRECORDER_H
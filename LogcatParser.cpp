@@ -0,0 +1,173 @@
+#include "LogcatParser.h"
+#include "LogTextKernels.h"
+
+namespace {
+
+inline bool isDigit(char c) { return c >= '0' && c <= '9'; }
+
+// 读取 count 位定长数字，失败返回 -1
+inline int fixedNumber(const char *p, int count)
+{
+    int value = 0;
+    for (int i = 0; i < count; ++i) {
+        if (!isDigit(p[i]))
+            return -1;
+        value = value * 10 + (p[i] - '0');
+    }
+    return value;
+}
+
+// 读取变长十进制数，pos 前进到数字之后，没有数字返回 -1
+inline qint32 readNumber(const char *data, qsizetype length, qsizetype &pos)
+{
+    const qsizetype begin = pos;
+    qint32 value = 0;
+    while (pos < length && isDigit(data[pos]) && pos - begin < 9)
+        value = value * 10 + (data[pos++] - '0');
+    return pos == begin ? -1 : value;
+}
+
+inline void skipSpaces(const char *data, qsizetype length, qsizetype &pos)
+{
+    while (pos < length && data[pos] == ' ')
+        ++pos;
+}
+
+const int DAYS_BEFORE_MONTH[12] = {0, 31, 59, 90, 120, 151, 181, 212, 243, 273, 304, 334};
+
+} // namespace
+
+int LogcatParser::levelIndex(char c)
+{
+    switch (c) {
+    case 'V': return 0;
+    case 'D': return 1;
+    case 'I': return 2;
+    case 'W': return 3;
+    case 'E':
+    case 'F':
+    case 'A': return 4;
+    default:  return -1;
+    }
+}
+
+bool LogcatParser::parse(const char *data, qsizetype length, LogLine &out)
+{
+    out = LogLine();
+    if (length > 0 && isDigit(data[0]) && parseThreadTime(data, length, out))
+        return true;
+    if (length > 2 && data[1] == '/' && levelIndex(data[0]) >= 0 && parseBrief(data, length, out))
+        return true;
+
+    out = LogLine();
+    parseRaw(data, length, out);
+    return false;
+}
+
+// 08-16 12:34:56.789  1234  5678 I ActivityManager: message
+// 可选年份前缀（-v year）与微秒精度（-v usec）
+bool LogcatParser::parseThreadTime(const char *data, qsizetype length, LogLine &out)
+{
+    qsizetype pos = 0;
+    if (length > 5 && data[4] == '-' && fixedNumber(data, 4) >= 0)
+        pos = 5;
+    if (length - pos < 18)
+        return false;
+
+    const char *p = data + pos;
+    if (p[2] != '-' || p[5] != ' ' || p[8] != ':' || p[11] != ':' || p[14] != '.')
+        return false;
+    const int month = fixedNumber(p, 2);
+    const int day = fixedNumber(p + 3, 2);
+    const int hour = fixedNumber(p + 6, 2);
+    const int minute = fixedNumber(p + 9, 2);
+    const int second = fixedNumber(p + 12, 2);
+    const int millis = fixedNumber(p + 15, 3);
+    if (month < 1 || month > 12 || day < 1 || hour < 0 || minute < 0 || second < 0 || millis < 0)
+        return false;
+
+    pos += 18;
+    while (pos < length && isDigit(data[pos]))     // 微秒/纳秒精度的多余位
+        ++pos;
+
+    skipSpaces(data, length, pos);
+    const qint32 pid = readNumber(data, length, pos);
+    skipSpaces(data, length, pos);
+    const qint32 tid = readNumber(data, length, pos);
+    skipSpaces(data, length, pos);
+    if (pid < 0 || tid < 0 || pos + 1 >= length || data[pos + 1] != ' ')
+        return false;
+    const int level = levelIndex(data[pos]);
+    if (level < 0)
+        return false;
+    pos += 2;
+
+    // TAG 以第一个 ": " 结束，logcat 会在 TAG 后补空格对齐
+    const qsizetype tagBegin = pos;
+    while (pos < length && !(data[pos] == ':' && (pos + 1 == length || data[pos + 1] == ' ')))
+        ++pos;
+    if (pos >= length)
+        return false;
+    qsizetype tagEnd = pos;
+    while (tagEnd > tagBegin && data[tagEnd - 1] == ' ')
+        --tagEnd;
+    if (tagEnd > MaxFieldOffset)
+        return false;               // TAG 位置超出 LogLine 字段范围，不是正常的 logcat 行
+    pos = qMin(pos + 2, length);
+
+    out.timeMs = ((qint64(DAYS_BEFORE_MONTH[month - 1] + day - 1) * 24 + hour) * 3600
+                  + minute * 60 + second) * 1000 + millis;
+    out.pid = pid;
+    out.tid = tid;
+    out.level = quint8(level);
+    out.format = LogLine::ThreadTime;
+    out.tagOffset = quint16(tagBegin);
+    out.tagLength = quint16(tagEnd - tagBegin);
+    out.messageOffset = quint32(pos);
+    out.messageLength = quint32(length - pos);
+    return true;
+}
+
+// I/ActivityManager(  585): message
+bool LogcatParser::parseBrief(const char *data, qsizetype length, LogLine &out)
+{
+    qsizetype pos = 2;
+    while (pos < length && data[pos] != '(')
+        ++pos;
+    if (pos >= length)
+        return false;
+    qsizetype tagEnd = pos;
+    while (tagEnd > 2 && data[tagEnd - 1] == ' ')
+        --tagEnd;
+    if (tagEnd > MaxFieldOffset)
+        return false;
+
+    ++pos;
+    skipSpaces(data, length, pos);
+    const qint32 pid = readNumber(data, length, pos);
+    if (pid < 0 || pos + 1 >= length || data[pos] != ')' || data[pos + 1] != ':')
+        return false;
+    pos += 2;
+    if (pos < length && data[pos] == ' ')
+        ++pos;
+
+    out.pid = pid;
+    out.level = quint8(levelIndex(data[0]));
+    out.format = LogLine::Brief;
+    out.tagOffset = 2;
+    out.tagLength = quint16(tagEnd - 2);
+    out.messageOffset = quint32(pos);
+    out.messageLength = quint32(length - pos);
+    return true;
+}
+
+// 未知格式：与原先的 \b([VDIWE])[/\s] 规则一致，取第一个独立的级别字符
+void LogcatParser::parseRaw(const char *data, qsizetype length, LogLine &out)
+{
+    out.format = LogLine::Raw;
+    out.messageOffset = 0;
+    out.messageLength = quint32(length);
+    const qsizetype i = LogTextKernels::findLevelByte(data, length);
+    if (i >= 0)
+        out.level = quint8(levelIndex(data[i]));
+}
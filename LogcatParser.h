@@ -0,0 +1,29 @@
+#ifndef LOGCATPARSER_H
+#define LOGCATPARSER_H
+
+#include <QByteArray>
+#include "LogRecord.h"
+
+// logcat 行解析器
+// 直接在原始字节上工作，结果写入定长的 LogLine，解析过程中不做任何堆分配。
+// 支持 threadtime（adb logcat 默认格式）和 brief 格式，其余行按 Raw 处理，只提取级别字符。
+class LogcatParser
+{
+public:
+    // LogLine 中 TAG 的位置为 16 位；TAG 超出此范围的行不按 logcat 格式解析（整行作为 Raw）
+    static constexpr qsizetype MaxFieldOffset = 0xFFFF;
+
+    // 解析一行（不含换行符），返回是否识别为 logcat 格式
+    static bool parse(const char *data, qsizetype length, LogLine &out);
+    static bool parse(const QByteArray &line, LogLine &out) { return parse(line.constData(), line.size(), out); }
+
+    // 级别字符（V/D/I/W/E/F/A）转 LEVELS 下标，非级别字符返回 -1
+    static int levelIndex(char c);
+
+private:
+    static bool parseThreadTime(const char *data, qsizetype length, LogLine &out);
+    static bool parseBrief(const char *data, qsizetype length, LogLine &out);
+    static void parseRaw(const char *data, qsizetype length, LogLine &out);
+};
+
+#endif // LOGCATPARSER_H
@@ -0,0 +1,173 @@
+#include "LogcatWorker.h"
+#include "PipelineStats.h"
+#include <QTimer>
+
+LogcatWorker::LogcatWorker(const QString &adbPath, const QString &serial, const QString &fileName, QObject *parent)
+    : QObject(parent), m_adbPath(adbPath), m_serial(serial), m_fileName(fileName)
+{
+    m_builder.setSource("adb:" + serial);
+}
+
+LogcatWorker::~LogcatWorker()
+{
+    shutdown();
+}
+
+void LogcatWorker::setCompression(const CompressedLogWriter::Options &options)
+{
+    m_compressed.setOptions(options);
+    m_compress = true;
+}
+
+// 在工作线程中执行：打开文件、清空设备缓冲、启动 logcat
+void LogcatWorker::start()
+{
+    QString baseName = m_fileName;
+    if (baseName.endsWith(".txt"))
+        baseName.chop(4);
+
+    if (m_fileName.isEmpty()) {
+        // 只输出日志块
+    } else if (m_compress) {
+        if (!m_compressed.open(baseName)) {
+            emit logMessage("压缩日志文件打开失败");
+            finish();
+            return;
+        }
+    } else {
+        if (!m_writer.open(m_fileName)) {
+            emit logMessage("日志文件打开失败");
+            finish();
+            return;
+        }
+        if (!m_session.open(baseName + ".fdl"))
+            emit logMessage("会话索引文件打开失败，仅保存文本日志");
+    }
+
+    // 先清除设备旧日志缓冲区，完成后再启动 logcat（线程可能与其他设备共用，不做同步等待）
+    m_clear = new QProcess(this);
+    connect(m_clear, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &LogcatWorker::startLogcat);
+    connect(m_clear, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            startLogcat();
+    });
+    m_clear->start(m_adbPath, adbArgs({"logcat", "-c"}));
+}
+
+void LogcatWorker::startLogcat()
+{
+    if (m_stopping || m_stopped || m_process)
+        return;
+
+    m_process = new QProcess(this);
+    m_process->setProcessChannelMode(QProcess::SeparateChannels);
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &LogcatWorker::onReadyRead);
+    connect(m_process, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &LogcatWorker::onProcessFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error != QProcess::FailedToStart)
+            return;
+        emit logMessage("adb logcat 启动失败: " + m_process->errorString());
+        finish();
+    });
+
+    // 定时把未满的块发出去，并按时间落盘
+    m_timer = new QTimer(this);
+    connect(m_timer, &QTimer::timeout, this, &LogcatWorker::onTick);
+    m_timer->start(BlockIntervalMs);
+
+    m_process->start(m_adbPath, adbArgs(QStringList{"logcat"} + m_logcatArgs));
+}
+
+// 指定设备序列号，多台设备同时连接时各自抓取
+QStringList LogcatWorker::adbArgs(const QStringList &args) const
+{
+    if (m_serial.isEmpty())
+        return args;
+    return QStringList{"-s", m_serial} + args;
+}
+
+// adb logcat 只是本地客户端，直接结束即可；线程与其他设备共用，不等待进程退出，
+// 由进程的 finished 信号完成收尾（onProcessFinished）
+void LogcatWorker::stop()
+{
+    m_stopping = true;
+    if (m_clear && m_clear->state() != QProcess::NotRunning)
+        m_clear->kill();
+    if (m_process && m_process->state() != QProcess::NotRunning)
+        m_process->kill();
+    else
+        finish();
+}
+
+void LogcatWorker::onReadyRead()
+{
+    if (m_stopped)
+        return;
+
+    const QByteArray data = m_process->readAllStandardOutput();
+    PipelineStats::instance().add(PipelineStats::AdbBytesIn, quint64(data.size()));
+    if (data.isEmpty())
+        return;
+
+    m_writer.write(data);
+    m_compressed.write(data);
+    m_builder.feed(data);
+    if (m_builder.lineCount() >= MaxBlockLines)
+        emitBlock();
+}
+
+void LogcatWorker::onProcessFinished(int, QProcess::ExitStatus)
+{
+    finish();
+}
+
+void LogcatWorker::onTick()
+{
+    emitBlock();
+    m_writer.flushIfDue();
+    m_session.flushIfDue();
+    m_compressed.flushIfDue();
+}
+
+void LogcatWorker::emitBlock()
+{
+    LogBlockPtr block = m_builder.take();
+    if (block) {
+        m_session.append(*block);
+        emit blockReady(block);
+    }
+}
+
+void LogcatWorker::finish()
+{
+    if (m_finished)
+        return;
+    m_finished = true;
+    shutdown();
+    emit finished();
+}
+
+// 读完进程残留输出、发出最后一块并关闭文件（只执行一次）
+void LogcatWorker::shutdown()
+{
+    if (m_stopped)
+        return;
+
+    if (m_process) {
+        const QByteArray rest = m_process->readAllStandardOutput();
+        m_writer.write(rest);
+        m_compressed.write(rest);
+        m_builder.feed(rest);
+    }
+    m_stopped = true;
+
+    if (m_timer)
+        m_timer->stop();
+    m_builder.finishPartial();
+    emitBlock();
+    m_writer.close();
+    m_session.close();
+    m_compressed.close();
+    if (m_compressed.droppedBytes() > 0)
+        emit logMessage(QString("压缩日志写入跟不上，丢弃了 %1 字节").arg(m_compressed.droppedBytes()));
+}
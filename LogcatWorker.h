@@ -0,0 +1,75 @@
+#ifndef LOGCATWORKER_H
+#define LOGCATWORKER_H
+
+#include <QObject>
+#include <QProcess>
+#include "LogBlockBuilder.h"
+#include "LogFileWriter.h"
+#include "LogSessionWriter.h"
+#include "CompressedLogWriter.h"
+
+class QTimer;
+
+// logcat 抓取工作对象，运行在独立线程中
+// 负责 adb logcat 进程、原始日志落盘和逐行解析，只把攒好的 LogBlock 发给界面线程
+// 原始文本写入 .txt，同时在旁边写一份带索引的会话文件（.fdl）
+// 启用压缩时改为写入按大小/时间轮转的压缩分段（.fdz），不再写 .txt 和 .fdl
+// 文件名为空时不落盘，只发出日志块
+// 多个工作对象可以共用同一个线程，所有操作都不阻塞线程：stop() 只结束进程，
+// 进程退出后收尾并发出 finished（无论是主动停止还是进程自行退出，都只发出一次）
+class LogcatWorker : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int BlockIntervalMs = 50;       // 最长攒块时间
+    static constexpr int MaxBlockLines = 4096;       // 单块最多行数
+
+    LogcatWorker(const QString &adbPath, const QString &serial, const QString &fileName, QObject *parent = nullptr);
+    ~LogcatWorker();
+
+    // 在 start() 之前调用
+    void setCompression(const CompressedLogWriter::Options &options);
+    void setLogcatArgs(const QStringList &args) { m_logcatArgs = args; }   // 追加到 logcat 后的参数（如过滤规则 *:W）
+    // 触发规则，启动后只能在所属线程中调用
+    void setTriggers(const TriggerMatcherPtr &triggers) { m_builder.setTriggers(triggers); }
+
+public slots:
+    void start();
+    void stop();
+
+signals:
+    void blockReady(const LogBlockPtr &block);
+    void logMessage(const QString &msg);
+    void finished();
+
+private slots:
+    void onReadyRead();
+    void onProcessFinished(int exitCode, QProcess::ExitStatus exitStatus);
+    void onTick();
+
+private:
+    void startLogcat();
+    void emitBlock();
+    void finish();
+    void shutdown();
+    QStringList adbArgs(const QStringList &args) const;
+
+    QString m_adbPath;
+    QString m_serial;
+    QString m_fileName;
+    QStringList m_logcatArgs;
+    QProcess *m_clear = nullptr;
+    QProcess *m_process = nullptr;
+    QTimer *m_timer = nullptr;
+    LogBlockBuilder m_builder;
+    LogFileWriter m_writer;
+    LogSessionWriter m_session;
+    CompressedLogWriter m_compressed;
+    bool m_compress = false;
+    bool m_stopping = false;              // 已要求停止，等待进程退出
+    bool m_stopped = false;
+    bool m_finished = false;
+};
+
+#endif // LOGCATWORKER_H
@@ -0,0 +1,160 @@
+#include "PipelineStats.h"
+#include <QElapsedTimer>
+
+PipelineStats &PipelineStats::instance()
+{
+    static PipelineStats stats;
+    return stats;
+}
+
+qint64 PipelineStats::nowUs()
+{
+    static const QElapsedTimer clock = []() {
+        QElapsedTimer timer;
+        timer.start();
+        return timer;
+    }();
+    return clock.nsecsElapsed() / 1000;
+}
+
+// 0..3 各占一档，之后每个 2 的幂 [2^e, 2^(e+1)) 按高两位再分 4 档
+int PipelineStats::bucketOf(quint64 value)
+{
+    if (value < SubBuckets)
+        return int(value);
+    const int e = 63 - qCountLeadingZeroBits(value);
+    const int bucket = (e - 1) * SubBuckets + int((value >> (e - 2)) & (SubBuckets - 1));
+    return qMin(bucket, BucketCount - 1);
+}
+
+quint64 PipelineStats::bucketUpperBound(int bucket)
+{
+    if (bucket < SubBuckets)
+        return quint64(bucket);
+    const int e = bucket / SubBuckets + 1;
+    const quint64 lower = quint64(SubBuckets + bucket % SubBuckets) << (e - 2);
+    return lower + (quint64(1) << (e - 2)) - 1;
+}
+
+void PipelineStats::record(Histogram histogram, qint64 valueUs)
+{
+    const quint64 value = quint64(qMax<qint64>(0, valueUs));
+    AtomicHistogram &h = m_histograms[histogram];
+    h.buckets[bucketOf(value)].fetch_add(1, std::memory_order_relaxed);
+    h.count.fetch_add(1, std::memory_order_relaxed);
+    h.sum.fetch_add(value, std::memory_order_relaxed);
+    quint64 max = h.max.load(std::memory_order_relaxed);
+    while (value > max && !h.max.compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+void PipelineStats::setGauge(Gauge gauge, qint64 value)
+{
+    m_gauges[gauge].store(value, std::memory_order_relaxed);
+    qint64 max = m_gaugeMax[gauge].load(std::memory_order_relaxed);
+    while (value > max && !m_gaugeMax[gauge].compare_exchange_weak(max, value, std::memory_order_relaxed)) {
+    }
+}
+
+PipelineStats::Snapshot PipelineStats::snapshot() const
+{
+    Snapshot snap;
+    snap.timeUs = nowUs();
+    for (int i = 0; i < CounterCount; ++i)
+        snap.counters[i] = m_counters[i].load(std::memory_order_relaxed);
+    for (int i = 0; i < GaugeCount; ++i) {
+        snap.gauges[i] = m_gauges[i].load(std::memory_order_relaxed);
+        snap.gaugeMax[i] = m_gaugeMax[i].load(std::memory_order_relaxed);
+    }
+    for (int i = 0; i < HistogramCount; ++i) {
+        const AtomicHistogram &h = m_histograms[i];
+        HistogramData &out = snap.histograms[i];
+        for (int b = 0; b < BucketCount; ++b)
+            out.buckets[b] = h.buckets[b].load(std::memory_order_relaxed);
+        out.count = h.count.load(std::memory_order_relaxed);
+        out.sum = h.sum.load(std::memory_order_relaxed);
+        out.max = h.max.load(std::memory_order_relaxed);
+    }
+    return snap;
+}
+
+void PipelineStats::reset()
+{
+    for (auto &counter : m_counters)
+        counter.store(0, std::memory_order_relaxed);
+    for (int i = 0; i < GaugeCount; ++i)
+        m_gaugeMax[i].store(m_gauges[i].load(std::memory_order_relaxed), std::memory_order_relaxed);
+    for (AtomicHistogram &h : m_histograms) {
+        for (auto &bucket : h.buckets)
+            bucket.store(0, std::memory_order_relaxed);
+        h.count.store(0, std::memory_order_relaxed);
+        h.sum.store(0, std::memory_order_relaxed);
+        h.max.store(0, std::memory_order_relaxed);
+    }
+}
+
+PipelineStats::HistogramData PipelineStats::HistogramData::operator-(const HistogramData &other) const
+{
+    // 快照不是原子的整体，个别桶可能比 count 先更新，相减时按 0 截断
+    HistogramData diff;
+    for (int b = 0; b < BucketCount; ++b)
+        diff.buckets[b] = buckets[b] > other.buckets[b] ? buckets[b] - other.buckets[b] : 0;
+    diff.count = count > other.count ? count - other.count : 0;
+    diff.sum = sum > other.sum ? sum - other.sum : 0;
+    for (int b = BucketCount - 1; b >= 0; --b) {
+        if (diff.buckets[b]) {
+            diff.max = qMin(max, bucketUpperBound(b));
+            break;
+        }
+    }
+    return diff;
+}
+
+quint64 PipelineStats::HistogramData::percentile(double p) const
+{
+    quint64 total = 0;
+    for (quint64 n : buckets)
+        total += n;
+    if (total == 0)
+        return 0;
+    const quint64 rank = qMax<quint64>(1, quint64(p * double(total) + 0.5));
+    quint64 seen = 0;
+    for (int b = 0; b < BucketCount; ++b) {
+        seen += buckets[b];
+        if (seen >= rank)
+            return qMin(bucketUpperBound(b), max ? max : bucketUpperBound(b));
+    }
+    return max;
+}
+
+QString PipelineStats::counterName(Counter counter)
+{
+    switch (counter) {
+    case AdbBytesIn: return "adb_bytes_in";
+    case SerialBytesIn: return "serial_bytes_in";
+    case LinesParsed: return "lines_parsed";
+    case BlocksParsed: return "blocks_parsed";
+    case QueueDropped: return "queue_dropped";
+    case FramesDrawn: return "frames_drawn";
+    default: return QString();
+    }
+}
+
+QString PipelineStats::histogramName(Histogram histogram)
+{
+    switch (histogram) {
+    case Latency: return "latency_us";
+    case FrameTime: return "frame_time_us";
+    default: return QString();
+    }
+}
+
+QString PipelineStats::gaugeName(Gauge gauge)
+{
+    switch (gauge) {
+    case QueueDepth: return "queue_depth";
+    case StoreLines: return "store_lines";
+    case StoreBytes: return "store_bytes";
+    default: return QString();
+    }
+}
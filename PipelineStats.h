@@ -0,0 +1,97 @@
+#ifndef PIPELINESTATS_H
+#define PIPELINESTATS_H
+
+#include <QtGlobal>
+#include <QString>
+#include <atomic>
+
+// 日志流水线各环节的计数和直方图（进程内唯一）
+// 读取线程、解析线程和界面线程都可以直接更新，全部是无锁的原子操作；
+// 读取端通过 snapshot() 取累计值，两次快照相减即得区间速率和区间分位数
+class PipelineStats
+{
+public:
+    enum Counter {
+        AdbBytesIn,             // adb logcat 读到的字节
+        SerialBytesIn,          // 串口读到的字节
+        LinesParsed,            // 解析出的行
+        BlocksParsed,           // 攒好的日志块
+        QueueDropped,           // 界面队列溢出丢弃的块
+        FramesDrawn,            // 日志视图刷新次数
+        CounterCount
+    };
+
+    enum Histogram {
+        Latency,                // 数据读到 → 日志视图绘制，微秒
+        FrameTime,              // 一次刷新（取队列、更新模型、绘制）在界面线程上的耗时，微秒
+        HistogramCount
+    };
+
+    enum Gauge {
+        QueueDepth,             // 界面队列中待处理的块数
+        StoreLines,             // 日志视图存储中的行数
+        StoreBytes,             // 日志视图存储占用的内存（记录 + 文本字节池 + 驻留池）
+        GaugeCount
+    };
+
+    // 对数分桶：每个 2 的幂分 4 档，相对误差 < 25%，覆盖到约 2^40 微秒
+    static constexpr int SubBuckets = 4;
+    static constexpr int BucketCount = 41 * SubBuckets;
+
+    struct HistogramData {
+        quint64 buckets[BucketCount] = {};
+        quint64 count = 0;
+        quint64 sum = 0;
+        quint64 max = 0;                  // 累计最大值（区间相减后不再准确，以 buckets 为准）
+
+        HistogramData operator-(const HistogramData &other) const;
+        quint64 percentile(double p) const;   // 所在桶的上界
+        quint64 mean() const { return count ? sum / count : 0; }
+    };
+
+    struct Snapshot {
+        qint64 timeUs = 0;                // nowUs()
+        quint64 counters[CounterCount] = {};
+        qint64 gauges[GaugeCount] = {};
+        qint64 gaugeMax[GaugeCount] = {};
+        HistogramData histograms[HistogramCount];
+    };
+
+    static PipelineStats &instance();
+
+    // 进程内单调时钟（微秒）
+    static qint64 nowUs();
+
+    void add(Counter counter, quint64 value = 1)
+    {
+        m_counters[counter].fetch_add(value, std::memory_order_relaxed);
+    }
+    void record(Histogram histogram, qint64 valueUs);
+    void setGauge(Gauge gauge, qint64 value);
+
+    Snapshot snapshot() const;
+    void reset();
+
+    static QString counterName(Counter counter);
+    static QString histogramName(Histogram histogram);
+    static QString gaugeName(Gauge gauge);
+    static int bucketOf(quint64 value);
+    static quint64 bucketUpperBound(int bucket);
+
+private:
+    PipelineStats() = default;
+
+    struct AtomicHistogram {
+        std::atomic<quint64> buckets[BucketCount] = {};
+        std::atomic<quint64> count{0};
+        std::atomic<quint64> sum{0};
+        std::atomic<quint64> max{0};
+    };
+
+    std::atomic<quint64> m_counters[CounterCount] = {};
+    std::atomic<qint64> m_gauges[GaugeCount] = {};
+    std::atomic<qint64> m_gaugeMax[GaugeCount] = {};
+    AtomicHistogram m_histograms[HistogramCount];
+};
+
+#endif // PIPELINESTATS_H
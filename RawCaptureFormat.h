@@ -0,0 +1,35 @@
+#ifndef RAWCAPTUREFORMAT_H
+#define RAWCAPTUREFORMAT_H
+
+#include <QtGlobal>
+
+// 串口原始数据文件（.fdr）格式，按小端字节序存放
+//
+//   RawCaptureHeader
+//   数据段：RawChunkHeader + 一次读取到的原始字节……
+//
+// 每次从串口读到的数据原样保存为一段，并记录读到时相对抓取开始的主机时间，回放时据此重现到达节奏。
+// 不做任何解码：波特率不对时的乱码、Boot ROM 的二进制输出都按字节保存。
+// 没有索引和尾部，写入中断时读取端读到最后一个完整的段为止。
+
+static const char RAW_CAPTURE_MAGIC[4] = {'F', 'D', 'R', 'W'};
+static const quint32 RAW_CAPTURE_VERSION = 1;
+
+struct RawCaptureHeader {
+    char magic[4];
+    quint32 version;
+    quint32 baudRate;
+    quint32 reserved;
+    qint64 startMs;             // 抓取开始时的 UTC 时间（毫秒）
+};
+
+struct RawChunkHeader {
+    qint64 timeUs;              // 读到这段数据时距抓取开始的主机单调时间（微秒）
+    quint32 length;             // 数据字节数，数据紧跟在段头之后，不补齐
+    quint32 reserved;
+};
+
+static_assert(sizeof(RawCaptureHeader) == 24, "unexpected raw capture header size");
+static_assert(sizeof(RawChunkHeader) == 16, "unexpected raw chunk header size");
+
+#endif // RAWCAPTUREFORMAT_H
@@ -0,0 +1,37 @@
+#include "RawCaptureWriter.h"
+#include <QDateTime>
+#include <cstring>
+
+bool RawCaptureWriter::open(const QString &fileName, int baudRate)
+{
+    if (!m_writer.open(fileName))
+        return false;
+
+    RawCaptureHeader header;
+    memcpy(header.magic, RAW_CAPTURE_MAGIC, 4);
+    header.version = RAW_CAPTURE_VERSION;
+    header.baudRate = quint32(baudRate);
+    header.reserved = 0;
+    header.startMs = QDateTime::currentMSecsSinceEpoch();
+    m_writer.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_clock.start();
+    return true;
+}
+
+void RawCaptureWriter::close()
+{
+    m_writer.close();
+}
+
+void RawCaptureWriter::write(const char *data, qsizetype length)
+{
+    if (!m_writer.isOpen() || length <= 0)
+        return;
+
+    RawChunkHeader header;
+    header.timeUs = m_clock.nsecsElapsed() / 1000;
+    header.length = quint32(length);
+    header.reserved = 0;
+    m_writer.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    m_writer.write(data, length);
+}
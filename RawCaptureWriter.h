@@ -0,0 +1,25 @@
+#ifndef RAWCAPTUREWRITER_H
+#define RAWCAPTUREWRITER_H
+
+#include <QElapsedTimer>
+#include "LogFileWriter.h"
+#include "RawCaptureFormat.h"
+
+// 串口原始数据文件（.fdr）写入：每次读到的数据加上时间戳作为一段追加
+class RawCaptureWriter
+{
+public:
+    bool open(const QString &fileName, int baudRate);
+    void close();
+    bool isOpen() const { return m_writer.isOpen(); }
+
+    // 一次读取到的数据，时间取调用时刻
+    void write(const char *data, qsizetype length);
+    void flushIfDue() { m_writer.flushIfDue(); }
+
+private:
+    LogFileWriter m_writer;
+    QElapsedTimer m_clock;
+};
+
+#endif // RAWCAPTUREWRITER_H
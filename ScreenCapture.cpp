@@ -0,0 +1,265 @@
+#include "ScreenCapture.h"
+#include <QProcess>
+#include <QTimer>
+#include <QImage>
+#include <QDir>
+#include <QDateTime>
+#include <QThreadPool>
+#include <cstring>
+
+ScreenCapture::ScreenCapture(const QString &adbPath, QObject *parent)
+    : QObject(parent), m_adbPath(adbPath),
+      m_idleTimer(new QTimer(this)),
+      m_burstTimer(new QTimer(this))
+{
+    m_idleTimer->setSingleShot(true);
+    connect(m_idleTimer, &QTimer::timeout, this, &ScreenCapture::onIdleTimeout);
+    connect(m_burstTimer, &QTimer::timeout, this, &ScreenCapture::onBurstTick);
+}
+
+ScreenCapture::~ScreenCapture()
+{
+    m_burstTotal = -1;
+    if (m_process) {
+        m_process->disconnect(this);
+        m_process->kill();
+        m_process->waitForFinished(1000);
+    }
+    // 等待编码任务结束，之后投递过来的回调会随对象销毁一起丢弃
+    m_encoder.waitForDone();
+}
+
+bool ScreenCapture::capture(const QString &serial, const QString &fileName)
+{
+    if (m_process) {
+        emit failed("上一张截图尚未完成");
+        return false;
+    }
+    m_serial = serial;
+    m_target = fileName;
+    startProcess();
+    return true;
+}
+
+void ScreenCapture::startProcess()
+{
+    if (m_mode == Png) {
+        m_file.setFileName(m_target);
+        if (!m_file.open(QIODevice::WriteOnly)) {
+            frameDone(m_target, false, "无法写入文件: " + m_file.errorString());
+            return;
+        }
+    } else {
+        m_raw.clear();
+    }
+
+    m_process = new QProcess(this);
+    m_process->setProcessChannelMode(QProcess::SeparateChannels);
+    connect(m_process, &QProcess::readyReadStandardOutput, this, &ScreenCapture::onReadyRead);
+    connect(m_process, QOverload<int,QProcess::ExitStatus>::of(&QProcess::finished), this, &ScreenCapture::onProcessFinished);
+    connect(m_process, &QProcess::errorOccurred, this, [this](QProcess::ProcessError error) {
+        if (error == QProcess::FailedToStart)
+            fail("adb 启动失败: " + m_process->errorString());
+    });
+
+    QStringList args;
+    if (!m_serial.isEmpty())
+        args << "-s" << m_serial;
+    args << "exec-out" << (m_mode == Png ? "screencap -p" : "screencap");
+    m_process->start(m_adbPath, args);
+    m_idleTimer->start(m_timeoutMs);
+}
+
+void ScreenCapture::onReadyRead()
+{
+    const QByteArray data = m_process->readAllStandardOutput();
+    if (data.isEmpty())
+        return;
+    m_idleTimer->start(m_timeoutMs);      // 有数据就重新计时
+
+    // 磁盘满等写入失败时本帧失败，不再留下截断的 PNG
+    if (m_mode == Png) {
+        if (m_file.write(data) != data.size())
+            fail("写入截图文件失败: " + m_file.errorString());
+    } else {
+        m_raw += data;
+    }
+}
+
+void ScreenCapture::onProcessFinished()
+{
+    if (!m_process)
+        return;
+    onReadyRead();
+    if (!m_process)
+        return;           // 写入失败，已按失败结束
+    m_idleTimer->stop();
+
+    const bool exitOk = m_process->exitStatus() == QProcess::NormalExit && m_process->exitCode() == 0;
+    const QString stderrText = QString::fromLocal8Bit(m_process->readAllStandardError()).trimmed();
+    m_process->deleteLater();
+    m_process = nullptr;
+
+    if (m_mode == Png) {
+        // 缓冲中剩余的数据在这里才真正写入
+        if (!m_file.flush()) {
+            const QString writeError = m_file.errorString();
+            m_file.close();
+            QFile::remove(m_target);
+            frameDone(m_target, false, "写入截图文件失败: " + writeError);
+            return;
+        }
+        const qint64 size = m_file.size();
+        m_file.close();
+        // 检查 PNG 文件头，设备未授权等情况下输出的是错误文本
+        QFile check(m_target);
+        QByteArray magic;
+        if (check.open(QIODevice::ReadOnly))
+            magic = check.read(4);
+        if (!exitOk || size == 0 || magic != "\x89PNG") {
+            QFile::remove(m_target);
+            frameDone(m_target, false, stderrText.isEmpty() ? "截图失败" : "截图失败: " + stderrText);
+            return;
+        }
+        frameDone(m_target, true, QString());
+    } else {
+        if (!exitOk || m_raw.size() < 12) {
+            frameDone(m_target, false, stderrText.isEmpty() ? "截图失败" : "截图失败: " + stderrText);
+            return;
+        }
+        encodeRaw(m_raw, m_target);
+        m_raw = QByteArray();
+    }
+}
+
+void ScreenCapture::onIdleTimeout()
+{
+    fail(QString("截图超时（%1 ms 内没有收到数据）").arg(m_timeoutMs));
+}
+
+// 原始格式：width、height、format 各 4 字节（Android 9 起还有 4 字节 colorspace），其后为像素
+void ScreenCapture::encodeRaw(const QByteArray &raw, const QString &fileName)
+{
+    ++m_encoding;
+    m_encoder.start([this, raw, fileName]() {
+        quint32 header[3];
+        memcpy(header, raw.constData(), sizeof(header));
+        const int width = int(header[0]);
+        const int height = int(header[1]);
+
+        QImage::Format format = QImage::Format_Invalid;
+        int bytesPerPixel = 4;
+        switch (header[2]) {
+        case 1: format = QImage::Format_RGBA8888; break;
+        case 2: format = QImage::Format_RGBX8888; break;
+        case 3: format = QImage::Format_RGB888; bytesPerPixel = 3; break;
+        case 4: format = QImage::Format_RGB16; bytesPerPixel = 2; break;
+        case 5: format = QImage::Format_ARGB32; break;     // BGRA，小端下与 ARGB32 一致
+        default: break;
+        }
+
+        const qint64 pixelBytes = qint64(width) * height * bytesPerPixel;
+        const qint64 headerBytes = raw.size() - pixelBytes;
+        QString error;
+        bool ok = false;
+        if (format == QImage::Format_Invalid || width <= 0 || height <= 0) {
+            error = QString("不支持的原始像素格式 %1").arg(header[2]);
+        } else if (headerBytes != 12 && headerBytes != 16) {
+            error = "原始截图数据长度不正确";
+        } else {
+            const QImage image(reinterpret_cast<const uchar *>(raw.constData() + headerBytes),
+                               width, height, width * bytesPerPixel, format);
+            ok = image.save(fileName, "PNG");
+            if (!ok)
+                error = "PNG 编码失败";
+        }
+
+        QMetaObject::invokeMethod(this, [this, fileName, ok, error]() {
+            --m_encoding;
+            frameDone(fileName, ok, error);
+        }, Qt::QueuedConnection);
+    });
+}
+
+void ScreenCapture::fail(const QString &error)
+{
+    if (!m_process)
+        return;
+    m_idleTimer->stop();
+    m_process->disconnect(this);
+    m_process->kill();
+    m_process->deleteLater();
+    m_process = nullptr;
+    if (m_file.isOpen()) {
+        m_file.close();
+        QFile::remove(m_target);
+    }
+    m_raw = QByteArray();
+    frameDone(m_target, false, error);
+}
+
+void ScreenCapture::frameDone(const QString &fileName, bool ok, const QString &error)
+{
+    if (!isBursting()) {
+        if (ok)
+            emit captured(fileName);
+        else
+            emit failed(error);
+        return;
+    }
+
+    // 连拍中的单帧失败只计数，不逐帧报错
+    if (ok)
+        ++m_burstSaved;
+    if (m_burstTotal > 0 && m_burstIndex >= m_burstTotal && !isBusy()) {
+        m_burstTimer->stop();
+        m_burstTotal = -1;
+        emit burstFinished(m_burstSaved, m_burstDir);
+    }
+}
+
+void ScreenCapture::startBurst(const QString &serial, double fps, int frameCount, const QString &dir)
+{
+    if (isBursting() || m_process) {
+        emit failed("截图正在进行中");
+        return;
+    }
+
+    QDir().mkpath(dir);
+    m_serial = serial;
+    m_burstDir = dir;
+    m_burstTotal = qMax(0, frameCount);
+    m_burstIndex = 0;
+    m_burstSaved = 0;
+    m_burstTimer->start(qMax(1, int(1000.0 / qMax(0.1, fps))));
+    onBurstTick();
+}
+
+void ScreenCapture::stopBurst()
+{
+    if (!isBursting())
+        return;
+    m_burstTimer->stop();
+    // 让正在进行的帧自然结束，之后不再开始新帧
+    m_burstTotal = m_burstIndex;
+    if (m_burstTotal == 0 || !isBusy()) {
+        m_burstTotal = -1;
+        emit burstFinished(m_burstSaved, m_burstDir);
+    }
+}
+
+void ScreenCapture::onBurstTick()
+{
+    if (m_burstTotal > 0 && m_burstIndex >= m_burstTotal) {
+        m_burstTimer->stop();
+        return;
+    }
+    if (m_process || m_encoding >= m_encoder.maxThreadCount())
+        return;             // 上一帧还在传输或编码积压，跳过本帧
+
+    ++m_burstIndex;
+    m_target = QString("%1/frame_%2_%3.png").arg(m_burstDir)
+            .arg(m_burstIndex, 4, 10, QChar('0'))
+            .arg(QDateTime::currentDateTime().toString("HHmmss_zzz"));
+    startProcess();
+}
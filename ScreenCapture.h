@@ -0,0 +1,80 @@
+#ifndef SCREENCAPTURE_H
+#define SCREENCAPTURE_H
+
+#include <QObject>
+#include <QFile>
+#include <QThreadPool>
+
+class QProcess;
+class QTimer;
+
+// 设备截图：adb exec-out screencap 的输出边读边写入文件，不再整张图缓存在内存中等待进程结束
+// 超时按"无数据间隔"计算，大尺寸屏幕传输时间长也不会误判失败
+//
+// Png 模式由设备编码 PNG 直接落盘；Raw 模式取原始像素（设备端省去编码，传输更快），
+// 在线程池中编码为 PNG，不占用界面线程
+// 连拍模式按设定帧率依次截图，存为带时间戳的序列；上一帧未完成时跳过该帧
+class ScreenCapture : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Mode { Png, Raw };
+
+    static constexpr int DefaultTimeoutMs = 15000;
+
+    explicit ScreenCapture(const QString &adbPath, QObject *parent = nullptr);
+    ~ScreenCapture();
+
+    void setMode(Mode mode) { m_mode = mode; }
+    Mode mode() const { return m_mode; }
+    void setTimeout(int ms) { m_timeoutMs = ms; }
+    int timeout() const { return m_timeoutMs; }
+
+    bool isBusy() const { return m_process != nullptr || m_encoding > 0; }
+    bool isBursting() const { return m_burstTotal >= 0; }
+
+    // 单张截图，fileName 为 .png
+    bool capture(const QString &serial, const QString &fileName);
+    // 连拍：每秒 fps 帧，frameCount 为 0 时一直拍到 stopBurst()
+    void startBurst(const QString &serial, double fps, int frameCount, const QString &dir);
+    void stopBurst();
+
+signals:
+    void captured(const QString &filePath);
+    void failed(const QString &error);
+    void burstFinished(int frames, const QString &dir);
+
+private:
+    void startProcess();
+    void onReadyRead();
+    void onProcessFinished();
+    void onIdleTimeout();
+    void encodeRaw(const QByteArray &raw, const QString &fileName);
+    void fail(const QString &error);
+    void frameDone(const QString &fileName, bool ok, const QString &error);
+    void onBurstTick();
+
+    QString m_adbPath;
+    Mode m_mode = Png;
+    int m_timeoutMs = DefaultTimeoutMs;
+
+    // 当前帧
+    QString m_serial;
+    QString m_target;
+    QProcess *m_process = nullptr;
+    QFile m_file;                         // Png 模式直接写入
+    QByteArray m_raw;                     // Raw 模式的像素数据
+    QTimer *m_idleTimer;
+    QThreadPool m_encoder;                // Raw 模式的 PNG 编码
+    int m_encoding = 0;                   // 正在编码的帧数
+
+    // 连拍
+    QTimer *m_burstTimer;
+    QString m_burstDir;
+    int m_burstTotal = -1;                // -1 表示未在连拍
+    int m_burstIndex = 0;
+    int m_burstSaved = 0;
+};
+
+#endif // SCREENCAPTURE_H
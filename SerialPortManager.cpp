@@ -1,21 +1,26 @@
 #include "SerialPortManager.h"
+#include "CaptureSessionManager.h"
 #include <QDebug>
 
-SerialPortManager::SerialPortManager(QObject *parent) : QObject(parent), serial(nullptr)
+SerialPortManager::SerialPortManager(CaptureSessionManager *captures, QObject *parent)
+    : QObject(parent), captures(captures)
 {
-    serial = new QSerialPort(this);
-    connect(serial, &QSerialPort::readyRead, this, &SerialPortManager::onReadyRead);
-    connect(serial, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError error) {
-        if (error != QSerialPort::NoError) {
-            emit errorOccurred(serial->errorString());
+    // 串口被拔出等情况下会话由管理器自行结束，这里同步界面状态
+    connect(captures, &CaptureSessionManager::sessionStopped, this, [this](const QString &source) {
+        if (!portName.isEmpty() && source == CaptureSessionManager::serialSource(portName)) {
+            portName.clear();
+            emit portClosed();
         }
     });
+    connect(captures, &CaptureSessionManager::errorOccurred, this, [this](const QString &source, const QString &error) {
+        if (!portName.isEmpty() && source == CaptureSessionManager::serialSource(portName))
+            emit errorOccurred(error);
+    });
 }
 
 SerialPortManager::~SerialPortManager()
 {
     closePort();
-    delete serial;
 }
 
 void SerialPortManager::refreshAvailablePorts()
@@ -27,40 +32,44 @@ void SerialPortManager::refreshAvailablePorts()
     }
 }
 
-bool SerialPortManager::openPort(const QString &portName, int baudRate)
+bool SerialPortManager::openPort(const QString &name, int baudRate)
 {
-    if (serial->isOpen()) {
+    if (isPortOpen()) {
         emit errorOccurred("Port is already open");
         return false;
     }
 
-    serial->setPortName(portName);
-    serial->setBaudRate(baudRate);
-    serial->setDataBits(QSerialPort::Data8);
-    serial->setParity(QSerialPort::NoParity);
-    serial->setStopBits(QSerialPort::OneStop);
-    serial->setFlowControl(QSerialPort::NoFlowControl);
-
-    if (serial->open(QIODevice::ReadWrite)) {
-        emit portOpened(true, QString("Port %1 opened successfully").arg(portName));
+    QString error;
+    if (!captures) {
+        emit errorOccurred("Failed to open port: capture manager is gone");
+        return false;
+    }
+    if (captures->startSerial(name, baudRate, &error)) {
+        portName = name;
+        emit portOpened(true, QString("Port %1 opened successfully, saving to %2")
+                        .arg(name, captures->fileName(CaptureSessionManager::serialSource(name))));
         return true;
     } else {
-        emit errorOccurred(QString("Failed to open port: %1").arg(serial->errorString()));
+        emit errorOccurred(QString("Failed to open port: %1").arg(error));
         return false;
     }
 }
 
 void SerialPortManager::closePort()
 {
-    if (serial->isOpen()) {
-        serial->close();
-        emit portClosed();
-    }
+    // 停止是异步的：请求发出后即视为已关闭，之后的 sessionStopped 不再匹配
+    if (!isPortOpen())
+        return;
+    const QString source = CaptureSessionManager::serialSource(portName);
+    portName.clear();
+    if (captures)
+        captures->stop(source);
+    emit portClosed();
 }
 
 bool SerialPortManager::isPortOpen() const
 {
-    return serial->isOpen();
+    return !portName.isEmpty();
 }
 
 QStringList SerialPortManager::availablePorts() const
@@ -70,21 +79,11 @@ QStringList SerialPortManager::availablePorts() const
 
 QString SerialPortManager::currentPortName() const
 {
-    return serial->portName();
+    return portName;
 }
 
 void SerialPortManager::writeData(const QByteArray &data)
 {
-    if (serial->isOpen()) {
-        serial->write(data);
-    }
+    if (isPortOpen() && captures)
+        captures->writeSerial(portName, data);
 }
-
-void SerialPortManager::onReadyRead()
-{
-    QByteArray data = serial->readAll();
-    while (serial->waitForReadyRead(10)) {
-        data += serial->readAll();
-    }
-    emit dataReceived(QString::fromUtf8(data));
-}
\ No newline at end of file
@@ -2,15 +2,19 @@
 #define SERIALPORTMANAGER_H
 
 #include <QObject>
-#include <QSerialPort>
+#include <QPointer>
 #include <QSerialPortInfo>
 
+class CaptureSessionManager;
+
+// 界面上"当前串口"的管理；读取、解析和落盘由 CaptureSessionManager 中的串口会话完成，
+// 日志块也直接从 CaptureSessionManager 发出
 class SerialPortManager : public QObject
 {
     Q_OBJECT
 
 public:
-    explicit SerialPortManager(QObject *parent = nullptr);
+    explicit SerialPortManager(CaptureSessionManager *captures, QObject *parent = nullptr);
     ~SerialPortManager();
 
     // 公共接口
@@ -22,7 +26,6 @@ public:
     QString currentPortName() const;
 
 signals:
-    void dataReceived(const QString &data);
     void portOpened(bool success, const QString &message);
     void portClosed();
     void errorOccurred(const QString &error);
@@ -30,12 +33,10 @@ signals:
 public slots:
     void writeData(const QByteArray &data);
 
-private slots:
-    void onReadyRead();
-
 private:
-    QSerialPort *serial;
+    QPointer<CaptureSessionManager> captures;  // 共享的抓取会话管理，可能先于本对象析构
+    QString portName;                    // 当前打开的串口，未打开时为空
     QStringList portList;
 };
 
-#endif // SERIALPORTMANAGER_H
\ No newline at end of file
+#endif // SERIALPORTMANAGER_H
@@ -0,0 +1,133 @@
+#include "SerialReader.h"
+#include "PipelineStats.h"
+#include <QSerialPort>
+#include <QTimer>
+
+SerialReader::SerialReader(QObject *parent)
+    : QObject(parent)
+{
+}
+
+SerialReader::~SerialReader()
+{
+    close();
+}
+
+void SerialReader::setCompression(const CompressedLogWriter::Options &options)
+{
+    m_compressed.setOptions(options);
+    m_compress = true;
+}
+
+bool SerialReader::open(const QString &portName, int baudRate, const QString &fileName, QString *error)
+{
+    if (!m_serial) {
+        // 在工作线程中创建，串口通知也在工作线程中处理
+        m_serial = new QSerialPort(this);
+        connect(m_serial, &QSerialPort::readyRead, this, &SerialReader::onReadyRead);
+        connect(m_serial, &QSerialPort::errorOccurred, this, [this](QSerialPort::SerialPortError err) {
+            if (err == QSerialPort::NoError)
+                return;
+            emit errorOccurred(m_serial->errorString());
+            if (err == QSerialPort::ResourceError)
+                emit portLost();
+        });
+
+        m_timer = new QTimer(this);
+        connect(m_timer, &QTimer::timeout, this, &SerialReader::onTick);
+        m_readBuffer.resize(ReadBufferBytes);
+    }
+
+    m_serial->setPortName(portName);
+    m_serial->setBaudRate(baudRate);
+    m_serial->setDataBits(QSerialPort::Data8);
+    m_serial->setParity(QSerialPort::NoParity);
+    m_serial->setStopBits(QSerialPort::OneStop);
+    m_serial->setFlowControl(QSerialPort::NoFlowControl);
+
+    if (!m_serial->open(QIODevice::ReadWrite)) {
+        if (error)
+            *error = m_serial->errorString();
+        return false;
+    }
+
+    if (!fileName.isEmpty()) {
+        QString baseName = fileName;
+        if (baseName.endsWith(".txt"))
+            baseName.chop(4);
+        if (m_compress) {
+            if (!m_compressed.open(baseName))
+                emit errorOccurred("压缩日志文件打开失败: " + baseName);
+        } else if (!m_writer.open(fileName)) {
+            emit errorOccurred("日志文件打开失败: " + fileName);
+        } else {
+            m_session.open(baseName + ".fdl");
+        }
+        if (m_rawCapture && !m_raw.open(baseName + ".fdr", baudRate))
+            emit errorOccurred("原始数据文件打开失败: " + baseName + ".fdr");
+    }
+
+    m_builder.setSource("uart:" + portName);
+    m_sinceData.start();
+    m_timer->start(PublishIntervalMs);
+    return true;
+}
+
+void SerialReader::close()
+{
+    if (!m_serial || !m_serial->isOpen())
+        return;
+
+    onReadyRead();
+    m_serial->close();
+    m_timer->stop();
+    m_builder.finishPartial();
+    publish();
+    m_writer.close();
+    m_session.close();
+    m_compressed.close();
+    if (m_compressed.droppedBytes() > 0)
+        emit errorOccurred(QString("压缩日志写入跟不上，丢弃了 %1 字节").arg(m_compressed.droppedBytes()));
+    m_raw.close();
+}
+
+void SerialReader::write(const QByteArray &data)
+{
+    if (m_serial && m_serial->isOpen())
+        m_serial->write(data);
+}
+
+void SerialReader::onReadyRead()
+{
+    qint64 n;
+    while ((n = m_serial->read(m_readBuffer.data(), m_readBuffer.size())) > 0) {
+        PipelineStats::instance().add(PipelineStats::SerialBytesIn, quint64(n));
+        m_raw.write(m_readBuffer.constData(), n);
+        m_writer.write(m_readBuffer.constData(), n);
+        m_compressed.write(m_readBuffer.constData(), n);
+        m_builder.feed(m_readBuffer.constData(), n);
+        m_sinceData.restart();
+        if (m_builder.lineCount() >= MaxBlockLines)
+            publish();
+    }
+}
+
+void SerialReader::onTick()
+{
+    if (m_builder.hasPartial() && m_sinceData.elapsed() >= PartialLineTimeoutMs)
+        m_builder.finishPartial();
+    publish();
+    m_writer.flushIfDue();
+    m_session.flushIfDue();
+    m_compressed.flushIfDue();
+    m_raw.flushIfDue();
+}
+
+void SerialReader::publish()
+{
+    LogBlockPtr block = m_builder.take();
+    if (block) {
+        m_session.append(*block);
+        emit blockReady(block);
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef SERIALREADER_H
+#define SERIALREADER_H
+
+#include <QObject>
+#include <QByteArray>
+#include <QElapsedTimer>
+#include "LogBlockBuilder.h"
+#include "LogFileWriter.h"
+#include "LogSessionWriter.h"
+#include "CompressedLogWriter.h"
+#include "RawCaptureWriter.h"
+
+class QSerialPort;
+class QTimer;
+
+// 串口读取工作对象，运行在独立线程中
+// 读入预分配缓冲后增量切行（跨读取的半行、被截断的多字节 UTF-8 字符都会留到下次拼接），
+// 按固定间隔把攒好的行作为一个 LogBlock 发出，界面线程不再参与读取
+// 指定输出文件时，原始数据写入 .txt，解析结果同时写入会话文件（.fdl）；启用压缩时改为写入压缩分段（.fdz）
+// 启用原始抓取时另外把每次读到的字节连同时间戳写入 .fdr，可用 SerialReplayer 回放
+class SerialReader : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int ReadBufferBytes = 256 * 1024;
+    static constexpr int PublishIntervalMs = 20;      // 最长攒块时间
+    static constexpr int PartialLineTimeoutMs = 100;  // 无换行的半行（如 shell 提示符）最长等待时间
+    static constexpr int MaxBlockLines = 4096;
+
+    explicit SerialReader(QObject *parent = nullptr);
+    ~SerialReader();
+
+    // 在 open() 之前调用
+    void setCompression(const CompressedLogWriter::Options &options);
+    void setRawCapture(bool enabled) { m_rawCapture = enabled; }
+    // 触发规则，打开后只能在所属线程中调用
+    void setTriggers(const TriggerMatcherPtr &triggers) { m_builder.setTriggers(triggers); }
+
+    // 以下接口只能在所属线程中调用
+    bool open(const QString &portName, int baudRate, const QString &fileName, QString *error);
+    void close();
+    void write(const QByteArray &data);
+
+signals:
+    void blockReady(const LogBlockPtr &block);
+    void errorOccurred(const QString &error);
+    void portLost();                  // 设备被拔出等不可恢复错误
+
+private slots:
+    void onReadyRead();
+    void onTick();
+
+private:
+    void publish();
+
+    QSerialPort *m_serial = nullptr;
+    QTimer *m_timer = nullptr;
+    QByteArray m_readBuffer;
+    LogBlockBuilder m_builder;
+    LogFileWriter m_writer;
+    LogSessionWriter m_session;
+    CompressedLogWriter m_compressed;
+    bool m_compress = false;
+    RawCaptureWriter m_raw;
+    bool m_rawCapture = false;
+    QElapsedTimer m_sinceData;
+};
+
+#endif // SERIALREADER_H
@@ -0,0 +1,139 @@
+#include "SerialReplayer.h"
+#include <QFileInfo>
+#include <QTimer>
+#include <cstring>
+
+SerialReplayer::SerialReplayer(const QString &fileName, double speed, QObject *parent)
+    : QObject(parent), m_fileName(fileName), m_speed(speed)
+{
+}
+
+SerialReplayer::~SerialReplayer()
+{
+    stop();
+}
+
+bool SerialReplayer::open(QString *error)
+{
+    m_file.setFileName(m_fileName);
+    if (!m_file.open(QIODevice::ReadOnly)) {
+        if (error)
+            *error = m_file.errorString();
+        return false;
+    }
+
+    m_size = m_file.size();
+    if (m_size < qint64(sizeof(RawCaptureHeader))) {
+        if (error)
+            *error = "文件太小，不是串口原始数据文件";
+        m_file.close();
+        return false;
+    }
+    m_map = m_file.map(0, m_size);
+    if (!m_map) {
+        if (error)
+            *error = m_file.errorString();
+        m_file.close();
+        return false;
+    }
+
+    RawCaptureHeader header;
+    memcpy(&header, m_map, sizeof(header));
+    if (memcmp(header.magic, RAW_CAPTURE_MAGIC, 4) != 0 || header.version != RAW_CAPTURE_VERSION) {
+        if (error)
+            *error = "不支持的串口原始数据文件格式";
+        stop();
+        return false;
+    }
+    m_baudRate = int(header.baudRate);
+    m_pos = sizeof(RawCaptureHeader);
+    m_builder.setSource("replay:" + QFileInfo(m_fileName).fileName());
+
+    m_timer = new QTimer(this);
+    m_timer->setSingleShot(true);
+    connect(m_timer, &QTimer::timeout, this, &SerialReplayer::onTick);
+    return true;
+}
+
+void SerialReplayer::start()
+{
+    if (!m_map)
+        return;
+    m_clock.start();
+    m_sinceData.start();
+    m_sincePublish.start();
+    m_timer->start(0);
+}
+
+void SerialReplayer::stop()
+{
+    if (m_timer)
+        m_timer->stop();
+    if (m_map) {
+        m_builder.finishPartial();
+        publish();
+        m_file.unmap(const_cast<uchar *>(m_map));
+        m_map = nullptr;
+    }
+    m_file.close();
+}
+
+// 下一段完整的数据；文件末尾或写入中断留下的不完整段返回 false
+bool SerialReplayer::nextChunk(RawChunkHeader &header) const
+{
+    if (m_size - m_pos < qint64(sizeof(RawChunkHeader)))
+        return false;
+    memcpy(&header, m_map + m_pos, sizeof(header));
+    return m_size - m_pos - qint64(sizeof(RawChunkHeader)) >= qint64(header.length);
+}
+
+void SerialReplayer::onTick()
+{
+    if (!m_map)
+        return;
+
+    const qint64 elapsedUs = m_clock.nsecsElapsed() / 1000;
+    qint64 fed = 0;
+    RawChunkHeader header;
+    while (nextChunk(header)) {
+        if (m_firstChunkUs < 0)
+            m_firstChunkUs = header.timeUs;
+        // 按记录的到达时间回放：还没到时间的段留到下次
+        if (m_speed > 0 && qint64(double(header.timeUs - m_firstChunkUs) / m_speed) > elapsedUs)
+            break;
+        m_builder.feed(reinterpret_cast<const char *>(m_map + m_pos + sizeof(RawChunkHeader)), header.length);
+        m_pos += qint64(sizeof(RawChunkHeader)) + header.length;
+        m_sinceData.restart();
+        if (m_builder.lineCount() >= MaxBlockLines)
+            publish();
+        fed += header.length;
+        if (m_speed <= 0 && fed >= MaxSpeedSliceBytes)
+            break;
+    }
+
+    const bool ended = !nextChunk(header);
+    if (ended || (m_builder.hasPartial() && m_sinceData.elapsed() >= PartialLineTimeoutMs))
+        m_builder.finishPartial();
+    if (ended || m_speed <= 0 || m_sincePublish.elapsed() >= PublishIntervalMs)
+        publish();
+    if (ended) {
+        emit finished();
+        return;
+    }
+
+    // 下一段到时间或到了攒块间隔时再处理
+    qint64 delayMs = 0;
+    if (m_speed > 0) {
+        const qint64 dueUs = qint64(double(header.timeUs - m_firstChunkUs) / m_speed);
+        delayMs = qBound<qint64>(0, (dueUs - m_clock.nsecsElapsed() / 1000) / 1000, PublishIntervalMs);
+    }
+    m_timer->start(int(delayMs));
+}
+
+void SerialReplayer::publish()
+{
+    m_sincePublish.restart();
+    LogBlockPtr block = m_builder.take();
+    if (block)
+        emit blockReady(block);
+}
@@ -0,0 +1,65 @@
+#ifndef SERIALREPLAYER_H
+#define SERIALREPLAYER_H
+
+#include <QObject>
+#include <QFile>
+#include <QElapsedTimer>
+#include "LogBlockBuilder.h"
+#include "RawCaptureFormat.h"
+
+class QTimer;
+
+// 串口原始数据文件（.fdr）回放工作对象，运行在抓取工作线程中
+// 按记录的到达时间（可按倍数加速）把各段数据喂给与实时抓取相同的切行/解析流程，
+// 发出的 LogBlock 与串口抓取的一致，来源为 replay:<文件名>；文件以内存映射方式读取，数据不再拷贝。
+// 最快速度回放时每次只处理一批数据就让出事件循环，随时可以停止；没有硬件时也可以用来压测流水线
+class SerialReplayer : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int PublishIntervalMs = 20;        // 与 SerialReader 相同的攒块间隔
+    static constexpr int PartialLineTimeoutMs = 100;
+    static constexpr int MaxBlockLines = 4096;
+    static constexpr qint64 MaxSpeedSliceBytes = 4 * 1024 * 1024;  // 最快速度时每次事件循环处理的字节数
+
+    // speed 为倍速，<= 0 表示不等待、尽快回放
+    SerialReplayer(const QString &fileName, double speed, QObject *parent = nullptr);
+    ~SerialReplayer();
+
+    // 以下接口只能在所属线程中调用
+    bool open(QString *error);
+    void start();
+    void stop();
+
+    int baudRate() const { return m_baudRate; }
+    void setTriggers(const TriggerMatcherPtr &triggers) { m_builder.setTriggers(triggers); }
+
+signals:
+    void blockReady(const LogBlockPtr &block);
+    void finished();                  // 回放到文件末尾
+
+private slots:
+    void onTick();
+
+private:
+    bool nextChunk(RawChunkHeader &header) const;
+    void publish();
+
+    QString m_fileName;
+    double m_speed;
+    QFile m_file;
+    const uchar *m_map = nullptr;
+    qint64 m_size = 0;
+    qint64 m_pos = 0;                 // 下一段的段头位置
+    int m_baudRate = 0;
+    qint64 m_firstChunkUs = -1;       // 第一段的记录时间，回放时间从这里起算
+
+    QTimer *m_timer = nullptr;
+    QElapsedTimer m_clock;            // 回放开始后的时间
+    QElapsedTimer m_sinceData;
+    QElapsedTimer m_sincePublish;
+    LogBlockBuilder m_builder;
+};
+
+#endif // SERIALREPLAYER_H
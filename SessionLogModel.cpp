@@ -0,0 +1,84 @@
+#include "SessionLogModel.h"
+#include "LogModel.h"
+#include <algorithm>
+#include <climits>
+
+SessionLogModel::SessionLogModel(QObject *parent)
+    : QAbstractListModel(parent)
+{
+}
+
+bool SessionLogModel::open(const QString &fileName, QString *error)
+{
+    beginResetModel();
+    m_filtered = false;
+    m_rows.clear();
+    const bool ok = m_reader.open(fileName, error);
+    endResetModel();
+    return ok;
+}
+
+void SessionLogModel::close()
+{
+    beginResetModel();
+    m_reader.close();
+    m_filtered = false;
+    m_rows.clear();
+    endResetModel();
+}
+
+int SessionLogModel::rowCount(const QModelIndex &parent) const
+{
+    if (parent.isValid())
+        return 0;
+    const quint64 count = m_filtered ? m_rows.size() : m_reader.recordCount();
+    return int(qMin<quint64>(count, INT_MAX));
+}
+
+QVariant SessionLogModel::data(const QModelIndex &index, int role) const
+{
+    if (!index.isValid() || index.row() >= rowCount())
+        return QVariant();
+
+    const LogSessionReader::Record rec = m_reader.record(recordForRow(index.row()));
+    if (!rec.header)
+        return QVariant();
+
+    switch (role) {
+    case Qt::DisplayRole:
+        return QString::fromUtf8(rec.line, rec.header->length);
+    case LogModel::LevelRole:
+        return int(rec.header->level);
+    case Qt::ForegroundRole:
+        return rec.header->level < LEVELS.size() ? LEVELS[rec.header->level].color : QColor(Qt::black);
+    default:
+        return QVariant();
+    }
+}
+
+void SessionLogModel::setFilter(int minLevel, const QByteArray &tag)
+{
+    beginResetModel();
+    m_rows.clear();
+    m_filtered = minLevel > 0 || !tag.isEmpty();
+    if (m_filtered)
+        m_reader.select(minLevel, tag, -1, m_rows);
+    endResetModel();
+}
+
+int SessionLogModel::rowForTime(qint64 timeMs) const
+{
+    const quint64 record = m_reader.findTime(timeMs);
+    if (record >= m_reader.recordCount())
+        return -1;
+    if (!m_filtered)
+        return int(qMin<quint64>(record, INT_MAX));
+
+    auto it = std::lower_bound(m_rows.begin(), m_rows.end(), record);
+    return it == m_rows.end() ? -1 : int(it - m_rows.begin());
+}
+
+quint64 SessionLogModel::recordForRow(int row) const
+{
+    return m_filtered ? m_rows[size_t(row)] : quint64(row);
+}
@@ -0,0 +1,37 @@
+#ifndef SESSIONLOGMODEL_H
+#define SESSIONLOGMODEL_H
+
+#include <QAbstractListModel>
+#include <vector>
+#include "LogSessionReader.h"
+
+// 已保存会话（.fdl）的视图模型：直接从内存映射读取可见行，打开大文件不需要加载全部内容
+class SessionLogModel : public QAbstractListModel
+{
+    Q_OBJECT
+
+public:
+    explicit SessionLogModel(QObject *parent = nullptr);
+
+    bool open(const QString &fileName, QString *error = nullptr);
+    void close();
+    bool isOpen() const { return m_reader.isOpen(); }
+    QString fileName() const { return m_reader.fileName(); }
+
+    int rowCount(const QModelIndex &parent = QModelIndex()) const override;
+    QVariant data(const QModelIndex &index, int role = Qt::DisplayRole) const override;
+
+    // 按级别和 TAG（精确匹配，空表示不限）过滤，只扫描索引可能命中的块
+    void setFilter(int minLevel, const QByteArray &tag);
+    // 第一条设备时间 >= timeMs 的可见行，没有返回 -1
+    int rowForTime(qint64 timeMs) const;
+
+private:
+    quint64 recordForRow(int row) const;
+
+    LogSessionReader m_reader;
+    bool m_filtered = false;
+    std::vector<quint64> m_rows;          // 过滤生效时可见记录的下标
+};
+
+#endif // SESSIONLOGMODEL_H
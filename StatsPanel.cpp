@@ -0,0 +1,281 @@
+#include "StatsPanel.h"
+#include <QTimer>
+#include <QTableWidget>
+#include <QHeaderView>
+#include <QPushButton>
+#include <QVBoxLayout>
+#include <QHBoxLayout>
+#include <QFileDialog>
+#include <QMessageBox>
+#include <QFile>
+#include <QTextStream>
+#include <QDateTime>
+#include <QDir>
+#include <QJsonArray>
+#include <QJsonObject>
+#include <QJsonDocument>
+
+namespace {
+
+enum Row {
+    RowAdb,
+    RowSerial,
+    RowLines,
+    RowQueue,
+    RowDropped,
+    RowLatency,
+    RowFrame,
+    RowFrames,
+    RowStore,
+    RowCount
+};
+
+QString ms(quint64 us)
+{
+    return QString::number(us / 1000.0, 'f', us < 10000 ? 1 : 0);
+}
+
+QString rate(double bytesPerSec)
+{
+    if (bytesPerSec >= 1024 * 1024)
+        return QString::number(bytesPerSec / (1024 * 1024), 'f', 2) + " MB/s";
+    return QString::number(bytesPerSec / 1024, 'f', 1) + " KB/s";
+}
+
+QString bytes(quint64 value)
+{
+    return QString::number(value / (1024.0 * 1024.0), 'f', 1) + " MB";
+}
+
+QJsonObject histogramJson(const PipelineStats::HistogramData &h)
+{
+    QJsonArray buckets;
+    for (int b = 0; b < PipelineStats::BucketCount; ++b) {
+        if (h.buckets[b])
+            buckets.append(QJsonObject{{"le", double(PipelineStats::bucketUpperBound(b))},
+                                       {"count", double(h.buckets[b])}});
+    }
+    return QJsonObject{
+        {"count", double(h.count)},
+        {"mean", double(h.mean())},
+        {"p50", double(h.percentile(0.50))},
+        {"p95", double(h.percentile(0.95))},
+        {"p99", double(h.percentile(0.99))},
+        {"max", double(h.max)},
+        {"buckets", buckets},
+    };
+}
+
+} // namespace
+
+StatsPanel::StatsPanel(QWidget *parent)
+    : QWidget(parent)
+{
+    m_table = new QTableWidget(RowCount, 2, this);
+    m_table->setHorizontalHeaderLabels({"最近 1 秒", "累计"});
+    m_table->setVerticalHeaderLabels({"adb 输入", "串口输入", "解析行数", "界面队列深度", "丢弃块数",
+                                      "延迟 p50/p95/p99/max (ms)", "帧耗时 p50/p95/max (ms)", "刷新次数",
+                                      "日志缓冲内存"});
+    m_table->setEditTriggers(QAbstractItemView::NoEditTriggers);
+    m_table->setSelectionMode(QAbstractItemView::NoSelection);
+    m_table->horizontalHeader()->setSectionResizeMode(QHeaderView::Stretch);
+    for (int row = 0; row < RowCount; ++row) {
+        m_table->setItem(row, 0, new QTableWidgetItem);
+        m_table->setItem(row, 1, new QTableWidgetItem);
+    }
+
+    QPushButton *btnExport = new QPushButton("导出...", this);
+    QPushButton *btnReset = new QPushButton("清零", this);
+    connect(btnExport, &QPushButton::clicked, this, &StatsPanel::exportToFile);
+    connect(btnReset, &QPushButton::clicked, this, &StatsPanel::resetStats);
+
+    QHBoxLayout *buttons = new QHBoxLayout;
+    buttons->addStretch();
+    buttons->addWidget(btnReset);
+    buttons->addWidget(btnExport);
+
+    QVBoxLayout *layout = new QVBoxLayout(this);
+    layout->addWidget(m_table);
+    layout->addLayout(buttons);
+
+    // 只在面板可见时采样，隐藏后不产生定时唤醒
+    m_timer = new QTimer(this);
+    m_timer->setInterval(SampleIntervalMs);
+    connect(m_timer, &QTimer::timeout, this, &StatsPanel::sample);
+    m_last = PipelineStats::instance().snapshot();
+}
+
+void StatsPanel::showEvent(QShowEvent *event)
+{
+    QWidget::showEvent(event);
+    m_last = PipelineStats::instance().snapshot();
+    m_timer->start();
+}
+
+void StatsPanel::hideEvent(QHideEvent *event)
+{
+    QWidget::hideEvent(event);
+    m_timer->stop();
+}
+
+void StatsPanel::sample()
+{
+    const PipelineStats::Snapshot now = PipelineStats::instance().snapshot();
+    const double seconds = qMax<qint64>(1, now.timeUs - m_last.timeUs) / 1e6;
+    auto delta = [&](PipelineStats::Counter c) { return now.counters[c] - m_last.counters[c]; };
+
+    const PipelineStats::HistogramData latency =
+            now.histograms[PipelineStats::Latency] - m_last.histograms[PipelineStats::Latency];
+    const PipelineStats::HistogramData frame =
+            now.histograms[PipelineStats::FrameTime] - m_last.histograms[PipelineStats::FrameTime];
+
+    Sample s;
+    s.timeMs = QDateTime::currentMSecsSinceEpoch();
+    s.adbBytesPerSec = delta(PipelineStats::AdbBytesIn) / seconds;
+    s.serialBytesPerSec = delta(PipelineStats::SerialBytesIn) / seconds;
+    s.linesPerSec = delta(PipelineStats::LinesParsed) / seconds;
+    s.framesPerSec = delta(PipelineStats::FramesDrawn) / seconds;
+    s.dropped = delta(PipelineStats::QueueDropped);
+    s.queueDepth = now.gauges[PipelineStats::QueueDepth];
+    s.queueDepthMax = now.gaugeMax[PipelineStats::QueueDepth];
+    s.latencyP50 = latency.percentile(0.50);
+    s.latencyP95 = latency.percentile(0.95);
+    s.latencyP99 = latency.percentile(0.99);
+    s.latencyMax = latency.max;
+    s.frameP50 = frame.percentile(0.50);
+    s.frameP95 = frame.percentile(0.95);
+    s.frameMax = frame.max;
+
+    if (m_samples.size() >= MaxSamples)
+        m_samples.removeFirst();
+    m_samples.append(s);
+    m_last = now;
+
+    const PipelineStats::HistogramData &totalLatency = now.histograms[PipelineStats::Latency];
+    const PipelineStats::HistogramData &totalFrame = now.histograms[PipelineStats::FrameTime];
+    setRow(RowAdb, rate(s.adbBytesPerSec), bytes(now.counters[PipelineStats::AdbBytesIn]));
+    setRow(RowSerial, rate(s.serialBytesPerSec), bytes(now.counters[PipelineStats::SerialBytesIn]));
+    setRow(RowLines, QString::number(qRound64(s.linesPerSec)) + " 行/s",
+           QString::number(now.counters[PipelineStats::LinesParsed]));
+    setRow(RowQueue, QString::number(s.queueDepth), "最大 " + QString::number(s.queueDepthMax));
+    setRow(RowDropped, QString::number(s.dropped), QString::number(now.counters[PipelineStats::QueueDropped]));
+    setRow(RowLatency,
+           ms(s.latencyP50) + " / " + ms(s.latencyP95) + " / " + ms(s.latencyP99) + " / " + ms(s.latencyMax),
+           ms(totalLatency.percentile(0.50)) + " / " + ms(totalLatency.percentile(0.95)) + " / "
+           + ms(totalLatency.percentile(0.99)) + " / " + ms(totalLatency.max));
+    setRow(RowFrame, ms(s.frameP50) + " / " + ms(s.frameP95) + " / " + ms(s.frameMax),
+           ms(totalFrame.percentile(0.50)) + " / " + ms(totalFrame.percentile(0.95)) + " / " + ms(totalFrame.max));
+    setRow(RowFrames, QString::number(s.framesPerSec, 'f', 1) + " 次/s",
+           QString::number(now.counters[PipelineStats::FramesDrawn]));
+    const qint64 storeLines = now.gauges[PipelineStats::StoreLines];
+    const qint64 storeBytes = now.gauges[PipelineStats::StoreBytes];
+    setRow(RowStore, bytes(quint64(storeBytes)),
+           QString("%1 行，%2 字节/行").arg(storeLines).arg(storeLines > 0 ? storeBytes / storeLines : 0));
+}
+
+void StatsPanel::setRow(int row, const QString &current, const QString &total)
+{
+    m_table->item(row, 0)->setText(current);
+    m_table->item(row, 1)->setText(total);
+}
+
+void StatsPanel::resetStats()
+{
+    PipelineStats::instance().reset();
+    m_last = PipelineStats::instance().snapshot();
+    m_samples.clear();
+    for (int row = 0; row < RowCount; ++row)
+        setRow(row, QString(), QString());
+}
+
+void StatsPanel::exportToFile()
+{
+    QString selectedFilter;
+    const QString fileName = QFileDialog::getSaveFileName(
+                this, "导出统计", QDir::currentPath() + "/pipeline_stats_"
+                + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss") + ".csv",
+                "CSV (*.csv);;JSON (*.json)", &selectedFilter);
+    if (fileName.isEmpty())
+        return;
+
+    QString error;
+    const bool json = fileName.endsWith(".json", Qt::CaseInsensitive) || selectedFilter.startsWith("JSON");
+    if (!(json ? exportJson(fileName, &error) : exportCsv(fileName, &error)))
+        QMessageBox::warning(this, "导出失败", error);
+}
+
+// 每行一个样本，数值不带单位：字节/秒、行/秒、微秒
+bool StatsPanel::exportCsv(const QString &fileName, QString *error) const
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Text)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+
+    QTextStream out(&file);
+    out << "time,adb_bytes_per_s,serial_bytes_per_s,lines_per_s,frames_per_s,dropped,queue_depth,queue_depth_max,"
+           "latency_p50_us,latency_p95_us,latency_p99_us,latency_max_us,frame_p50_us,frame_p95_us,frame_max_us\n";
+    for (const Sample &s : m_samples) {
+        out << QDateTime::fromMSecsSinceEpoch(s.timeMs).toString(Qt::ISODateWithMs) << ','
+            << qRound64(s.adbBytesPerSec) << ',' << qRound64(s.serialBytesPerSec) << ','
+            << qRound64(s.linesPerSec) << ',' << s.framesPerSec << ',' << s.dropped << ','
+            << s.queueDepth << ',' << s.queueDepthMax << ','
+            << s.latencyP50 << ',' << s.latencyP95 << ',' << s.latencyP99 << ',' << s.latencyMax << ','
+            << s.frameP50 << ',' << s.frameP95 << ',' << s.frameMax << '\n';
+    }
+    return true;
+}
+
+// 样本序列 + 当前累计值（计数和完整的直方图分桶）
+bool StatsPanel::exportJson(const QString &fileName, QString *error) const
+{
+    QJsonArray samples;
+    for (const Sample &s : m_samples) {
+        samples.append(QJsonObject{
+            {"time", QDateTime::fromMSecsSinceEpoch(s.timeMs).toString(Qt::ISODateWithMs)},
+            {"adb_bytes_per_s", s.adbBytesPerSec},
+            {"serial_bytes_per_s", s.serialBytesPerSec},
+            {"lines_per_s", s.linesPerSec},
+            {"frames_per_s", s.framesPerSec},
+            {"dropped", double(s.dropped)},
+            {"queue_depth", double(s.queueDepth)},
+            {"queue_depth_max", double(s.queueDepthMax)},
+            {"latency_us", QJsonObject{{"p50", double(s.latencyP50)}, {"p95", double(s.latencyP95)},
+                                       {"p99", double(s.latencyP99)}, {"max", double(s.latencyMax)}}},
+            {"frame_time_us", QJsonObject{{"p50", double(s.frameP50)}, {"p95", double(s.frameP95)},
+                                          {"max", double(s.frameMax)}}},
+        });
+    }
+
+    const PipelineStats::Snapshot now = PipelineStats::instance().snapshot();
+    QJsonObject counters;
+    for (int i = 0; i < PipelineStats::CounterCount; ++i)
+        counters.insert(PipelineStats::counterName(PipelineStats::Counter(i)), double(now.counters[i]));
+    QJsonObject gauges;
+    for (int i = 0; i < PipelineStats::GaugeCount; ++i) {
+        const QString name = PipelineStats::gaugeName(PipelineStats::Gauge(i));
+        gauges.insert(name, double(now.gauges[i]));
+        gauges.insert(name + "_max", double(now.gaugeMax[i]));
+    }
+    QJsonObject histograms;
+    for (int i = 0; i < PipelineStats::HistogramCount; ++i)
+        histograms.insert(PipelineStats::histogramName(PipelineStats::Histogram(i)), histogramJson(now.histograms[i]));
+
+    const QJsonObject root{
+        {"generated", QDateTime::currentDateTime().toString(Qt::ISODateWithMs)},
+        {"sample_interval_ms", SampleIntervalMs},
+        {"samples", samples},
+        {"totals", QJsonObject{{"counters", counters}, {"gauges", gauges}, {"histograms", histograms}}},
+    };
+
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly)) {
+        if (error)
+            *error = file.errorString();
+        return false;
+    }
+    file.write(QJsonDocument(root).toJson());
+    return true;
+}
@@ -0,0 +1,58 @@
+#ifndef STATSPANEL_H
+#define STATSPANEL_H
+
+#include <QWidget>
+#include <QVector>
+#include "PipelineStats.h"
+
+class QTimer;
+class QTableWidget;
+
+// 流水线统计面板：每秒取一次 PipelineStats 快照，显示区间速率、队列深度、丢弃、
+// 端到端延迟和界面帧耗时的分位数；面板可见期间的每秒样本可导出为 CSV / JSON
+class StatsPanel : public QWidget
+{
+    Q_OBJECT
+
+public:
+    static constexpr int SampleIntervalMs = 1000;
+    static constexpr int MaxSamples = 3600;         // 保留最近一小时
+
+    explicit StatsPanel(QWidget *parent = nullptr);
+
+    bool exportCsv(const QString &fileName, QString *error = nullptr) const;
+    bool exportJson(const QString &fileName, QString *error = nullptr) const;
+
+protected:
+    void showEvent(QShowEvent *event) override;
+    void hideEvent(QHideEvent *event) override;
+
+private slots:
+    void sample();
+    void resetStats();
+    void exportToFile();
+
+private:
+    // 一秒区间内的统计结果
+    struct Sample {
+        qint64 timeMs = 0;                // 墙钟时间
+        double adbBytesPerSec = 0;
+        double serialBytesPerSec = 0;
+        double linesPerSec = 0;
+        double framesPerSec = 0;
+        quint64 dropped = 0;
+        qint64 queueDepth = 0;
+        qint64 queueDepthMax = 0;
+        quint64 latencyP50 = 0, latencyP95 = 0, latencyP99 = 0, latencyMax = 0;
+        quint64 frameP50 = 0, frameP95 = 0, frameMax = 0;
+    };
+
+    void setRow(int row, const QString &current, const QString &total);
+
+    QTimer *m_timer;
+    QTableWidget *m_table;
+    PipelineStats::Snapshot m_last;
+    QVector<Sample> m_samples;
+};
+
+#endif // STATSPANEL_H
@@ -0,0 +1,162 @@
+#include "TimelineMerger.h"
+#include "PipelineStats.h"
+
+qint64 TimelineMerger::Stream::skewUs() const
+{
+    return qMin(skewMin, skewPrevMin);
+}
+
+void TimelineMerger::Stream::sampleSkew(qint64 receivedUs, qint64 skewUs)
+{
+    if (skewWindowStartUs < 0 || receivedUs - skewWindowStartUs >= SkewWindowUs) {
+        skewPrevMin = skewMin;
+        skewMin = NoSkew;
+        skewWindowStartUs = receivedUs;
+    }
+    skewMin = qMin(skewMin, skewUs);
+}
+
+TimelineMerger::Stream &TimelineMerger::streamFor(const QString &source)
+{
+    for (Stream &stream : m_streams) {
+        if (stream.source == source)
+            return stream;
+    }
+    m_streams.emplace_back();
+    m_streams.back().source = source;
+    return m_streams.back();
+}
+
+void TimelineMerger::push(const LogBlockPtr &block)
+{
+    if (block->lines.isEmpty())
+        return;
+
+    Stream &stream = streamFor(block->source);
+    Pending pending;
+    pending.block = block;
+    pending.keys.reserve(size_t(block->lines.size()));
+    const qint64 fallbackUs = block->receivedUs >= 0 ? block->receivedUs : PipelineStats::nowUs();
+    for (const LogBlock::Line &line : block->lines) {
+        const qint64 receivedUs = line.receivedUs >= 0 ? line.receivedUs : fallbackUs;
+        qint64 key = receivedUs;
+        if (line.meta.timeMs >= 0) {
+            // 先计入本行再取偏差，校正后的时间不会晚于本行的接收时间
+            const qint64 deviceUs = line.meta.timeMs * 1000;
+            stream.sampleSkew(receivedUs, receivedUs - deviceUs);
+            key = deviceUs + stream.skewUs();
+        }
+        stream.lastKey = qMax(stream.lastKey, key);
+        stream.lastReceivedUs = qMax(stream.lastReceivedUs, receivedUs);
+        pending.keys.push_back(stream.lastKey);
+    }
+    stream.pending.push_back(std::move(pending));
+}
+
+// 一路以后到达的行不会早于该值；长时间没有数据的路不参与比较
+qint64 TimelineMerger::watermark(const Stream &stream, qint64 nowUs) const
+{
+    if (nowUs - stream.lastReceivedUs > IdleStreamUs)
+        return std::numeric_limits<qint64>::max();
+    return qMax(stream.lastKey, nowUs - HoldbackUs);
+}
+
+void TimelineMerger::take(qint64 nowUs, QVector<LogBlockPtr> &out)
+{
+    for (;;) {
+        // 各路队首中时间最早的一路
+        int best = -1;
+        for (int i = 0; i < int(m_streams.size()); ++i) {
+            const Stream &stream = m_streams[i];
+            if (stream.pending.empty())
+                continue;
+            const Pending &head = stream.pending.front();
+            if (best < 0 || head.keys[head.next] < m_streams[best].pending.front().keys[m_streams[best].pending.front().next])
+                best = i;
+        }
+        if (best < 0)
+            return;
+
+        // 这一路可以连续输出到：不晚于其他路的队首，也不晚于没有暂存数据的路的水位
+        qint64 limit = std::numeric_limits<qint64>::max();
+        for (int i = 0; i < int(m_streams.size()); ++i) {
+            if (i == best)
+                continue;
+            const Stream &other = m_streams[i];
+            if (other.pending.empty()) {
+                limit = qMin(limit, watermark(other, nowUs));
+            } else {
+                const Pending &head = other.pending.front();
+                limit = qMin(limit, head.keys[head.next]);
+            }
+        }
+
+        Stream &stream = m_streams[best];
+        Pending &head = stream.pending.front();
+        const int lineCount = int(head.block->lines.size());
+        int end = head.next;
+        while (end < lineCount && head.keys[end] <= limit)
+            ++end;
+        // 队首最早的一行还不能确定顺序时，其他各行更晚，本次到此为止
+        if (end == head.next)
+            return;
+
+        out.append(head.next == 0 && end == lineCount ? head.block : slice(head.block, head.next, end));
+        head.next = end;
+        if (end == lineCount)
+            stream.pending.pop_front();
+    }
+}
+
+void TimelineMerger::flush(QVector<LogBlockPtr> &out)
+{
+    take(std::numeric_limits<qint64>::max(), out);
+}
+
+void TimelineMerger::clear()
+{
+    m_streams.clear();
+}
+
+bool TimelineMerger::hasPending() const
+{
+    for (const Stream &stream : m_streams) {
+        if (!stream.pending.empty())
+            return true;
+    }
+    return false;
+}
+
+qint64 TimelineMerger::nextDeadlineUs() const
+{
+    qint64 earliest = -1;
+    for (const Stream &stream : m_streams) {
+        if (stream.pending.empty())
+            continue;
+        const Pending &head = stream.pending.front();
+        const qint64 key = head.keys[head.next];
+        if (earliest < 0 || key < earliest)
+            earliest = key;
+    }
+    return earliest < 0 ? -1 : earliest + HoldbackUs;
+}
+
+// 块中 [first, end) 行组成的新块；各行在 data 中首尾相接
+LogBlockPtr TimelineMerger::slice(const LogBlockPtr &block, int first, int end)
+{
+    QSharedPointer<LogBlock> part(new LogBlock);
+    const quint32 begin = block->lines[first].offset;
+    const LogBlock::Line &last = block->lines[end - 1];
+    part->data = block->data.mid(begin, last.offset + last.length - begin);
+    part->lines = block->lines.mid(first, end - first);
+    for (LogBlock::Line &line : part->lines) {
+        line.offset -= begin;
+        if (line.meta.trigger)
+            ++part->triggered;
+    }
+    part->source = block->source;
+    if (part->triggered)
+        part->triggers = block->triggers;
+    part->receivedUs = part->lines.first().receivedUs;
+    return part;
+}
@@ -0,0 +1,69 @@
+#ifndef TIMELINEMERGER_H
+#define TIMELINEMERGER_H
+
+#include <QString>
+#include <QVector>
+#include <deque>
+#include <limits>
+#include <vector>
+#include "LogRecord.h"
+
+// 多路日志按时间合并（k 路归并）
+// 每一路（adb:<serial>、uart:<port> 等来源）内部保持到达顺序，各路之间按“校正后时间”交错，
+// 时间统一换算到主机单调时钟（微秒）：
+// - 带 logcat 时间戳的行：设备时间 + 该路的时钟偏差。偏差取（主机接收时间 - 设备时间）在最近两个
+//   窗口内的最小值，即传输延迟最短的那些行，设备校时或时钟漂移后一两个窗口内跟上
+// - 没有时间戳的行（串口控制台、内核输出等）：主机接收时间
+//
+// 同一路的时间截成单调不减，某一路最后一行的时间就是它以后各行的下界（水位）。一行只有在不晚于
+// 其他各路的水位时才输出；各路水位至少按 当前时间 - HoldbackUs 计，所以一行最多等 HoldbackUs，
+// 长时间没有数据的路不参与比较。新数据到达后可以增量输出，不需要等待全部数据。
+class TimelineMerger
+{
+public:
+    static constexpr qint64 HoldbackUs = 200000;         // 最多等待其他路的时间（覆盖各路攒块和刷新间隔）
+    static constexpr qint64 SkewWindowUs = 30000000;     // 时钟偏差估计的窗口
+    static constexpr qint64 IdleStreamUs = 1000000;      // 超过该时间没有数据的路不再阻塞其他路
+
+    // 加入一块（来源不能为空）
+    void push(const LogBlockPtr &block);
+    // 把已能确定顺序的行按时间顺序追加到 out；整块输出时直接复用原块，被其他路打断时拆成新块
+    void take(qint64 nowUs, QVector<LogBlockPtr> &out);
+    // 不再等待，输出全部暂存的行
+    void flush(QVector<LogBlockPtr> &out);
+    void clear();
+
+    bool hasPending() const;
+    // 暂存的行中最早可以输出的时刻（没有新数据到达时），没有暂存的行时返回 -1
+    qint64 nextDeadlineUs() const;
+
+private:
+    struct Pending {
+        LogBlockPtr block;
+        std::vector<qint64> keys;       // 各行的校正后时间
+        int next = 0;                   // 下一条待输出的行
+    };
+
+    static constexpr qint64 NoSkew = std::numeric_limits<qint64>::max();
+
+    struct Stream {
+        QString source;
+        std::deque<Pending> pending;
+        qint64 lastKey = 0;             // 最后一行的校正后时间（水位）
+        qint64 lastReceivedUs = -1;
+        qint64 skewMin = NoSkew;        // 当前窗口的最小偏差（主机时间 - 设备时间）
+        qint64 skewPrevMin = NoSkew;    // 上一个窗口的最小偏差
+        qint64 skewWindowStartUs = -1;
+
+        qint64 skewUs() const;
+        void sampleSkew(qint64 receivedUs, qint64 skewUs);
+    };
+
+    Stream &streamFor(const QString &source);
+    qint64 watermark(const Stream &stream, qint64 nowUs) const;
+    static LogBlockPtr slice(const LogBlockPtr &block, int first, int end);
+
+    std::vector<Stream> m_streams;
+};
+
+#endif // TIMELINEMERGER_H
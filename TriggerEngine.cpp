@@ -0,0 +1,286 @@
+#include "TriggerEngine.h"
+#include "PipelineStats.h"
+#include <QDateTime>
+#include <QDir>
+#include <QFile>
+#include <QJsonArray>
+#include <QJsonDocument>
+#include <QJsonObject>
+#include <QRegularExpression>
+#include <QTimer>
+#include <algorithm>
+
+namespace {
+
+const struct {
+    const char *name;
+    int action;
+} ActionNames[] = {
+    {"mark", TriggerRule::Mark},
+    {"freeze", TriggerRule::Freeze},
+    {"screenshot", TriggerRule::Screenshot},
+    {"bugreport", TriggerRule::Bugreport},
+};
+
+TriggerRule makeRule(const QString &name, const QStringList &patterns, int minLevel, int actions)
+{
+    TriggerRule rule;
+    rule.name = name;
+    rule.patterns = patterns;
+    rule.minLevel = minLevel;
+    rule.actions = actions;
+    return rule;
+}
+
+bool checkRuleTimes(const TriggerRule &rule, QString *error)
+{
+    const struct {
+        const char *key;
+        int value;
+    } times[] = {{"cooldown", rule.cooldownSec}, {"pre", rule.preSec}, {"post", rule.postSec}};
+    for (const auto &time : times) {
+        if (time.value < 0 || time.value > TriggerEngine::MaxRuleSec) {
+            if (error)
+                *error = QString("规则 %1 的 %2 超出范围（0 ~ %3 秒）: %4")
+                        .arg(rule.name).arg(QLatin1String(time.key)).arg(TriggerEngine::MaxRuleSec).arg(time.value);
+            return false;
+        }
+    }
+    return true;
+}
+
+}
+
+TriggerEngine::TriggerEngine(QObject *parent)
+    : QObject(parent), m_outputDir(QDir::currentPath() + "/device_logs/triggers")
+{
+    setRules(defaultRules());
+}
+
+QVector<TriggerRule> TriggerEngine::defaultRules()
+{
+    const int collect = TriggerRule::Mark | TriggerRule::Freeze | TriggerRule::Screenshot;
+    return {
+        makeRule("Java崩溃", {"FATAL EXCEPTION"}, 4, collect),
+        makeRule("Native崩溃", {"Fatal signal", "*** *** *** *** ***"}, 0, collect),
+        makeRule("ANR", {"ANR in "}, 0, collect),
+        makeRule("内核异常", {"Kernel panic", "Unable to handle kernel", "soft lockup", "Internal error: Oops"}, 0,
+                 TriggerRule::Mark | TriggerRule::Freeze),
+    };
+}
+
+bool TriggerEngine::parseRules(const QByteArray &json, QVector<TriggerRule> &rules, QString *error)
+{
+    QJsonParseError parseError;
+    const QJsonDocument doc = QJsonDocument::fromJson(json, &parseError);
+    if (parseError.error != QJsonParseError::NoError) {
+        *error = parseError.errorString();
+        return false;
+    }
+    if (!doc.isArray()) {
+        *error = "触发规则应为 JSON 数组";
+        return false;
+    }
+
+    rules.clear();
+    for (const QJsonValue &value : doc.array()) {
+        const QJsonObject obj = value.toObject();
+        TriggerRule rule;
+        rule.name = obj.value("name").toString();
+        if (rule.name.isEmpty()) {
+            *error = "触发规则缺少 name";
+            return false;
+        }
+        for (const QJsonValue &pattern : obj.value("patterns").toArray())
+            rule.patterns << pattern.toString();
+
+        const QString level = obj.value("level").toString();
+        if (!level.isEmpty()) {
+            rule.minLevel = -1;
+            for (int i = 0; i < LEVELS.size(); ++i) {
+                if (LEVELS[i].level.compare(level, Qt::CaseInsensitive) == 0)
+                    rule.minLevel = i;
+            }
+            if (rule.minLevel < 0) {
+                *error = "规则 " + rule.name + " 的级别无效: " + level;
+                return false;
+            }
+        }
+
+        if (obj.contains("actions")) {
+            rule.actions = 0;
+            for (const QJsonValue &action : obj.value("actions").toArray()) {
+                int flag = 0;
+                for (const auto &known : ActionNames) {
+                    if (action.toString() == QLatin1String(known.name))
+                        flag = known.action;
+                }
+                if (!flag) {
+                    *error = "规则 " + rule.name + " 的动作无效: " + action.toString();
+                    return false;
+                }
+                rule.actions |= flag;
+            }
+        }
+        // 负数按 0 处理；过大的值会让等待和保留时长失去意义，直接拒绝（按 double 比较，超出 int 的值不会回绕）
+        const struct {
+            const char *key;
+            int *value;
+        } times[] = {{"cooldown", &rule.cooldownSec}, {"pre", &rule.preSec}, {"post", &rule.postSec}};
+        for (const auto &time : times) {
+            const double seconds = obj.value(QLatin1String(time.key)).toDouble(*time.value);
+            if (seconds > MaxRuleSec) {
+                *error = QString("规则 %1 的 %2 超出上限 %3 秒: %4")
+                        .arg(rule.name).arg(QLatin1String(time.key)).arg(MaxRuleSec).arg(seconds);
+                return false;
+            }
+            *time.value = int(qMax(0.0, seconds));
+        }
+        rules.append(rule);
+    }
+    return true;
+}
+
+bool TriggerEngine::setRules(const QVector<TriggerRule> &rules, QString *error)
+{
+    for (const TriggerRule &rule : rules) {
+        if (!checkRuleTimes(rule, error))
+            return false;
+    }
+    const TriggerMatcherPtr matcher = TriggerMatcher::compile(rules, error);
+    if (!matcher)
+        return false;
+    m_matcher = matcher;
+    m_lastFiredUs.clear();
+
+    // 保留最长的前后窗口，再加上等待延迟的余量
+    qint64 retainSec = -1;
+    for (const TriggerRule &rule : rules) {
+        if (rule.actions & TriggerRule::Freeze)
+            retainSec = qMax(retainSec, qint64(rule.preSec) + rule.postSec);
+    }
+    m_retainUs = retainSec < 0 ? 0 : retainSec * 1000000 + qint64(FreezeSettleMs) * 2000;
+    if (m_retainUs == 0)
+        m_windows.clear();
+    for (LogWindowRecorder &window : m_windows)
+        window.setRetainUs(m_retainUs);
+    return true;
+}
+
+bool TriggerEngine::loadRules(const QString &fileName, QString *error)
+{
+    QFile file(fileName);
+    if (!file.open(QIODevice::ReadOnly)) {
+        *error = file.errorString();
+        return false;
+    }
+    QVector<TriggerRule> rules;
+    return parseRules(file.readAll(), rules, error) && setRules(rules, error);
+}
+
+// 记下各来源的行；命中的行按块中记下的规则（抓取线程匹配时使用的那一套）解释
+void TriggerEngine::onBlock(const LogBlockPtr &block)
+{
+    // 本地提示信息没有来源，不记录
+    if (m_retainUs > 0 && !block->source.isEmpty()) {
+        auto window = m_windows.find(block->source);
+        if (window == m_windows.end())
+            window = m_windows.insert(block->source, LogWindowRecorder(m_retainUs));
+        window->append(*block);
+
+        // 已停止输出的来源（会话结束、设备拔出）在最后一行过期后整个移除，不再占着最后一块
+        const qint64 expireUs = window->newestUs() - m_retainUs;
+        for (auto it = m_windows.begin(); it != m_windows.end();) {
+            if (it->newestUs() < expireUs)
+                it = m_windows.erase(it);
+            else
+                ++it;
+        }
+    }
+    if (!block->triggered || !block->triggers)
+        return;
+    const QVector<TriggerRule> &rules = block->triggers->rules();
+    for (const LogBlock::Line &line : block->lines) {
+        if (line.meta.trigger == 0)
+            continue;
+        const TriggerRule &rule = rules[line.meta.trigger - 1];
+        if (!(rule.actions & ~TriggerRule::Mark))
+            continue;
+        const QString key = rule.name + '\n' + block->source;
+        auto last = m_lastFiredUs.constFind(key);
+        if (last != m_lastFiredUs.constEnd() && line.receivedUs - *last < qint64(rule.cooldownSec) * 1000000)
+            continue;
+        m_lastFiredUs.insert(key, line.receivedUs);
+        fire(rule, block->source, *block, line);
+    }
+}
+
+void TriggerEngine::fire(const TriggerRule &rule, const QString &source, const LogBlock &block, const LogBlock::Line &line)
+{
+    Event event;
+    event.rule = rule;
+    event.source = source;
+    event.line = block.data.mid(line.offset, line.length);
+    event.receivedUs = line.receivedUs;
+
+    // 不同来源可能在同一毫秒内触发同一规则，名称中带上来源，仍重名时追加序号
+    const QRegularExpression unsafe("[\\\\/:*?\"<>|\\s]");
+    const QString baseDir = m_outputDir + "/" + QDateTime::currentDateTime().toString("yyyyMMdd_HHmmss_zzz") + "_"
+            + QString(source.isEmpty() ? QString("local") : source).replace(unsafe, "_") + "_"
+            + QString(rule.name).replace(unsafe, "_");
+    event.dir = baseDir;
+    for (int i = 2; QDir(event.dir).exists(); ++i)
+        event.dir = baseDir + "_" + QString::number(i);
+    QDir().mkpath(event.dir);
+    emit logMessage(QString("触发规则 [%1]（%2）: %3，现场保存至 %4")
+                    .arg(rule.name, source.isEmpty() ? QString("本地") : source,
+                         QString::fromUtf8(event.line), event.dir));
+
+    // 只有 adb 来源知道是哪台设备
+    const QString serial = source.startsWith("adb:") ? source.mid(4) : QString();
+    if (rule.actions & TriggerRule::Screenshot)
+        emit screenshotRequested(serial, event.dir + "/screenshot.png");
+    if (rule.actions & TriggerRule::Bugreport)
+        emit bugreportRequested(serial, event.dir + "/bugreport.zip");
+    if (rule.actions & TriggerRule::Freeze) {
+        const qint64 delayMs = (event.receivedUs + qint64(rule.postSec) * 1000000 - PipelineStats::nowUs()) / 1000
+                + FreezeSettleMs;
+        QTimer::singleShot(int(qMax<qint64>(0, delayMs)), this, [this, event]() { freezeWindow(event); });
+    }
+}
+
+// 各来源记下的行中接收时间在窗口内的部分，命中的来源在前，每个来源按到达顺序
+void TriggerEngine::freezeWindow(const Event &event)
+{
+    const qint64 fromUs = event.receivedUs - qint64(event.rule.preSec) * 1000000;
+    const qint64 toUs = event.receivedUs + qint64(event.rule.postSec) * 1000000;
+
+    QByteArray out;
+    out.append("# 触发规则: " + event.rule.name.toUtf8() + "\n");
+    out.append("# 来源: " + event.source.toUtf8() + "\n");
+    out.append("# 命中行: " + event.line + "\n");
+    out.append(QString("# 窗口: 命中前 %1 秒 ~ 命中后 %2 秒\n").arg(event.rule.preSec).arg(event.rule.postSec).toUtf8());
+
+    QStringList sources = m_windows.keys();
+    std::sort(sources.begin(), sources.end());
+    if (sources.removeOne(event.source))
+        sources.prepend(event.source);
+    int lines = 0;
+    for (const QString &source : sources) {
+        int count = 0;
+        const QByteArray text = m_windows.constFind(source)->window(fromUs, toUs, &count);
+        if (count == 0)
+            continue;
+        out.append(QString("\n## %1（%2 行）\n").arg(source).arg(count).toUtf8());
+        out.append(text);
+        lines += count;
+    }
+
+    const QString fileName = event.dir + "/window.txt";
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly) || file.write(out) != out.size()) {
+        emit logMessage("触发窗口保存失败: " + fileName);
+        return;
+    }
+    emit logMessage(QString("触发窗口已保存（%1 行）: %2").arg(lines).arg(fileName));
+}
@@ -0,0 +1,78 @@
+#ifndef TRIGGERENGINE_H
+#define TRIGGERENGINE_H
+
+#include <QObject>
+#include <QHash>
+#include "LogRecord.h"
+#include "LogWindowRecorder.h"
+#include "TriggerMatcher.h"
+
+// 触发器：等待崩溃等事件出现，自动收集现场
+// 规则在各抓取线程切行时逐行匹配（TriggerMatcher，见 CaptureSessionManager::setTriggers），
+// 命中的行随日志块到达界面线程后在这里执行动作：
+// - 标记：由 LogModel 在行进入存储时记下，这里不处理
+// - 截图、bugreport：针对产生该行的设备，串口等其他来源取当前设备
+// - 冻结窗口：各来源到达的日志块都交给 onBlock，按来源记下最近一段时间的行（LogWindowRecorder，
+//   不依赖日志视图的存储）；等命中后 postSec 内的行也到达，把前后窗口内的行另存为文件，
+//   命中的来源在前，其他来源各占一段
+// 一次触发的截图、bugreport 和日志窗口放在同一个目录 <输出目录>/<时间（毫秒）>_<来源>_<规则名>/ 中；
+// 同一规则在同一来源上有冷却时间，崩溃时连续输出的几十行只触发一次，不同设备各自触发
+class TriggerEngine : public QObject
+{
+    Q_OBJECT
+
+public:
+    static constexpr int FreezeSettleMs = 1500;          // 窗口结束后再等待的时间（抓取线程攒块的延迟）
+    static constexpr int MaxRuleSec = 3600;              // cooldown、pre、post 的上限
+
+    explicit TriggerEngine(QObject *parent = nullptr);
+
+    // 内置规则：Java 崩溃、native 崩溃、ANR、内核异常
+    static QVector<TriggerRule> defaultRules();
+    // JSON 数组，每项如：
+    // {"name": "crash", "patterns": ["FATAL EXCEPTION"], "level": "E",
+    //  "actions": ["mark", "freeze", "screenshot", "bugreport"], "cooldown": 30, "pre": 30, "post": 10}
+    static bool parseRules(const QByteArray &json, QVector<TriggerRule> &rules, QString *error);
+
+    // 编译规则，失败时保持原来的规则；时间超出 [0, MaxRuleSec] 的规则同样拒绝
+    bool setRules(const QVector<TriggerRule> &rules, QString *error = nullptr);
+    bool loadRules(const QString &fileName, QString *error);
+    const QVector<TriggerRule> &rules() const { return m_matcher->rules(); }
+    TriggerMatcherPtr matcher() const { return m_matcher; }
+
+    void setOutputDirectory(const QString &dir) { m_outputDir = dir; }
+    QString outputDirectory() const { return m_outputDir; }
+
+    // 界面线程收到的每个日志块（启用触发器期间），入队前调用
+    void onBlock(const LogBlockPtr &block);
+    // 丢弃各来源记下的行（关闭触发器时）
+    void clearWindows() { m_windows.clear(); }
+    // 当前记着行的来源
+    QStringList recordedSources() const { return m_windows.keys(); }
+
+signals:
+    // serial 为空表示取当前设备
+    void screenshotRequested(const QString &serial, const QString &fileName);
+    void bugreportRequested(const QString &serial, const QString &fileName);
+    void logMessage(const QString &msg);
+
+private:
+    struct Event {
+        TriggerRule rule;
+        QString source;
+        QByteArray line;
+        qint64 receivedUs = -1;
+        QString dir;
+    };
+
+    void fire(const TriggerRule &rule, const QString &source, const LogBlock &block, const LogBlock::Line &line);
+    void freezeWindow(const Event &event);
+
+    TriggerMatcherPtr m_matcher;
+    QString m_outputDir;
+    QHash<QString, qint64> m_lastFiredUs;     // 各规则在各来源上次执行动作的时间，键为 规则名 + '\n' + 来源
+    QHash<QString, LogWindowRecorder> m_windows;  // 各来源最近的行，没有冻结动作时不记录，停止输出的来源过期后移除
+    qint64 m_retainUs = 0;                    // 记录保留的时长，按规则中最长的前后窗口
+};
+
+#endif // TRIGGERENGINE_H
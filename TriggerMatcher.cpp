@@ -0,0 +1,141 @@
+#include "TriggerMatcher.h"
+#include "LogRecord.h"
+#include <QtAlgorithms>
+#include <deque>
+
+namespace {
+
+uchar foldCase(uchar c)
+{
+    return (c >= 'A' && c <= 'Z') ? uchar(c + ('a' - 'A')) : c;
+}
+
+}
+
+TriggerMatcherPtr TriggerMatcher::compile(const QVector<TriggerRule> &rules, QString *error)
+{
+    if (rules.size() > MaxRules) {
+        if (error)
+            *error = QString("触发规则最多 %1 条").arg(MaxRules);
+        return TriggerMatcherPtr();
+    }
+
+    QSharedPointer<TriggerMatcher> matcher(new TriggerMatcher);
+    matcher->m_rules = rules;
+
+    // 等价类：关键字中出现过的字节各一类（大小写字母同类）
+    QVector<QByteArray> patterns;
+    QVector<int> owners;
+    int classCount = 1;
+    for (int r = 0; r < rules.size(); ++r) {
+        if (rules[r].patterns.isEmpty()) {
+            if (error)
+                *error = "触发规则没有关键字: " + rules[r].name;
+            return TriggerMatcherPtr();
+        }
+        for (const QString &pattern : rules[r].patterns) {
+            QByteArray bytes = pattern.toUtf8();
+            if (bytes.isEmpty()) {
+                if (error)
+                    *error = "触发规则的关键字为空: " + rules[r].name;
+                return TriggerMatcherPtr();
+            }
+            for (char &c : bytes) {
+                c = char(foldCase(uchar(c)));
+                if (matcher->m_class[uchar(c)] == 0)
+                    matcher->m_class[uchar(c)] = quint8(classCount++);
+            }
+            patterns.append(bytes);
+            owners.append(r);
+        }
+    }
+    for (int c = 'A'; c <= 'Z'; ++c)
+        matcher->m_class[c] = matcher->m_class[c - 'A' + 'a'];
+
+    while ((1 << matcher->m_shift) < classCount)
+        ++matcher->m_shift;
+    const int width = 1 << matcher->m_shift;
+
+    // 字典树，-1 表示没有该转移
+    std::vector<int> go(width, -1);
+    std::vector<quint64> output(1, 0);
+    for (int i = 0; i < patterns.size(); ++i) {
+        int state = 0;
+        for (char c : patterns[i]) {
+            const int cls = matcher->m_class[uchar(c)];
+            int &target = go[size_t(state) * width + cls];
+            if (target < 0) {
+                target = int(output.size());
+                output.push_back(0);
+                go.resize(go.size() + width, -1);
+            }
+            state = go[size_t(state) * width + cls];
+        }
+        output[state] |= quint64(1) << owners[i];
+    }
+    if (output.size() > size_t(MaxStates)) {
+        if (error)
+            *error = "触发规则的关键字总长度过长";
+        return TriggerMatcherPtr();
+    }
+
+    // 按层补全失配转移，得到确定自动机；命中集合沿失配链合并
+    std::vector<int> fail(output.size(), 0);
+    std::deque<int> queue;
+    for (int cls = 0; cls < width; ++cls) {
+        int &target = go[cls];
+        if (target < 0) {
+            target = 0;
+        } else {
+            fail[target] = 0;
+            queue.push_back(target);
+        }
+    }
+    while (!queue.empty()) {
+        const int state = queue.front();
+        queue.pop_front();
+        output[state] |= output[fail[state]];
+        for (int cls = 0; cls < width; ++cls) {
+            int &target = go[size_t(state) * width + cls];
+            const int fallback = go[size_t(fail[state]) * width + cls];
+            if (target < 0) {
+                target = fallback;
+            } else {
+                fail[target] = fallback;
+                queue.push_back(target);
+            }
+        }
+    }
+
+    matcher->m_next.assign(go.begin(), go.end());
+    matcher->m_output = std::move(output);
+    matcher->m_levelRules.assign(LEVELS.size(), 0);
+    for (int level = 0; level < LEVELS.size(); ++level) {
+        for (int r = 0; r < rules.size(); ++r) {
+            if (level >= rules[r].minLevel)
+                matcher->m_levelRules[level] |= quint64(1) << r;
+        }
+    }
+    return matcher;
+}
+
+int TriggerMatcher::match(const char *data, qsizetype length, int level) const
+{
+    const quint64 allowed = m_levelRules[qBound(0, level, int(m_levelRules.size()) - 1)];
+    if (!allowed)
+        return -1;
+
+    const quint16 *next = m_next.data();
+    const quint64 *output = m_output.data();
+    const int shift = m_shift;
+    const uchar *p = reinterpret_cast<const uchar *>(data);
+    const uchar *end = p + length;
+    unsigned state = 0;
+    for (; p < end; ++p) {
+        state = next[(state << shift) | m_class[*p]];
+        const quint64 hits = output[state] & allowed;
+        if (hits)
+            return qCountTrailingZeroBits(hits);
+    }
+    return -1;
+}
@@ -0,0 +1,59 @@
+#ifndef TRIGGERMATCHER_H
+#define TRIGGERMATCHER_H
+
+#include <QString>
+#include <QStringList>
+#include <QVector>
+#include <QSharedPointer>
+#include <vector>
+
+// 触发规则：日志行中出现任一关键字时执行的动作
+struct TriggerRule {
+    enum Action {
+        Mark = 0x1,             // 在日志视图中标记该行，可以在标记之间跳转
+        Freeze = 0x2,           // 把命中前后一段时间的日志另存到文件
+        Screenshot = 0x4,       // 设备截图
+        Bugreport = 0x8         // adb bugreport
+    };
+
+    QString name;
+    QStringList patterns;       // 关键字（ASCII 不区分大小写）
+    int minLevel = 0;           // 只匹配不低于该级别的行（LEVELS 下标）
+    int actions = Mark;
+    int cooldownSec = 30;       // 同一规则两次执行动作的最短间隔（标记不受限制）
+    int preSec = 30;            // Freeze 保存命中前后各多长时间的日志
+    int postSec = 10;
+};
+
+// 触发规则的多模式匹配（Aho-Corasick）
+// 全部规则的关键字编译成一个确定自动机，每行只扫描一遍，每字节一次查表，耗时与关键字数量无关；
+// 字节先映射到等价类（关键字中出现过的字节各一类，其余共用一类），转移表很小，常驻缓存
+// 编译后只读，各抓取线程共享同一份
+class TriggerMatcher
+{
+public:
+    static constexpr int MaxRules = 64;
+    static constexpr int MaxStates = 65535;
+
+    // 编译规则，规则过多、关键字为空或总长度过长时返回空指针
+    static QSharedPointer<const TriggerMatcher> compile(const QVector<TriggerRule> &rules, QString *error = nullptr);
+
+    const QVector<TriggerRule> &rules() const { return m_rules; }
+
+    // 行中最先出现的关键字所属的规则编号（只考虑级别符合的规则），没有命中返回 -1
+    int match(const char *data, qsizetype length, int level) const;
+
+private:
+    TriggerMatcher() = default;
+
+    QVector<TriggerRule> m_rules;
+    quint8 m_class[256] = {};           // 字节 → 等价类，0 为关键字中没有的字节
+    int m_shift = 0;                    // 转移表每个状态占 1 << m_shift 项
+    std::vector<quint16> m_next;        // [状态 << m_shift | 等价类] → 下一状态
+    std::vector<quint64> m_output;      // 到达该状态时命中的规则（位集合，含后缀上的命中）
+    std::vector<quint64> m_levelRules;  // 每个级别参与匹配的规则
+};
+
+using TriggerMatcherPtr = QSharedPointer<const TriggerMatcher>;
+
+#endif // TRIGGERMATCHER_H
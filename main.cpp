@@ -1,8 +1,95 @@
 #include <QApplication>
 #include <QIcon>
+#include <cstdio>
+#include <cstring>
 #include "MainWindow.h"
+#include "HeadlessCapture.h"
+#include "BenchRunner.h"
+
+#ifdef Q_OS_WIN
+#include <windows.h>
+
+// 程序是 GUI 子系统，从命令行启动时挂到父控制台上；已重定向的输出保持不变
+static void attachParentConsole()
+{
+    if (AttachConsole(ATTACH_PARENT_PROCESS)) {
+        if (!GetStdHandle(STD_OUTPUT_HANDLE))
+            freopen("CONOUT$", "w", stdout);
+        if (!GetStdHandle(STD_ERROR_HANDLE))
+            freopen("CONOUT$", "w", stderr);
+    }
+}
+#endif
+
+// 无界面抓取：FaeDiag --capture [选项]，不创建任何窗口
+static int runHeadlessCapture(int argc, char *argv[])
+{
+#ifdef Q_OS_WIN
+    attachParentConsole();
+#endif
+
+    QCoreApplication a(argc, argv);
+
+    HeadlessCapture::Options options;
+    QString error, help;
+    if (!HeadlessCapture::parseArguments(a.arguments(), options, &error, &help)) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return 2;
+    }
+    if (!help.isEmpty()) {
+        fputs(qPrintable(help), stdout);
+        return 0;
+    }
+
+    HeadlessCapture capture(options);
+    if (!capture.start())
+        return 1;
+    return a.exec();
+}
+
+// 吞吐基准：FaeDiag --bench [选项]，不需要真实设备
+// 日志视图照常创建和绘制，默认使用 offscreen 平台不弹出窗口（设置 QT_QPA_PLATFORM 可以改为真实显示）
+static int runBench(int argc, char *argv[])
+{
+#ifdef Q_OS_WIN
+    attachParentConsole();
+#endif
+
+    if (!qEnvironmentVariableIsSet("QT_QPA_PLATFORM"))
+        qputenv("QT_QPA_PLATFORM", "offscreen");
+    QApplication a(argc, argv);
+
+    BenchRunner::Options options;
+    QString error, help;
+    if (!BenchRunner::parseArguments(a.arguments(), options, &error, &help)) {
+        fprintf(stderr, "%s\n", qPrintable(error));
+        return 2;
+    }
+    if (!help.isEmpty()) {
+        fputs(qPrintable(help), stdout);
+        return 0;
+    }
+
+    BenchRunner bench(options);
+    if (!bench.start())
+        return 1;
+    return a.exec();
+}
 
 int main(int argc, char *argv[]) {
+    // 基准模式启动的模拟 adb 子进程
+    if (qEnvironmentVariableIsSet(BenchRunner::FakeAdbEnv)) {
+        QCoreApplication a(argc, argv);
+        return BenchRunner::runFakeAdb(a.arguments(), qgetenv(BenchRunner::FakeAdbEnv));
+    }
+
+    for (int i = 1; i < argc; ++i) {
+        if (strcmp(argv[i], "--capture") == 0)
+            return runHeadlessCapture(argc, argv);
+        if (strcmp(argv[i], "--bench") == 0)
+            return runBench(argc, argv);
+    }
+
     QApplication a(argc, argv);
     a.setWindowIcon(QIcon(":/icons/MyApp.ico"));   // 设置应用程序图标（任务栏和窗口标题栏）
     
@@ -2,24 +2,46 @@
 #include "ui_MainWindow.h"
 #include "AdbManager.h"
 #include "SerialPortManager.h"
+#include "LogModel.h"
+#include "LogViewPipeline.h"
+#include "SessionLogModel.h"
+#include "LogBlockBuilder.h"
+#include "LogFileImporter.h"
+#include "CaptureSessionManager.h"
+#include "ScreenCapture.h"
+#include "PipelineStats.h"
+#include "StatsPanel.h"
+#include "FrameScheduler.h"
+#include "TriggerEngine.h"
 
 #include <QDateTime>
-#include <QScrollBar>
 #include <QMessageBox>
 #include <QFileDialog>
 #include <QDir>
 #include <QPixmap>
-#include <QRegularExpression>
 #include <QTextStream>
 #include <QSerialPortInfo>
 #include <QCoreApplication>
 #include <QFileInfo>
+#include <QProgressBar>
+#include <QSignalBlocker>
+#include <QElapsedTimer>
+#include <QDockWidget>
+#include <QMenuBar>
+#include <QMenu>
+#include <QAction>
+#include <algorithm>
 
 MainWindow::MainWindow(QWidget *parent)
     : QMainWindow(parent), ui(new Ui::MainWindow),
-      serialManager(new SerialPortManager(this)),
+      logModel(new LogModel(LogStore::DefaultCapacity, this)),
+      sessionModel(new SessionLogModel(this)),
+      importer(new LogFileImporter(this)),
       adbManager(new AdbManager(this))
 {
+    captureManager = new CaptureSessionManager(adbManager->getAdbPath(), this);
+    serialManager = new SerialPortManager(captureManager, this);
+
     ui->setupUi(this);
 
     // 初始化UI
@@ -28,29 +50,141 @@ MainWindow::MainWindow(QWidget *parent)
     connect(ui->functionList, &QListWidget::currentRowChanged, this, &MainWindow::onFunctionChanged);
 
     ui->filterLevelCombo->addItems({"ALL", "V", "D", "I", "W", "E"});
+    ui->deviceCombo->addItem("全部设备", QString());
     ui->autoScrollCheck->setChecked(true);
-    ui->logTextEdit->setFont(QFont("Consolas", 10));
+
+    // 日志视图：只绘制可见行，行高固定；数据经显示流水线按帧进入模型
+    ui->logView->setModel(logModel);
+    LogViewPipeline::configureView(ui->logView);
+    logPipeline = new LogViewPipeline(logModel, ui->logView, this);
+
+    // 过滤条件变化时基于历史记录重新过滤（关键字输入做防抖）
+    filterTimer = new QTimer(this);
+    filterTimer->setSingleShot(true);
+    filterTimer->setInterval(200);
+    connect(filterTimer, &QTimer::timeout, this, &MainWindow::applyLogFilter);
+    connect(ui->filterKeywordEdit, &QLineEdit::textChanged, filterTimer, qOverload<>(&QTimer::start));
+    connect(ui->filterLevelCombo, QOverload<int>::of(&QComboBox::currentIndexChanged), this, &MainWindow::applyLogFilter);
+
+    // 全文搜索：回车执行，上一个/下一个在命中之间跳转
+    connect(ui->searchEdit, &QLineEdit::returnPressed, this, &MainWindow::runSearch);
+    connect(ui->btnSearchNext, &QPushButton::clicked, this, [this]() { gotoSearchHit(1); });
+    connect(ui->btnSearchPrev, &QPushButton::clicked, this, [this]() { gotoSearchHit(-1); });
 
     // 连接按钮信号
+    connect(ui->compressLogCheck, &QCheckBox::toggled, this, [this](bool enabled) {
+        captureManager->setCompression(enabled);
+    });
     connect(ui->btnStartLog, &QPushButton::clicked, this, &MainWindow::startLogcat);
     connect(ui->btnStopLog, &QPushButton::clicked, this, &MainWindow::stopLogcat);
     connect(ui->btnExportLog, &QPushButton::clicked, this, &MainWindow::exportLog);
+    connect(ui->btnOpenSession, &QPushButton::clicked, this, &MainWindow::openSession);
+    connect(ui->btnImportLog, &QPushButton::clicked, this, &MainWindow::importLogFile);
     connect(ui->btnScreenshot, &QPushButton::clicked, this, &MainWindow::captureScreenshot);
+    connect(ui->btnBurst, &QPushButton::toggled, this, &MainWindow::toggleBurst);
+    connect(ui->rawScreencapCheck, &QCheckBox::toggled, this, [this](bool raw) {
+        adbManager->screenCapture()->setMode(raw ? ScreenCapture::Raw : ScreenCapture::Png);
+    });
+
+    // 离线导入：解析好的块与实时日志走同一条队列，进度显示在状态栏
+    importProgress = new QProgressBar(this);
+    importProgress->setRange(0, 1000);
+    importProgress->setMaximumWidth(200);
+    importProgress->hide();
+    ui->statusbar->addPermanentWidget(importProgress);
+    connect(importer, &LogFileImporter::blockReady, this, &MainWindow::onLogBlockReceived);
+    // 显示队列积压时暂停导入，界面取走一批后继续
+    importer->setBacklog([this]() { return logPipeline->queueSize(); });
+    connect(logPipeline, &LogViewPipeline::blocksAppended, importer, &LogFileImporter::resume);
+    connect(importer, &LogFileImporter::progress, this, [this](qint64 done, qint64 total) {
+        importProgress->setValue(int(done * 1000 / qMax<qint64>(1, total)));
+    });
+    connect(importer, &LogFileImporter::finished, this, &MainWindow::onImportFinished);
+
+    // 流水线统计：停靠窗口默认隐藏，从“视图”菜单打开；日志视图绘制时统计端到端延迟和帧耗时
+    statsPanel = new StatsPanel(this);
+    QDockWidget *statsDock = new QDockWidget("流水线统计", this);
+    statsDock->setObjectName("statsDock");
+    statsDock->setWidget(statsPanel);
+    addDockWidget(Qt::RightDockWidgetArea, statsDock);
+    statsDock->hide();
+    QMenu *viewMenu = menuBar()->addMenu("视图");
+    viewMenu->addAction(statsDock->toggleViewAction());
+
+    // 多路日志（各设备的 logcat、串口控制台）按校正后的时间交错显示，关闭后按到达顺序显示
+    QAction *mergeAction = viewMenu->addAction("多路日志按时间合并");
+    mergeAction->setCheckable(true);
+    mergeAction->setChecked(logPipeline->timelineMerge());
+    connect(mergeAction, &QAction::toggled, logPipeline, &LogViewPipeline::setTimelineMerge);
+
+    // 触发器：规则在抓取线程逐行匹配，命中时自动截图、抓 bugreport、标记并保存前后的日志窗口
+    triggerEngine = new TriggerEngine(this);
+    connect(triggerEngine, &TriggerEngine::logMessage, this, &MainWindow::appendLog);
+    connect(triggerEngine, &TriggerEngine::screenshotRequested, this, [this](const QString &serial, const QString &fileName) {
+        if (!adbManager->captureScreenshot(serial, fileName)) {
+            appendLog("触发截图跳过：没有可用的设备或上一张截图尚未完成");
+            return;
+        }
+        m_triggerShots << fileName;
+    });
+    connect(triggerEngine, &TriggerEngine::bugreportRequested, this, [this](const QString &serial, const QString &fileName) {
+        if (!adbManager->captureBugreport(serial, fileName))
+            appendLog("触发 bugreport 跳过：没有可用的设备或上一个 bugreport 尚未完成");
+    });
+    QMenu *triggerMenu = menuBar()->addMenu("触发器");
+    QAction *triggerAction = triggerMenu->addAction("启用触发器");
+    triggerAction->setCheckable(true);
+    connect(triggerAction, &QAction::toggled, this, &MainWindow::setTriggersEnabled);
+    triggerMenu->addAction("加载触发规则...", this, &MainWindow::loadTriggerRules);
+    triggerMenu->addSeparator();
+    triggerMenu->addAction("上一个触发标记", QKeySequence(Qt::SHIFT | Qt::Key_F4), this, [this]() { gotoMark(-1); });
+    triggerMenu->addAction("下一个触发标记", QKeySequence(Qt::Key_F4), this, [this]() { gotoMark(1); });
 
     // 串口相关连接
     connect(ui->refreshPortsBtn, &QPushButton::clicked, this, &MainWindow::refreshSerialPorts);
     connect(ui->openPortBtn, &QPushButton::clicked, this, &MainWindow::openSerialPort);
     connect(ui->closePortBtn, &QPushButton::clicked, this, &MainWindow::closeSerialPort);
+    connect(ui->rawCaptureCheck, &QCheckBox::toggled, this, [this](bool enabled) {
+        captureManager->setRawSerialCapture(enabled);
+    });
+    ui->replaySpeedCombo->addItem("1x", 1.0);
+    ui->replaySpeedCombo->addItem("4x", 4.0);
+    ui->replaySpeedCombo->addItem("16x", 16.0);
+    ui->replaySpeedCombo->addItem("最快", 0.0);
+    connect(ui->btnReplay, &QPushButton::toggled, this, &MainWindow::toggleReplay);
 
     // 连接串口管理器的信号
-    connect(serialManager, &SerialPortManager::dataReceived, this, &MainWindow::onSerialDataReceived);
+    connect(captureManager, &CaptureSessionManager::blockReceived, this, &MainWindow::onLogBlockReceived);
+    connect(captureManager, &CaptureSessionManager::logMessage, this, &MainWindow::appendLog);
+    connect(captureManager, &CaptureSessionManager::sessionStarted, this, [this](const QString &source, const QString &fileName) {
+        if (source.startsWith("adb:"))
+            appendLog("开始实时抓取日志 " + source.mid(4) + "，保存至 " + fileName);
+    });
+    connect(captureManager, &CaptureSessionManager::sessionStopped, this, [this](const QString &source) {
+        if (source.startsWith("adb:"))
+            appendLog("日志抓取已结束: " + source.mid(4));
+        if (source == m_replaySource) {
+            m_replaySource.clear();
+            appendLog("回放已结束: " + source.mid(7));
+            QSignalBlocker blocker(ui->btnReplay);
+            ui->btnReplay->setChecked(false);
+        }
+    });
     connect(serialManager, &SerialPortManager::portOpened, this, &MainWindow::onPortOpened);
     connect(serialManager, &SerialPortManager::portClosed, this, &MainWindow::onPortClosed);
     connect(serialManager, &SerialPortManager::errorOccurred, this, &MainWindow::onSerialError);
 
     // 连接ADB管理器的信号
-    m_adbManager = new AdbManager(this);  // 实例化先
-    connect(m_adbManager, &AdbManager::logMessage, this, &MainWindow::appendLog);     // 新增日志窗口提示信号
+    connect(adbManager, &AdbManager::logMessage, this, &MainWindow::appendLog);
+    connect(adbManager, &AdbManager::onlineDevicesChanged, this, [this](const QStringList &serials) {
+        // 第 0 项为全部设备，其后为各在线设备
+        const QString current = ui->deviceCombo->currentData().toString();
+        ui->deviceCombo->clear();
+        ui->deviceCombo->addItem("全部设备", QString());
+        for (const QString &serial : serials)
+            ui->deviceCombo->addItem(serial, serial);
+        ui->deviceCombo->setCurrentIndex(qMax(0, ui->deviceCombo->findData(current)));
+    });
     connect(adbManager, &AdbManager::deviceStatusUpdated, this, [this](const QString &status, const QString &color, 
              const QString &serial, const QString &brand, const QString &model, const QString &androidVer, const QString &imagePath) {
         ui->statusLabel->setText("设备状态: " + status);
@@ -69,8 +203,14 @@ MainWindow::MainWindow(QWidget *parent)
                 ui->deviceImageLabel->setText("(无产品图片)");
             }
     });
+    connect(adbManager->screenCapture(), &ScreenCapture::burstFinished, this, [this]() {
+        QSignalBlocker blocker(ui->btnBurst);
+        ui->btnBurst->setChecked(false);
+    });
     connect(adbManager, &AdbManager::screenshotCaptured, this, [this](const QString &filePath) {
         appendLog("截图已保存: " + filePath);
+        if (m_triggerShots.removeOne(filePath))
+            return;
         showInfo("完成", "截图已保存至:\n" + filePath);
     });
     // 使用lambda解决参数不匹配问题
@@ -78,25 +218,29 @@ MainWindow::MainWindow(QWidget *parent)
         showError("ADB错误", msg);
     });
 
-    // 初始化定时器
-    logUpdateTimer = new QTimer(this);
-    connect(logUpdateTimer, &QTimer::timeout, this, &MainWindow::processLogQueue);
-    logUpdateTimer->start(100);
+    // 日志视图刷新：有数据时按帧调度，空闲时不唤醒
+    connect(logPipeline, &LogViewPipeline::appended, this, [this](bool wasAtBottom) {
+        if (!isViewingSession() && ui->autoScrollCheck->isChecked() && wasAtBottom)
+            ui->logView->scrollToBottom();
+    });
+    connect(logPipeline->scheduler(), &FrameScheduler::backlogGrowing, this, [this](int backlog) {
+        statusBar()->showMessage(QString("界面刷新跟不上日志速度，积压 %1 个日志块（队列满时丢弃最旧的数据）")
+                                 .arg(backlog));
+    });
+    connect(logPipeline->scheduler(), &FrameScheduler::backlogCleared, this, [this]() {
+        statusBar()->showMessage("日志积压已清空", 3000);
+    });
 
-    // 初始检查设备状态
-    // adbManager->checkDeviceStatus(); // 这里不需要立即检查，等用户点击ADB功能时再检查
+    // 设备状态由 AdbManager 在设备插拔时主动推送
     refreshSerialPorts();
-
-    // 定时检查设备ADB状态
-    QTimer *timer = new QTimer(this);
-    connect(timer, &QTimer::timeout, m_adbManager, &AdbManager::checkDeviceStatus);
-    timer->start(3000);  // 每3秒检测一次设备状态
-
 }
 
 MainWindow::~MainWindow() {
     stopLogcat();
     closeSerialPort();
+    // serialManager 引用 captureManager，而后者先创建、会先被 QObject 析构
+    delete serialManager;
+    serialManager = nullptr;
     delete ui;
 }
 
@@ -130,16 +274,6 @@ void MainWindow::closeSerialPort() {
     serialManager->closePort();
 }
 
-void MainWindow::onSerialDataReceived(const QString &data) {
-    QList<QByteArray> lines = data.toUtf8().split('\n');
-    for (const QByteArray &line : lines) {
-        QString msg = QString::fromUtf8(line).trimmed();
-        if (!msg.isEmpty()) {
-            m_logQueue.push(msg);
-        }
-    }
-}
-
 void MainWindow::onPortOpened(bool success, const QString &message) {
     if (success) {
         appendLog(message);
@@ -158,70 +292,80 @@ void MainWindow::onSerialError(const QString &error) {
     showError("串口错误", error);
 }
 
-QColor MainWindow::colorForLevel(const QString& level) {
-    for (const auto &ll : LEVELS) {
-        if (ll.level == level)
-            return ll.color;
+// 回放串口原始数据文件（.fdr）：数据经过与实时串口相同的切行、解析流程进入日志视图
+void MainWindow::toggleReplay(bool start) {
+    if (!start) {
+        if (!m_replaySource.isEmpty())
+            captureManager->stop(m_replaySource);
+        return;
     }
-    return Qt::black;
-}
 
-int MainWindow::levelIndex(const QString &level) {
-    for (int i = 0; i < LEVELS.size(); ++i)
-        if (LEVELS[i].level == level) return i;
-    return 2; // 默认I
+    const QString filePath = QFileDialog::getOpenFileName(this, "打开串口原始数据文件", QDir::currentPath() + "/device_logs",
+                                                          "Serial Raw Capture (*.fdr)");
+    QString error;
+    if (filePath.isEmpty() || !captureManager->startReplay(filePath, ui->replaySpeedCombo->currentData().toDouble(), &error)) {
+        QSignalBlocker blocker(ui->btnReplay);
+        ui->btnReplay->setChecked(false);
+        if (!error.isEmpty())
+            showError("错误", "回放失败:\n" + error);
+        return;
+    }
+    m_replaySource = CaptureSessionManager::replaySource(filePath);
+    showLiveLog();
+    appendLog(QString("开始回放 %1（%2）").arg(filePath, ui->replaySpeedCombo->currentText()));
 }
 
-void MainWindow::processLogQueue() {
-    QString msg;
-    while (m_logQueue.pop(msg)) {
-        bool showMessage = true;
-
-        QString levelChar = "I";
-        QRegularExpression re(R"(\b([VDIWE])[/\s])");
-        QRegularExpressionMatch match = re.match(msg);
-        if (match.hasMatch()) {
-            levelChar = match.captured(1);
-        }
-
-        QString keyword = ui->filterKeywordEdit->text().trimmed();
-        if (!keyword.isEmpty() && !msg.contains(keyword, Qt::CaseInsensitive))
-            showMessage = false;
-
-        QString currentFilter = ui->filterLevelCombo->currentText();
-        if (currentFilter != "ALL") {
-            int minLevelIndex = levelIndex(currentFilter);
-            int msgLevelIndex = levelIndex(levelChar);
-            if (msgLevelIndex < minLevelIndex)
-                showMessage = false;
-        }
+void MainWindow::onLogBlockReceived(const LogBlockPtr &block) {
+    // 触发动作在入队前执行，队列积压或溢出时也不会错过；冻结窗口所需的各来源日志也在这里记下
+    if (m_triggersEnabled)
+        triggerEngine->onBlock(block);
+    logPipeline->push(block);
+}
 
-        if (showMessage) {
-            QTextCharFormat fmt;
-            fmt.setForeground(colorForLevel(levelChar));
-            ui->logTextEdit->setCurrentCharFormat(fmt);
-            ui->logTextEdit->append(msg);
-        }
+void MainWindow::applyLogFilter() {
+    // 下拉框第 0 项为 ALL，其后依次对应 LEVELS
+    int minLevel = qMax(0, ui->filterLevelCombo->currentIndex() - 1);
+    if (isViewingSession()) {
+        // 会话文件按 TAG 过滤，可以借助块索引跳过无关数据
+        sessionModel->setFilter(minLevel, ui->filterKeywordEdit->text().trimmed().toUtf8());
+        return;
     }
+    logModel->setFilter(minLevel, ui->filterKeywordEdit->text().trimmed());
 
-    auto sb = ui->logTextEdit->verticalScrollBar();
-    bool atBottom = (sb->value() >= sb->maximum() - 3);
-    if (ui->autoScrollCheck->isChecked() && atBottom) {
-        sb->setValue(sb->maximum());
+    if (ui->autoScrollCheck->isChecked()) {
+        ui->logView->scrollToBottom();
     }
 }
 
+// 对选中的设备（或全部在线设备）各自启动一路 logcat 抓取
 void MainWindow::startLogcat() {
-    adbManager->startLogcat();
+    QStringList serials = adbManager->onlineDevices();
+    const QString selected = ui->deviceCombo->currentData().toString();
+    if (!selected.isEmpty())
+        serials = serials.contains(selected) ? QStringList{selected} : QStringList();
+    if (serials.isEmpty()) {
+        showError("ADB错误", "未检测到ADB设备");
+        return;
+    }
+
+    showLiveLog();
+    QStringList errors;
+    for (const QString &serial : serials) {
+        QString error;
+        if (!captureManager->startLogcat(serial, &error))
+            errors << error;
+    }
+    if (!errors.isEmpty())
+        showError("ADB错误", errors.join('\n'));
 }
 
 void MainWindow::stopLogcat() {
-    adbManager->stopLogcat();
+    captureManager->stopAllLogcat();
 }
 
 void MainWindow::exportLog() {
-    QString content = ui->logTextEdit->toPlainText().trimmed();
-    if (content.isEmpty()) {
+    QAbstractItemModel *model = ui->logView->model();
+    if (model->rowCount() == 0) {
         showWarning("提示", "当前没有可导出的日志");
         return;
     }
@@ -232,22 +376,219 @@ void MainWindow::exportLog() {
         QFile f(filePath);
         if (f.open(QIODevice::WriteOnly | QIODevice::Text)) {
             QTextStream out(&f);
-            out << content;
+            for (int row = 0; row < model->rowCount(); ++row)
+                out << model->index(row, 0).data().toString() << '\n';
             f.close();
             showInfo("完成", "已导出筛选日志至:\n" + filePath);
         }
     }
 }
 
+// 打开已保存的会话文件（.fdl），以内存映射方式浏览，不影响正在进行的抓取
+void MainWindow::openSession() {
+    QString filePath = QFileDialog::getOpenFileName(this, "打开会话文件", QDir::currentPath() + "/device_logs",
+                                                    "FaeDiag Session (*.fdl)");
+    if (filePath.isEmpty())
+        return;
+
+    QString error;
+    if (!sessionModel->open(filePath, &error)) {
+        showError("错误", "会话文件打开失败:\n" + error);
+        return;
+    }
+
+    ui->logView->setModel(sessionModel);
+    ui->filterKeywordEdit->setPlaceholderText("会话文件按 TAG 过滤");
+    applyLogFilter();
+    appendLog("已打开会话文件: " + filePath);
+}
+
+void MainWindow::runSearch() {
+    m_searchHits.clear();
+    m_searchCurrent = -1;
+    const QString text = ui->searchEdit->text().trimmed();
+    if (text.isEmpty()) {
+        ui->searchResultLabel->clear();
+        return;
+    }
+    if (isViewingSession()) {
+        ui->searchResultLabel->setText("会话文件请使用 TAG 过滤");
+        return;
+    }
+
+    LogSearchIndex::Query query = LogSearchIndex::parseQuery(text, ui->searchRegexCheck->isChecked());
+    QElapsedTimer timer;
+    timer.start();
+    QString error;
+    if (!logModel->search(query, m_searchHits, &error)) {
+        ui->searchResultLabel->setText("正则无效: " + error);
+        return;
+    }
+    ui->searchResultLabel->setText(QString("%1 处（%2 ms）").arg(m_searchHits.size()).arg(timer.elapsed()));
+    ui->autoScrollCheck->setChecked(false);     // 停止自动滚动，便于查看命中行
+    gotoSearchHit(1);
+}
+
+// 跳到下一个/上一个命中；被当前过滤条件隐藏或已滚出缓冲的命中会被跳过
+void MainWindow::gotoSearchHit(int direction) {
+    if (m_searchHits.empty() || isViewingSession())
+        return;
+
+    const int count = int(m_searchHits.size());
+    int index = m_searchCurrent;
+    for (int tried = 0; tried < count; ++tried) {
+        index = (index + direction + count) % count;
+        const int row = logModel->rowForSeq(m_searchHits[index]);
+        if (row < 0)
+            continue;
+        m_searchCurrent = index;
+        const QModelIndex modelIndex = logModel->index(row, 0);
+        ui->logView->setCurrentIndex(modelIndex);
+        ui->logView->scrollTo(modelIndex, QAbstractItemView::PositionAtCenter);
+        ui->searchResultLabel->setText(QString("%1 / %2").arg(index + 1).arg(count));
+        return;
+    }
+    ui->searchResultLabel->setText(QString("%1 处均不在当前显示范围内").arg(count));
+}
+
+// 导入离线日志文件（logcat / 串口文本），多核并行解析，按文件顺序边解析边显示
+void MainWindow::importLogFile() {
+    if (!captureManager->sources().isEmpty()) {
+        showWarning("提示", "请先停止日志抓取并关闭串口");
+        return;
+    }
+
+    // 可以一次选择多个文件（如轮转出的各个压缩分段），按文件名顺序导入
+    QStringList filePaths = QFileDialog::getOpenFileNames(this, "打开日志文件", QDir::currentPath() + "/device_logs",
+                                                          "Log Files (*.txt *.log *.fdz);;All Files (*)");
+    if (filePaths.isEmpty())
+        return;
+    filePaths.sort();
+
+    showLiveLog();
+    importer->cancel();
+    logPipeline->clear();
+    logModel->clear();
+
+    QString error;
+    if (!importer->start(filePaths, &error)) {
+        showError("错误", "日志文件打开失败:\n" + error);
+        return;
+    }
+    importProgress->setValue(0);
+    importProgress->show();
+    statusBar()->showMessage("正在导入: " + filePaths.join(", "));
+}
+
+void MainWindow::onImportFinished(qint64 lineCount, qint64 elapsedMs) {
+    importProgress->hide();
+    statusBar()->showMessage(QString("导入完成: %1 行，用时 %2 ms").arg(lineCount).arg(elapsedMs), 5000);
+    if (lineCount > logModel->store().capacity())
+        appendLog(QString("文件共 %1 行，超出日志缓冲容量，仅保留最新的 %2 行")
+                  .arg(lineCount).arg(logModel->store().capacity()));
+}
+
 void MainWindow::captureScreenshot() {
     adbManager->captureScreenshot();
 }
 
+void MainWindow::toggleBurst(bool start) {
+    if (start) {
+        adbManager->startScreenshotBurst(ui->burstFpsSpin->value());
+        if (!adbManager->screenCapture()->isBursting()) {
+            QSignalBlocker blocker(ui->btnBurst);
+            ui->btnBurst->setChecked(false);
+        }
+    } else {
+        adbManager->stopScreenshotBurst();
+    }
+}
+
+// 规则交给抓取线程逐行匹配，关闭时各线程不再匹配
+void MainWindow::setTriggersEnabled(bool enabled) {
+    m_triggersEnabled = enabled;
+    captureManager->setTriggers(enabled ? triggerEngine->matcher() : TriggerMatcherPtr());
+    if (enabled) {
+        QStringList names;
+        for (const TriggerRule &rule : triggerEngine->rules())
+            names << rule.name;
+        appendLog("触发器已启用: " + names.join(", ") + "，现场保存至 " + triggerEngine->outputDirectory());
+    } else {
+        triggerEngine->clearWindows();
+    }
+}
+
+void MainWindow::loadTriggerRules() {
+    const QString filePath = QFileDialog::getOpenFileName(this, "加载触发规则", QDir::currentPath(), "Trigger Rules (*.json)");
+    if (filePath.isEmpty())
+        return;
+
+    QString error;
+    if (!triggerEngine->loadRules(filePath, &error)) {
+        showError("错误", "触发规则加载失败:\n" + error);
+        return;
+    }
+    appendLog(QString("已加载 %1 条触发规则: %2").arg(triggerEngine->rules().size()).arg(filePath));
+    if (m_triggersEnabled)
+        setTriggersEnabled(true);
+}
+
+// 从当前行向前/向后跳到最近的触发标记，被过滤隐藏的标记跳过
+void MainWindow::gotoMark(int direction) {
+    if (isViewingSession())
+        return;
+    const std::deque<quint64> &marks = logModel->marks();
+    const QModelIndex current = ui->logView->currentIndex();
+    const bool hasCurrent = current.isValid() && current.row() < logModel->rowCount();
+    const quint64 currentSeq = hasCurrent ? logModel->seqForRow(current.row()) : 0;
+
+    auto tryMark = [&](quint64 seq) {
+        const int row = logModel->rowForSeq(seq);
+        if (row < 0)
+            return false;
+        const QModelIndex index = logModel->index(row, 0);
+        ui->autoScrollCheck->setChecked(false);
+        ui->logView->setCurrentIndex(index);
+        ui->logView->scrollTo(index, QAbstractItemView::PositionAtCenter);
+        return true;
+    };
+    if (direction > 0) {
+        auto it = hasCurrent ? std::upper_bound(marks.begin(), marks.end(), currentSeq) : marks.begin();
+        for (; it != marks.end(); ++it) {
+            if (tryMark(*it))
+                return;
+        }
+    } else {
+        auto it = hasCurrent ? std::lower_bound(marks.begin(), marks.end(), currentSeq) : marks.end();
+        while (it != marks.begin()) {
+            if (tryMark(*--it))
+                return;
+        }
+    }
+    statusBar()->showMessage(marks.empty() ? "没有触发标记" : "该方向没有更多触发标记", 3000);
+}
+
 // 工具方法 *******************************************************************
 
 // 将信息加入日志队列（供UI异步刷新）
 void MainWindow::appendLog(const QString &msg) {
-    m_logQueue.push(msg);
+    LogBlockPtr block = LogBlockBuilder::fromText(msg.toUtf8());
+    if (block)
+        logPipeline->push(block);
+}
+
+bool MainWindow::isViewingSession() const {
+    return ui->logView->model() == sessionModel;
+}
+
+// 切回实时日志视图
+void MainWindow::showLiveLog() {
+    if (!isViewingSession())
+        return;
+    ui->logView->setModel(logModel);
+    ui->filterKeywordEdit->setPlaceholderText(QString());
+    sessionModel->close();
+    applyLogFilter();
 }
 
 // 显示警告弹窗
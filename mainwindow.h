@@ -4,49 +4,25 @@
 #include <QMainWindow>
 #include <QTimer>
 #include <QColor>
-#include <QQueue>
-#include <QMutex>
+#include <vector>
 #include "AdbManager.h"
+#include "LogRecord.h"
 
 QT_BEGIN_NAMESPACE
 namespace Ui { class MainWindow; }
 QT_END_NAMESPACE
 
-// 日志级别颜色
-struct LogLevel {
-    QString level;
-    QColor color;
-};
-
-static const QVector<LogLevel> LEVELS = {
-    {"V", QColor(128,128,128)},  // Verbose 灰色
-    {"D", QColor(0,128,0)},      // Debug   绿色
-    {"I", QColor(0,0,255)},      // Info    蓝色
-    {"W", QColor(255,140,0)},    // Warn    橙色
-    {"E", QColor(255,0,0)}       // Error   红色
-};
-
-// 简单线程安全队列（用于日志）
-class LogQueue {
-public:
-    void push(const QString &msg) {
-        QMutexLocker locker(&m_mutex);
-        m_queue.enqueue(msg);
-    }
-    bool pop(QString &msg) {
-        QMutexLocker locker(&m_mutex);
-        if (m_queue.isEmpty()) return false;
-        msg = m_queue.dequeue();
-        return true;
-    }
-private:
-    QQueue<QString> m_queue;
-    QMutex m_mutex;
-};
-
 // 前向声明
 class AdbManager;
 class SerialPortManager;
+class LogModel;
+class SessionLogModel;
+class LogFileImporter;
+class CaptureSessionManager;
+class StatsPanel;
+class LogViewPipeline;
+class TriggerEngine;
+class QProgressBar;
 
 class MainWindow : public QMainWindow
 {
@@ -64,29 +40,55 @@ private slots:
     void refreshSerialPorts();
     void openSerialPort();
     void closeSerialPort();
-    void onSerialDataReceived(const QString &data);
     void onPortOpened(bool success, const QString &message);
     void onPortClosed();
     void onSerialError(const QString &error);
+    void toggleReplay(bool start);
+
+    // ADB / 串口日志块
+    void onLogBlockReceived(const LogBlockPtr &block);
 
     // 日志相关
-    void processLogQueue();
+    void applyLogFilter();
     void startLogcat();
     void stopLogcat();
     void exportLog();
+    void openSession();
+    void importLogFile();
+    void onImportFinished(qint64 lineCount, qint64 elapsedMs);
     void captureScreenshot();
+    void runSearch();
+    void gotoSearchHit(int direction);
+    void toggleBurst(bool start);
+    void setTriggersEnabled(bool enabled);
+    void loadTriggerRules();
+    void gotoMark(int direction);
 
 private:
     Ui::MainWindow *ui;
     QString currentConnection;           // 当前连接类型（ADB/串口）
 
-    QTimer *logUpdateTimer;              // 定时更新日志
+    QTimer *filterTimer;                 // 关键字输入防抖
+
+    LogModel *logModel;                  // 日志视图模型（固定容量环形缓冲）
+    LogViewPipeline *logPipeline;        // 日志块队列 → 按帧刷新 → 按时间合并 → 模型（与 --bench 共用）
+    SessionLogModel *sessionModel;       // 已保存会话文件的视图模型
+    LogFileImporter *importer;           // 离线日志文件并行导入
+    QProgressBar *importProgress;        // 导入进度（状态栏）
 
-    LogQueue m_logQueue;                 // 日志队列
+    CaptureSessionManager *captureManager; // 多设备/多串口抓取会话（共享工作线程）
+    QString m_replaySource;              // 正在进行的回放会话，没有时为空
+    std::vector<quint64> m_searchHits;   // 当前搜索命中的记录序号
+    int m_searchCurrent = -1;            // 当前定位到的命中下标
+
+    StatsPanel *statsPanel;              // 流水线统计面板（停靠窗口，默认隐藏）
+
+    TriggerEngine *triggerEngine;        // 触发规则（抓取线程匹配，命中后在这里执行动作）
+    bool m_triggersEnabled = false;
+    QStringList m_triggerShots;          // 触发器请求的截图，完成时不弹窗
 
     SerialPortManager *serialManager;    // 串口管理对象
     AdbManager *adbManager;              // ADB管理对象
-    AdbManager *m_adbManager;            // 添加成员变量
 
 private:
     // 工具方法
@@ -94,9 +96,8 @@ private:
     void showWarning(const QString &title, const QString &msg);
     void showInfo(const QString &title, const QString &msg);
     void showError(const QString &title, const QString &msg);
-
-    QColor colorForLevel(const QString &level);
-    int levelIndex(const QString &level);
+    bool isViewingSession() const;
+    void showLiveLog();
 };
 
 #endif // MAINWINDOW_H
\ No newline at end of file
@@ -0,0 +1,246 @@
+#include <QtTest>
+#include <QThread>
+#include "AllocationCounter.h"
+#include "LoadGenerator.h"
+#include "LogBlockBuilder.h"
+#include <limits>
+
+// 日志从读取线程送到界面线程的开销：原来的逐行信号 / 整段 QString 对比现在的 LogBlock 批量信号
+// - adb 逐行（baseline 的 AdbManager）：split → QString::fromUtf8().trimmed() → 每行 emit logReceived(QString)
+// - 串口整段（baseline 的 SerialPortManager + MainWindow::onSerialDataReceived）：
+//   每次读取 emit dataReceived(QString::fromUtf8(data))，界面线程再 toUtf8 → split → fromUtf8 → trimmed
+// - LogBlock：读取线程用 LogBlockBuilder 切行、解析，每次读取 emit 一个共享的只读块
+// 每种做法都是真实的跨线程排队连接，计时从第一段数据到界面线程收完最后一行
+// 分配次数包括两个线程（需要 glibc，见 AllocationCounter），报告中为每行的平均值
+class Producer : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Path { PerLine, DecodedText, Blocks };
+
+    QVector<QByteArray> chunks;
+
+public slots:
+    void run(int path);
+
+signals:
+    void lineReceived(const QString &line);
+    void textReceived(const QString &text);
+    void blockReceived(const LogBlockPtr &block);
+    void finished();
+};
+
+class Consumer : public QObject
+{
+    Q_OBJECT
+
+public:
+    quint64 lines = 0;
+    quint64 signalCount = 0;
+    qint64 bytes = 0;                   // 防止编译器优化掉收到的内容
+
+public slots:
+    void onLine(const QString &line);
+    void onText(const QString &text);
+    void onBlock(const LogBlockPtr &block);
+};
+
+void Producer::run(int path)
+{
+    LogBlockBuilder builder;
+    builder.setSource("bench");
+    for (const QByteArray &data : chunks) {
+        switch (path) {
+        case PerLine:
+            for (const auto &line : data.split('\n')) {
+                QString msg = QString::fromUtf8(line).trimmed();
+                if (!msg.isEmpty())
+                    emit lineReceived(msg);
+            }
+            break;
+        case DecodedText:
+            emit textReceived(QString::fromUtf8(data));
+            break;
+        case Blocks: {
+            builder.feed(data);
+            const LogBlockPtr block = builder.take();
+            if (block)
+                emit blockReceived(block);
+            break;
+        }
+        }
+    }
+    emit finished();
+}
+
+void Consumer::onLine(const QString &line)
+{
+    ++signalCount;
+    ++lines;
+    bytes += line.size();
+}
+
+void Consumer::onText(const QString &text)
+{
+    ++signalCount;
+    const QList<QByteArray> split = text.toUtf8().split('\n');
+    for (const QByteArray &line : split) {
+        QString msg = QString::fromUtf8(line).trimmed();
+        if (!msg.isEmpty()) {
+            ++lines;
+            bytes += msg.size();
+        }
+    }
+}
+
+void Consumer::onBlock(const LogBlockPtr &block)
+{
+    ++signalCount;
+    lines += quint64(block->lines.size());
+    bytes += block->data.size();
+}
+
+class BenchDelivery : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void linesAgree();
+    void deliver_data();
+    void deliver();
+    void report();
+
+private:
+    struct Result {
+        quint64 lines = 0;
+        quint64 signalCount = 0;
+        qint64 elapsedNs = 0;
+        quint64 allocations = 0;
+    };
+
+    Result run(Producer::Path path);
+
+    QThread m_thread;
+    Producer *m_producer = nullptr;
+};
+
+static const int CorpusLines = 50000;
+static const int ReadBytes = 16 * 1024;     // 单次读取的数据量，与管道/串口一次 readAll 的量级相当
+
+void BenchDelivery::initTestCase()
+{
+    qRegisterMetaType<LogBlockPtr>();
+
+    LoadGenerator::Options options;
+    options.linesPerSec = CorpusLines;
+    LoadGenerator generator(options);
+    QByteArray corpus;
+    generator.generate(1000000, corpus, CorpusLines);
+
+    // 每段在行尾截断，各做法收到的行数相同（原来的串口路径会把跨段的行切成两行）
+    m_producer = new Producer;
+    qsizetype pos = 0;
+    while (pos < corpus.size()) {
+        qsizetype end = qMin(pos + ReadBytes, corpus.size());
+        if (end < corpus.size())
+            end = corpus.lastIndexOf('\n', end - 1) + 1;
+        m_producer->chunks.append(corpus.mid(pos, end - pos));
+        pos = end;
+    }
+    m_producer->moveToThread(&m_thread);
+    m_thread.start();
+}
+
+void BenchDelivery::cleanupTestCase()
+{
+    m_thread.quit();
+    m_thread.wait();
+    delete m_producer;
+}
+
+BenchDelivery::Result BenchDelivery::run(Producer::Path path)
+{
+    Consumer consumer;
+    connect(m_producer, &Producer::lineReceived, &consumer, &Consumer::onLine);
+    connect(m_producer, &Producer::textReceived, &consumer, &Consumer::onText);
+    connect(m_producer, &Producer::blockReceived, &consumer, &Consumer::onBlock);
+    QEventLoop loop;
+    // 排队连接按发出顺序投递，finished 到达时前面的数据都已处理完
+    connect(m_producer, &Producer::finished, &loop, &QEventLoop::quit);
+
+    const quint64 allocationsBefore = AllocationCounter::allocations();
+    QElapsedTimer timer;
+    timer.start();
+    QMetaObject::invokeMethod(m_producer, "run", Qt::QueuedConnection, Q_ARG(int, int(path)));
+    loop.exec();
+
+    Result result;
+    result.elapsedNs = qMax<qint64>(1, timer.nsecsElapsed());
+    result.allocations = AllocationCounter::allocations() - allocationsBefore;
+    result.lines = consumer.lines;
+    result.signalCount = consumer.signalCount;
+    m_producer->disconnect(&consumer);
+    m_producer->disconnect(&loop);
+    return result;
+}
+
+void BenchDelivery::linesAgree()
+{
+    for (int path = Producer::PerLine; path <= Producer::Blocks; ++path)
+        QCOMPARE(run(Producer::Path(path)).lines, quint64(CorpusLines));
+}
+
+void BenchDelivery::deliver_data()
+{
+    QTest::addColumn<int>("path");
+    QTest::newRow("per-line QString") << int(Producer::PerLine);
+    QTest::newRow("decoded QString") << int(Producer::DecodedText);
+    QTest::newRow("LogBlock") << int(Producer::Blocks);
+}
+
+void BenchDelivery::deliver()
+{
+    QFETCH(int, path);
+    quint64 lines = 0;
+    QBENCHMARK {
+        lines += run(Producer::Path(path)).lines;
+    }
+    QVERIFY(lines > 0);
+}
+
+void BenchDelivery::report()
+{
+    const char *names[] = {"per-line QString", "decoded QString", "LogBlock"};
+    Result best[3];
+    for (int path = Producer::PerLine; path <= Producer::Blocks; ++path) {
+        // 取 5 遍中最快的一遍；分配次数每遍相同
+        best[path].elapsedNs = std::numeric_limits<qint64>::max();
+        for (int pass = 0; pass < 5; ++pass) {
+            const Result result = run(Producer::Path(path));
+            if (result.elapsedNs < best[path].elapsedNs)
+                best[path] = result;
+        }
+    }
+    for (int path = Producer::PerLine; path <= Producer::Blocks; ++path) {
+        const Result &r = best[path];
+        const double seconds = r.elapsedNs / 1e9;
+        if (AllocationCounter::available()) {
+            qInfo("%-18s %12.0f lines/s %10.0f signals/s %8.2f allocs/line", names[path],
+                  r.lines / seconds, r.signalCount / seconds, double(r.allocations) / r.lines);
+        } else {
+            qInfo("%-18s %12.0f lines/s %10.0f signals/s  (allocs/line needs glibc)", names[path],
+                  r.lines / seconds, r.signalCount / seconds);
+        }
+    }
+    QVERIFY(best[Producer::Blocks].signalCount < best[Producer::PerLine].signalCount);
+    if (AllocationCounter::available()) {
+        QVERIFY(best[Producer::Blocks].allocations < best[Producer::PerLine].allocations);
+        QVERIFY(best[Producer::Blocks].allocations < best[Producer::DecodedText].allocations);
+    }
+}
+
+QTEST_GUILESS_MAIN(BenchDelivery)
+#include "bench_delivery.moc"
@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+TARGET = bench_delivery
+
+SOURCES += \
+    bench_delivery.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$ALLOCATION_COUNTER_SOURCES \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$ALLOCATION_COUNTER_HEADERS \
+    $$CORE_HEADERS
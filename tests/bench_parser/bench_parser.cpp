@@ -0,0 +1,178 @@
+#include <QtTest>
+#include "LoadGenerator.h"
+#include "LogcatParser.h"
+#include <cstring>
+#include <limits>
+
+// logcat 行解析的微基准：LogcatParser（原始字节、无堆分配）对比原来界面线程上的做法
+// 原来的做法（baseline 的 AdbManager + MainWindow::processLogQueue）：
+//   按 '\n' split 出 QByteArray 列表 → QString::fromUtf8().trimmed() →
+//   每行新建 QRegularExpression(R"(\b([VDIWE])[/\s])") 取级别 → 与 LEVELS 逐个比较 QString 得到下标
+// 同时列出“正则只编译一次”的结果，区分正则构造和匹配本身的开销
+//
+// QBENCHMARK 给出每遍语料的耗时；lineRate 直接打印各做法的行/秒和相对倍数
+class BenchParser : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Path { LegacyRegex, PrecompiledRegex, Parser };
+
+private slots:
+    void initTestCase();
+    void levelsAgree();
+    void parse_data();
+    void parse();
+    void lineRate();
+
+private:
+    static QByteArray corpus(bool threadtime, int lines);
+    static int runPath(Path path, const QByteArray &data);
+
+    QByteArray m_threadtime;
+    QByteArray m_brief;
+};
+
+static const int CorpusLines = 20000;
+
+// threadtime 用合成日志生成器的输出，brief 由同一批行改写（L/TAG(  PID): msg）
+QByteArray BenchParser::corpus(bool threadtime, int lines)
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = lines;
+    LoadGenerator generator(options);
+    QByteArray out;
+    generator.generate(1000000, out, lines);
+    if (threadtime)
+        return out;
+
+    QByteArray brief;
+    for (const QByteArray &line : out.split('\n')) {
+        if (line.size() < 33)
+            continue;
+        LogLine meta;
+        LogcatParser::parse(line, meta);
+        brief += "VDIWE"[meta.level];
+        brief += '/';
+        brief += line.mid(meta.tagOffset, meta.tagLength);
+        brief += '(';
+        brief += QByteArray::number(meta.pid).rightJustified(5, ' ');
+        brief += "): ";
+        brief += line.mid(meta.messageOffset, meta.messageLength);
+        brief += '\n';
+    }
+    return brief;
+}
+
+namespace {
+
+int legacyLevelIndex(const QString &level)
+{
+    for (int i = 0; i < LEVELS.size(); ++i)
+        if (LEVELS[i].level == level)
+            return i;
+    return 2;
+}
+
+} // namespace
+
+// 返回各行级别下标之和，防止编译器优化掉解析
+int BenchParser::runPath(Path path, const QByteArray &data)
+{
+    int sum = 0;
+    if (path == Parser) {
+        const char *p = data.constData();
+        const char *end = p + data.size();
+        LogLine meta;
+        while (p < end) {
+            const char *nl = static_cast<const char *>(memchr(p, '\n', size_t(end - p)));
+            const char *lineEnd = nl ? nl : end;
+            LogcatParser::parse(p, lineEnd - p, meta);
+            sum += meta.level;
+            p = lineEnd + 1;
+        }
+        return sum;
+    }
+
+    static const QRegularExpression precompiled(R"(\b([VDIWE])[/\s])");
+    for (const QByteArray &line : data.split('\n')) {
+        const QString msg = QString::fromUtf8(line).trimmed();
+        if (msg.isEmpty())
+            continue;
+        QString levelChar = "I";
+        const QRegularExpressionMatch match = path == LegacyRegex
+                ? QRegularExpression(R"(\b([VDIWE])[/\s])").match(msg)
+                : precompiled.match(msg);
+        if (match.hasMatch())
+            levelChar = match.captured(1);
+        sum += legacyLevelIndex(levelChar);
+    }
+    return sum;
+}
+
+void BenchParser::initTestCase()
+{
+    m_threadtime = corpus(true, CorpusLines);
+    m_brief = corpus(false, CorpusLines);
+    QCOMPARE(m_threadtime.count('\n'), qsizetype(CorpusLines));
+    QCOMPARE(m_brief.count('\n'), qsizetype(CorpusLines));
+}
+
+// 两种做法对这些格式取到的级别一致，比较的是同样的工作
+void BenchParser::levelsAgree()
+{
+    QCOMPARE(runPath(Parser, m_threadtime), runPath(PrecompiledRegex, m_threadtime));
+    QCOMPARE(runPath(Parser, m_brief), runPath(PrecompiledRegex, m_brief));
+}
+
+void BenchParser::parse_data()
+{
+    QTest::addColumn<int>("path");
+    QTest::addColumn<bool>("threadtime");
+    QTest::newRow("threadtime/legacy-regex") << int(LegacyRegex) << true;
+    QTest::newRow("threadtime/precompiled-regex") << int(PrecompiledRegex) << true;
+    QTest::newRow("threadtime/LogcatParser") << int(Parser) << true;
+    QTest::newRow("brief/legacy-regex") << int(LegacyRegex) << false;
+    QTest::newRow("brief/precompiled-regex") << int(PrecompiledRegex) << false;
+    QTest::newRow("brief/LogcatParser") << int(Parser) << false;
+}
+
+void BenchParser::parse()
+{
+    QFETCH(int, path);
+    QFETCH(bool, threadtime);
+    const QByteArray &data = threadtime ? m_threadtime : m_brief;
+    int sum = 0;
+    QBENCHMARK {
+        sum += runPath(Path(path), data);
+    }
+    QVERIFY(sum > 0);
+}
+
+void BenchParser::lineRate()
+{
+    const char *names[] = {"legacy regex", "precompiled regex", "LogcatParser"};
+    for (bool threadtime : {true, false}) {
+        const QByteArray &data = threadtime ? m_threadtime : m_brief;
+        double rates[3] = {};
+        for (int path = LegacyRegex; path <= Parser; ++path) {
+            // 取 5 遍中最快的一遍
+            qint64 bestNs = std::numeric_limits<qint64>::max();
+            for (int pass = 0; pass < 5; ++pass) {
+                QElapsedTimer timer;
+                timer.start();
+                runPath(Path(path), data);
+                bestNs = qMin(bestNs, qMax<qint64>(1, timer.nsecsElapsed()));
+            }
+            rates[path] = CorpusLines * 1e9 / bestNs;
+        }
+        for (int path = LegacyRegex; path <= Parser; ++path) {
+            qInfo("%-10s %-18s %12.0f lines/s  x%.1f", threadtime ? "threadtime" : "brief", names[path],
+                  rates[path], rates[path] / rates[LegacyRegex]);
+        }
+        QVERIFY(rates[Parser] > rates[LegacyRegex]);
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchParser)
+#include "bench_parser.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = bench_parser
+
+SOURCES += \
+    bench_parser.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$CORE_HEADERS
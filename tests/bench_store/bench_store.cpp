@@ -0,0 +1,128 @@
+#include <QtTest>
+#include "AllocationCounter.h"
+#include "LoadGenerator.h"
+#include "LogBlockBuilder.h"
+#include "LogStore.h"
+#include <vector>
+
+// 内存中日志的每行占用：同一批合成 logcat 行分别存成
+// - QString 列表：原来的做法，每行 QString::fromUtf8().trimmed()（原来还要再存一份在 QTextDocument 里，这里不计）
+// - 保留日志块：上一版的存储，每行一条 {块指针, 行号} 记录，并让所属的 LogBlock 一直存活
+// - LogStore：定长紧凑记录 + UTF-8 字节池 + TAG/来源驻留池
+// 占用按堆上实际增加的字节计（需要 glibc，见 AllocationCounter），LogStore 另外列出 memoryUsage() 的统计
+class BenchStore : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Layout { StringList, RetainedBlocks, Store, LayoutCount };
+
+private slots:
+    void initTestCase();
+    void memory();
+
+private:
+    static qint64 measure(Layout layout, const QByteArray &data, int lines);
+
+    QByteArray m_corpus;
+};
+
+static const int CorpusLines = 200000;
+static const qsizetype ReadBytes = 16 * 1024;
+
+void BenchStore::initTestCase()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = CorpusLines;
+    LoadGenerator generator(options);
+    generator.generate(1000000, m_corpus, CorpusLines);
+    QCOMPARE(m_corpus.count('\n'), qsizetype(CorpusLines));
+}
+
+namespace {
+
+struct BlockRecord {
+    LogBlockPtr block;
+    int index;
+};
+
+// 按读取线程的方式分段喂入，取出的块依次交给 sink
+template <typename Sink>
+void buildBlocks(const QByteArray &data, Sink sink)
+{
+    LogBlockBuilder builder;
+    builder.setSource("adb:bench");
+    for (qsizetype offset = 0; offset < data.size(); offset += ReadBytes) {
+        builder.feed(data.constData() + offset, qMin(ReadBytes, data.size() - offset));
+        if (LogBlockPtr block = builder.take())
+            sink(block);
+    }
+    builder.finishPartial();
+    if (LogBlockPtr block = builder.take())
+        sink(block);
+}
+
+} // namespace
+
+// 建好一种存储，返回它仍然存活时比建之前多占用的堆字节数
+qint64 BenchStore::measure(Layout layout, const QByteArray &data, int lines)
+{
+    const qint64 before = AllocationCounter::liveBytes();
+    qint64 used = 0;
+    if (layout == StringList) {
+        QStringList list;
+        for (const QByteArray &line : data.split('\n')) {
+            const QString text = QString::fromUtf8(line).trimmed();
+            if (!text.isEmpty())
+                list.append(text);
+        }
+        used = AllocationCounter::liveBytes() - before;
+        if (list.size() != lines)
+            return -1;
+    } else if (layout == RetainedBlocks) {
+        std::vector<BlockRecord> records;
+        buildBlocks(data, [&records](const LogBlockPtr &block) {
+            for (int i = 0; i < block->lines.size(); ++i)
+                records.push_back({block, i});
+        });
+        used = AllocationCounter::liveBytes() - before;
+        if (records.size() != size_t(lines))
+            return -1;
+    } else {
+        LogStore store(lines);
+        buildBlocks(data, [&store](const LogBlockPtr &block) { store.append(*block); });
+        used = AllocationCounter::liveBytes() - before;
+        const LogStore::MemoryUsage usage = store.memoryUsage();
+        qInfo("LogStore memoryUsage(): records %.1f + text %.1f + strings %.1f = %.1f bytes/line",
+              double(usage.records) / lines, double(usage.text) / lines, double(usage.strings) / lines,
+              double(usage.total()) / lines);
+        if (store.size() != lines)
+            return -1;
+    }
+    return used;
+}
+
+void BenchStore::memory()
+{
+    const char *names[] = {"QString list", "retained blocks", "LogStore"};
+    const double rawBytes = double(m_corpus.size()) / CorpusLines;
+    qInfo("corpus: %d lines, %.1f bytes/line of UTF-8 text", CorpusLines, rawBytes);
+
+    qint64 used[LayoutCount] = {};
+    for (int layout = StringList; layout < LayoutCount; ++layout) {
+        used[layout] = measure(Layout(layout), m_corpus, CorpusLines);
+        QVERIFY(used[layout] >= 0);
+    }
+    if (!AllocationCounter::available())
+        QSKIP("堆占用统计需要 glibc（见 AllocationCounter）");
+
+    for (int layout = StringList; layout < LayoutCount; ++layout) {
+        qInfo("%-16s %8.1f bytes/line  x%.2f of QString list", names[layout], double(used[layout]) / CorpusLines,
+              double(used[layout]) / used[StringList]);
+    }
+    QVERIFY(used[Store] < used[StringList]);
+    QVERIFY(used[Store] < used[RetainedBlocks]);
+}
+
+QTEST_APPLESS_MAIN(BenchStore)
+#include "bench_store.moc"
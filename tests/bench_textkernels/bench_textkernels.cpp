@@ -0,0 +1,130 @@
+#include <QtTest>
+#include "LoadGenerator.h"
+#include "LogTextKernels.h"
+#include <limits>
+
+// 文本扫描函数的微基准：同一份 threadtime 语料上对比逐字节、SSE2、AVX2 实现（只测本机支持的）
+//   split   按 '\n' 切行（findByte）
+//   trim    逐行去首尾空白
+//   level   逐行找级别字符（findLevelByte，brief 等格式的回退路径）
+//   search  逐行不区分大小写查找关键字（findIgnoreCase，关键字不存在，每行都扫到底）
+// QBENCHMARK 给出每遍语料的耗时；throughput 直接打印各实现的 MB/s 和相对逐字节实现的倍数
+class BenchTextKernels : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum Kernel { Split, Trim, Level, Search, KernelCount };
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void kernel_data();
+    void kernel();
+    void throughput();
+
+private:
+    static qint64 run(Kernel kernel, const QByteArray &data);
+
+    QByteArray m_corpus;
+};
+
+static const int CorpusLines = 50000;
+static const char *const KernelNames[] = {"split", "trim", "level", "search"};
+static const char *const SetNames[] = {"scalar", "SSE2", "AVX2"};
+
+void BenchTextKernels::initTestCase()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = CorpusLines;
+    LoadGenerator generator(options);
+    generator.generate(1000000, m_corpus, CorpusLines);
+    QCOMPARE(m_corpus.count('\n'), qsizetype(CorpusLines));
+}
+
+void BenchTextKernels::cleanupTestCase()
+{
+    LogTextKernels::setInstructionSet(LogTextKernels::supportedInstructionSet());
+}
+
+// 返回与结果相关的和，各实现应当一致，也防止编译器优化掉扫描
+qint64 BenchTextKernels::run(Kernel kernel, const QByteArray &data)
+{
+    const char *p = data.constData();
+    const char *end = p + data.size();
+    qint64 sum = 0;
+    while (p < end) {
+        const char *lineEnd = LogTextKernels::findByte(p, end, '\n');
+        switch (kernel) {
+        case Split:
+            sum += lineEnd - p;
+            break;
+        case Trim: {
+            const char *begin = p;
+            const char *last = lineEnd;
+            LogTextKernels::trim(begin, last);
+            sum += last - begin;
+            break;
+        }
+        case Level:
+            sum += LogTextKernels::findLevelByte(p, lineEnd - p);
+            break;
+        default:
+            sum += LogTextKernels::findIgnoreCase(p, lineEnd - p, "exception", 9);
+            break;
+        }
+        p = lineEnd + 1;
+    }
+    return sum;
+}
+
+void BenchTextKernels::kernel_data()
+{
+    QTest::addColumn<int>("set");
+    QTest::addColumn<int>("kernel");
+    for (int kernel = Split; kernel < KernelCount; ++kernel) {
+        for (int set = LogTextKernels::Scalar; set <= LogTextKernels::supportedInstructionSet(); ++set)
+            QTest::newRow(qPrintable(QString("%1/%2").arg(KernelNames[kernel], SetNames[set]))) << set << kernel;
+    }
+}
+
+void BenchTextKernels::kernel()
+{
+    QFETCH(int, set);
+    QFETCH(int, kernel);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    qint64 sum = 0;
+    QBENCHMARK {
+        sum += run(Kernel(kernel), m_corpus);
+    }
+    QVERIFY(sum != 0);
+}
+
+void BenchTextKernels::throughput()
+{
+    const int supported = LogTextKernels::supportedInstructionSet();
+    for (int kernel = Split; kernel < KernelCount; ++kernel) {
+        double rates[3] = {};
+        qint64 sums[3] = {};
+        for (int set = LogTextKernels::Scalar; set <= supported; ++set) {
+            QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+            // 取 5 遍中最快的一遍
+            qint64 bestNs = std::numeric_limits<qint64>::max();
+            for (int pass = 0; pass < 5; ++pass) {
+                QElapsedTimer timer;
+                timer.start();
+                sums[set] = run(Kernel(kernel), m_corpus);
+                bestNs = qMin(bestNs, qMax<qint64>(1, timer.nsecsElapsed()));
+            }
+            rates[set] = m_corpus.size() * 1e3 / bestNs;
+        }
+        for (int set = LogTextKernels::Scalar; set <= supported; ++set) {
+            qInfo("%-7s %-7s %9.0f MB/s  x%.2f", KernelNames[kernel], SetNames[set], rates[set],
+                  rates[set] / rates[LogTextKernels::Scalar]);
+            QCOMPARE(sums[set], sums[LogTextKernels::Scalar]);
+        }
+    }
+}
+
+QTEST_APPLESS_MAIN(BenchTextKernels)
+#include "bench_textkernels.moc"
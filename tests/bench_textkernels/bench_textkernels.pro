@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = bench_textkernels
+
+SOURCES += \
+    bench_textkernels.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$SRC/LogTextKernels.cpp
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$SRC/LogTextKernels.h
@@ -0,0 +1,128 @@
+#include <QtTest>
+#include "LoadGenerator.h"
+#include "LogBlockBuilder.h"
+#include "TriggerEngine.h"
+#include <limits>
+
+// 触发规则匹配对抓取线程切行解析的影响：同一份语料按读取线程的方式分段喂给 LogBlockBuilder，
+// 分别不匹配、匹配内置规则、匹配 64 条规则（内置规则 + 60 条各含 2 个关键字的规则，都不会命中）
+// 语料每 1000 行插入一行 Java 崩溃；后两种做法命中的行数应当相同
+// QBENCHMARK 给出每遍语料的耗时；lineRate 直接打印各做法的行/秒和相对不匹配时的比例
+class BenchTriggers : public QObject
+{
+    Q_OBJECT
+
+public:
+    enum RuleSet { NoRules, DefaultRules, ManyRules, RuleSetCount };
+
+private slots:
+    void initTestCase();
+    void hitsAgree();
+    void feed_data();
+    void feed();
+    void lineRate();
+
+private:
+    static int run(const TriggerMatcherPtr &triggers, const QByteArray &data);
+
+    QByteArray m_corpus;
+    TriggerMatcherPtr m_matchers[RuleSetCount];
+};
+
+static const int CorpusLines = 50000;
+static const int CrashEvery = 1000;
+static const qsizetype ReadBytes = 16 * 1024;
+
+void BenchTriggers::initTestCase()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = CorpusLines;
+    LoadGenerator generator(options);
+    QByteArray lines;
+    generator.generate(1000000, lines, CorpusLines);
+    int n = 0;
+    for (const QByteArray &line : lines.split('\n')) {
+        if (line.isEmpty())
+            continue;
+        m_corpus += line + '\n';
+        if (++n % CrashEvery == 0)
+            m_corpus += "01-02 03:04:05.678  1000  1001 E AndroidRuntime: FATAL EXCEPTION: main\n";
+    }
+
+    QVector<TriggerRule> rules = TriggerEngine::defaultRules();
+    m_matchers[DefaultRules] = TriggerMatcher::compile(rules);
+    for (int i = 0; rules.size() < TriggerMatcher::MaxRules; ++i) {
+        TriggerRule rule;
+        rule.name = QString("rule%1").arg(i);
+        rule.patterns << QString("no such pattern %1").arg(i) << QString("missing_%1_keyword").arg(i);
+        rules.append(rule);
+    }
+    m_matchers[ManyRules] = TriggerMatcher::compile(rules);
+    QVERIFY(m_matchers[DefaultRules]);
+    QVERIFY(m_matchers[ManyRules]);
+}
+
+// 返回命中触发规则的行数
+int BenchTriggers::run(const TriggerMatcherPtr &triggers, const QByteArray &data)
+{
+    LogBlockBuilder builder;
+    builder.setTriggers(triggers);
+    int hits = 0;
+    for (qsizetype offset = 0; offset < data.size(); offset += ReadBytes) {
+        builder.feed(data.constData() + offset, qMin(ReadBytes, data.size() - offset));
+        if (LogBlockPtr block = builder.take())
+            hits += block->triggered;
+    }
+    builder.finishPartial();
+    if (LogBlockPtr block = builder.take())
+        hits += block->triggered;
+    return hits;
+}
+
+void BenchTriggers::hitsAgree()
+{
+    QCOMPARE(run(m_matchers[NoRules], m_corpus), 0);
+    const int hits = run(m_matchers[DefaultRules], m_corpus);
+    QVERIFY(hits >= CorpusLines / CrashEvery);
+    QCOMPARE(run(m_matchers[ManyRules], m_corpus), hits);
+}
+
+void BenchTriggers::feed_data()
+{
+    QTest::addColumn<int>("rules");
+    QTest::newRow("no rules") << int(NoRules);
+    QTest::newRow("default rules") << int(DefaultRules);
+    QTest::newRow("64 rules") << int(ManyRules);
+}
+
+void BenchTriggers::feed()
+{
+    QFETCH(int, rules);
+    int hits = 0;
+    QBENCHMARK {
+        hits += run(m_matchers[rules], m_corpus);
+    }
+    QVERIFY(rules == NoRules || hits > 0);
+}
+
+void BenchTriggers::lineRate()
+{
+    const char *names[] = {"no rules", "default rules", "64 rules"};
+    double rates[RuleSetCount] = {};
+    for (int rules = NoRules; rules < RuleSetCount; ++rules) {
+        // 取 5 遍中最快的一遍
+        qint64 bestNs = std::numeric_limits<qint64>::max();
+        for (int pass = 0; pass < 5; ++pass) {
+            QElapsedTimer timer;
+            timer.start();
+            run(m_matchers[rules], m_corpus);
+            bestNs = qMin(bestNs, qMax<qint64>(1, timer.nsecsElapsed()));
+        }
+        rates[rules] = CorpusLines * 1e9 / bestNs;
+    }
+    for (int rules = NoRules; rules < RuleSetCount; ++rules)
+        qInfo("%-14s %12.0f lines/s  x%.2f", names[rules], rates[rules], rates[rules] / rates[NoRules]);
+}
+
+QTEST_APPLESS_MAIN(BenchTriggers)
+#include "bench_triggers.moc"
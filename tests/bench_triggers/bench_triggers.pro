@@ -0,0 +1,16 @@
+include(../tests.pri)
+
+TARGET = bench_triggers
+
+SOURCES += \
+    bench_triggers.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$SRC/TriggerEngine.cpp \
+    $$SRC/LogWindowRecorder.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$SRC/TriggerEngine.h \
+    $$SRC/LogWindowRecorder.h \
+    $$CORE_HEADERS
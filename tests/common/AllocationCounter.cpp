@@ -0,0 +1,119 @@
+#include "AllocationCounter.h"
+#include <atomic>
+#include <cstddef>
+
+#if defined(__GLIBC__) && !defined(__SANITIZE_ADDRESS__) && !defined(__SANITIZE_THREAD__)
+#define ALLOCATION_COUNTER_ENABLED
+#include <cerrno>
+#include <malloc.h>
+
+extern "C" {
+void *__libc_malloc(size_t size);
+void *__libc_calloc(size_t count, size_t size);
+void *__libc_realloc(void *ptr, size_t size);
+void *__libc_memalign(size_t alignment, size_t size);
+void __libc_free(void *ptr);
+}
+#endif
+
+namespace {
+
+std::atomic<quint64> g_allocations{0};
+std::atomic<qint64> g_liveBytes{0};
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+void *noteAllocated(void *ptr)
+{
+    if (ptr) {
+        g_allocations.fetch_add(1, std::memory_order_relaxed);
+        g_liveBytes.fetch_add(qint64(malloc_usable_size(ptr)), std::memory_order_relaxed);
+    }
+    return ptr;
+}
+
+void noteFreed(void *ptr)
+{
+    if (ptr)
+        g_liveBytes.fetch_sub(qint64(malloc_usable_size(ptr)), std::memory_order_relaxed);
+}
+#endif
+
+} // namespace
+
+#ifdef ALLOCATION_COUNTER_ENABLED
+extern "C" {
+
+void *malloc(size_t size)
+{
+    return noteAllocated(__libc_malloc(size));
+}
+
+void *calloc(size_t count, size_t size)
+{
+    return noteAllocated(__libc_calloc(count, size));
+}
+
+void *realloc(void *ptr, size_t size)
+{
+    noteFreed(ptr);
+    void *result = __libc_realloc(ptr, size);
+    if (!result && ptr && size) {
+        // 失败时原块不变
+        g_liveBytes.fetch_add(qint64(malloc_usable_size(ptr)), std::memory_order_relaxed);
+        return nullptr;
+    }
+    return noteAllocated(result);
+}
+
+void free(void *ptr)
+{
+    noteFreed(ptr);
+    __libc_free(ptr);
+}
+
+void *memalign(size_t alignment, size_t size)
+{
+    return noteAllocated(__libc_memalign(alignment, size));
+}
+
+void *aligned_alloc(size_t alignment, size_t size)
+{
+    return noteAllocated(__libc_memalign(alignment, size));
+}
+
+int posix_memalign(void **result, size_t alignment, size_t size)
+{
+    if (alignment % sizeof(void *) != 0 || (alignment & (alignment - 1)) != 0)
+        return EINVAL;
+    void *ptr = noteAllocated(__libc_memalign(alignment, size));
+    if (!ptr && size)
+        return ENOMEM;
+    *result = ptr;
+    return 0;
+}
+
+} // extern "C"
+#endif
+
+namespace AllocationCounter {
+
+bool available()
+{
+#ifdef ALLOCATION_COUNTER_ENABLED
+    return true;
+#else
+    return false;
+#endif
+}
+
+quint64 allocations()
+{
+    return g_allocations.load(std::memory_order_relaxed);
+}
+
+qint64 liveBytes()
+{
+    return g_liveBytes.load(std::memory_order_relaxed);
+}
+
+} // namespace AllocationCounter
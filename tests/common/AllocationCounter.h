@@ -0,0 +1,17 @@
+#ifndef ALLOCATIONCOUNTER_H
+#define ALLOCATIONCOUNTER_H
+
+#include <QtGlobal>
+
+// 基准用的堆分配统计：替换 malloc 系列函数（operator new 和 Qt 容器最终都走这里），
+// 记录累计分配次数和当前占用的字节数（按 malloc_usable_size 计，含分配器的取整）
+// 只在 glibc 上可用，其他平台 available() 为 false，各计数恒为 0
+namespace AllocationCounter {
+
+bool available();
+quint64 allocations();      // 进程启动以来的分配次数（所有线程）
+qint64 liveBytes();         // 当前未释放的堆内存
+
+} // namespace AllocationCounter
+
+#endif // ALLOCATIONCOUNTER_H
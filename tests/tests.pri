@@ -0,0 +1,42 @@
+# 各测试/基准子项目的公共设置：直接编译被测的源文件，不链接整个程序
+#
+# 基准用例用 QBENCHMARK 编写，make check 时各跑一遍以确认能用；测量时单独运行，如：
+#   ./tst_logqueue -minimumvalue 100 -iterations 10
+#   ./bench_parser -tickcounter
+# 无锁代码的数据竞争检查（ThreadSanitizer，GCC/Clang）：
+#   qmake CONFIG+=sanitizer CONFIG+=sanitize_thread && make check
+QT += testlib
+
+CONFIG += c++17 console testcase
+CONFIG -= app_bundle
+
+SRC = $$PWD/..
+INCLUDEPATH += $$SRC
+DEPENDPATH += $$SRC
+
+# 日志核心：切行、解析、触发匹配、存储和过滤，多数用例都要用到
+CORE_SOURCES = \
+    $$SRC/LogBlockBuilder.cpp \
+    $$SRC/LogcatParser.cpp \
+    $$SRC/LogTextKernels.cpp \
+    $$SRC/TriggerMatcher.cpp \
+    $$SRC/PipelineStats.cpp \
+    $$SRC/LogStore.cpp \
+    $$SRC/LogStringPool.cpp \
+    $$SRC/LogFilterEngine.cpp
+
+CORE_HEADERS = \
+    $$SRC/LogRecord.h \
+    $$SRC/LogBlockBuilder.h \
+    $$SRC/LogcatParser.h \
+    $$SRC/LogTextKernels.h \
+    $$SRC/TriggerMatcher.h \
+    $$SRC/PipelineStats.h \
+    $$SRC/LogStore.h \
+    $$SRC/LogStringPool.h \
+    $$SRC/LogFilterEngine.h
+
+# 基准用的堆分配统计（glibc）
+INCLUDEPATH += $$PWD/common
+ALLOCATION_COUNTER_SOURCES = $$PWD/common/AllocationCounter.cpp
+ALLOCATION_COUNTER_HEADERS = $$PWD/common/AllocationCounter.h
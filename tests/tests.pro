@@ -0,0 +1,24 @@
+TEMPLATE = subdirs
+
+SUBDIRS += \
+    tst_loadgenerator \
+    tst_logfilterengine \
+    bench_parser \
+    tst_logqueue \
+    tst_logblockbuilder \
+    tst_logstore \
+    bench_delivery \
+    tst_logsessionreader \
+    tst_logfileimporter \
+    tst_adbclient \
+    tst_devicewatcher \
+    tst_capturesessionmanager \
+    tst_serialportmanager \
+    tst_screencapture \
+    tst_compressedlog \
+    tst_textkernels \
+    bench_textkernels \
+    bench_store \
+    tst_triggerengine \
+    bench_triggers \
+    tst_logsearchindex
@@ -0,0 +1,297 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include <QThread>
+#include <QTimer>
+#include <atomic>
+#include "AdbClient.h"
+
+// 进程内的模拟 adb server（在独立线程中运行，AdbClient 的调用是阻塞的）
+// 支持 host:version、host:devices、host:transport:<serial>、shell:<command>；
+// closeAfterHost 时 host: 查询应答后关闭连接（真实 adb server 的行为），否则保持连接
+// shell 命令：
+//   echo <text>   输出 text 后关闭
+//   slow <n>      每 200ms 输出一段，共 n 段后关闭（总时长超过单次超时，但间隔不超过）
+//   hang          输出一段后不再输出也不关闭
+class FakeAdbServer : public QObject
+{
+    Q_OBJECT
+
+public:
+    std::atomic<int> connections{0};
+    std::atomic<int> requests{0};
+    std::atomic<bool> closeAfterHost{false};
+    quint16 port = 0;
+
+public slots:
+    void listen();
+    void stop();
+
+private:
+    void onReadyRead(QTcpSocket *socket);
+    void handle(QTcpSocket *socket, const QByteArray &service);
+    static void reply(QTcpSocket *socket, const QByteArray &payload);
+    static void fail(QTcpSocket *socket, const QByteArray &message);
+
+    QTcpServer *m_server = nullptr;
+};
+
+void FakeAdbServer::listen()
+{
+    m_server = new QTcpServer(this);
+    m_server->listen(QHostAddress::LocalHost, 0);
+    port = m_server->serverPort();
+    connect(m_server, &QTcpServer::newConnection, this, [this]() {
+        while (QTcpSocket *socket = m_server->nextPendingConnection()) {
+            ++connections;
+            socket->setProperty("transport", false);
+            connect(socket, &QTcpSocket::readyRead, this, [this, socket]() { onReadyRead(socket); });
+            connect(socket, &QTcpSocket::disconnected, socket, &QObject::deleteLater);
+        }
+    });
+}
+
+void FakeAdbServer::stop()
+{
+    delete m_server;
+    m_server = nullptr;
+}
+
+void FakeAdbServer::onReadyRead(QTcpSocket *socket)
+{
+    QByteArray buffer = socket->property("buffer").toByteArray() + socket->readAll();
+    while (buffer.size() >= 4) {
+        bool ok = false;
+        const int length = buffer.left(4).toInt(&ok, 16);
+        if (!ok || buffer.size() < 4 + length)
+            break;
+        const QByteArray service = buffer.mid(4, length);
+        buffer.remove(0, 4 + length);
+        ++requests;
+        handle(socket, service);
+    }
+    socket->setProperty("buffer", buffer);
+}
+
+void FakeAdbServer::reply(QTcpSocket *socket, const QByteArray &payload)
+{
+    socket->write("OKAY" + QByteArray::number(payload.size(), 16).rightJustified(4, '0') + payload);
+}
+
+void FakeAdbServer::fail(QTcpSocket *socket, const QByteArray &message)
+{
+    socket->write("FAIL" + QByteArray::number(message.size(), 16).rightJustified(4, '0') + message);
+    socket->disconnectFromHost();
+}
+
+void FakeAdbServer::handle(QTcpSocket *socket, const QByteArray &service)
+{
+    if (service == "host:version" || service == "host:devices") {
+        reply(socket, service == "host:version" ? QByteArray("0029") : QByteArray("SER1\tdevice\nSER2\toffline\n"));
+        if (closeAfterHost)
+            socket->disconnectFromHost();
+        return;
+    }
+    if (service.startsWith("host:transport:")) {
+        if (service.mid(15) != "SER1") {
+            fail(socket, "device '" + service.mid(15) + "' not found");
+            return;
+        }
+        socket->setProperty("transport", true);
+        socket->write("OKAY");
+        return;
+    }
+    if (!service.startsWith("shell:") || !socket->property("transport").toBool()) {
+        fail(socket, "unknown service");
+        return;
+    }
+
+    socket->write("OKAY");
+    const QByteArray command = service.mid(6);
+    if (command.startsWith("echo ")) {
+        socket->write(command.mid(5) + "\r\n");
+        socket->disconnectFromHost();
+    } else if (command.startsWith("slow ")) {
+        const int chunks = command.mid(5).toInt();
+        QTimer *timer = new QTimer(socket);
+        timer->setProperty("left", chunks);
+        connect(timer, &QTimer::timeout, socket, [socket, timer]() {
+            const int left = timer->property("left").toInt();
+            if (left == 0) {
+                timer->stop();
+                socket->disconnectFromHost();
+                return;
+            }
+            socket->write("chunk " + QByteArray::number(left) + "\n");
+            timer->setProperty("left", left - 1);
+        });
+        timer->start(200);
+    } else if (command == "hang") {
+        socket->write("partial\n");
+    } else {
+        socket->disconnectFromHost();
+    }
+}
+
+class TestAdbClient : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void init();
+    void reusesOpenConnection();
+    void reconnectsAfterServerClose();
+    void devices();
+    void shellOutput();
+    void shellUnknownDevice();
+    void shellIdleTimeout();
+    void shellLongOutputWithinIdleTimeout();
+    void serverDown();
+    void parseDevices();
+
+private:
+    QThread m_thread;
+    FakeAdbServer *m_server = nullptr;
+};
+
+void TestAdbClient::initTestCase()
+{
+    m_server = new FakeAdbServer;
+    m_server->moveToThread(&m_thread);
+    m_thread.start();
+    QMetaObject::invokeMethod(m_server, "listen", Qt::BlockingQueuedConnection);
+    QVERIFY(m_server->port != 0);
+}
+
+void TestAdbClient::cleanupTestCase()
+{
+    QMetaObject::invokeMethod(m_server, "stop", Qt::BlockingQueuedConnection);
+    m_thread.quit();
+    m_thread.wait();
+    delete m_server;
+}
+
+void TestAdbClient::init()
+{
+    m_server->connections = 0;
+    m_server->requests = 0;
+    m_server->closeAfterHost = false;
+}
+
+void TestAdbClient::reusesOpenConnection()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    for (int i = 0; i < 5; ++i) {
+        QByteArray version;
+        QString error;
+        QVERIFY2(adb.hostQuery("host:version", version, &error), qPrintable(error));
+        QCOMPARE(version, QByteArray("0029"));
+        QVERIFY(adb.isConnected());
+    }
+    QCOMPARE(m_server->connections.load(), 1);
+    QCOMPARE(m_server->requests.load(), 5);
+}
+
+// server 每次应答后关闭连接：每次都重新连接，调用方感觉不到
+void TestAdbClient::reconnectsAfterServerClose()
+{
+    m_server->closeAfterHost = true;
+    AdbClient adb("127.0.0.1", m_server->port);
+    for (int i = 0; i < 5; ++i) {
+        QByteArray version;
+        QString error;
+        QVERIFY2(adb.hostQuery("host:version", version, &error), qPrintable(error));
+        QCOMPARE(version, QByteArray("0029"));
+    }
+    QCOMPARE(m_server->connections.load(), 5);
+}
+
+void TestAdbClient::devices()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    QList<AdbDevice> devices;
+    QVERIFY(adb.devices(devices));
+    QCOMPARE(devices.size(), qsizetype(2));
+    QCOMPARE(devices[0].serial, QString("SER1"));
+    QCOMPARE(devices[0].state, QString("device"));
+    QCOMPARE(devices[1].state, QString("offline"));
+}
+
+// shell 用掉当前连接，之后的查询重新连接
+void TestAdbClient::shellOutput()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    QByteArray version;
+    QVERIFY(adb.hostQuery("host:version", version));
+    QByteArray out;
+    QString error;
+    QVERIFY2(adb.shell("SER1", "echo hello", out, &error), qPrintable(error));
+    QCOMPARE(out, QByteArray("hello\n"));
+    QVERIFY(!adb.isConnected());
+    QVERIFY(adb.hostQuery("host:version", version));
+    QCOMPARE(m_server->connections.load(), 2);
+}
+
+void TestAdbClient::shellUnknownDevice()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    QByteArray out;
+    QString error;
+    QVERIFY(!adb.shell("NOPE", "echo hello", out, &error));
+    QCOMPARE(error, QString("device 'NOPE' not found"));
+}
+
+void TestAdbClient::shellIdleTimeout()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    adb.setTimeout(300);
+    QByteArray out;
+    QString error;
+    QElapsedTimer timer;
+    timer.start();
+    QVERIFY(!adb.shell("SER1", "hang", out, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(timer.elapsed() < 3000);
+}
+
+// 输出共 1.6 秒，超过 500ms 的超时，但每段间隔只有 200ms
+void TestAdbClient::shellLongOutputWithinIdleTimeout()
+{
+    AdbClient adb("127.0.0.1", m_server->port);
+    adb.setTimeout(500);
+    QByteArray out;
+    QString error;
+    QVERIFY2(adb.shell("SER1", "slow 8", out, &error), qPrintable(error));
+    QCOMPARE(out.count('\n'), qsizetype(8));
+    QVERIFY(out.startsWith("chunk 8\n"));
+}
+
+void TestAdbClient::serverDown()
+{
+    QTcpServer unused;
+    QVERIFY(unused.listen(QHostAddress::LocalHost, 0));
+    const quint16 port = unused.serverPort();
+    unused.close();
+
+    AdbClient adb("127.0.0.1", port);
+    adb.setTimeout(500);
+    QByteArray out;
+    QString error;
+    QVERIFY(!adb.hostQuery("host:version", out, &error));
+    QVERIFY(!error.isEmpty());
+    QVERIFY(!adb.isConnected());
+}
+
+void TestAdbClient::parseDevices()
+{
+    const QList<AdbDevice> devices = AdbClient::parseDevices("A\tdevice\n\nB\tunauthorized \nbogus\n");
+    QCOMPARE(devices.size(), qsizetype(2));
+    QCOMPARE(devices[1].serial, QString("B"));
+    QCOMPARE(devices[1].state, QString("unauthorized"));
+    QCOMPARE(AdbClient::encodeRequest("host:version"), QByteArray("000chost:version"));
+}
+
+QTEST_GUILESS_MAIN(TestAdbClient)
+#include "tst_adbclient.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+QT += network
+
+TARGET = tst_adbclient
+
+SOURCES += \
+    tst_adbclient.cpp \
+    $$SRC/AdbClient.cpp
+
+HEADERS += \
+    $$SRC/AdbClient.h
@@ -0,0 +1,153 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "CaptureSessionManager.h"
+
+// 抓取会话的异步停止：stop() 立即返回，工作线程收尾后发出 sessionStopped（排在最后一块之后），
+// 进程自行退出同样回收，空闲线程退出，收尾期间不能重新开始同一来源，带着运行中的会话析构不挂起
+// 用一个 shell 脚本充当 adb（logcat -c 直接退出，logcat 持续输出或输出若干行后退出），仅类 Unix 系统
+class TestCaptureSessionManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void stopDoesNotBlock();
+    void processExitEndsSession();
+    void idleThreadsAreReclaimed();
+    void restartWhileStopping();
+    void destroyWithRunningSessions();
+
+private:
+    QString fakeAdb(int lines);
+
+    QTemporaryDir m_dir;
+};
+
+void TestCaptureSessionManager::initTestCase()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("模拟 adb 是 shell 脚本");
+#endif
+    QVERIFY(m_dir.isValid());
+    qRegisterMetaType<LogBlockPtr>();
+}
+
+// lines < 0 时一直输出，直到被结束
+QString TestCaptureSessionManager::fakeAdb(int lines)
+{
+    const QString fileName = m_dir.filePath(QString("adb_%1.sh").arg(lines));
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    file.write("#!/bin/sh\n"
+               "case \"$*\" in *\"logcat -c\"*) exit 0;; esac\n"
+               "i=0\n"
+               "while [ " + QByteArray::number(lines) + " -lt 0 ] || [ $i -lt " + QByteArray::number(lines) + " ]; do\n"
+               "  echo \"01-02 03:04:05.678  1000  1001 I Tag: line $i\"\n"
+               "  i=$((i+1))\n"
+               "  [ " + QByteArray::number(lines) + " -lt 0 ] && sleep 0.01\n"
+               "done\n"
+               "exit 0\n");
+    file.close();
+    file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+    return fileName;
+}
+
+void TestCaptureSessionManager::stopDoesNotBlock()
+{
+    CaptureSessionManager manager(fakeAdb(-1));
+    manager.setOutputDirectory(QString());
+    qint64 lines = 0;
+    connect(&manager, &CaptureSessionManager::blockReceived, this, [&lines](const LogBlockPtr &block) {
+        lines += block->lines.size();
+    });
+    QSignalSpy stopped(&manager, &CaptureSessionManager::sessionStopped);
+    QSignalSpy allStopped(&manager, &CaptureSessionManager::allSessionsStopped);
+
+    for (int i = 0; i < 3; ++i)
+        QVERIFY(manager.startLogcat(QString("dev%1").arg(i)));
+    QTRY_VERIFY(lines > 30);
+
+    QElapsedTimer timer;
+    timer.start();
+    manager.stopAll();
+    QVERIFY(timer.elapsed() < 100);
+    QVERIFY(manager.sources().isEmpty());
+    QVERIFY(!manager.isIdle());
+
+    QTRY_COMPARE(stopped.count(), 3);
+    QCOMPARE(allStopped.count(), 1);
+    QVERIFY(manager.isIdle());
+}
+
+// logcat 自行退出：不调用 stop() 也会回收，且停止信号在最后一块之后
+void TestCaptureSessionManager::processExitEndsSession()
+{
+    CaptureSessionManager manager(fakeAdb(500));
+    manager.setOutputDirectory(QString());
+    qint64 lines = 0;
+    qint64 linesAtStop = -1;
+    connect(&manager, &CaptureSessionManager::blockReceived, this, [&lines](const LogBlockPtr &block) {
+        lines += block->lines.size();
+    });
+    connect(&manager, &CaptureSessionManager::sessionStopped, this, [&]() { linesAtStop = lines; });
+
+    QVERIFY(manager.startLogcat("dev"));
+    QTRY_VERIFY(linesAtStop >= 0);
+    QCOMPARE(linesAtStop, qint64(500));
+    QVERIFY(!manager.isRunning(CaptureSessionManager::logcatSource("dev")));
+    QVERIFY(manager.isIdle());
+}
+
+void TestCaptureSessionManager::idleThreadsAreReclaimed()
+{
+    CaptureSessionManager manager(fakeAdb(-1));
+    manager.setOutputDirectory(QString());
+    QVERIFY(manager.startLogcat("a"));
+    QVERIFY(manager.startLogcat("b"));
+    QCOMPARE(manager.threadCount(), 2);
+
+    manager.stop(CaptureSessionManager::logcatSource("a"));
+    QTRY_COMPARE(manager.threadCount(), 1);
+    manager.stopAll();
+    QTRY_COMPARE(manager.threadCount(), 0);
+
+    QVERIFY(manager.startLogcat("c"));
+    QCOMPARE(manager.threadCount(), 1);
+    manager.stopAll();
+    QTRY_VERIFY(manager.isIdle());
+}
+
+void TestCaptureSessionManager::restartWhileStopping()
+{
+    CaptureSessionManager manager(fakeAdb(-1));
+    manager.setOutputDirectory(m_dir.path());
+    QVERIFY(manager.startLogcat("dev"));
+    manager.stop(CaptureSessionManager::logcatSource("dev"));
+
+    QString error;
+    QVERIFY(!manager.startLogcat("dev", &error));
+    QVERIFY(!error.isEmpty());
+    QTRY_VERIFY(manager.isIdle());
+    QVERIFY2(manager.startLogcat("dev", &error), qPrintable(error));
+    manager.stopAll();
+    QTRY_VERIFY(manager.isIdle());
+}
+
+void TestCaptureSessionManager::destroyWithRunningSessions()
+{
+    QElapsedTimer timer;
+    timer.start();
+    {
+        CaptureSessionManager manager(fakeAdb(-1));
+        manager.setOutputDirectory(m_dir.path());
+        for (int i = 0; i < 4; ++i)
+            QVERIFY(manager.startLogcat(QString("x%1").arg(i)));
+        QTest::qWait(200);
+        manager.stop(CaptureSessionManager::logcatSource("x0"));
+    }
+    QVERIFY(timer.elapsed() < 10000);
+}
+
+QTEST_GUILESS_MAIN(TestCaptureSessionManager)
+#include "tst_capturesessionmanager.moc"
@@ -0,0 +1,31 @@
+include(../tests.pri)
+
+QT += serialport
+
+TARGET = tst_capturesessionmanager
+
+SOURCES += \
+    tst_capturesessionmanager.cpp \
+    $$SRC/CaptureSessionManager.cpp \
+    $$SRC/LogcatWorker.cpp \
+    $$SRC/SerialReader.cpp \
+    $$SRC/SerialReplayer.cpp \
+    $$SRC/LogFileWriter.cpp \
+    $$SRC/LogSessionWriter.cpp \
+    $$SRC/CompressedLogWriter.cpp \
+    $$SRC/RawCaptureWriter.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/CaptureSessionManager.h \
+    $$SRC/LogcatWorker.h \
+    $$SRC/SerialReader.h \
+    $$SRC/SerialReplayer.h \
+    $$SRC/LogFileWriter.h \
+    $$SRC/LogSessionWriter.h \
+    $$SRC/LogSessionFormat.h \
+    $$SRC/CompressedLogFormat.h \
+    $$SRC/CompressedLogWriter.h \
+    $$SRC/RawCaptureFormat.h \
+    $$SRC/RawCaptureWriter.h \
+    $$CORE_HEADERS
@@ -0,0 +1,212 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "LoadGenerator.h"
+#include "CompressedLogWriter.h"
+#include "CompressedLogReader.h"
+#include <cstring>
+
+// 压缩日志分段：写入、轮转后逐段读回与原文一致；后台积压有上限（写入的 + 丢弃的 = 全部）；
+// 尾部索引损坏时不使用，按块头重建；截断的文件只读出完整的块
+class TestCompressedLog : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void roundTrip();
+    void backlogIsBounded();
+    void corruptIndex_data();
+    void corruptIndex();
+    void truncated();
+
+private:
+    QString writeSegments(const QString &name, const CompressedLogWriter::Options &options,
+                          const QByteArray &data, qint64 *dropped = nullptr);
+    static QByteArray readSegments(const QString &baseName, int *segments = nullptr);
+    static QByteArray readFile(const QString &fileName);
+
+    QTemporaryDir m_dir;
+    QByteArray m_corpus;
+};
+
+void TestCompressedLog::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    LoadGenerator::Options options;
+    options.linesPerSec = 20000;
+    LoadGenerator generator(options);
+    qint64 elapsedUs = 0;
+    while (m_corpus.size() < 2 * 1024 * 1024) {
+        elapsedUs += 1000000;
+        generator.generate(elapsedUs, m_corpus, 20000);
+    }
+}
+
+// 按 64 KB 分次写入，关闭后等后台写完，返回基本文件名
+QString TestCompressedLog::writeSegments(const QString &name, const CompressedLogWriter::Options &options,
+                                         const QByteArray &data, qint64 *dropped)
+{
+    const QString baseName = m_dir.filePath(name);
+    CompressedLogWriter writer;
+    writer.setOptions(options);
+    if (!writer.open(baseName))
+        return QString();
+    for (qsizetype offset = 0; offset < data.size(); offset += 64 * 1024)
+        writer.write(data.constData() + offset, qMin<qsizetype>(64 * 1024, data.size() - offset));
+    writer.close();
+    if (dropped)
+        *dropped = writer.droppedBytes();
+    CompressedLogWriter::waitForBackground();
+    return baseName;
+}
+
+QByteArray TestCompressedLog::readSegments(const QString &baseName, int *segments)
+{
+    QByteArray out;
+    int segment = 1;
+    for (;; ++segment) {
+        const QString fileName = QString("%1_%2.fdz").arg(baseName).arg(segment, 3, 10, QChar('0'));
+        if (!QFile::exists(fileName))
+            break;
+        CompressedLogReader reader;
+        if (!reader.open(fileName))
+            break;
+        for (int i = 0; i < reader.blockCount(); ++i)
+            out += reader.block(i);
+    }
+    if (segments)
+        *segments = segment - 1;
+    return out;
+}
+
+QByteArray TestCompressedLog::readFile(const QString &fileName)
+{
+    QFile file(fileName);
+    return file.open(QIODevice::ReadOnly) ? file.readAll() : QByteArray();
+}
+
+void TestCompressedLog::roundTrip()
+{
+    CompressedLogWriter::Options options;
+    options.blockBytes = 16 * 1024;
+    options.rotateBytes = 512 * 1024;
+    const QString baseName = writeSegments("roundtrip", options, m_corpus);
+    QVERIFY(!baseName.isEmpty());
+
+    int segments = 0;
+    QCOMPARE(readSegments(baseName, &segments), m_corpus);
+    QVERIFY(segments >= 4);
+
+    CompressedLogReader reader;
+    QVERIFY(reader.open(baseName + "_001.fdz"));
+    QVERIFY(reader.blockCount() > 1);
+    QVERIFY(reader.block(-1).isEmpty());
+    QVERIFY(reader.block(reader.blockCount()).isEmpty());
+}
+
+// 压缩跟不上时积压不超过上限：多出的块被丢弃并计数，已写入的块完整可读
+void TestCompressedLog::backlogIsBounded()
+{
+    CompressedLogWriter::Options options;
+    options.blockBytes = 16 * 1024;
+    options.rotateBytes = 0;
+    options.level = 9;
+    options.maxPendingBytes = 64 * 1024;
+    options.maxQueuedBytes = 128 * 1024;
+    QByteArray data;
+    for (int i = 0; i < 8; ++i)
+        data += m_corpus;
+
+    qint64 dropped = -1;
+    const QString baseName = writeSegments("bounded", options, data, &dropped);
+    QVERIFY(!baseName.isEmpty());
+    const QByteArray stored = readSegments(baseName);
+    QCOMPARE(qint64(stored.size()) + dropped, qint64(data.size()));
+    QVERIFY(stored.isEmpty() || stored.endsWith('\n'));
+}
+
+// 把正常关闭的文件的尾部索引改坏：索引不可信，按块头重建后内容不变
+void TestCompressedLog::corruptIndex_data()
+{
+    QTest::addColumn<int>("field");
+    QTest::addColumn<quint64>("value");
+    // field: 0..3 为第二项索引的 fileOffset/rawOffset/storedSize/rawSize，4 为尾部 blockCount，5 为尾部 indexOffset
+    QTest::newRow("fileOffset past end") << 0 << (quint64(1) << 40);
+    QTest::newRow("fileOffset huge") << 0 << ~quint64(0);
+    QTest::newRow("rawOffset") << 1 << quint64(12345);
+    QTest::newRow("storedSize past end") << 2 << quint64(0xffffffffu);
+    QTest::newRow("storedSize mismatch") << 2 << quint64(7);
+    QTest::newRow("rawSize zero") << 3 << quint64(0);
+    QTest::newRow("blockCount") << 4 << quint64(0x7fffffff);
+    QTest::newRow("indexOffset") << 5 << quint64(8);
+}
+
+void TestCompressedLog::corruptIndex()
+{
+    QFETCH(int, field);
+    QFETCH(quint64, value);
+
+    CompressedLogWriter::Options options;
+    options.blockBytes = 16 * 1024;
+    options.rotateBytes = 0;
+    const QByteArray data = m_corpus.left(m_corpus.indexOf('\n', 256 * 1024) + 1);
+    const QString baseName = writeSegments(QString("corrupt %1").arg(QTest::currentDataTag()), options, data);
+    const QString fileName = baseName + "_001.fdz";
+    QByteArray bytes = readFile(fileName);
+
+    CompressedFileFooter footer;
+    QVERIFY(bytes.size() > qsizetype(sizeof(footer)));
+    memcpy(&footer, bytes.constData() + bytes.size() - sizeof(footer), sizeof(footer));
+    QVERIFY(footer.blockCount > 2);
+
+    const qsizetype entry = qsizetype(footer.indexOffset + sizeof(CompressedBlockIndex));
+    const qsizetype footerAt = bytes.size() - qsizetype(sizeof(footer));
+    switch (field) {
+    case 0: { const quint64 v = value; memcpy(bytes.data() + entry + offsetof(CompressedBlockIndex, fileOffset), &v, 8); break; }
+    case 1: { const quint64 v = value; memcpy(bytes.data() + entry + offsetof(CompressedBlockIndex, rawOffset), &v, 8); break; }
+    case 2: { const quint32 v = quint32(value); memcpy(bytes.data() + entry + offsetof(CompressedBlockIndex, storedSize), &v, 4); break; }
+    case 3: { const quint32 v = quint32(value); memcpy(bytes.data() + entry + offsetof(CompressedBlockIndex, rawSize), &v, 4); break; }
+    case 4: { const quint32 v = quint32(value); memcpy(bytes.data() + footerAt + offsetof(CompressedFileFooter, blockCount), &v, 4); break; }
+    default: { const quint64 v = value; memcpy(bytes.data() + footerAt + offsetof(CompressedFileFooter, indexOffset), &v, 8); break; }
+    }
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+    file.write(bytes);
+    file.close();
+
+    QCOMPARE(readSegments(baseName), data);
+}
+
+// 写入中断的文件：没有尾部索引，最后一块可能只写了一半
+void TestCompressedLog::truncated()
+{
+    CompressedLogWriter::Options options;
+    options.blockBytes = 16 * 1024;
+    options.rotateBytes = 0;
+    const QByteArray data = m_corpus.left(m_corpus.indexOf('\n', 256 * 1024) + 1);
+    const QString baseName = writeSegments("truncated", options, data);
+    const QString fileName = baseName + "_001.fdz";
+    const QByteArray bytes = readFile(fileName);
+
+    for (qsizetype cut : {qsizetype(0), qsizetype(sizeof(CompressedFileHeader)), qsizetype(100), bytes.size() / 2,
+                          bytes.size() - 1, bytes.size() - qsizetype(sizeof(CompressedFileFooter))}) {
+        QFile file(fileName);
+        QVERIFY(file.open(QIODevice::WriteOnly | QIODevice::Truncate));
+        file.write(bytes.left(cut));
+        file.close();
+
+        CompressedLogReader reader;
+        if (!reader.open(fileName)) {
+            QVERIFY(cut < qsizetype(sizeof(CompressedFileHeader)));
+            continue;
+        }
+        QByteArray out;
+        for (int i = 0; i < reader.blockCount(); ++i)
+            out += reader.block(i);
+        QVERIFY(data.startsWith(out));
+        QVERIFY(out.isEmpty() || out.endsWith('\n'));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestCompressedLog)
+#include "tst_compressedlog.moc"
@@ -0,0 +1,15 @@
+include(../tests.pri)
+
+TARGET = tst_compressedlog
+
+SOURCES += \
+    tst_compressedlog.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$SRC/CompressedLogWriter.cpp \
+    $$SRC/CompressedLogReader.cpp
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$SRC/CompressedLogFormat.h \
+    $$SRC/CompressedLogWriter.h \
+    $$SRC/CompressedLogReader.h
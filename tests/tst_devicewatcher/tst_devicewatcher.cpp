@@ -0,0 +1,100 @@
+#include <QtTest>
+#include <QTcpServer>
+#include <QTcpSocket>
+#include "DeviceWatcher.h"
+
+// track-devices 长连接：server 不可用时第一次失败也报告状态（之后的重试不重复报告），
+// 连上后按推送的列表发出增删和状态变化，server 断开时所有设备视为断开
+class TestDeviceWatcher : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void reportsUnavailableOnce();
+    void tracksDevices();
+
+private:
+    static QByteArray payload(const QByteArray &list);
+};
+
+void TestDeviceWatcher::initTestCase()
+{
+    qRegisterMetaType<AdbDevice>();
+    qRegisterMetaType<QList<AdbDevice>>();
+}
+
+QByteArray TestDeviceWatcher::payload(const QByteArray &list)
+{
+    return QByteArray::number(list.size(), 16).rightJustified(4, '0') + list;
+}
+
+void TestDeviceWatcher::reportsUnavailableOnce()
+{
+    QTcpServer unused;
+    QVERIFY(unused.listen(QHostAddress::LocalHost, 0));
+    const quint16 port = unused.serverPort();
+    unused.close();
+
+    // adb 不存在：启动 server 失败后按退避间隔重连，状态只报告一次
+    DeviceWatcher watcher("/nonexistent/adb", nullptr, port);
+    QSignalSpy spy(&watcher, &DeviceWatcher::serverAvailableChanged);
+    watcher.start();
+    QTRY_COMPARE(spy.count(), 1);
+    QCOMPARE(spy[0][0].toBool(), false);
+    QVERIFY(!spy[0][1].toString().isEmpty());
+    QVERIFY(!watcher.isServerAvailable());
+
+    QTest::qWait(1500);
+    QCOMPARE(spy.count(), 1);
+
+    // 重新 start() 后再报告一次
+    watcher.stop();
+    watcher.start();
+    QTRY_COMPARE(spy.count(), 2);
+    QCOMPARE(spy[1][0].toBool(), false);
+}
+
+void TestDeviceWatcher::tracksDevices()
+{
+    QTcpServer server;
+    QVERIFY(server.listen(QHostAddress::LocalHost, 0));
+    QTcpSocket *client = nullptr;
+    QByteArray request;
+    connect(&server, &QTcpServer::newConnection, this, [&]() {
+        client = server.nextPendingConnection();
+        connect(client, &QTcpSocket::readyRead, this, [&]() {
+            request += client->readAll();
+            if (request == "0012host:track-devices")
+                client->write("OKAY" + payload("SER1\tdevice\n"));
+        });
+    });
+
+    DeviceWatcher watcher("/nonexistent/adb", nullptr, server.serverPort());
+    QSignalSpy available(&watcher, &DeviceWatcher::serverAvailableChanged);
+    QSignalSpy added(&watcher, &DeviceWatcher::deviceAdded);
+    QSignalSpy removed(&watcher, &DeviceWatcher::deviceRemoved);
+    QSignalSpy changed(&watcher, &DeviceWatcher::deviceStateChanged);
+    watcher.start();
+
+    QTRY_COMPARE(added.count(), 1);
+    QCOMPARE(available.count(), 1);
+    QCOMPARE(available[0][0].toBool(), true);
+    QCOMPARE(watcher.devices().size(), qsizetype(1));
+    QCOMPARE(watcher.devices()[0].serial, QString("SER1"));
+
+    client->write(payload("SER1\toffline\nSER2\tdevice\n"));
+    QTRY_COMPARE(added.count(), 2);
+    QCOMPARE(changed.count(), 1);
+    QCOMPARE(changed[0][0].value<AdbDevice>().state, QString("offline"));
+
+    client->disconnectFromHost();
+    QTRY_COMPARE(removed.count(), 2);
+    QCOMPARE(available.count(), 2);
+    QCOMPARE(available[1][0].toBool(), false);
+    QVERIFY(watcher.devices().isEmpty());
+    watcher.stop();
+}
+
+QTEST_GUILESS_MAIN(TestDeviceWatcher)
+#include "tst_devicewatcher.moc"
@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+QT += network
+
+TARGET = tst_devicewatcher
+
+SOURCES += \
+    tst_devicewatcher.cpp \
+    $$SRC/AdbClient.cpp \
+    $$SRC/DeviceWatcher.cpp
+
+HEADERS += \
+    $$SRC/AdbClient.h \
+    $$SRC/DeviceWatcher.h
@@ -0,0 +1,153 @@
+#include <QtTest>
+#include "LoadGenerator.h"
+
+// 合成日志生成器：参数解析、按时间积分的行数、行格式和序号（--bench 靠序号统计丢失的行）
+class TestLoadGenerator : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void specRoundTrip();
+    void invalidSpec_data();
+    void invalidSpec();
+    void sequenceOf();
+    void rateFollowsTime();
+    void burstRate();
+    void lineFormat_data();
+    void lineFormat();
+    void generateThroughput();
+};
+
+void TestLoadGenerator::specRoundTrip()
+{
+    LoadGenerator::Options options;
+    QString error;
+    QVERIFY(LoadGenerator::parseSpec("rate=1234,len=80-90,levels=1/2/3/4/5,burst=4x100/1000,format=uart,seed=7",
+                                     options, &error));
+    QCOMPARE(options.linesPerSec, 1234.0);
+    QCOMPARE(options.minLineBytes, 80);
+    QCOMPARE(options.maxLineBytes, 90);
+    QCOMPARE(options.levelWeights[4], 5);
+    QCOMPARE(options.burstFactor, 4.0);
+    QCOMPARE(options.burstLengthMs, 100);
+    QCOMPARE(options.burstPeriodMs, 1000);
+    QVERIFY(!options.logcat);
+    QCOMPARE(options.seed, 7u);
+
+    LoadGenerator::Options copy;
+    QVERIFY(LoadGenerator::parseSpec(LoadGenerator::toSpec(options), copy, &error));
+    QCOMPARE(LoadGenerator::toSpec(copy), LoadGenerator::toSpec(options));
+}
+
+void TestLoadGenerator::invalidSpec_data()
+{
+    QTest::addColumn<QString>("spec");
+    QTest::newRow("unknown key") << "speed=10";
+    QTest::newRow("negative rate") << "rate=-1";
+    QTest::newRow("reversed len") << "len=100-50";
+    QTest::newRow("levels count") << "levels=1/2/3";
+    QTest::newRow("zero levels") << "levels=0/0/0/0/0";
+    QTest::newRow("burst period") << "burst=2x500/100";
+    QTest::newRow("format") << "format=json";
+}
+
+void TestLoadGenerator::invalidSpec()
+{
+    QFETCH(QString, spec);
+    LoadGenerator::Options options;
+    QString error;
+    QVERIFY(!LoadGenerator::parseSpec(spec, options, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestLoadGenerator::sequenceOf()
+{
+    const QByteArray line = "01-02 03:04:05.678  1000  1001 I Tag: seq=42 abc";
+    QCOMPARE(LoadGenerator::sequenceOf(line.constData(), line.size()), qint64(42));
+    QCOMPARE(LoadGenerator::sequenceOf("no sequence", 11), qint64(-1));
+    QCOMPARE(LoadGenerator::sequenceOf("seq=x", 5), qint64(-1));
+    QCOMPARE(LoadGenerator::sequenceOf("seq=", 4), qint64(-1));
+}
+
+void TestLoadGenerator::rateFollowsTime()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = 1000;
+    LoadGenerator generator(options);
+    QByteArray out;
+    QCOMPARE(generator.generate(500000, out, 100000), 500);
+    QCOMPARE(generator.generate(500000, out, 100000), 0);
+    // 单次上限截断的行在下次补上
+    QCOMPARE(generator.generate(2000000, out, 1000), 1000);
+    QCOMPARE(generator.generate(2000000, out, 1000), 500);
+    QCOMPARE(generator.linesGenerated(), quint64(2000));
+    QCOMPARE(out.count('\n'), qsizetype(2000));
+}
+
+void TestLoadGenerator::burstRate()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = 100;
+    options.burstFactor = 10;
+    options.burstLengthMs = 100;
+    options.burstPeriodMs = 1000;
+    LoadGenerator generator(options);
+    QByteArray out;
+    // 每秒 0.1 秒 ×10 倍 + 0.9 秒 ×1 倍 = 190 行
+    generator.generate(100000, out, 100000);
+    QCOMPARE(generator.linesGenerated(), quint64(100));
+    generator.generate(2000000, out, 100000);
+    QCOMPARE(generator.linesGenerated(), quint64(380));
+}
+
+void TestLoadGenerator::lineFormat_data()
+{
+    QTest::addColumn<bool>("logcat");
+    QTest::newRow("logcat") << true;
+    QTest::newRow("uart") << false;
+}
+
+void TestLoadGenerator::lineFormat()
+{
+    QFETCH(bool, logcat);
+    LoadGenerator::Options options;
+    options.linesPerSec = 10000;
+    options.minLineBytes = 100;
+    options.maxLineBytes = 160;
+    options.logcat = logcat;
+    LoadGenerator generator(options);
+    QByteArray out;
+    generator.generate(1000000, out, 100000);
+
+    const QList<QByteArray> lines = out.split('\n');
+    QCOMPARE(lines.size(), qsizetype(10001));
+    QVERIFY(lines.last().isEmpty());
+    for (int i = 0; i < 10000; ++i) {
+        const QByteArray &line = lines[i];
+        QCOMPARE(LoadGenerator::sequenceOf(line.constData(), line.size()), qint64(i));
+        QVERIFY2(line.size() >= options.minLineBytes && line.size() <= options.maxLineBytes, line.constData());
+        if (logcat) {
+            QVERIFY(QRegularExpression("^\\d\\d-\\d\\d \\d\\d:\\d\\d:\\d\\d\\.\\d{3} +\\d+ +\\d+ [VDIWE] \\w+: seq=")
+                    .match(QString::fromLatin1(line)).hasMatch());
+        } else {
+            QVERIFY(QRegularExpression("^\\[ *\\d+\\.\\d{6}\\] [VDIWE] seq=").match(QString::fromLatin1(line)).hasMatch());
+        }
+    }
+}
+
+void TestLoadGenerator::generateThroughput()
+{
+    LoadGenerator::Options options;
+    options.linesPerSec = 1e6;
+    LoadGenerator generator(options);
+    QByteArray out;
+    qint64 elapsedUs = 0;
+    QBENCHMARK {
+        out.clear();
+        elapsedUs += 10000;
+        generator.generate(elapsedUs, out, 100000);
+    }
+}
+
+QTEST_APPLESS_MAIN(TestLoadGenerator)
+#include "tst_loadgenerator.moc"
@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_loadgenerator
+
+SOURCES += \
+    tst_loadgenerator.cpp \
+    $$SRC/LoadGenerator.cpp
+
+HEADERS += \
+    $$SRC/LoadGenerator.h
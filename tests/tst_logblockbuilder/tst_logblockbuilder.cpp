@@ -0,0 +1,104 @@
+#include <QtTest>
+#include "LogBlockBuilder.h"
+#include "LogcatParser.h"
+
+// 切行：任意分段喂入、不完整末行、超长行强制断行（不拆开 UTF-8 字符）
+class TestLogBlockBuilder : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void splitsAcrossFeeds();
+    void longLinesKeepUtf8_data();
+    void longLinesKeepUtf8();
+    void oversizedTagIsRaw();
+
+private:
+    static bool wholeCharacters(const char *data, qsizetype length);
+};
+
+// 首字节不是续字节，末尾的字符完整
+bool TestLogBlockBuilder::wholeCharacters(const char *data, qsizetype length)
+{
+    if (length == 0)
+        return true;
+    if ((uchar(data[0]) & 0xC0) == 0x80)
+        return false;
+    qsizetype lead = length - 1;
+    while (lead > 0 && (uchar(data[lead]) & 0xC0) == 0x80)
+        --lead;
+    const uchar c = uchar(data[lead]);
+    const int expected = c < 0x80 ? 1 : c >= 0xF0 ? 4 : c >= 0xE0 ? 3 : 2;
+    return length - lead == expected;
+}
+
+void TestLogBlockBuilder::splitsAcrossFeeds()
+{
+    const QByteArray text = "01-02 03:04:05.678  100  101 I Tag: first\r\n  \nsecond line\nthird";
+    for (int step = 1; step <= text.size(); ++step) {
+        LogBlockBuilder builder;
+        for (int pos = 0; pos < text.size(); pos += step)
+            builder.feed(text.mid(pos, step));
+        QVERIFY(builder.hasPartial());
+        builder.finishPartial();
+        const LogBlockPtr block = builder.take();
+        QVERIFY(block);
+        QCOMPARE(block->lines.size(), qsizetype(3));
+        const LogBlock::Line &first = block->lines[0];
+        QCOMPARE(block->data.mid(first.offset, first.length), QByteArray("01-02 03:04:05.678  100  101 I Tag: first"));
+        QCOMPARE(int(first.meta.format), int(LogLine::ThreadTime));
+        QCOMPARE(block->data.mid(block->lines[2].offset, block->lines[2].length), QByteArray("third"));
+    }
+}
+
+void TestLogBlockBuilder::longLinesKeepUtf8_data()
+{
+    QTest::addColumn<QByteArray>("character");
+    QTest::addColumn<int>("feedBytes");
+    const QByteArray characters[] = {"\xc3\xa9", "\xe4\xb8\xad", "\xf0\x9f\x98\x80"};
+    for (const QByteArray &c : characters) {
+        for (int feedBytes : {1000, 70000, 300000})
+            QTest::addRow("%d-byte char, feed %d", int(c.size()), feedBytes) << c << feedBytes;
+    }
+}
+
+// 一行 300KB：无论是在等待换行时（不完整行过长）还是整行到达后断开，各段都是完整字符
+void TestLogBlockBuilder::longLinesKeepUtf8()
+{
+    QFETCH(QByteArray, character);
+    QFETCH(int, feedBytes);
+    QByteArray text;
+    while (text.size() < 300000)
+        text += character;
+    text += '\n';
+
+    LogBlockBuilder builder;
+    for (qsizetype pos = 0; pos < text.size(); pos += feedBytes)
+        builder.feed(text.mid(pos, feedBytes));
+    const LogBlockPtr block = builder.take();
+    QVERIFY(block);
+    QVERIFY(block->lines.size() > 1);
+    qsizetype total = 0;
+    for (const LogBlock::Line &line : block->lines) {
+        QVERIFY(line.length <= quint32(LogBlockBuilder::MaxLineBytes));
+        QVERIFY(wholeCharacters(block->data.constData() + line.offset, line.length));
+        total += line.length;
+    }
+    QCOMPARE(total, text.size() - 1);
+}
+
+// TAG 落在 16 位偏移之外时整行按 Raw 处理，不截断偏移
+void TestLogBlockBuilder::oversizedTagIsRaw()
+{
+    QByteArray line = "01-02 03:04:05.678";
+    line += QByteArray(70000, '9');
+    line += "  100  101 I Tag: message";
+    LogLine meta;
+    QVERIFY(!LogcatParser::parse(line, meta));
+    QCOMPARE(int(meta.format), int(LogLine::Raw));
+    QCOMPARE(meta.tagLength, quint16(0));
+    QCOMPARE(meta.messageLength, quint32(line.size()));
+}
+
+QTEST_APPLESS_MAIN(TestLogBlockBuilder)
+#include "tst_logblockbuilder.moc"
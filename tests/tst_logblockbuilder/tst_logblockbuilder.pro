@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_logblockbuilder
+
+SOURCES += \
+    tst_logblockbuilder.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$CORE_HEADERS
@@ -0,0 +1,143 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "LoadGenerator.h"
+#include "LogBlockBuilder.h"
+#include "LogFileImporter.h"
+
+// 离线导入：按块并行解析、按文件顺序发出；没有换行的超长内容也切成有上限的块；
+// 接收端积压时暂停发出，resume() 后继续，一行不丢
+class TestLogFileImporter : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void importsInOrder();
+    void longLineWithoutNewline();
+    void pausesOnBacklog();
+
+private:
+    struct Received {
+        QByteArray text;            // 各行内容依次拼接
+        qint64 lines = 0;
+        int blocks = 0;
+        int maxLineBytes = 0;
+        qint64 finishedLines = -1;
+    };
+
+    void connectImporter(LogFileImporter &importer, Received &received);
+    QString write(const QByteArray &data, const QString &name);
+
+    QTemporaryDir m_dir;
+    QByteArray m_corpus;            // 约 6 个导入块
+};
+
+void TestLogFileImporter::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    qRegisterMetaType<LogBlockPtr>();
+
+    LoadGenerator::Options options;
+    options.linesPerSec = 20000;
+    LoadGenerator generator(options);
+    qint64 elapsedUs = 0;
+    while (m_corpus.size() < 6 * LogFileImporter::ChunkBytes) {
+        elapsedUs += 1000000;
+        generator.generate(elapsedUs, m_corpus, 20000);
+    }
+}
+
+QString TestLogFileImporter::write(const QByteArray &data, const QString &name)
+{
+    const QString fileName = m_dir.filePath(name + ".txt");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    file.write(data);
+    return fileName;
+}
+
+void TestLogFileImporter::connectImporter(LogFileImporter &importer, Received &received)
+{
+    connect(&importer, &LogFileImporter::blockReady, this, [&received](const LogBlockPtr &block) {
+        ++received.blocks;
+        received.lines += block->lines.size();
+        for (const LogBlock::Line &line : block->lines) {
+            received.text.append(block->data.constData() + line.offset, line.length);
+            received.maxLineBytes = qMax(received.maxLineBytes, int(line.length));
+        }
+    });
+    connect(&importer, &LogFileImporter::finished, this, [&received](qint64 lineCount, qint64) {
+        received.finishedLines = lineCount;
+    });
+}
+
+void TestLogFileImporter::importsInOrder()
+{
+    LogFileImporter importer;
+    Received received;
+    connectImporter(importer, received);
+    QString error;
+    QVERIFY2(importer.start(write(m_corpus, "corpus"), &error), qPrintable(error));
+    QTRY_VERIFY_WITH_TIMEOUT(received.finishedLines >= 0, 30000);
+
+    QCOMPARE(received.finishedLines, qint64(m_corpus.count('\n')));
+    QCOMPARE(received.lines, received.finishedLines);
+    QVERIFY(received.blocks >= 6);
+    QByteArray expected = m_corpus;
+    expected.replace('\n', QByteArray());
+    QVERIFY(received.text == expected);
+}
+
+// 中间一段 12 MB 没有换行：按块上限断开，内容完整，每行不超过 MaxLineBytes
+void TestLogFileImporter::longLineWithoutNewline()
+{
+    QByteArray data = m_corpus.left(m_corpus.indexOf('\n', 1000000) + 1);
+    const QByteArray pattern = "\xe4\xb8\xad\xe6\x96\x87-abc-";      // 含多字节字符，检查断点不落在字符中间
+    while (data.size() < 3 * LogFileImporter::ChunkBytes)
+        data += pattern;
+    data += '\n';
+    data += m_corpus.left(m_corpus.indexOf('\n', 1000000) + 1);
+
+    LogFileImporter importer;
+    Received received;
+    connectImporter(importer, received);
+    QVERIFY(importer.start(write(data, "long")));
+    QTRY_VERIFY_WITH_TIMEOUT(received.finishedLines >= 0, 30000);
+
+    QVERIFY(received.maxLineBytes <= LogBlockBuilder::MaxLineBytes);
+    QByteArray expected = data;
+    expected.replace('\n', QByteArray());
+    QVERIFY(received.text == expected);
+    QVERIFY(QString::fromUtf8(received.text).toUtf8() == received.text);
+}
+
+void TestLogFileImporter::pausesOnBacklog()
+{
+    LogFileImporter importer;
+    Received received;
+    connectImporter(importer, received);
+    int backlog = 0;
+    importer.setBacklog([&backlog]() { return backlog; });
+    // 接收端不消费：每发出一块积压加一
+    connect(&importer, &LogFileImporter::blockReady, this, [&backlog]() { ++backlog; });
+
+    QVERIFY(importer.start(write(m_corpus, "backlog")));
+    QTRY_COMPARE_WITH_TIMEOUT(received.blocks, LogFileImporter::MaxBacklogBlocks, 30000);
+    // 其余块解析完也不再发出
+    QTest::qWait(500);
+    QCOMPARE(received.blocks, LogFileImporter::MaxBacklogBlocks);
+    QVERIFY(importer.isRunning());
+
+    // 消费一部分后继续；之后不再限制
+    backlog = LogFileImporter::MaxBacklogBlocks - 1;
+    importer.resume();
+    QCOMPARE(received.blocks, LogFileImporter::MaxBacklogBlocks + 1);
+    importer.setBacklog(LogFileImporter::BacklogFunction());
+    importer.resume();
+    QTRY_VERIFY_WITH_TIMEOUT(received.finishedLines >= 0, 30000);
+    QCOMPARE(received.lines, qint64(m_corpus.count('\n')));
+}
+
+QTEST_GUILESS_MAIN(TestLogFileImporter)
+#include "tst_logfileimporter.moc"
@@ -0,0 +1,17 @@
+include(../tests.pri)
+
+TARGET = tst_logfileimporter
+
+SOURCES += \
+    tst_logfileimporter.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$SRC/CompressedLogReader.cpp \
+    $$SRC/LogFileImporter.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$SRC/CompressedLogFormat.h \
+    $$SRC/CompressedLogReader.h \
+    $$SRC/LogFileImporter.h \
+    $$CORE_HEADERS
@@ -0,0 +1,115 @@
+#include <QtTest>
+#include "LogBlockBuilder.h"
+#include "LogFilterEngine.h"
+#include "LogStore.h"
+
+// 关键字过滤：缓存命中、继续输入时的收窄和逐行匹配都按同一规则（只折叠 ASCII 大小写）
+class TestLogFilterEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void foldNeedle();
+    void asciiOnlyFolding();
+    void narrowingMatchesFullScan();
+    void cachedKeywordIsByteExact();
+
+private:
+    static void fill(LogStore &store, LogFilterEngine &filter, const QList<QByteArray> &lines);
+    static QList<quint64> hits(const LogStore &store, const LogFilterEngine &filter);
+};
+
+void TestLogFilterEngine::fill(LogStore &store, LogFilterEngine &filter, const QList<QByteArray> &lines)
+{
+    LogBlockBuilder builder;
+    for (const QByteArray &line : lines)
+        builder.addLine(line.constData(), line.size());
+    const LogBlockPtr block = builder.take();
+    const quint64 from = store.endSeq();
+    store.append(*block);
+    filter.onAppended(store, from, store.endSeq());
+}
+
+QList<quint64> TestLogFilterEngine::hits(const LogStore &store, const LogFilterEngine &filter)
+{
+    QList<quint64> out;
+    filter.collect(store.firstSeq(), store.endSeq(), out);
+    return out;
+}
+
+void TestLogFilterEngine::foldNeedle()
+{
+    QCOMPARE(LogFilterEngine::foldNeedle("FATAL Exception"), QByteArray("fatal exception"));
+    // 非 ASCII 字符保持原样（QString::toLower 会把 É 转成 é）
+    QCOMPARE(LogFilterEngine::foldNeedle(QString::fromUtf8("ÉCHEC")), QByteArray("\xc3\x89" "chec"));
+}
+
+void TestLogFilterEngine::asciiOnlyFolding()
+{
+    LogStore store(64);
+    LogFilterEngine filter(64);
+    fill(store, filter, {QByteArray("I/Tag: Échec du service"), QByteArray("I/Tag: échec du service"),
+                         QByteArray("I/Tag: ECHEC"), QByteArray("I/Tag: other")});
+
+    filter.setKeyword(QString::fromUtf8("échec"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>({1}));
+    filter.setKeyword(QString::fromUtf8("Échec"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>({0}));
+    filter.setKeyword("ECHEC", store);
+    QCOMPARE(hits(store, filter), QList<quint64>({2}));
+}
+
+// 继续输入时只复查上一个关键字命中的行，结果必须与全量匹配一致
+void TestLogFilterEngine::narrowingMatchesFullScan()
+{
+    const QList<QByteArray> lines = {
+        QByteArray("E/AndroidRuntime: FATAL EXCEPTION: main"),
+        QByteArray("E/AndroidRuntime: fatal exception in Ünit"),
+        QByteArray("E/AndroidRuntime: Fatal Exception in ünit"),
+        QByteArray("I/Tag: nothing"),
+    };
+    const QStringList typed = {"F", "Fa", "FATAL", "FATAL EX", "FATAL EXCEPTION IN ü", "FATAL EXCEPTION IN Ü"};
+
+    LogStore store(64);
+    LogFilterEngine incremental(64);
+    fill(store, incremental, lines);
+    for (const QString &keyword : typed) {
+        incremental.setKeyword(keyword, store);
+
+        LogStore fresh(64);
+        LogFilterEngine full(64);
+        fill(fresh, full, lines);
+        full.setKeyword(keyword, fresh);
+        QCOMPARE(hits(store, incremental), hits(fresh, full));
+
+        QList<quint64> expected;
+        const QByteArray needle = LogFilterEngine::foldNeedle(keyword);
+        for (int i = 0; i < lines.size(); ++i)
+            if (LogFilterEngine::lineMatches(lines[i].constData(), lines[i].size(), needle))
+                expected.append(quint64(i));
+        QCOMPARE(hits(store, incremental), expected);
+    }
+}
+
+// 只差非 ASCII 大小写的两个关键字是不同的过滤条件，不能共用缓存的位图
+void TestLogFilterEngine::cachedKeywordIsByteExact()
+{
+    LogStore store(64);
+    LogFilterEngine filter(64);
+    fill(store, filter, {QByteArray("I/Tag: Ünit"), QByteArray("I/Tag: ünit")});
+
+    filter.setKeyword(QString::fromUtf8("ünit"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>({1}));
+    filter.setKeyword(QString::fromUtf8("Ünit"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>({0}));
+    filter.setKeyword(QString::fromUtf8("UNIT"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>());
+
+    // 新行按各缓存关键字增量匹配
+    fill(store, filter, {QByteArray("I/Tag: ÜNIT")});
+    filter.setKeyword(QString::fromUtf8("Ünit"), store);
+    QCOMPARE(hits(store, filter), QList<quint64>({0, 2}));
+}
+
+QTEST_APPLESS_MAIN(TestLogFilterEngine)
+#include "tst_logfilterengine.moc"
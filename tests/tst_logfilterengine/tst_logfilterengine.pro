@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_logfilterengine
+
+SOURCES += \
+    tst_logfilterengine.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$CORE_HEADERS
@@ -0,0 +1,246 @@
+#include <QtTest>
+#include <QThread>
+#include <QRandomGenerator>
+#include "LogQueue.h"
+
+// 无锁队列：顺序、批量、丢弃最旧的计数，以及生产者/消费者并发的压力测试和吞吐
+// 并发用例在 ThreadSanitizer 下运行（见 tests.pri），队列很小时大部分入队都会走丢弃最旧的 CAS 路径
+class TestLogQueue : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void capacityRoundsUp();
+    void fifoAndBatches();
+    void dropOldest();
+    void dropNewestWhileClaimed();
+    void stress_data();
+    void stress();
+    void stressNonTrivial();
+    void throughput_data();
+    void throughput();
+};
+
+void TestLogQueue::capacityRoundsUp()
+{
+    QCOMPARE(LogQueue<int>(0).capacity(), 2);
+    QCOMPARE(LogQueue<int>(5).capacity(), 8);
+    QCOMPARE(LogQueue<int>(1024).capacity(), 1024);
+}
+
+void TestLogQueue::fifoAndBatches()
+{
+    LogQueue<int> queue(16);
+    const QVector<int> items = {1, 2, 3, 4, 5};
+    QCOMPARE(queue.push(items), 0);
+    QVERIFY(queue.push(6));
+    QCOMPARE(queue.size(), 6);
+
+    QVector<int> out;
+    QCOMPARE(queue.pop(out, 4), 4);
+    QCOMPARE(out, QVector<int>({1, 2, 3, 4}));
+    int one = 0;
+    QVERIFY(queue.pop(one));
+    QCOMPARE(one, 5);
+    QCOMPARE(queue.pop(out), 1);
+    QCOMPARE(out.last(), 6);
+    QVERIFY(!queue.pop(one));
+    QCOMPARE(queue.pop(out, 0), 0);
+
+    QCOMPARE(queue.pushedCount(), quint64(6));
+    QCOMPARE(queue.poppedCount(), quint64(6));
+    QCOMPARE(queue.droppedCount(), quint64(0));
+}
+
+void TestLogQueue::dropOldest()
+{
+    LogQueue<int> queue(8);
+    QVector<int> items;
+    for (int i = 0; i < 20; ++i)
+        items.append(i);
+    QCOMPARE(queue.push(items), 12);
+    QCOMPARE(queue.size(), 8);
+
+    QVector<int> out;
+    queue.pop(out);
+    QCOMPARE(out, QVector<int>({12, 13, 14, 15, 16, 17, 18, 19}));
+    QCOMPARE(queue.pushedCount(), queue.poppedCount() + queue.droppedCount());
+}
+
+// 消费者认领了最旧的一批但尚未释放时，生产者不能挤掉它们，只能丢弃新元素
+// 单线程里用一个在拷贝时入队的元素类型模拟“认领后、释放前”的时刻
+void TestLogQueue::dropNewestWhileClaimed()
+{
+    struct Item {
+        int value = 0;
+        LogQueue<Item> *queue = nullptr;
+        int *droppedDuringRead = nullptr;
+        Item() = default;
+        Item(int v, LogQueue<Item> *q, int *d) : value(v), queue(q), droppedDuringRead(d) {}
+        Item(Item &&other) noexcept { *this = std::move(other); }
+        Item &operator=(Item &&other) noexcept
+        {
+            value = other.value;
+            queue = other.queue;
+            droppedDuringRead = other.droppedDuringRead;
+            other.queue = nullptr;
+            if (queue && value == 0) {
+                *droppedDuringRead = queue->push(Item(100, nullptr, nullptr)) ? 0 : 1;
+                queue = nullptr;
+            }
+            return *this;
+        }
+        Item(const Item &other) = default;
+        Item &operator=(const Item &other) = default;
+    };
+
+    LogQueue<Item> queue(2);
+    int droppedDuringRead = -1;
+    QVERIFY(queue.push(Item(0, &queue, &droppedDuringRead)));
+    QVERIFY(queue.push(Item(1, nullptr, nullptr)));
+
+    QVector<Item> out;
+    QCOMPARE(queue.pop(out, 1), 1);
+    QCOMPARE(droppedDuringRead, 1);
+    QCOMPARE(out[0].value, 0);
+    QVERIFY(queue.pop(out));
+    QCOMPARE(out.last().value, 1);
+    QCOMPARE(queue.pushedCount(), quint64(3));
+    QCOMPARE(queue.droppedCount(), quint64(1));
+    QCOMPARE(queue.pushedCount(), queue.poppedCount() + queue.droppedCount());
+}
+
+void TestLogQueue::stress_data()
+{
+    QTest::addColumn<int>("capacity");
+    QTest::addColumn<int>("maxBatch");
+    QTest::newRow("tiny queue, mostly drops") << 4 << 8;
+    QTest::newRow("small queue") << 64 << 32;
+    QTest::newRow("default queue") << int(LogQueue<quint64>::DefaultCapacity) << 256;
+}
+
+// 生产者按随机批量推入递增序号，消费者按随机批量取出：
+// 取出的序号严格递增（丢弃只会造成跳号），结束时 推入 = 取出 + 丢弃
+void TestLogQueue::stress()
+{
+    QFETCH(int, capacity);
+    QFETCH(int, maxBatch);
+    const quint64 total = 1000000;
+
+    LogQueue<quint64> queue(capacity);
+    std::atomic<bool> done{false};
+    QThread *producer = QThread::create([&]() {
+        QRandomGenerator random(1);
+        std::vector<quint64> batch;
+        quint64 next = 0;
+        while (next < total) {
+            batch.clear();
+            const int n = int(qMin<quint64>(total - next, random.bounded(1, maxBatch + 1)));
+            for (int i = 0; i < n; ++i)
+                batch.push_back(next++);
+            queue.push(batch.data(), n);
+        }
+        done.store(true, std::memory_order_release);
+    });
+    producer->start();
+
+    QRandomGenerator random(2);
+    QVector<quint64> out;
+    qint64 last = -1;
+    quint64 popped = 0;
+    bool ordered = true;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        out.clear();
+        const int n = queue.pop(out, random.bounded(1, maxBatch + 1));
+        for (quint64 value : out) {
+            ordered = ordered && qint64(value) > last;
+            last = qint64(value);
+        }
+        popped += quint64(n);
+        if (n == 0 && finished)
+            break;
+    }
+    producer->wait();
+    delete producer;
+
+    QVERIFY(ordered);
+    QCOMPARE(queue.pushedCount(), total);
+    QCOMPARE(queue.poppedCount(), popped);
+    QCOMPARE(queue.pushedCount(), queue.poppedCount() + queue.droppedCount());
+    QCOMPARE(queue.size(), 0);
+    if (queue.droppedCount() == 0)
+        QCOMPARE(last, qint64(total - 1));
+}
+
+// 元素为共享指针（与日志块相同）：槽位的读写和析构都在 ThreadSanitizer 的检查范围内
+void TestLogQueue::stressNonTrivial()
+{
+    using Item = QSharedPointer<const QByteArray>;
+    const int total = 300000;
+    LogQueue<Item> queue(16);
+    std::atomic<bool> done{false};
+    QThread *producer = QThread::create([&]() {
+        for (int i = 0; i < total; ++i)
+            queue.push(Item(new QByteArray(QByteArray::number(i))));
+        done.store(true, std::memory_order_release);
+    });
+    producer->start();
+
+    QVector<Item> out;
+    int last = -1;
+    bool ordered = true;
+    for (;;) {
+        const bool finished = done.load(std::memory_order_acquire);
+        out.clear();
+        if (queue.pop(out, 8) == 0 && finished)
+            break;
+        for (const Item &item : out) {
+            const int value = item->toInt();
+            ordered = ordered && value > last;
+            last = value;
+        }
+    }
+    producer->wait();
+    delete producer;
+
+    QVERIFY(ordered);
+    QCOMPARE(queue.pushedCount(), queue.poppedCount() + queue.droppedCount());
+}
+
+void TestLogQueue::throughput_data()
+{
+    QTest::addColumn<int>("batch");
+    QTest::newRow("batch 1") << 1;
+    QTest::newRow("batch 32") << 32;
+    QTest::newRow("batch 1024") << 1024;
+}
+
+// 一百万个元素从生产者线程经队列到消费者的耗时（队列足够大，不丢弃）
+void TestLogQueue::throughput()
+{
+    QFETCH(int, batch);
+    const int total = 1000000;
+    std::vector<quint64> items(size_t(batch), 0);
+
+    QBENCHMARK {
+        LogQueue<quint64> queue(1 << 20);
+        QThread *producer = QThread::create([&]() {
+            for (int sent = 0; sent < total; sent += batch)
+                queue.push(items.data(), qMin(batch, total - sent));
+        });
+        producer->start();
+        QVector<quint64> out;
+        out.reserve(1 << 16);
+        quint64 received = 0;
+        while (received < quint64(total)) {
+            out.clear();
+            received += quint64(queue.pop(out, 1 << 16));
+        }
+        producer->wait();
+        delete producer;
+    }
+}
+
+QTEST_GUILESS_MAIN(TestLogQueue)
+#include "tst_logqueue.moc"
@@ -0,0 +1,9 @@
+include(../tests.pri)
+
+TARGET = tst_logqueue
+
+SOURCES += \
+    tst_logqueue.cpp
+
+HEADERS += \
+    $$SRC/LogQueue.h
@@ -0,0 +1,97 @@
+#include <QtTest>
+#include "LogBlockBuilder.h"
+#include "LogSearchIndex.h"
+#include "LogStore.h"
+
+// 全文搜索：子串、TAG/PID 前缀和正则的命中与逐行扫描一致；
+// 带内联选项的正则（(?x) 忽略空白、(?-i) 区分大小写）不按字面量排除块，否则会漏掉命中
+class TestLogSearchIndex : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void parseQuery();
+    void substring();
+    void regex();
+    void regexWithInlineOptions();
+
+private:
+    QList<quint64> search(const QString &input, bool regex);
+
+    LogStore m_store;
+    LogSearchIndex m_index;
+};
+
+// 4 个索引块的普通行，其中 130 号是 errorCode 行，200 号是崩溃行
+void TestLogSearchIndex::initTestCase()
+{
+    LogBlockBuilder builder;
+    builder.setSource("adb:a");
+    for (int i = 0; i < 4 * LogSearchIndex::BlockLines; ++i) {
+        if (i == 130)
+            builder.feed("01-02 03:04:05.678  100  101 W Module: errorCode=42 in module\n");
+        else if (i == 200)
+            builder.feed("01-02 03:04:05.678  300  301 E Crash: FATAL EXCEPTION: main\n");
+        else
+            builder.feed("01-02 03:04:05.678  100  101 I Tag: line " + QByteArray::number(i) + "\n");
+    }
+    const LogBlockPtr block = builder.take();
+    QCOMPARE(block->lines.size(), 4 * LogSearchIndex::BlockLines);
+    m_store.append(*block);
+    m_index.onAppended(m_store, m_store.firstSeq(), m_store.endSeq());
+}
+
+QList<quint64> TestLogSearchIndex::search(const QString &input, bool regex)
+{
+    std::vector<quint64> hits;
+    QString error;
+    if (!m_index.search(m_store, LogSearchIndex::parseQuery(input, regex), hits, &error))
+        qWarning() << input << error;
+    return QList<quint64>(hits.begin(), hits.end());
+}
+
+void TestLogSearchIndex::parseQuery()
+{
+    const LogSearchIndex::Query query = LogSearchIndex::parseQuery("pid:300 fatal tag:Crash exception", false);
+    QCOMPARE(query.text, QString("fatal exception"));
+    QCOMPARE(query.tag, QByteArray("Crash"));
+    QCOMPARE(query.pid, 300);
+    QCOMPARE(LogSearchIndex::parseQuery("pid:x", false).text, QString("pid:x"));
+}
+
+void TestLogSearchIndex::substring()
+{
+    QCOMPARE(search("fatal exception", false), QList<quint64>({200}));
+    QCOMPARE(search("tag:Crash", false), QList<quint64>({200}));
+    QCOMPARE(search("pid:300 main", false), QList<quint64>({200}));
+    QVERIFY(search("pid:100 main", false).isEmpty());
+    QVERIFY(search("tag:Nothing", false).isEmpty());
+    // line 1、line 10~19、line 100~199（130 号不是普通行）
+    QCOMPARE(int(search("line 1", false).size()), 110);
+}
+
+void TestLogSearchIndex::regex()
+{
+    QCOMPARE(search("fatal\\s+exception", true), QList<quint64>({200}));
+    QCOMPARE(search("errorcode=\\d+", true), QList<quint64>({130}));
+    QVERIFY(search("errorcode=43", true).isEmpty());
+
+    std::vector<quint64> hits;
+    QString error;
+    QVERIFY(!m_index.search(m_store, LogSearchIndex::parseQuery("(unclosed", true), hits, &error));
+    QVERIFY(!error.isEmpty());
+}
+
+void TestLogSearchIndex::regexWithInlineOptions()
+{
+    // (?x) 下模式中的空白被忽略，字面量 " error code = 42" 不会出现在行中
+    QCOMPARE(search("(?x) error code = 42", true), QList<quint64>({130}));
+    QCOMPARE(search("(?x)fatal \\s exception", true), QList<quint64>({200}));
+    QCOMPARE(search("(?-i)errorCode", true), QList<quint64>({130}));
+    QVERIFY(search("(?-i)ERRORCODE", true).isEmpty());
+    QCOMPARE(search("(?#note)errorCode", true), QList<quint64>({130}));
+}
+
+QTEST_APPLESS_MAIN(TestLogSearchIndex)
+#include "tst_logsearchindex.moc"
@@ -0,0 +1,12 @@
+include(../tests.pri)
+
+TARGET = tst_logsearchindex
+
+SOURCES += \
+    tst_logsearchindex.cpp \
+    $$SRC/LogSearchIndex.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LogSearchIndex.h \
+    $$CORE_HEADERS
@@ -0,0 +1,285 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include <QTemporaryDir>
+#include "LoadGenerator.h"
+#include "LogBlockBuilder.h"
+#include "LogSessionReader.h"
+#include "LogSessionWriter.h"
+#include <cstring>
+#include <limits>
+
+// 会话文件读取：正常文件、尾部/块索引损坏时退回扫描重建、记录头损坏时该记录不可访问，
+// 以及随机改坏字节后打开和遍历都不越出映射范围
+class TestLogSessionReader : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void validFile();
+    void corruptIndex_data();
+    void corruptIndex();
+    void corruptRecord_data();
+    void corruptRecord();
+    void truncated_data();
+    void truncated();
+    void randomCorruption();
+
+private:
+    QString write(const QByteArray &data, const QString &name);
+    static quint64 recordOffset(const QByteArray &data, int index);
+    static SessionRecordHeader *recordHeader(QByteArray &data, int index);
+    static SessionFileFooter *footer(QByteArray &data);
+    static SessionChunkIndex *chunkIndex(QByteArray &data, int chunk);
+    static void walk(const LogSessionReader &reader, qint64 fileSize);
+
+    QTemporaryDir m_dir;
+    QByteArray m_file;          // 正常关闭的会话文件
+};
+
+static const int RecordCount = 600;     // 三个块：256 + 256 + 88
+
+void TestLogSessionReader::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+    LoadGenerator::Options options;
+    options.linesPerSec = RecordCount;
+    LoadGenerator generator(options);
+    QByteArray text;
+    generator.generate(1000000, text, RecordCount);
+
+    LogBlockBuilder builder;
+    builder.feed(text);
+    const LogBlockPtr block = builder.take();
+    QVERIFY(block);
+    QCOMPARE(block->lines.size(), qsizetype(RecordCount));
+
+    const QString fileName = m_dir.filePath("valid.fdl");
+    LogSessionWriter writer;
+    QVERIFY(writer.open(fileName));
+    writer.append(*block);
+    writer.close();
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    m_file = file.readAll();
+}
+
+QString TestLogSessionReader::write(const QByteArray &data, const QString &name)
+{
+    const QString fileName = m_dir.filePath(name + ".fdl");
+    QFile file(fileName);
+    if (!file.open(QIODevice::WriteOnly | QIODevice::Truncate))
+        return QString();
+    file.write(data);
+    return fileName;
+}
+
+quint64 TestLogSessionReader::recordOffset(const QByteArray &data, int index)
+{
+    quint64 offset = sizeof(SessionFileHeader);
+    for (int i = 0; i < index; ++i) {
+        const auto *h = reinterpret_cast<const SessionRecordHeader *>(data.constData() + offset);
+        offset += sessionRecordSize(h->length);
+    }
+    return offset;
+}
+
+SessionRecordHeader *TestLogSessionReader::recordHeader(QByteArray &data, int index)
+{
+    return reinterpret_cast<SessionRecordHeader *>(data.data() + recordOffset(data, index));
+}
+
+SessionFileFooter *TestLogSessionReader::footer(QByteArray &data)
+{
+    return reinterpret_cast<SessionFileFooter *>(data.data() + data.size() - sizeof(SessionFileFooter));
+}
+
+SessionChunkIndex *TestLogSessionReader::chunkIndex(QByteArray &data, int chunk)
+{
+    return reinterpret_cast<SessionChunkIndex *>(data.data() + footer(data)->indexOffset) + chunk;
+}
+
+// 逐条访问、按时间定位、过滤，访问到的记录都必须完整落在文件内
+// （映射的起点由第一条记录推出，第一条本身损坏时只检查字段）
+void TestLogSessionReader::walk(const LogSessionReader &reader, qint64 fileSize)
+{
+    const LogSessionReader::Record first = reader.record(0);
+    const char *map = first.header ? reinterpret_cast<const char *>(first.header) - sizeof(SessionFileHeader) : nullptr;
+    for (quint64 i = 0; i < reader.recordCount(); ++i) {
+        const LogSessionReader::Record rec = reader.record(i);
+        if (!rec.header)
+            continue;
+        QVERIFY(rec.header->level < 32);
+        QVERIFY(quint32(rec.header->tagOffset) + rec.header->tagLength <= rec.header->length);
+        QVERIFY(rec.header->messageOffset <= rec.header->length);
+        if (map)
+            QVERIFY(rec.line + rec.header->length <= map + fileSize);
+    }
+    reader.findTime(0);
+    reader.findTime(std::numeric_limits<qint64>::max());
+    std::vector<quint64> rows;
+    reader.select(0, QByteArray(), -1, rows);
+    reader.select(3, "ActivityManager", 1000, rows);
+    QVERIFY(rows.size() <= reader.recordCount());
+}
+
+void TestLogSessionReader::validFile()
+{
+    LogSessionReader reader;
+    QString error;
+    QVERIFY2(reader.open(write(m_file, "valid"), &error), qPrintable(error));
+    QCOMPARE(reader.recordCount(), quint64(RecordCount));
+    QCOMPARE(reader.chunkCount(), 3);
+    // 使用的是映射中的尾部索引，不是扫描重建的
+    const char *map = reinterpret_cast<const char *>(reader.record(0).header) - sizeof(SessionFileHeader);
+    QCOMPARE(reinterpret_cast<const char *>(&reader.chunk(0)), map + footer(m_file)->indexOffset);
+    for (int i = 0; i < RecordCount; ++i)
+        QVERIFY(reader.record(quint64(i)).header);
+    QVERIFY(!reader.record(RecordCount).header);
+
+    std::vector<quint64> rows;
+    reader.select(0, QByteArray(), -1, rows);
+    QCOMPARE(rows.size(), size_t(RecordCount));
+    walk(reader, m_file.size());
+}
+
+void TestLogSessionReader::corruptIndex_data()
+{
+    QTest::addColumn<int>("field");
+    QTest::newRow("recordCount huge") << 0;
+    QTest::newRow("recordCount off by one") << 1;
+    QTest::newRow("chunkCount huge") << 2;
+    QTest::newRow("indexOffset past end") << 3;
+    QTest::newRow("indexOffset unaligned") << 4;
+    QTest::newRow("chunk offset past end") << 5;
+    QTest::newRow("chunk offset in header") << 6;
+    QTest::newRow("chunk firstRecord") << 7;
+    QTest::newRow("chunk recordCount") << 8;
+    QTest::newRow("last chunk too long") << 9;
+}
+
+// 尾部或块索引不可信时按扫描重建，记录仍然全部可读
+void TestLogSessionReader::corruptIndex()
+{
+    QFETCH(int, field);
+    QByteArray data = m_file;
+    switch (field) {
+    case 0: footer(data)->recordCount = ~quint64(0) / 2; break;
+    case 1: footer(data)->recordCount += 1; break;
+    case 2: footer(data)->chunkCount = 0xFFFFFFFF; break;
+    case 3: footer(data)->indexOffset = ~quint64(0) - 8; break;
+    case 4: footer(data)->indexOffset += 4; break;
+    case 5: chunkIndex(data, 1)->offset = quint64(data.size()) * 2; break;
+    case 6: chunkIndex(data, 0)->offset = 8; break;
+    case 7: chunkIndex(data, 2)->firstRecord = 100; break;
+    case 8: chunkIndex(data, 0)->recordCount = 0xFFFFFFFF; break;
+    case 9: chunkIndex(data, 2)->recordCount = SESSION_CHUNK_RECORDS + 1; break;
+    }
+
+    LogSessionReader reader;
+    QVERIFY(reader.open(write(data, QTest::currentDataTag())));
+    QCOMPARE(reader.recordCount(), quint64(RecordCount));
+    QCOMPARE(reader.chunkCount(), 3);
+    for (int i = 0; i < RecordCount; ++i)
+        QVERIFY(reader.record(quint64(i)).header);
+    walk(reader, data.size());
+}
+
+void TestLogSessionReader::corruptRecord_data()
+{
+    QTest::addColumn<int>("record");
+    QTest::addColumn<int>("field");
+    QTest::newRow("level 32") << 10 << 0;
+    QTest::newRow("level 255") << 300 << 1;
+    QTest::newRow("tag past line") << 20 << 2;
+    QTest::newRow("message past line") << 530 << 3;
+    QTest::newRow("length past file") << 5 << 4;
+}
+
+// 索引完好、块内某条记录损坏：该记录及同块中其后的记录不可访问，其他块不受影响
+void TestLogSessionReader::corruptRecord()
+{
+    QFETCH(int, record);
+    QFETCH(int, field);
+    QByteArray data = m_file;
+    SessionRecordHeader *h = recordHeader(data, record);
+    switch (field) {
+    case 0: h->level = 32; break;
+    case 1: h->level = 255; break;
+    case 2: h->tagOffset = quint16(h->length); h->tagLength = 1; break;
+    case 3: h->messageOffset = h->length + 1; break;
+    case 4: h->length = 0xFFFFFFF0u; break;
+    }
+
+    LogSessionReader reader;
+    QVERIFY(reader.open(write(data, QTest::currentDataTag())));
+    QCOMPARE(reader.recordCount(), quint64(RecordCount));
+    const int chunkStart = record - record % int(SESSION_CHUNK_RECORDS);
+    const int chunkEnd = qMin(chunkStart + int(SESSION_CHUNK_RECORDS), RecordCount);
+    for (int i = 0; i < RecordCount; ++i) {
+        const bool lost = i >= record && i < chunkEnd;
+        QCOMPARE(reader.record(quint64(i)).header == nullptr, lost);
+    }
+    walk(reader, data.size());
+
+    // 选择结果不包含不可访问的记录
+    std::vector<quint64> rows;
+    reader.select(0, QByteArray(), -1, rows);
+    QCOMPARE(rows.size(), size_t(RecordCount - (chunkEnd - record)));
+}
+
+void TestLogSessionReader::truncated_data()
+{
+    QTest::addColumn<int>("corruptAt");
+    QTest::addColumn<int>("cut");
+    QTest::newRow("no footer") << -1 << 0;
+    QTest::newRow("half a record") << -1 << 12;
+    QTest::newRow("bad level while scanning") << 100 << 0;
+}
+
+// 没有尾部（抓取中断）：扫描到半条或损坏的记录为止
+void TestLogSessionReader::truncated()
+{
+    QFETCH(int, corruptAt);
+    QFETCH(int, cut);
+    QByteArray data = m_file;
+    const quint64 end = recordOffset(data, RecordCount - 1);
+    if (corruptAt >= 0)
+        recordHeader(data, corruptAt)->level = 40;
+    data.truncate(qsizetype(end) + cut);
+
+    LogSessionReader reader;
+    QVERIFY(reader.open(write(data, QTest::currentDataTag())));
+    QCOMPARE(reader.recordCount(), quint64(corruptAt >= 0 ? corruptAt : RecordCount - 1));
+    for (quint64 i = 0; i < reader.recordCount(); ++i)
+        QVERIFY(reader.record(i).header);
+    walk(reader, data.size());
+}
+
+void TestLogSessionReader::randomCorruption()
+{
+    QRandomGenerator random(1234);
+    for (int round = 0; round < 300; ++round) {
+        QByteArray data = m_file;
+        const int flips = 1 + int(random.bounded(8));
+        for (int i = 0; i < flips; ++i) {
+            // 一半改在记录头/尾部附近，一半随机
+            const qsizetype pos = random.bounded(2) ? qsizetype(random.bounded(quint32(data.size())))
+                                                    : data.size() - 1 - qsizetype(random.bounded(quint32(1024)));
+            data[pos] = char(random.generate());
+        }
+        if (random.bounded(4) == 0)
+            data.truncate(qsizetype(random.bounded(quint32(data.size()))));
+
+        LogSessionReader reader;
+        if (!reader.open(write(data, "random")))
+            continue;
+        walk(reader, data.size());
+        if (QTest::currentTestFailed())
+            QFAIL(qPrintable(QString("round %1").arg(round)));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestLogSessionReader)
+#include "tst_logsessionreader.moc"
@@ -0,0 +1,19 @@
+include(../tests.pri)
+
+TARGET = tst_logsessionreader
+
+SOURCES += \
+    tst_logsessionreader.cpp \
+    $$SRC/LoadGenerator.cpp \
+    $$SRC/LogFileWriter.cpp \
+    $$SRC/LogSessionWriter.cpp \
+    $$SRC/LogSessionReader.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/LoadGenerator.h \
+    $$SRC/LogFileWriter.h \
+    $$SRC/LogSessionFormat.h \
+    $$SRC/LogSessionWriter.h \
+    $$SRC/LogSessionReader.h \
+    $$CORE_HEADERS
@@ -0,0 +1,86 @@
+#include <QtTest>
+#include "LogBlockBuilder.h"
+#include "LogStore.h"
+
+// 日志存储：环形覆盖、驻留池整理后编号仍然正确、来源编号用尽时的标记
+class TestLogStore : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void appendAndWrap();
+    void compactsTags();
+    void sourceOverflowIsMarked();
+
+private:
+    static LogBlockPtr makeBlock(const QString &source, int first, int count, const QByteArray &tagPrefix);
+    static void appendRing(LogStore &store, const LogBlock &block);
+};
+
+LogBlockPtr TestLogStore::makeBlock(const QString &source, int first, int count, const QByteArray &tagPrefix)
+{
+    LogBlockBuilder builder;
+    builder.setSource(source);
+    for (int i = first; i < first + count; ++i)
+        builder.feed("01-02 03:04:05.678  100  101 I " + tagPrefix + QByteArray::number(i) + ": line "
+                     + QByteArray::number(i) + "\n");
+    return builder.take();
+}
+
+// 与 LogModel 相同：放不下时先丢弃最旧的记录
+void TestLogStore::appendRing(LogStore &store, const LogBlock &block)
+{
+    const int overflow = store.size() + int(block.lines.size()) - store.capacity();
+    if (overflow > 0)
+        store.dropOldest(overflow);
+    store.append(block);
+}
+
+void TestLogStore::appendAndWrap()
+{
+    LogStore store(10);
+    for (int i = 0; i < 25; i += 5)
+        appendRing(store, *makeBlock("adb:a", i, 5, "Tag"));
+    QCOMPARE(store.size(), 10);
+    QCOMPARE(store.firstSeq(), quint64(15));
+    QCOMPARE(store.at(0).text(), QString("01-02 03:04:05.678  100  101 I Tag15: line 15"));
+    QCOMPARE(store.tags().value(store.at(9).packed->tagId), QByteArray("Tag24"));
+    QCOMPARE(store.sourceName(store.at(0).packed->sourceId), QByteArray("adb:a"));
+}
+
+// 每行一个新 TAG：驻留池不随总行数增长，整理后各记录的 TAG 和来源仍指向正确的串
+void TestLogStore::compactsTags()
+{
+    LogStore store(1000);
+    for (int i = 0; i < 300000; i += 100)
+        appendRing(store, *makeBlock(i % 200 ? "adb:a" : "uart:b", i, 100, "Tag"));
+
+    QVERIFY(store.tags().count() < 2 * LogStore::MinCompactStrings);
+    QVERIFY(store.sources().count() <= 3);
+    for (quint64 seq = store.firstSeq(); seq < store.endSeq(); ++seq) {
+        const LogRecord record = store.bySeq(seq);
+        const QByteArray line(record.data(), record.size());
+        QVERIFY(line.contains(" " + store.tags().value(record.packed->tagId) + ": "));
+        QVERIFY(!store.sourceName(record.packed->sourceId).isEmpty());
+    }
+}
+
+// 同时存在的来源超过 16 位编号时，多出的来源记为 OverflowSourceId，不与已有来源混淆
+void TestLogStore::sourceOverflowIsMarked()
+{
+    LogStore store(70000);
+    for (int i = 0; i < int(LogStore::OverflowSourceId) + 10; ++i)
+        appendRing(store, *makeBlock(QString("adb:%1").arg(i), i, 1, "Tag"));
+
+    for (int row = 0; row < store.size(); ++row) {
+        const quint16 sourceId = store.at(row).packed->sourceId;
+        if (row < int(LogStore::OverflowSourceId) - 1)
+            QCOMPARE(store.sourceName(sourceId), QString("adb:%1").arg(row).toUtf8());
+        else
+            QCOMPARE(sourceId, LogStore::OverflowSourceId);
+    }
+    QCOMPARE(store.sourceName(LogStore::OverflowSourceId), QByteArray("?"));
+}
+
+QTEST_APPLESS_MAIN(TestLogStore)
+#include "tst_logstore.moc"
@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_logstore
+
+SOURCES += \
+    tst_logstore.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$CORE_HEADERS
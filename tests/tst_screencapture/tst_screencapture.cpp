@@ -0,0 +1,86 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "ScreenCapture.h"
+#ifdef Q_OS_UNIX
+#include <sys/resource.h>
+#include <csignal>
+#endif
+
+// PNG 截图写文件：正常时得到完整文件，写入失败（用 RLIMIT_FSIZE 模拟磁盘满）时本帧报失败且不留下截断的文件
+// 用一个 shell 脚本充当 adb，输出 PNG 文件头加 256 KB 数据，仅类 Unix 系统
+class TestScreenCapture : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void writesFile();
+    void writeFailureFailsFrame();
+
+private:
+    QTemporaryDir m_dir;
+    QString m_adb;
+};
+
+static const int PayloadBytes = 256 * 1024;
+
+void TestScreenCapture::initTestCase()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("模拟 adb 是 shell 脚本");
+#endif
+    QVERIFY(m_dir.isValid());
+    m_adb = m_dir.filePath("adb.sh");
+    QFile file(m_adb);
+    QVERIFY(file.open(QIODevice::WriteOnly));
+    file.write("#!/bin/sh\n"
+               "printf '\\211PNG\\r\\n\\032\\n'\n"
+               "head -c " + QByteArray::number(PayloadBytes) + " /dev/zero\n"
+               "exit 0\n");
+    file.close();
+    file.setPermissions(file.permissions() | QFileDevice::ExeOwner);
+}
+
+void TestScreenCapture::writesFile()
+{
+    ScreenCapture capture(m_adb);
+    QSignalSpy captured(&capture, &ScreenCapture::captured);
+    QSignalSpy failed(&capture, &ScreenCapture::failed);
+    const QString target = m_dir.filePath("ok.png");
+    QVERIFY(capture.capture(QString(), target));
+    QTRY_COMPARE(captured.count() + failed.count(), 1);
+    QCOMPARE(captured.count(), 1);
+    QCOMPARE(QFileInfo(target).size(), qint64(8 + PayloadBytes));
+}
+
+void TestScreenCapture::writeFailureFailsFrame()
+{
+#ifdef Q_OS_UNIX
+    // 超过文件大小上限的 write 返回 EFBIG（忽略 SIGXFSZ），与磁盘满时一样写不进去
+    rlimit saved;
+    QVERIFY(getrlimit(RLIMIT_FSIZE, &saved) == 0);
+    rlimit limited = saved;
+    limited.rlim_cur = 4096;
+    const auto oldHandler = std::signal(SIGXFSZ, SIG_IGN);
+    QVERIFY(setrlimit(RLIMIT_FSIZE, &limited) == 0);
+
+    ScreenCapture capture(m_adb);
+    QSignalSpy captured(&capture, &ScreenCapture::captured);
+    QSignalSpy failed(&capture, &ScreenCapture::failed);
+    const QString target = m_dir.filePath("full.png");
+    const bool started = capture.capture(QString(), target);
+    QTest::qWaitFor([&]() { return captured.count() + failed.count() > 0; }, 10000);
+
+    setrlimit(RLIMIT_FSIZE, &saved);
+    std::signal(SIGXFSZ, oldHandler);
+
+    QVERIFY(started);
+    QCOMPARE(captured.count(), 0);
+    QCOMPARE(failed.count(), 1);
+    QVERIFY(failed.first().first().toString().startsWith("写入截图文件失败"));
+    QVERIFY(!QFile::exists(target));
+#endif
+}
+
+QTEST_GUILESS_MAIN(TestScreenCapture)
+#include "tst_screencapture.moc"
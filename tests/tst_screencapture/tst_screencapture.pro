@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_screencapture
+
+SOURCES += \
+    tst_screencapture.cpp \
+    $$SRC/ScreenCapture.cpp
+
+HEADERS += \
+    $$SRC/ScreenCapture.h
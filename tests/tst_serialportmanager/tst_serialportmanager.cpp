@@ -0,0 +1,98 @@
+#include <QtTest>
+#include <QPointer>
+#include "CaptureSessionManager.h"
+#include "SerialPortManager.h"
+
+#ifdef Q_OS_UNIX
+#include <fcntl.h>
+#include <unistd.h>
+#include <cstdlib>
+#endif
+
+// 串口管理的关闭与析构：closePort 立即发出一次 portClosed，之后的 sessionStopped 不再重复；
+// 串口打开时按 MainWindow 的创建顺序（先 CaptureSessionManager 后 SerialPortManager）析构父对象不访问已释放的管理器
+// 用伪终端从端充当串口，仅类 Unix 系统
+class TestSerialPortManager : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cleanupTestCase();
+    void closeEmitsOnce();
+    void destroyWithPortOpen();
+    void destroyPortManagerFirst();
+
+private:
+    int m_ptyMaster = -1;
+    QString m_portName;
+};
+
+void TestSerialPortManager::initTestCase()
+{
+#ifndef Q_OS_UNIX
+    QSKIP("虚拟串口使用伪终端");
+#else
+    m_ptyMaster = posix_openpt(O_RDWR | O_NOCTTY);
+    QVERIFY(m_ptyMaster >= 0);
+    QVERIFY(grantpt(m_ptyMaster) == 0 && unlockpt(m_ptyMaster) == 0);
+    m_portName = QString::fromLocal8Bit(ptsname(m_ptyMaster));
+    qRegisterMetaType<LogBlockPtr>();
+#endif
+}
+
+void TestSerialPortManager::cleanupTestCase()
+{
+#ifdef Q_OS_UNIX
+    if (m_ptyMaster >= 0)
+        ::close(m_ptyMaster);
+#endif
+}
+
+void TestSerialPortManager::closeEmitsOnce()
+{
+    CaptureSessionManager captures("adb");
+    captures.setOutputDirectory(QString());
+    SerialPortManager serial(&captures);
+    QSignalSpy closed(&serial, &SerialPortManager::portClosed);
+    QSignalSpy stopped(&captures, &CaptureSessionManager::sessionStopped);
+
+    QVERIFY(serial.openPort(m_portName, 115200));
+    QVERIFY(serial.isPortOpen());
+
+    serial.closePort();
+    QVERIFY(!serial.isPortOpen());
+    QCOMPARE(closed.count(), 1);
+
+    QTRY_COMPARE(stopped.count(), 1);
+    QCOMPARE(closed.count(), 1);
+}
+
+void TestSerialPortManager::destroyWithPortOpen()
+{
+    auto *parent = new QObject;
+    auto *captures = new CaptureSessionManager("adb", parent);
+    captures->setOutputDirectory(QString());
+    QPointer<SerialPortManager> serial = new SerialPortManager(captures, parent);
+    QVERIFY(serial->openPort(m_portName, 115200));
+
+    // 子对象按创建顺序析构：captures 先于 serial
+    delete parent;
+    QVERIFY(serial.isNull());
+}
+
+void TestSerialPortManager::destroyPortManagerFirst()
+{
+    CaptureSessionManager captures("adb");
+    captures.setOutputDirectory(QString());
+    QSignalSpy stopped(&captures, &CaptureSessionManager::sessionStopped);
+    auto *serial = new SerialPortManager(&captures);
+    QVERIFY(serial->openPort(m_portName, 115200));
+
+    delete serial;
+    QTRY_COMPARE(stopped.count(), 1);
+    QTRY_VERIFY(captures.isIdle());
+}
+
+QTEST_GUILESS_MAIN(TestSerialPortManager)
+#include "tst_serialportmanager.moc"
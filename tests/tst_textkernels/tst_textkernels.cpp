@@ -0,0 +1,248 @@
+#include <QtTest>
+#include <QRandomGenerator>
+#include "LogTextKernels.h"
+#include <algorithm>
+#include <vector>
+
+// 文本扫描函数的各实现（逐字节、SSE2、AVX2，只测本机支持的）与测试中独立写出的朴素实现逐一对比：
+// 长度 0~64 的每个长度（覆盖向量宽度前后的所有尾部情况）以及较长的缓冲区，内容随机，
+// 字符集偏向空白、级别字符、'/'、换行、大小写字母和高位字节，保证命中和边界情况都经常出现
+// 缓冲区按实际长度单独分配，配合 CONFIG+=sanitizer 可以发现越界读取
+// 级别字符另外与原先的正则 \b([VDIWE])[/\s] 对比（合法 UTF-8 文本，多字节字符不算单词字符）
+class TestTextKernels : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void cleanupTestCase();
+    void findByte_data();
+    void findByte();
+    void trim_data();
+    void trim();
+    void findLevelByte_data();
+    void findLevelByte();
+    void findLevelByteMatchesRegex_data();
+    void findLevelByteMatchesRegex();
+    void findIgnoreCase_data();
+    void findIgnoreCase();
+
+private:
+    static void addInstructionSets();
+    static std::vector<char> randomBuffer(QRandomGenerator &random, qsizetype length);
+};
+
+static const int RoundsPerLength = 200;
+
+void TestTextKernels::cleanupTestCase()
+{
+    LogTextKernels::setInstructionSet(LogTextKernels::supportedInstructionSet());
+}
+
+void TestTextKernels::addInstructionSets()
+{
+    QTest::addColumn<int>("set");
+    const char *names[] = {"scalar", "SSE2", "AVX2"};
+    for (int set = LogTextKernels::Scalar; set <= LogTextKernels::supportedInstructionSet(); ++set)
+        QTest::newRow(names[set]) << set;
+}
+
+std::vector<char> TestTextKernels::randomBuffer(QRandomGenerator &random, qsizetype length)
+{
+    // 末尾是 "中" 的 UTF-8 编码
+    static const char alphabet[] = " \t\n\r\v\f/VDIWEvdiwe_aZz09:.(\xe4\xb8\xad";
+    std::vector<char> buffer(size_t(length));
+    for (char &c : buffer) {
+        const quint32 pick = random.bounded(8);
+        if (pick == 0)
+            c = char(0x80 + random.bounded(0x80));
+        else if (pick == 1)
+            c = char(random.bounded(256));
+        else
+            c = alphabet[random.bounded(int(sizeof(alphabet) - 1))];
+    }
+    return buffer;
+}
+
+namespace {
+
+bool naiveBlank(char c)
+{
+    return c == ' ' || c == '\t' || c == '\n' || c == '\v' || c == '\f' || c == '\r';
+}
+
+bool naiveWordChar(char c)
+{
+    const uchar u = uchar(c);
+    return u < 0x80 && (c == '_' || (c >= '0' && c <= '9') || (c >= 'a' && c <= 'z') || (c >= 'A' && c <= 'Z'));
+}
+
+qsizetype naiveLevel(const char *data, qsizetype length)
+{
+    for (qsizetype i = 0; i + 1 < length; ++i) {
+        if (!QByteArray("VDIWE").contains(data[i]))
+            continue;
+        if (i > 0 && naiveWordChar(data[i - 1]))
+            continue;
+        if (data[i + 1] == '/' || naiveBlank(data[i + 1]))
+            return i;
+    }
+    return -1;
+}
+
+char naiveLower(char c)
+{
+    return c >= 'A' && c <= 'Z' ? char(c - 'A' + 'a') : c;
+}
+
+qsizetype naiveFind(const char *data, qsizetype length, const QByteArray &needle)
+{
+    for (qsizetype i = 0; i + needle.size() <= length; ++i) {
+        qsizetype j = 0;
+        while (j < needle.size() && naiveLower(data[i + j]) == needle[j])
+            ++j;
+        if (j == needle.size())
+            return i;
+    }
+    return -1;
+}
+
+QList<qsizetype> testLengths()
+{
+    QList<qsizetype> lengths;
+    for (qsizetype length = 0; length <= 64; ++length)
+        lengths << length;
+    lengths << 65 << 95 << 96 << 97 << 127 << 128 << 129 << 255 << 1000 << 4097;
+    return lengths;
+}
+
+} // namespace
+
+void TestTextKernels::findByte_data() { addInstructionSets(); }
+
+void TestTextKernels::findByte()
+{
+    QFETCH(int, set);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    QRandomGenerator random(1);
+    for (qsizetype length : testLengths()) {
+        for (int round = 0; round < RoundsPerLength; ++round) {
+            const std::vector<char> buffer = randomBuffer(random, length);
+            const char *begin = buffer.data();
+            const char *end = begin + length;
+            for (char c : {'\n', '/', char(0xff)}) {
+                const char *expected = std::find(begin, end, c);
+                QCOMPARE(LogTextKernels::findByte(begin, end, c) - begin, expected - begin);
+            }
+        }
+    }
+}
+
+void TestTextKernels::trim_data() { addInstructionSets(); }
+
+void TestTextKernels::trim()
+{
+    QFETCH(int, set);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    QRandomGenerator random(2);
+    for (qsizetype length : testLengths()) {
+        for (int round = 0; round < RoundsPerLength; ++round) {
+            std::vector<char> buffer = randomBuffer(random, length);
+            // 一部分缓冲区整段都是空白，或只在中间留一个非空白字符
+            if (round % 4 == 0) {
+                for (char &c : buffer)
+                    c = " \t\n\r"[random.bounded(4)];
+                if (round % 8 == 0 && length > 0)
+                    buffer[size_t(random.bounded(int(length)))] = 'x';
+            }
+            const char *expectedBegin = buffer.data();
+            const char *expectedEnd = expectedBegin + length;
+            while (expectedBegin < expectedEnd && naiveBlank(*expectedBegin))
+                ++expectedBegin;
+            while (expectedEnd > expectedBegin && naiveBlank(expectedEnd[-1]))
+                --expectedEnd;
+
+            const char *begin = buffer.data();
+            const char *end = begin + length;
+            LogTextKernels::trim(begin, end);
+            QCOMPARE(begin - buffer.data(), expectedBegin - buffer.data());
+            QCOMPARE(end - buffer.data(), expectedEnd - buffer.data());
+        }
+    }
+}
+
+void TestTextKernels::findLevelByte_data() { addInstructionSets(); }
+
+void TestTextKernels::findLevelByte()
+{
+    QFETCH(int, set);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    QRandomGenerator random(3);
+    for (qsizetype length : testLengths()) {
+        for (int round = 0; round < RoundsPerLength; ++round) {
+            const std::vector<char> buffer = randomBuffer(random, length);
+            QCOMPARE(LogTextKernels::findLevelByte(buffer.data(), length), naiveLevel(buffer.data(), length));
+        }
+    }
+}
+
+void TestTextKernels::findLevelByteMatchesRegex_data() { addInstructionSets(); }
+
+void TestTextKernels::findLevelByteMatchesRegex()
+{
+    QFETCH(int, set);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    const QRegularExpression regex(R"(\b([VDIWE])[/\s])");
+    QList<QByteArray> lines = {"中E 崩溃", "中E/Tag", "xE foo", "é W bar", "中文 I/Tag: 中E x", "_E x D y"};
+    // 随机拼接合法的 UTF-8 片段，覆盖向量宽度前后的位置
+    static const char *const pieces[] = {" ", "\t", "/", "V", "D", "I", "W", "E", "e", "_", "a", "0", ":", "中", "é"};
+    QRandomGenerator random(5);
+    for (int round = 0; round < 2000; ++round) {
+        QByteArray line;
+        const int count = random.bounded(80);
+        for (int i = 0; i < count; ++i)
+            line += pieces[random.bounded(int(sizeof(pieces) / sizeof(pieces[0])))];
+        lines << line;
+    }
+
+    for (const QByteArray &line : lines) {
+        const qsizetype i = LogTextKernels::findLevelByte(line.constData(), line.size());
+        const QRegularExpressionMatch match = regex.match(QString::fromUtf8(line));
+        QCOMPARE(i >= 0, match.hasMatch());
+        if (i >= 0)
+            QCOMPARE(QString::fromUtf8(line.constData(), i).size(), match.capturedStart(1));
+    }
+}
+
+void TestTextKernels::findIgnoreCase_data() { addInstructionSets(); }
+
+void TestTextKernels::findIgnoreCase()
+{
+    QFETCH(int, set);
+    QVERIFY(LogTextKernels::setInstructionSet(LogTextKernels::InstructionSet(set)));
+    QRandomGenerator random(4);
+    for (qsizetype length : testLengths()) {
+        for (int round = 0; round < RoundsPerLength; ++round) {
+            const std::vector<char> buffer = randomBuffer(random, length);
+            // 一半的关键字取自缓冲区本身（保证命中），一半随机
+            QByteArray needle;
+            const int needleLength = 1 + random.bounded(6);
+            if (round % 2 == 0 && length >= needleLength) {
+                const int at = random.bounded(int(length - needleLength + 1));
+                needle = QByteArray(buffer.data() + at, needleLength);
+            } else {
+                const std::vector<char> other = randomBuffer(random, needleLength);
+                needle = QByteArray(other.data(), needleLength);
+            }
+            for (char &c : needle)
+                c = naiveLower(c);
+
+            QCOMPARE(LogTextKernels::findIgnoreCase(buffer.data(), length, needle.constData(), needle.size()),
+                     naiveFind(buffer.data(), length, needle));
+        }
+        const std::vector<char> buffer = randomBuffer(random, length);
+        QCOMPARE(LogTextKernels::findIgnoreCase(buffer.data(), length, "", 0), qsizetype(0));
+    }
+}
+
+QTEST_APPLESS_MAIN(TestTextKernels)
+#include "tst_textkernels.moc"
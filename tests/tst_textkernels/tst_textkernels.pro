@@ -0,0 +1,10 @@
+include(../tests.pri)
+
+TARGET = tst_textkernels
+
+SOURCES += \
+    tst_textkernels.cpp \
+    $$SRC/LogTextKernels.cpp
+
+HEADERS += \
+    $$SRC/LogTextKernels.h
@@ -0,0 +1,212 @@
+#include <QtTest>
+#include <QTemporaryDir>
+#include "LogBlockBuilder.h"
+#include "LogWindowRecorder.h"
+#include "PipelineStats.h"
+#include "TriggerEngine.h"
+
+// 触发动作：冷却按 规则 + 来源 计，一台设备的崩溃不会压住另一台；
+// 冻结窗口取自各来源自己记下的行（命中的来源在前），窗口外的行不写出；
+// 各来源的记录超过保留时长后丢弃，停止输出的来源整个移除；规则的时间有上限
+class TestTriggerEngine : public QObject
+{
+    Q_OBJECT
+
+private slots:
+    void initTestCase();
+    void cooldownPerSource();
+    void freezeUsesSourceWindows();
+    void windowsExpire();
+    void stoppedSourcesRemoved();
+    void ruleTimesBounded();
+
+private:
+    struct Line {
+        QByteArray text;
+        qint64 receivedUs;
+    };
+    static LogBlockPtr block(const QString &source, const TriggerMatcherPtr &triggers, const QList<Line> &lines);
+    static QByteArray crashLine(const QByteArray &tag);
+    static QByteArray plainLine(const QByteArray &message);
+
+    QTemporaryDir m_dir;
+};
+
+void TestTriggerEngine::initTestCase()
+{
+    QVERIFY(m_dir.isValid());
+}
+
+LogBlockPtr TestTriggerEngine::block(const QString &source, const TriggerMatcherPtr &triggers, const QList<Line> &lines)
+{
+    LogBlockBuilder builder;
+    builder.setSource(source);
+    builder.setTriggers(triggers);
+    for (const Line &line : lines)
+        builder.addLine(line.text.constData(), line.text.size(), line.receivedUs);
+    return builder.take();
+}
+
+QByteArray TestTriggerEngine::crashLine(const QByteArray &tag)
+{
+    return "01-02 03:04:05.678  1000  1001 E " + tag + ": FATAL EXCEPTION: main";
+}
+
+QByteArray TestTriggerEngine::plainLine(const QByteArray &message)
+{
+    return "01-02 03:04:05.678  1000  1001 I Tag: " + message;
+}
+
+void TestTriggerEngine::cooldownPerSource()
+{
+    TriggerEngine engine;
+    engine.setOutputDirectory(m_dir.filePath("cooldown"));
+    TriggerRule rule;
+    rule.name = "crash";
+    rule.patterns << "FATAL EXCEPTION";
+    rule.actions = TriggerRule::Screenshot;
+    rule.cooldownSec = 30;
+    QVERIFY(engine.setRules({rule}));
+    QSignalSpy shots(&engine, &TriggerEngine::screenshotRequested);
+
+    const qint64 now = PipelineStats::nowUs();
+    // 同一来源连续的命中行只触发一次
+    engine.onBlock(block("adb:a", engine.matcher(), {{crashLine("A"), now}, {crashLine("A"), now + 1000}}));
+    QCOMPARE(shots.count(), 1);
+    QCOMPARE(shots.at(0).at(0).toString(), QString("a"));
+
+    // 另一台设备在冷却期内同样触发
+    engine.onBlock(block("adb:b", engine.matcher(), {{crashLine("B"), now + 2000}}));
+    QCOMPARE(shots.count(), 2);
+    QCOMPARE(shots.at(1).at(0).toString(), QString("b"));
+
+    // 同一秒内的两次触发各有自己的目录
+    const QStringList dirs = QDir(m_dir.filePath("cooldown")).entryList(QDir::Dirs | QDir::NoDotAndDotDot);
+    QCOMPARE(dirs.size(), 2);
+    QVERIFY(QFileInfo(shots.at(0).at(1).toString()).path() != QFileInfo(shots.at(1).at(1).toString()).path());
+
+    // 冷却期内不再触发，过后再次触发
+    engine.onBlock(block("adb:a", engine.matcher(), {{crashLine("A"), now + 10000000}}));
+    QCOMPARE(shots.count(), 2);
+    engine.onBlock(block("adb:a", engine.matcher(), {{crashLine("A"), now + 31000000}}));
+    QCOMPARE(shots.count(), 3);
+}
+
+void TestTriggerEngine::freezeUsesSourceWindows()
+{
+    const QString outputDir = m_dir.filePath("freeze");
+    TriggerEngine engine;
+    engine.setOutputDirectory(outputDir);
+    TriggerRule rule;
+    rule.name = "crash";
+    rule.patterns << "FATAL EXCEPTION";
+    rule.actions = TriggerRule::Freeze;
+    rule.preSec = 2;
+    rule.postSec = 0;
+    QVERIFY(engine.setRules({rule}));
+
+    const qint64 now = PipelineStats::nowUs();
+    engine.onBlock(block("uart:b", engine.matcher(), {{plainLine("old b"), now - 10000000},
+                                                      {plainLine("pre b"), now - 1000000}}));
+    engine.onBlock(block("adb:a", engine.matcher(), {{plainLine("old a"), now - 5000000},
+                                                     {plainLine("pre a"), now - 1000000},
+                                                     {crashLine("A"), now}}));
+
+    // 命中后 postSec 再加 FreezeSettleMs 才写出
+    QString fileName;
+    auto findWindow = [&]() {
+        QDirIterator it(outputDir, {"window.txt"}, QDir::Files, QDirIterator::Subdirectories);
+        fileName = it.hasNext() ? it.next() : QString();
+        return !fileName.isEmpty();
+    };
+    QTRY_VERIFY_WITH_TIMEOUT(findWindow(), 10000);
+
+    QFile file(fileName);
+    QVERIFY(file.open(QIODevice::ReadOnly));
+    const QByteArray text = file.readAll();
+    QVERIFY(text.contains("pre a"));
+    QVERIFY(text.contains("FATAL EXCEPTION"));
+    QVERIFY(text.contains("pre b"));
+    QVERIFY(!text.contains("old a"));
+    QVERIFY(!text.contains("old b"));
+    const qsizetype sectionA = text.indexOf("## adb:a");
+    const qsizetype sectionB = text.indexOf("## uart:b");
+    QVERIFY(sectionA >= 0 && sectionB > sectionA);
+}
+
+void TestTriggerEngine::windowsExpire()
+{
+    LogWindowRecorder recorder(1000000);
+    const QByteArray filler(1000, 'x');
+    const TriggerMatcherPtr none;
+    for (int i = 0; i < 3 * LogWindowRecorder::ChunkBytes / filler.size(); i += 100) {
+        QList<Line> lines;
+        for (int j = 0; j < 100; ++j)
+            lines.append({filler, 0});
+        recorder.append(*block("adb:a", none, lines));
+    }
+    QVERIFY(recorder.memoryUsage() >= 3 * LogWindowRecorder::ChunkBytes);
+
+    // 过期的行整块丢弃，最后一块仍在使用，保留
+    recorder.append(*block("adb:a", none, {{plainLine("late"), 10000000}}));
+    int lines = -1;
+    recorder.window(0, 0, &lines);
+    QVERIFY(lines < LogWindowRecorder::ChunkBytes / filler.size());
+    QVERIFY(recorder.memoryUsage() < 2 * LogWindowRecorder::ChunkBytes);
+    QVERIFY(recorder.window(10000000, 10000000).contains("late"));
+}
+
+void TestTriggerEngine::stoppedSourcesRemoved()
+{
+    TriggerEngine engine;
+    engine.setOutputDirectory(m_dir.filePath("stopped"));
+    TriggerRule rule;
+    rule.name = "crash";
+    rule.patterns << "FATAL EXCEPTION";
+    rule.actions = TriggerRule::Freeze;
+    rule.preSec = 1;
+    rule.postSec = 0;
+    QVERIFY(engine.setRules({rule}));
+
+    const qint64 now = PipelineStats::nowUs();
+    engine.onBlock(block("adb:a", engine.matcher(), {{plainLine("a"), now}}));
+    engine.onBlock(block("uart:b", engine.matcher(), {{plainLine("b"), now}}));
+    QCOMPARE(engine.recordedSources().size(), 2);
+
+    // adb:a 不再输出，保留时长过后随其他来源的下一块移除
+    engine.onBlock(block("uart:b", engine.matcher(), {{plainLine("b"), now + 2000000}}));
+    QCOMPARE(engine.recordedSources().size(), 2);
+    engine.onBlock(block("uart:b", engine.matcher(), {{plainLine("b"), now + 10000000}}));
+    QCOMPARE(engine.recordedSources(), QStringList{"uart:b"});
+}
+
+void TestTriggerEngine::ruleTimesBounded()
+{
+    QVector<TriggerRule> rules;
+    QString error;
+    QVERIFY(TriggerEngine::parseRules(R"([{"name": "a", "patterns": ["x"], "cooldown": -5, "pre": 3600, "post": 0}])",
+                                      rules, &error));
+    QCOMPARE(rules.size(), 1);
+    QCOMPARE(rules[0].cooldownSec, 0);
+    QCOMPARE(rules[0].preSec, TriggerEngine::MaxRuleSec);
+
+    // 超过上限（包括超出 int 的值）整体拒绝
+    for (const QByteArray &post : {QByteArray("3601"), QByteArray("2147484"), QByteArray("1e12")}) {
+        error.clear();
+        QVERIFY(!TriggerEngine::parseRules(R"([{"name": "a", "patterns": ["x"], "post": )" + post + "}]", rules, &error));
+        QVERIFY(error.contains("post"));
+    }
+
+    // 直接设置的规则同样检查，失败时保持原来的规则
+    TriggerEngine engine;
+    const int count = engine.rules().size();
+    TriggerRule rule;
+    rule.name = "a";
+    rule.patterns << "x";
+    rule.postSec = TriggerEngine::MaxRuleSec + 1;
+    QVERIFY(!engine.setRules({rule}, &error));
+    QCOMPARE(engine.rules().size(), count);
+}
+
+QTEST_GUILESS_MAIN(TestTriggerEngine)
+#include "tst_triggerengine.moc"
@@ -0,0 +1,14 @@
+include(../tests.pri)
+
+TARGET = tst_triggerengine
+
+SOURCES += \
+    tst_triggerengine.cpp \
+    $$SRC/TriggerEngine.cpp \
+    $$SRC/LogWindowRecorder.cpp \
+    $$CORE_SOURCES
+
+HEADERS += \
+    $$SRC/TriggerEngine.h \
+    $$SRC/LogWindowRecorder.h \
+    $$CORE_HEADERS